@@ -1,5 +1,5 @@
 import hw_conf
-from machine import Pin, SPI
+import machine
 import framebuf
 import utime
 
@@ -61,23 +61,47 @@ WF_PARTIAL_2IN66 =[
 ]
 
 class EPD_2in66:
-    def __init__(self):
-        self.reset_pin = Pin(hw_conf.RST_PIN, Pin.OUT)
-        self.busy_pin = Pin(hw_conf.BUSY_PIN, Pin.IN, Pin.PULL_UP)
-        self.cs_pin = Pin(hw_conf.CS_PIN, Pin.OUT)
+    # The controller's RAM X address of the first pixel column, in bytes.
+    RAM_X_OFFSET = 1
+
+    def __init__(self, spi=None, reset_pin=None, busy_pin=None, cs_pin=None, dc_pin=None, streaming=False):
+        # Pins and SPI bus default to the Beaver hardware, but can be passed in
+        # (e.g. the recording backend in epd_mock) to run without a panel.
+        if reset_pin is None:
+            reset_pin = machine.Pin(hw_conf.RST_PIN, machine.Pin.OUT)
+        if busy_pin is None:
+            busy_pin = machine.Pin(hw_conf.BUSY_PIN, machine.Pin.IN, machine.Pin.PULL_UP)
+        if cs_pin is None:
+            cs_pin = machine.Pin(hw_conf.CS_PIN, machine.Pin.OUT)
+        if dc_pin is None:
+            dc_pin = machine.Pin(hw_conf.DC_PIN, machine.Pin.OUT)
+        if spi is None:
+            spi = machine.SPI(1)
+            spi.init(baudrate=4000000)
+
+        self.reset_pin = reset_pin
+        self.busy_pin = busy_pin
+        self.cs_pin = cs_pin
         self.width = hw_conf.EPD_WIDTH
         self.height = hw_conf.EPD_HEIGHT
         self.lut = WF_PARTIAL_2IN66
 
-        self.spi = SPI(1)
-        self.spi.init(baudrate=4000000)
-        self.dc_pin = Pin(hw_conf.DC_PIN, Pin.OUT)
-        
-        self.buffer_landscape_black = bytearray(self.height * self.width // 8)
-        self.buffer_landscape_red = bytearray(self.height * self.width // 8)
-        
-        self.image_landscape_black = framebuf.FrameBuffer(self.buffer_landscape_black, self.height, self.width, framebuf.MONO_VLSB)
-        self.image_landscape_red = framebuf.FrameBuffer(self.buffer_landscape_red, self.height, self.width, framebuf.MONO_VLSB)
+        self.spi = spi
+        self.dc_pin = dc_pin
+
+        # In streaming mode every area is written straight into controller RAM
+        # by write_area, so no full-frame shadow buffers are needed; only small
+        # scratch planes sized for the largest area seen so far.
+        self.streaming = streaming
+        if streaming:
+            self.area_buf_black = bytearray(0)
+            self.area_buf_red = bytearray(0)
+        else:
+            self.buffer_landscape_black = bytearray(self.height * self.width // 8)
+            self.buffer_landscape_red = bytearray(self.height * self.width // 8)
+
+            self.image_landscape_black = framebuf.FrameBuffer(self.buffer_landscape_black, self.height, self.width, framebuf.MONO_VLSB)
+            self.image_landscape_red = framebuf.FrameBuffer(self.buffer_landscape_red, self.height, self.width, framebuf.MONO_VLSB)
         self.init(0)
 
     # Hardware reset
@@ -109,6 +133,14 @@ class EPD_2in66:
         self.cs_pin(0)
         self.spi.write(bytearray(buf))
         self.cs_pin(1)
+
+    # Like send_data1 but writes an existing buffer without copying it.
+    def send_buffer(self, buf):
+        self.cs_pin(1)
+        self.dc_pin(1)
+        self.cs_pin(0)
+        self.spi.write(buf)
+        self.cs_pin(1)
         
     def ReadBusy(self):
         print('e-Paper busy')
@@ -134,21 +166,16 @@ class EPD_2in66:
     def SetWindow(self, x_start, y_start, x_end, y_end):
         self.send_command(0x44) # SET_RAM_X_ADDRESS_START_END_POSITION
         # x point must be the multiple of 8 or the last 3 bits will be ignored
-        self.send_data((x_start>>3) & 0xFF)
-        self.send_data((x_end>>3) & 0xFF)
+        self.send_data1(((x_start >> 3) & 0xFF, (x_end >> 3) & 0xFF))
         self.send_command(0x45) # SET_RAM_Y_ADDRESS_START_END_POSITION
-        self.send_data(y_start & 0xFF)
-        self.send_data((y_start >> 8) & 0xFF)
-        self.send_data(y_end & 0xFF)
-        self.send_data((y_end >> 8) & 0xFF)
+        self.send_data1((y_start & 0xFF, (y_start >> 8) & 0xFF, y_end & 0xFF, (y_end >> 8) & 0xFF))
 
     def SetCursor(self, x, y):
         self.send_command(0x4E) # SET_RAM_X_ADDRESS_COUNTER
         self.send_data(x & 0xFF)
         
         self.send_command(0x4F) # SET_RAM_Y_ADDRESS_COUNTER
-        self.send_data(y & 0xFF)
-        self.send_data((y >> 8) & 0xFF)
+        self.send_data1((y & 0xFF, (y >> 8) & 0xFF))
     
     def init(self, mode):
         self.reset()
@@ -217,6 +244,53 @@ class EPD_2in66:
                 self.send_data(image[(Width-i-1) * Height + j])
                 
         
+    # Streaming mode: convert an area of RGB565 pixels (as given to an LVGL flush
+    # callback, in portrait display coordinates) and write it straight into the
+    # controller's black and red RAM through the RAM X/Y window.  Call
+    # TurnOnDisplay once the last area of a frame has been written.
+    #
+    # RAM X addresses are in bytes, so the window is widened to whole bytes.
+    # Pixels outside the area in those edge bytes are written as white; use
+    # round_area as the display's rounder to keep areas byte aligned.
+    def write_area(self, x, y, w, h, pixels):
+        x_start = x & ~7
+        x_end = (x + w + 7) & ~7
+        row_bytes = (x_end - x_start) >> 3
+        size = row_bytes * h
+        if len(self.area_buf_black) < size:
+            self.area_buf_black = bytearray(size)
+            self.area_buf_red = bytearray(size)
+        black_buf = memoryview(self.area_buf_black)[:size]
+        red_buf = memoryview(self.area_buf_red)[:size]
+        black = framebuf.FrameBuffer(black_buf, x_end - x_start, h, framebuf.MONO_HLSB)
+        red = framebuf.FrameBuffer(red_buf, x_end - x_start, h, framebuf.MONO_HLSB)
+        if x_start != x or x_end != x + w:
+            black.fill(1)
+            red.fill(0)
+        framebuf.convert_rgb565_tri(pixels, (x - x_start, 0, w, h), black, red)
+
+        ram_x = self.RAM_X_OFFSET * 8 + x_start
+        self.SetWindow(ram_x, y, ram_x + (x_end - x_start) - 1, y + h - 1)
+        self.SetCursor(ram_x >> 3, y)
+        self.send_command(0x24) # WRITE_RAM_BLACK_WHITE
+        self.send_buffer(black_buf)
+        self.SetCursor(ram_x >> 3, y)
+        self.send_command(0x26) # WRITE_RAM_RED_WHITE
+        self.send_buffer(red_buf)
+
+    # Flush one LVGL area (inclusive corners) in streaming mode, refreshing the
+    # panel only after the last area of the frame.
+    def flush_area(self, x1, y1, x2, y2, pixels, last):
+        self.write_area(x1, y1, x2 - x1 + 1, y2 - y1 + 1, pixels)
+        if last:
+            self.TurnOnDisplay()
+
+    # Widen an area in place so that it covers whole bytes of controller RAM.
+    @staticmethod
+    def round_area(area):
+        area.x1 &= ~7
+        area.x2 |= 7
+
     def Clear(self, color):
         self.send_command(0x24) # WRITE_RAM
         self.send_data1([color] * self.height * int(self.width / 8))
@@ -0,0 +1,62 @@
+# Recording stand-ins for the e-paper pins and SPI bus, so that epd_hal can be
+# exercised without a panel (e.g. on the unix port).  Every SPI write is logged
+# together with the level of the DC pin, which tells commands from data.
+
+
+class MockPin:
+    def __init__(self, value=0):
+        self._value = value
+
+    def __call__(self, value=None):
+        return self.value(value)
+
+    def value(self, value=None):
+        if value is None:
+            return self._value
+        self._value = value
+
+
+class MockSPI:
+    def __init__(self, dc_pin):
+        self.dc_pin = dc_pin
+        self.log = []
+
+    def init(self, *args, **kwargs):
+        pass
+
+    def write(self, buf):
+        self.log.append((self.dc_pin.value(), bytes(buf)))
+
+
+class MockBus:
+    def __init__(self):
+        self.reset_pin = MockPin()
+        self.busy_pin = MockPin(0)  # never busy
+        self.cs_pin = MockPin(1)
+        self.dc_pin = MockPin()
+        self.spi = MockSPI(self.dc_pin)
+
+    # Keyword arguments for the EPD_2in66 constructor.
+    def pins(self):
+        return {
+            "spi": self.spi,
+            "reset_pin": self.reset_pin,
+            "busy_pin": self.busy_pin,
+            "cs_pin": self.cs_pin,
+            "dc_pin": self.dc_pin,
+        }
+
+    # The recorded traffic as a list of (command, data) pairs, with all the
+    # data bytes sent after a command joined together.
+    def transactions(self):
+        out = []
+        for dc, buf in self.spi.log:
+            if dc == 0:
+                for cmd in buf:
+                    out.append((cmd, bytearray()))
+            elif out:
+                out[-1][1].extend(buf)
+        return out
+
+    def clear(self):
+        self.spi.log = []
@@ -0,0 +1,75 @@
+# Checks the streaming mode of epd_hal against the recording backend in
+# epd_mock.  Runs on the unix port: micropython test_epd_hal.py
+import epd_hal
+import epd_mock
+
+WHITE = 0xFFFF
+BLACK = 0x0000
+RED = 0xF800
+
+
+def rgb565(pixels):
+    buf = bytearray(2 * len(pixels))
+    for i, c in enumerate(pixels):
+        buf[2 * i] = c & 0xFF
+        buf[2 * i + 1] = c >> 8
+    return buf
+
+
+bus = epd_mock.MockBus()
+epd = epd_hal.EPD_2in66(streaming=True, **bus.pins())
+assert not hasattr(epd, "buffer_landscape_black")
+bus.clear()
+
+# A byte aligned 16x2 area at (8, 3): one bulk write per plane.
+row0 = [BLACK] * 8 + [WHITE] * 7 + [RED]
+row1 = [RED] * 8 + [WHITE] * 4 + [BLACK] * 4
+epd.flush_area(8, 3, 23, 4, rgb565(row0 + row1), False)
+expected = [
+    (0x44, bytearray([2, 3])),
+    (0x45, bytearray([3, 0, 4, 0])),
+    (0x4E, bytearray([2])),
+    (0x4F, bytearray([3, 0])),
+    (0x24, bytearray([0x00, 0xFF, 0xFF, 0xF0])),
+    (0x4E, bytearray([2])),
+    (0x4F, bytearray([3, 0])),
+    (0x26, bytearray([0x00, 0x01, 0xFF, 0x00])),
+]
+assert bus.transactions() == expected
+# Each plane goes out in a single SPI write.
+assert (1, bytes(expected[4][1])) in bus.spi.log
+assert (1, bytes(expected[7][1])) in bus.spi.log
+print("aligned area OK")
+
+# An unaligned area is widened to whole bytes, padding with white.
+bus.clear()
+epd.flush_area(3, 0, 6, 0, rgb565([BLACK, RED, BLACK, RED]), False)
+t = bus.transactions()
+assert t[0] == (0x44, bytearray([1, 1]))
+assert t[4] == (0x24, bytearray([0b11101011]))
+assert t[7] == (0x26, bytearray([0b00001010]))
+print("unaligned area OK")
+
+# The panel is refreshed only once, after the last area of a frame.
+bus.clear()
+band = rgb565([WHITE] * 152 * 10)
+for y in range(0, 296, 10):
+    h = min(10, 296 - y)
+    epd.flush_area(0, y, 151, y + h - 1, band, y + h == 296)
+cmds = [cmd for cmd, data in bus.transactions()]
+assert cmds.count(0x24) == 30
+assert cmds.count(0x20) == 1 and cmds[-1] == 0x20
+print("frame OK")
+
+round_area = epd_hal.EPD_2in66.round_area
+
+
+class Area:
+    pass
+
+
+a = Area()
+a.x1, a.x2 = 3, 17
+round_area(a)
+assert (a.x1, a.x2) == (0, 23)
+print("round_area OK")
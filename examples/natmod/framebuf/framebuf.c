@@ -1,9 +1,13 @@
 #define MICROPY_PY_ARRAY (1)
 #define MICROPY_PY_FRAMEBUF (1)
+#define MICROPY_PY_FRAMEBUF_DIRTY (1)
 
 #include "py/dynruntime.h"
 
 #if !defined(__linux__)
+void *memcpy(void *dst, const void *src, size_t n) {
+    return mp_fun_table.memmove_(dst, src, n);
+}
 void *memset(void *s, int c, size_t n) {
     return mp_fun_table.memset_(s, c, n);
 }
@@ -13,7 +17,7 @@ mp_obj_full_type_t mp_type_framebuf;
 
 #include "extmod/modframebuf.c"
 
-mp_map_elem_t framebuf_locals_dict_table[12];
+mp_map_elem_t framebuf_locals_dict_table[14];
 static MP_DEFINE_CONST_DICT(framebuf_locals_dict, framebuf_locals_dict_table);
 
 mp_obj_t mpy_init(mp_obj_fun_bc_t *self, size_t n_args, size_t n_kw, mp_obj_t *args) {
@@ -35,6 +39,8 @@ mp_obj_t mpy_init(mp_obj_fun_bc_t *self, size_t n_args, size_t n_kw, mp_obj_t *a
     framebuf_locals_dict_table[9] = (mp_map_elem_t){ MP_OBJ_NEW_QSTR(MP_QSTR_blit), MP_OBJ_FROM_PTR(&framebuf_blit_obj) };
     framebuf_locals_dict_table[10] = (mp_map_elem_t){ MP_OBJ_NEW_QSTR(MP_QSTR_scroll), MP_OBJ_FROM_PTR(&framebuf_scroll_obj) };
     framebuf_locals_dict_table[11] = (mp_map_elem_t){ MP_OBJ_NEW_QSTR(MP_QSTR_text), MP_OBJ_FROM_PTR(&framebuf_text_obj) };
+    framebuf_locals_dict_table[12] = (mp_map_elem_t){ MP_OBJ_NEW_QSTR(MP_QSTR_dirty), MP_OBJ_FROM_PTR(&framebuf_dirty_obj) };
+    framebuf_locals_dict_table[13] = (mp_map_elem_t){ MP_OBJ_NEW_QSTR(MP_QSTR_clear_dirty), MP_OBJ_FROM_PTR(&framebuf_clear_dirty_obj) };
     MP_OBJ_TYPE_SET_SLOT(&mp_type_framebuf, locals_dict, (void*)&framebuf_locals_dict, 2);
 
     mp_store_global(MP_QSTR_FrameBuffer, MP_OBJ_FROM_PTR(&mp_type_framebuf));
@@ -46,6 +52,12 @@ mp_obj_t mpy_init(mp_obj_fun_bc_t *self, size_t n_args, size_t n_kw, mp_obj_t *a
     mp_store_global(MP_QSTR_GS8, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_GS8));
     mp_store_global(MP_QSTR_MONO_HLSB, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_MHLSB));
     mp_store_global(MP_QSTR_MONO_HMSB, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_MHMSB));
+    mp_store_global(MP_QSTR_FLIP_H, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_FLIP_H));
+    mp_store_global(MP_QSTR_FLIP_V, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_FLIP_V));
+    mp_store_global(MP_QSTR_TRANSPOSE, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_TRANSPOSE));
+    mp_store_global(MP_QSTR_ROTATE_90, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_ROTATE_90));
+    mp_store_global(MP_QSTR_ROTATE_180, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_ROTATE_180));
+    mp_store_global(MP_QSTR_ROTATE_270, MP_OBJ_NEW_SMALL_INT(FRAMEBUF_ROTATE_270));
 
     MP_DYNRUNTIME_INIT_EXIT
 }
@@ -23,6 +23,7 @@ SRC_EXTMOD_C += \
 	extmod/modbtree.c \
 	extmod/modcryptolib.c \
 	extmod/moddeflate.c \
+	extmod/modepaper.c \
 	extmod/modframebuf.c \
 	extmod/modhashlib.c \
 	extmod/modheapq.c \
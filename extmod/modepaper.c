@@ -0,0 +1,536 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Beaver contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mperrno.h"
+#include "py/mphal.h"
+#include "extmod/tricolour.h"
+
+#if MICROPY_PY_EPAPER
+
+#if MICROPY_PY_MACHINE_SPI
+#include "extmod/modmachine.h"
+#endif
+
+// Driver for SSD1680-class tri-colour (white/black/red) e-paper controllers.
+//
+// Pixels from LVGL (RGB565 or L8) are quantised to the controller's black/white
+// and red/white RAM planes and streamed straight into the RAM X/Y window that
+// covers each flushed area, so no frame buffer is kept in RAM.
+//
+// The SPI bus may be a machine.SPI/SoftSPI object, which is driven through its
+// C protocol, or any object with a write(buf) method (eg a recording fake on
+// the unix port).  Pins may be any callable pin-like object.
+
+#define EPAPER_RGB565 (0)
+#define EPAPER_L8 (1)
+
+#define EPAPER_WAVEFORM_FULL (0)
+#define EPAPER_WAVEFORM_PARTIAL (1)
+
+#define EPAPER_CMD_SW_RESET (0x12)
+#define EPAPER_CMD_DEEP_SLEEP (0x10)
+#define EPAPER_CMD_DATA_ENTRY_MODE (0x11)
+#define EPAPER_CMD_MASTER_ACTIVATION (0x20)
+#define EPAPER_CMD_UPDATE_CONTROL_2 (0x22)
+#define EPAPER_CMD_WRITE_RAM_BW (0x24)
+#define EPAPER_CMD_WRITE_RAM_RED (0x26)
+#define EPAPER_CMD_WRITE_LUT (0x32)
+#define EPAPER_CMD_DISPLAY_OPTION (0x37)
+#define EPAPER_CMD_BORDER_WAVEFORM (0x3c)
+#define EPAPER_CMD_RAM_X_WINDOW (0x44)
+#define EPAPER_CMD_RAM_Y_WINDOW (0x45)
+#define EPAPER_CMD_RAM_X_COUNTER (0x4e)
+#define EPAPER_CMD_RAM_Y_COUNTER (0x4f)
+
+// Data is converted into this many bytes at a time before being sent.
+#define EPAPER_CHUNK_SIZE (128)
+
+#define EPAPER_BUSY_POLL_MS (10)
+#define EPAPER_BUSY_TIMEOUT_MS (30000)
+
+// Partial refresh waveform for the 2.66" panel (the 153-byte LUT register
+// contents only, as sent by WF_PARTIAL_2IN66 in epd_hal.py).
+static const uint8_t epaper_lut_partial[153] = {
+    0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x00, 0x00, 0x00,
+};
+
+// Display option register settings used with the partial refresh waveform.
+static const uint8_t epaper_partial_display_option[10] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00,
+};
+
+typedef struct _epaper_ssd1680_obj_t {
+    mp_obj_base_t base;
+    mp_obj_t spi;
+    #if MICROPY_PY_MACHINE_SPI
+    const mp_machine_spi_p_t *spi_p;
+    #endif
+    mp_obj_t dc, cs, rst, busy;
+    uint16_t width, height;
+    uint8_t ram_x_offset;
+    uint8_t color_format;
+    uint16_t black_max;
+    // Classification tables for RGB565 input.
+    tri_tables_t tables;
+} epaper_ssd1680_obj_t;
+
+// A plane of the area being written: which RAM it goes to and how its bits are
+// derived from the classified pixels.
+typedef enum {
+    PLANE_BLACK,
+    PLANE_RED,
+} epaper_plane_t;
+
+static void epaper_pin_write(mp_obj_t pin, int value) {
+    mp_call_function_1(pin, MP_OBJ_NEW_SMALL_INT(value));
+}
+
+static void epaper_spi_write(epaper_ssd1680_obj_t *self, const uint8_t *buf, size_t len) {
+    #if MICROPY_PY_MACHINE_SPI
+    if (self->spi_p != NULL) {
+        self->spi_p->transfer(MP_OBJ_TO_PTR(self->spi), len, buf, NULL);
+        return;
+    }
+    #endif
+    mp_obj_t dest[3];
+    mp_load_method(self->spi, MP_QSTR_write, dest);
+    dest[2] = mp_obj_new_bytes(buf, len);
+    mp_call_method_n_kw(1, 0, dest);
+}
+
+// Start a command or data transfer; data may then be sent in any number of
+// epaper_spi_write calls before epaper_end.
+static void epaper_begin(epaper_ssd1680_obj_t *self, int dc) {
+    epaper_pin_write(self->cs, 1);
+    epaper_pin_write(self->dc, dc);
+    epaper_pin_write(self->cs, 0);
+}
+
+static void epaper_end(epaper_ssd1680_obj_t *self) {
+    epaper_pin_write(self->cs, 1);
+}
+
+static void epaper_command(epaper_ssd1680_obj_t *self, uint8_t cmd, const uint8_t *data, size_t len) {
+    epaper_begin(self, 0);
+    epaper_spi_write(self, &cmd, 1);
+    epaper_end(self);
+    if (len) {
+        epaper_begin(self, 1);
+        epaper_spi_write(self, data, len);
+        epaper_end(self);
+    }
+}
+
+static bool epaper_is_busy(epaper_ssd1680_obj_t *self) {
+    return mp_obj_is_true(mp_call_function_0(self->busy));
+}
+
+// Wait for BUSY to be released.  Pending events and scheduled callbacks are
+// processed while waiting, so the VM stays responsive during a refresh.
+static void epaper_wait(epaper_ssd1680_obj_t *self, mp_uint_t timeout_ms) {
+    mp_uint_t start = mp_hal_ticks_ms();
+    while (epaper_is_busy(self)) {
+        if (mp_hal_ticks_ms() - start >= timeout_ms) {
+            mp_raise_OSError(MP_ETIMEDOUT);
+        }
+        mp_event_wait_ms(EPAPER_BUSY_POLL_MS);
+    }
+}
+
+static void epaper_set_thresholds(epaper_ssd1680_obj_t *self, const mp_int_t *thresholds) {
+    tri_tables_init(&self->tables, thresholds);
+    self->black_max = MAX(0, MIN(thresholds[TRI_BLACK_R_MAX], 256));
+}
+
+// Return the RAM bit for a pixel in the given plane: 1 is white in the black
+// plane and red in the red plane.
+static inline unsigned int epaper_pixel_bit(const epaper_ssd1680_obj_t *self, const uint8_t *p, epaper_plane_t plane) {
+    if (self->color_format == EPAPER_L8) {
+        return plane == PLANE_BLACK ? p[0] >= self->black_max : 0;
+    }
+    // Little-endian RGB565, as produced by LVGL.
+    unsigned int cls = tri_classify(&self->tables, p[0] | p[1] << 8);
+    if (plane == PLANE_BLACK) {
+        return (cls & TRI_CLASS_RED) || !(cls & TRI_CLASS_BLACK);
+    } else {
+        return cls & TRI_CLASS_RED;
+    }
+}
+
+static void epaper_set_window(epaper_ssd1680_obj_t *self, mp_int_t xb0, mp_int_t xb1, mp_int_t y0, mp_int_t y1) {
+    uint8_t buf[4] = {xb0, xb1};
+    epaper_command(self, EPAPER_CMD_RAM_X_WINDOW, buf, 2);
+    buf[0] = y0 & 0xff;
+    buf[1] = y0 >> 8;
+    buf[2] = y1 & 0xff;
+    buf[3] = y1 >> 8;
+    epaper_command(self, EPAPER_CMD_RAM_Y_WINDOW, buf, 4);
+}
+
+static void epaper_set_cursor(epaper_ssd1680_obj_t *self, mp_int_t xb, mp_int_t y) {
+    uint8_t buf[2] = {xb};
+    epaper_command(self, EPAPER_CMD_RAM_X_COUNTER, buf, 1);
+    buf[0] = y & 0xff;
+    buf[1] = y >> 8;
+    epaper_command(self, EPAPER_CMD_RAM_Y_COUNTER, buf, 2);
+}
+
+// Stream one plane of the area [x0, x1] x [y0, y1] (inclusive, clipped to the
+// panel) into RAM.  The source pixels cover [ax, ax + aw) in x starting at row
+// ay, and bits outside the area within the edge bytes are written as white.
+static void epaper_write_plane(epaper_ssd1680_obj_t *self, epaper_plane_t plane, const uint8_t *pixels,
+    mp_int_t ax, mp_int_t ay, mp_int_t aw, mp_int_t x0, mp_int_t y0, mp_int_t x1, mp_int_t y1) {
+    size_t bpp = self->color_format == EPAPER_L8 ? 1 : 2;
+    uint8_t pad = plane == PLANE_BLACK ? 1 : 0;
+    mp_int_t xb0 = x0 >> 3, xb1 = x1 >> 3;
+
+    epaper_set_cursor(self, self->ram_x_offset + xb0, y0);
+    uint8_t cmd = plane == PLANE_BLACK ? EPAPER_CMD_WRITE_RAM_BW : EPAPER_CMD_WRITE_RAM_RED;
+    epaper_command(self, cmd, NULL, 0);
+
+    uint8_t chunk[EPAPER_CHUNK_SIZE];
+    size_t n = 0;
+    epaper_begin(self, 1);
+    for (mp_int_t y = y0; y <= y1; ++y) {
+        const uint8_t *row = pixels + (y - ay) * aw * bpp;
+        for (mp_int_t xb = xb0; xb <= xb1; ++xb) {
+            uint8_t bits = 0;
+            for (mp_int_t x = xb * 8; x < xb * 8 + 8; ++x) {
+                unsigned int bit = pad;
+                if (x0 <= x && x <= x1) {
+                    bit = epaper_pixel_bit(self, row + (x - ax) * bpp, plane);
+                }
+                // The leftmost pixel is the most significant bit.
+                bits = bits << 1 | bit;
+            }
+            chunk[n++] = bits;
+            if (n == EPAPER_CHUNK_SIZE) {
+                epaper_spi_write(self, chunk, n);
+                n = 0;
+            }
+        }
+    }
+    if (n) {
+        epaper_spi_write(self, chunk, n);
+    }
+    epaper_end(self);
+}
+
+static void epaper_write_area(epaper_ssd1680_obj_t *self, mp_int_t x0, mp_int_t y0, mp_int_t x1, mp_int_t y1, mp_obj_t pixels_in) {
+    mp_int_t aw = x1 - x0 + 1;
+    mp_int_t ah = y1 - y0 + 1;
+    if (aw < 1 || ah < 1) {
+        return;
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(pixels_in, &bufinfo, MP_BUFFER_READ);
+    size_t bpp = self->color_format == EPAPER_L8 ? 1 : 2;
+    if ((size_t)ah > bufinfo.len / bpp / (size_t)aw) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+
+    // Clip to the panel.
+    mp_int_t ax = x0, ay = y0;
+    x0 = MAX(x0, 0);
+    y0 = MAX(y0, 0);
+    x1 = MIN(x1, self->width - 1);
+    y1 = MIN(y1, self->height - 1);
+    if (x1 < x0 || y1 < y0) {
+        return;
+    }
+
+    epaper_set_window(self, self->ram_x_offset + (x0 >> 3), self->ram_x_offset + (x1 >> 3), y0, y1);
+    epaper_write_plane(self, PLANE_BLACK, bufinfo.buf, ax, ay, aw, x0, y0, x1, y1);
+    epaper_write_plane(self, PLANE_RED, bufinfo.buf, ax, ay, aw, x0, y0, x1, y1);
+}
+
+static void epaper_refresh(epaper_ssd1680_obj_t *self, bool wait) {
+    epaper_command(self, EPAPER_CMD_MASTER_ACTIVATION, NULL, 0);
+    if (wait) {
+        epaper_wait(self, EPAPER_BUSY_TIMEOUT_MS);
+    }
+}
+
+static mp_obj_t epaper_ssd1680_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_spi, ARG_dc, ARG_cs, ARG_rst, ARG_busy, ARG_width, ARG_height, ARG_ram_x_offset, ARG_color_format, ARG_thresholds };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_spi, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_dc, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_cs, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_rst, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_busy, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_width, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 152} },
+        { MP_QSTR_height, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 296} },
+        { MP_QSTR_ram_x_offset, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 1} },
+        { MP_QSTR_color_format, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = EPAPER_RGB565} },
+        { MP_QSTR_thresholds, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t width = args[ARG_width].u_int;
+    mp_int_t height = args[ARG_height].u_int;
+    if (width < 8 || width > 2040 || height < 1 || height > 0xffff) {
+        mp_raise_ValueError(NULL);
+    }
+    if (args[ARG_color_format].u_int != EPAPER_RGB565 && args[ARG_color_format].u_int != EPAPER_L8) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid format"));
+    }
+
+    epaper_ssd1680_obj_t *self = mp_obj_malloc(epaper_ssd1680_obj_t, type);
+    self->spi = args[ARG_spi].u_obj;
+    #if MICROPY_PY_MACHINE_SPI
+    // Only use the C protocol of genuine machine.SPI/SoftSPI objects.
+    const mp_obj_type_t *spi_type = mp_obj_get_type(self->spi);
+    self->spi_p = NULL;
+    if (MP_OBJ_TYPE_HAS_SLOT(spi_type, locals_dict)
+        && MP_OBJ_TYPE_GET_SLOT(spi_type, locals_dict) == &mp_machine_spi_locals_dict) {
+        self->spi_p = MP_OBJ_TYPE_GET_SLOT(spi_type, protocol);
+    }
+    #endif
+    self->dc = args[ARG_dc].u_obj;
+    self->cs = args[ARG_cs].u_obj;
+    self->rst = args[ARG_rst].u_obj;
+    self->busy = args[ARG_busy].u_obj;
+    self->width = width;
+    self->height = height;
+    self->ram_x_offset = args[ARG_ram_x_offset].u_int;
+    self->color_format = args[ARG_color_format].u_int;
+
+    mp_int_t thresholds[TRI_NUM_THRESHOLDS];
+    tri_thresholds_get(args[ARG_thresholds].u_obj, thresholds);
+    epaper_set_thresholds(self, thresholds);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static mp_obj_t epaper_ssd1680_reset(mp_obj_t self_in) {
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    epaper_pin_write(self->rst, 1);
+    mp_hal_delay_ms(200);
+    epaper_pin_write(self->rst, 0);
+    mp_hal_delay_ms(200);
+    epaper_pin_write(self->rst, 1);
+    mp_hal_delay_ms(200);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(epaper_ssd1680_reset_obj, epaper_ssd1680_reset);
+
+static mp_obj_t epaper_ssd1680_init(size_t n_args, const mp_obj_t *args) {
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t waveform = n_args > 1 ? mp_obj_get_int(args[1]) : EPAPER_WAVEFORM_FULL;
+    mp_buffer_info_t lut = { .buf = (void *)epaper_lut_partial, .len = sizeof(epaper_lut_partial) };
+    if (n_args > 2) {
+        mp_get_buffer_raise(args[2], &lut, MP_BUFFER_READ);
+    }
+    if (waveform != EPAPER_WAVEFORM_FULL && waveform != EPAPER_WAVEFORM_PARTIAL) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid waveform"));
+    }
+
+    epaper_ssd1680_reset(self);
+    epaper_command(self, EPAPER_CMD_SW_RESET, NULL, 0);
+    epaper_wait(self, EPAPER_BUSY_TIMEOUT_MS);
+
+    // X and Y increment, X first.
+    uint8_t data = 0x03;
+    epaper_command(self, EPAPER_CMD_DATA_ENTRY_MODE, &data, 1);
+    epaper_set_window(self, self->ram_x_offset, self->ram_x_offset + ((self->width - 1) >> 3), 0, self->height - 1);
+
+    if (waveform == EPAPER_WAVEFORM_FULL) {
+        // Use the full refresh waveform from OTP.
+        data = 0x01;
+        epaper_command(self, EPAPER_CMD_BORDER_WAVEFORM, &data, 1);
+    } else {
+        // The whole LUT goes out in a single transfer.
+        epaper_command(self, EPAPER_CMD_WRITE_LUT, lut.buf, lut.len);
+        epaper_wait(self, EPAPER_BUSY_TIMEOUT_MS);
+        epaper_command(self, EPAPER_CMD_DISPLAY_OPTION, epaper_partial_display_option, sizeof(epaper_partial_display_option));
+        data = 0x80;
+        epaper_command(self, EPAPER_CMD_BORDER_WAVEFORM, &data, 1);
+        data = 0xcf;
+        epaper_command(self, EPAPER_CMD_UPDATE_CONTROL_2, &data, 1);
+        epaper_refresh(self, true);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(epaper_ssd1680_init_obj, 1, 3, epaper_ssd1680_init);
+
+static mp_obj_t epaper_ssd1680_clear(size_t n_args, const mp_obj_t *args) {
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    // Default to white: all ones in the black plane and zeros in the red plane.
+    uint8_t black = n_args > 1 ? mp_obj_get_int(args[1]) : 0xff;
+    uint8_t red = n_args > 2 ? mp_obj_get_int(args[2]) : 0x00;
+    size_t row_bytes = (self->width + 7) >> 3;
+    size_t len = row_bytes * self->height;
+    uint8_t chunk[EPAPER_CHUNK_SIZE];
+
+    epaper_set_window(self, self->ram_x_offset, self->ram_x_offset + row_bytes - 1, 0, self->height - 1);
+    for (int i = 0; i < 2; ++i) {
+        epaper_set_cursor(self, self->ram_x_offset, 0);
+        epaper_command(self, i == 0 ? EPAPER_CMD_WRITE_RAM_BW : EPAPER_CMD_WRITE_RAM_RED, NULL, 0);
+        memset(chunk, i == 0 ? black : red, sizeof(chunk));
+        epaper_begin(self, 1);
+        for (size_t n = len; n;) {
+            size_t l = MIN(n, sizeof(chunk));
+            epaper_spi_write(self, chunk, l);
+            n -= l;
+        }
+        epaper_end(self);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(epaper_ssd1680_clear_obj, 1, 3, epaper_ssd1680_clear);
+
+static mp_obj_t epaper_ssd1680_write_area(size_t n_args, const mp_obj_t *args) {
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    epaper_write_area(self, mp_obj_get_int(args[1]), mp_obj_get_int(args[2]),
+        mp_obj_get_int(args[3]), mp_obj_get_int(args[4]), args[5]);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(epaper_ssd1680_write_area_obj, 6, 6, epaper_ssd1680_write_area);
+
+static mp_obj_t epaper_ssd1680_refresh(size_t n_args, const mp_obj_t *args) {
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    epaper_refresh(self, n_args < 2 || mp_obj_is_true(args[1]));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(epaper_ssd1680_refresh_obj, 1, 2, epaper_ssd1680_refresh);
+
+static mp_obj_t epaper_ssd1680_busy(mp_obj_t self_in) {
+    return mp_obj_new_bool(epaper_is_busy(MP_OBJ_TO_PTR(self_in)));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(epaper_ssd1680_busy_obj, epaper_ssd1680_busy);
+
+static mp_obj_t epaper_ssd1680_wait(size_t n_args, const mp_obj_t *args) {
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    epaper_wait(self, n_args > 1 ? mp_obj_get_int(args[1]) : EPAPER_BUSY_TIMEOUT_MS);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(epaper_ssd1680_wait_obj, 1, 2, epaper_ssd1680_wait);
+
+static mp_obj_t epaper_ssd1680_sleep(mp_obj_t self_in) {
+    uint8_t data = 0x01;
+    epaper_command(MP_OBJ_TO_PTR(self_in), EPAPER_CMD_DEEP_SLEEP, &data, 1);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(epaper_ssd1680_sleep_obj, epaper_ssd1680_sleep);
+
+// LVGL flush callback: flush_cb(disp, area, px_map).  Writes the area into
+// panel RAM, refreshes the panel after the last area of a frame and then
+// signals LVGL that the flush is done.
+static mp_obj_t epaper_ssd1680_flush_cb(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    epaper_ssd1680_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_obj_t disp = args[1];
+    mp_obj_t area = args[2];
+    mp_obj_t px_map = args[3];
+
+    mp_int_t x1 = mp_obj_get_int(mp_load_attr(area, MP_QSTR_x1));
+    mp_int_t y1 = mp_obj_get_int(mp_load_attr(area, MP_QSTR_y1));
+    mp_int_t x2 = mp_obj_get_int(mp_load_attr(area, MP_QSTR_x2));
+    mp_int_t y2 = mp_obj_get_int(mp_load_attr(area, MP_QSTR_y2));
+
+    // LVGL passes the pixels as a C pointer which must be dereferenced to a
+    // buffer of the right size.
+    mp_buffer_info_t bufinfo;
+    if (!mp_get_buffer(px_map, &bufinfo, MP_BUFFER_READ)) {
+        size_t bpp = self->color_format == EPAPER_L8 ? 1 : 2;
+        mp_int_t len = (x2 - x1 + 1) * (y2 - y1 + 1) * bpp;
+        mp_obj_t dest[3];
+        mp_load_method(px_map, MP_QSTR___dereference__, dest);
+        dest[2] = mp_obj_new_int(MAX(len, 0));
+        px_map = mp_call_method_n_kw(1, 0, dest);
+    }
+    epaper_write_area(self, x1, y1, x2, y2, px_map);
+
+    mp_obj_t dest[2];
+    mp_load_method(disp, MP_QSTR_flush_is_last, dest);
+    if (mp_obj_is_true(mp_call_method_n_kw(0, 0, dest))) {
+        epaper_refresh(self, true);
+    }
+    mp_load_method(disp, MP_QSTR_flush_ready, dest);
+    mp_call_method_n_kw(0, 0, dest);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(epaper_ssd1680_flush_cb_obj, 4, 4, epaper_ssd1680_flush_cb);
+
+static const mp_rom_map_elem_t epaper_ssd1680_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_reset), MP_ROM_PTR(&epaper_ssd1680_reset_obj) },
+    { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&epaper_ssd1680_init_obj) },
+    { MP_ROM_QSTR(MP_QSTR_clear), MP_ROM_PTR(&epaper_ssd1680_clear_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write_area), MP_ROM_PTR(&epaper_ssd1680_write_area_obj) },
+    { MP_ROM_QSTR(MP_QSTR_refresh), MP_ROM_PTR(&epaper_ssd1680_refresh_obj) },
+    { MP_ROM_QSTR(MP_QSTR_busy), MP_ROM_PTR(&epaper_ssd1680_busy_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait), MP_ROM_PTR(&epaper_ssd1680_wait_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sleep), MP_ROM_PTR(&epaper_ssd1680_sleep_obj) },
+    { MP_ROM_QSTR(MP_QSTR_flush_cb), MP_ROM_PTR(&epaper_ssd1680_flush_cb_obj) },
+};
+static MP_DEFINE_CONST_DICT(epaper_ssd1680_locals_dict, epaper_ssd1680_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    epaper_ssd1680_type,
+    MP_QSTR_SSD1680,
+    MP_TYPE_FLAG_NONE,
+    make_new, epaper_ssd1680_make_new,
+    locals_dict, &epaper_ssd1680_locals_dict
+    );
+
+static const mp_rom_map_elem_t epaper_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_epaper) },
+    { MP_ROM_QSTR(MP_QSTR_SSD1680), MP_ROM_PTR(&epaper_ssd1680_type) },
+    { MP_ROM_QSTR(MP_QSTR_RGB565), MP_ROM_INT(EPAPER_RGB565) },
+    { MP_ROM_QSTR(MP_QSTR_L8), MP_ROM_INT(EPAPER_L8) },
+    { MP_ROM_QSTR(MP_QSTR_FULL), MP_ROM_INT(EPAPER_WAVEFORM_FULL) },
+    { MP_ROM_QSTR(MP_QSTR_PARTIAL), MP_ROM_INT(EPAPER_WAVEFORM_PARTIAL) },
+};
+static MP_DEFINE_CONST_DICT(epaper_module_globals, epaper_module_globals_table);
+
+const mp_obj_module_t mp_module_epaper = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&epaper_module_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR_epaper, mp_module_epaper);
+
+#endif // MICROPY_PY_EPAPER
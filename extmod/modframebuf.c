@@ -40,6 +40,11 @@ typedef struct _mp_obj_framebuf_t {
     void *buf;
     uint16_t width, height, stride;
     uint8_t format;
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    // Bounding box of pixels changed since the last clear_dirty(), as
+    // [dirty_x0, dirty_x1) x [dirty_y0, dirty_y1); empty if dirty_x1 <= dirty_x0.
+    uint16_t dirty_x0, dirty_y0, dirty_x1, dirty_y1;
+    #endif
 } mp_obj_framebuf_t;
 
 #if !MICROPY_ENABLE_DYNRUNTIME
@@ -241,13 +246,37 @@ static mp_framebuf_p_t formats[] = {
     [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
 };
 
+#if MICROPY_PY_FRAMEBUF_DIRTY
+static void framebuf_clear_dirty_rect(mp_obj_framebuf_t *fb) {
+    fb->dirty_x0 = fb->width;
+    fb->dirty_y0 = fb->height;
+    fb->dirty_x1 = 0;
+    fb->dirty_y1 = 0;
+}
+
+// Grow the dirty rectangle to include [x0, x1) x [y0, y1), which must already
+// be clipped to the framebuffer.
+static void framebuf_mark_dirty(mp_obj_framebuf_t *fb, int x0, int y0, int x1, int y1) {
+    if (x1 <= x0 || y1 <= y0) {
+        return;
+    }
+    fb->dirty_x0 = MIN(fb->dirty_x0, x0);
+    fb->dirty_y0 = MIN(fb->dirty_y0, y0);
+    fb->dirty_x1 = MAX(fb->dirty_x1, x1);
+    fb->dirty_y1 = MAX(fb->dirty_y1, y1);
+}
+#else
+#define framebuf_mark_dirty(fb, x0, y0, x1, y1)
+#endif
+
 static inline void setpixel(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
     formats[fb->format].setpixel(fb, x, y, col);
 }
 
-static void setpixel_checked(const mp_obj_framebuf_t *fb, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
+static void setpixel_checked(mp_obj_framebuf_t *fb, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
     if (mask && 0 <= x && x < fb->width && 0 <= y && y < fb->height) {
         setpixel(fb, x, y, col);
+        framebuf_mark_dirty(fb, x, y, x + 1, y + 1);
     }
 }
 
@@ -255,7 +284,7 @@ static inline uint32_t getpixel(const mp_obj_framebuf_t *fb, unsigned int x, uns
     return formats[fb->format].getpixel(fb, x, y);
 }
 
-static void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
+static void fill_rect(mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
     if (h < 1 || w < 1 || x + w <= 0 || y + h <= 0 || y >= fb->height || x >= fb->width) {
         // No operation needed.
         return;
@@ -268,6 +297,7 @@ static void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, u
     y = MAX(y, 0);
 
     formats[fb->format].fill_rect(fb, x, y, xend - x, yend - y, col);
+    framebuf_mark_dirty(fb, x, y, xend, yend);
 }
 
 static mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args_in) {
@@ -331,6 +361,9 @@ static mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size
     o->height = height;
     o->format = format;
     o->stride = stride;
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    framebuf_clear_dirty_rect(o);
+    #endif
 
     return MP_OBJ_FROM_PTR(o);
 }
@@ -350,6 +383,7 @@ static mp_obj_t framebuf_fill(mp_obj_t self_in, mp_obj_t col_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t col = mp_obj_get_int(col_in);
     formats[self->format].fill_rect(self, 0, 0, self->width, self->height, col);
+    framebuf_mark_dirty(self, 0, 0, self->width, self->height);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(framebuf_fill_obj, framebuf_fill);
@@ -374,6 +408,7 @@ static mp_obj_t framebuf_pixel(size_t n_args, const mp_obj_t *args_in) {
         } else {
             // set
             setpixel(self, x, y, mp_obj_get_int(args_in[3]));
+            framebuf_mark_dirty(self, x, y, x + 1, y + 1);
         }
     }
     return mp_const_none;
@@ -422,7 +457,11 @@ static mp_obj_t framebuf_rect(size_t n_args, const mp_obj_t *args_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_rect_obj, 6, 7, framebuf_rect);
 
-static void line(const mp_obj_framebuf_t *fb, mp_int_t x1, mp_int_t y1, mp_int_t x2, mp_int_t y2, mp_int_t col) {
+static void line(mp_obj_framebuf_t *fb, mp_int_t x1, mp_int_t y1, mp_int_t x2, mp_int_t y2, mp_int_t col) {
+    // All drawn pixels lie within the bounding box of the end points.
+    framebuf_mark_dirty(fb, MAX(0, MIN(x1, x2)), MAX(0, MIN(y1, y2)),
+        MIN(fb->width, MAX(x1, x2) + 1), MIN(fb->height, MAX(y1, y2) + 1));
+
     mp_int_t dx = x2 - x1;
     mp_int_t sx;
     if (dx > 0) {
@@ -504,7 +543,7 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_line_obj, 6, 6, framebuf_lin
 #define ELLIPSE_MASK_Q3 (0x04)
 #define ELLIPSE_MASK_Q4 (0x08)
 
-static void draw_ellipse_points(const mp_obj_framebuf_t *fb, mp_int_t cx, mp_int_t cy, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
+static void draw_ellipse_points(mp_obj_framebuf_t *fb, mp_int_t cx, mp_int_t cy, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
     if (mask & ELLIPSE_MASK_FILL) {
         if (mask & ELLIPSE_MASK_Q1) {
             fill_rect(fb, cx, cy - y, x + 1, 1, col);
@@ -707,6 +746,156 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_poly_obj, 5, 6, framebuf_pol
 
 #endif // MICROPY_PY_ARRAY
 
+// Transforms for blit.  A transformed source is first transposed (if
+// requested) and then mirrored horizontally and/or vertically, so that a
+// clockwise rotation by 90 degrees is a transpose followed by a horizontal flip.
+#define FRAMEBUF_FLIP_H (0x01)
+#define FRAMEBUF_FLIP_V (0x02)
+#define FRAMEBUF_TRANSPOSE (0x04)
+#define FRAMEBUF_ROTATE_90 (FRAMEBUF_TRANSPOSE | FRAMEBUF_FLIP_H)
+#define FRAMEBUF_ROTATE_180 (FRAMEBUF_FLIP_H | FRAMEBUF_FLIP_V)
+#define FRAMEBUF_ROTATE_270 (FRAMEBUF_TRANSPOSE | FRAMEBUF_FLIP_V)
+
+// Describes how source pixels are walked for a blit: (sx, sy) is the source
+// pixel for the first destination pixel, and the other members are the source
+// steps for a move of one destination pixel right (u) and down (v).
+typedef struct _blit_walk_t {
+    mp_int_t sx, sy;
+    mp_int_t du_x, du_y;
+    mp_int_t dv_x, dv_y;
+} blit_walk_t;
+
+static void blit_walk_init(blit_walk_t *walk, const mp_obj_framebuf_t *source, mp_int_t transform, mp_int_t u0, mp_int_t v0) {
+    bool transpose = transform & FRAMEBUF_TRANSPOSE;
+    mp_int_t w = transpose ? source->height : source->width;
+    mp_int_t h = transpose ? source->width : source->height;
+    mp_int_t u = u0, du = 1, v = v0, dv = 1;
+    if (transform & FRAMEBUF_FLIP_H) {
+        u = w - 1 - u0;
+        du = -1;
+    }
+    if (transform & FRAMEBUF_FLIP_V) {
+        v = h - 1 - v0;
+        dv = -1;
+    }
+    if (transpose) {
+        walk->sx = v;
+        walk->sy = u;
+        walk->du_x = 0;
+        walk->du_y = du;
+        walk->dv_x = dv;
+        walk->dv_y = 0;
+    } else {
+        walk->sx = u;
+        walk->sy = v;
+        walk->du_x = du;
+        walk->du_y = 0;
+        walk->dv_x = 0;
+        walk->dv_y = dv;
+    }
+}
+
+// Same-format RGB565 blit, walking the source with a single pointer step.
+static void blit_rgb565(const mp_obj_framebuf_t *fb, const mp_obj_framebuf_t *source, const blit_walk_t *walk,
+    mp_int_t x0, mp_int_t y0, mp_int_t w, mp_int_t h, mp_int_t key) {
+    mp_int_t step_u = walk->du_x + walk->du_y * source->stride;
+    mp_int_t step_v = walk->dv_x + walk->dv_y * source->stride;
+    mp_int_t dest_step = fb->stride;
+    const uint16_t *src_row = &((const uint16_t *)source->buf)[walk->sx + walk->sy * source->stride];
+    uint16_t *dest_row = &((uint16_t *)fb->buf)[x0 + y0 * fb->stride];
+    bool use_key = key >= 0 && key <= 0xffff;
+    // An untransformed blit of a framebuffer onto itself may overlap.  Like
+    // memmove, work from the end when the destination is after the source so
+    // that each pixel is read before it is overwritten.
+    bool backwards = source == fb && step_u == 1 && step_v == dest_step && dest_row > src_row;
+    if (backwards) {
+        src_row += (h - 1) * step_v;
+        dest_row += (h - 1) * dest_step;
+        step_v = -step_v;
+        dest_step = -dest_step;
+    }
+    for (; h; --h) {
+        if (step_u == 1 && !use_key) {
+            memmove(dest_row, src_row, w * sizeof(uint16_t));
+        } else if (backwards) {
+            for (mp_int_t i = w - 1; i >= 0; --i) {
+                if (src_row[i] != key) {
+                    dest_row[i] = src_row[i];
+                }
+            }
+        } else {
+            const uint16_t *s = src_row;
+            for (mp_int_t i = 0; i < w; ++i, s += step_u) {
+                if (!use_key || *s != key) {
+                    dest_row[i] = *s;
+                }
+            }
+        }
+        src_row += step_v;
+        dest_row += dest_step;
+    }
+}
+
+static inline bool format_is_mono(uint8_t format) {
+    return format == FRAMEBUF_MVLSB || format == FRAMEBUF_MHLSB || format == FRAMEBUF_MHMSB;
+}
+
+static inline unsigned int mono_getbit(const mp_obj_framebuf_t *fb, mp_int_t x, mp_int_t y) {
+    if (fb->format == FRAMEBUF_MVLSB) {
+        return mvlsb_getpixel(fb, x, y);
+    } else {
+        return mono_horiz_getpixel(fb, x, y);
+    }
+}
+
+// Monochrome to monochrome blit.  Each destination byte is assembled from up to
+// 8 source pixels and then stored with a single masked write.
+static void blit_mono(const mp_obj_framebuf_t *fb, const mp_obj_framebuf_t *source, const blit_walk_t *walk,
+    mp_int_t x0, mp_int_t y0, mp_int_t w, mp_int_t h, mp_int_t key) {
+    uint8_t *buf = fb->buf;
+    if (fb->format == FRAMEBUF_MVLSB) {
+        // Bytes run down each column.
+        for (mp_int_t i = 0; i < w; ++i) {
+            mp_int_t sx = walk->sx + i * walk->du_x;
+            mp_int_t sy = walk->sy + i * walk->du_y;
+            for (mp_int_t y = y0; y < y0 + h;) {
+                mp_int_t page_end = MIN((y & ~7) + 8, y0 + h);
+                uint8_t *b = &buf[(y >> 3) * fb->stride + x0 + i];
+                uint8_t mask = 0, bits = 0;
+                for (; y < page_end; ++y, sx += walk->dv_x, sy += walk->dv_y) {
+                    unsigned int col = mono_getbit(source, sx, sy);
+                    if (col != (mp_uint_t)key) {
+                        mask |= 1 << (y & 7);
+                        bits |= col << (y & 7);
+                    }
+                }
+                *b = (*b & ~mask) | bits;
+            }
+        }
+    } else {
+        // Bytes run along each row, MSB or LSB first.
+        bool msb_first = fb->format == FRAMEBUF_MHLSB;
+        for (mp_int_t j = 0; j < h; ++j) {
+            mp_int_t sx = walk->sx + j * walk->dv_x;
+            mp_int_t sy = walk->sy + j * walk->dv_y;
+            for (mp_int_t x = x0; x < x0 + w;) {
+                mp_int_t byte_end = MIN((x & ~7) + 8, x0 + w);
+                uint8_t *b = &buf[(x + (y0 + j) * fb->stride) >> 3];
+                uint8_t mask = 0, bits = 0;
+                for (; x < byte_end; ++x, sx += walk->du_x, sy += walk->du_y) {
+                    unsigned int col = mono_getbit(source, sx, sy);
+                    if (col != (mp_uint_t)key) {
+                        unsigned int offset = msb_first ? 7 - (x & 7) : x & 7;
+                        mask |= 1 << offset;
+                        bits |= col << offset;
+                    }
+                }
+                *b = (*b & ~mask) | bits;
+            }
+        }
+    }
+}
+
 static mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args_in[0]);
     mp_obj_t source_in = mp_obj_cast_to_native_base(args_in[1], MP_OBJ_FROM_PTR(&mp_type_framebuf));
@@ -725,12 +914,27 @@ static mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args_in) {
     if (n_args > 5 && args_in[5] != mp_const_none) {
         palette = MP_OBJ_TO_PTR(mp_obj_cast_to_native_base(args_in[5], MP_OBJ_FROM_PTR(&mp_type_framebuf)));
     }
+    mp_int_t transform = 0;
+    if (n_args > 6) {
+        transform = mp_obj_get_int(args_in[6]);
+        if (transform & ~(FRAMEBUF_FLIP_H | FRAMEBUF_FLIP_V | FRAMEBUF_TRANSPOSE)) {
+            mp_raise_ValueError(NULL);
+        }
+    }
+
+    // Size of the source once transformed.
+    mp_int_t width = source->width;
+    mp_int_t height = source->height;
+    if (transform & FRAMEBUF_TRANSPOSE) {
+        width = source->height;
+        height = source->width;
+    }
 
     if (
         (x >= self->width) ||
         (y >= self->height) ||
-        (-x >= source->width) ||
-        (-y >= source->height)
+        (-x >= width) ||
+        (-y >= height)
         ) {
         // Out of bounds, no-op.
         return mp_const_none;
@@ -741,26 +945,71 @@ static mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args_in) {
     int y0 = MAX(0, y);
     int x1 = MAX(0, -x);
     int y1 = MAX(0, -y);
-    int x0end = MIN(self->width, x + source->width);
-    int y0end = MIN(self->height, y + source->height);
+    int x0end = MIN(self->width, x + width);
+    int y0end = MIN(self->height, y + height);
+
+    blit_walk_t walk;
+    blit_walk_init(&walk, source, transform, x1, y1);
+    framebuf_mark_dirty(self, x0, y0, x0end, y0end);
+
+    if (palette == NULL) {
+        if (source->format == FRAMEBUF_RGB565 && self->format == FRAMEBUF_RGB565) {
+            blit_rgb565(self, source, &walk, x0, y0, x0end - x0, y0end - y0, key);
+            return mp_const_none;
+        }
+        if (format_is_mono(source->format) && format_is_mono(self->format)) {
+            blit_mono(self, source, &walk, x0, y0, x0end - x0, y0end - y0, key);
+            return mp_const_none;
+        }
+    }
+
+    // For sources with few colours look the palette up once, up front.
+    uint32_t lut[16];
+    size_t lut_len = 0;
+    if (palette != NULL) {
+        switch (source->format) {
+            case FRAMEBUF_MVLSB:
+            case FRAMEBUF_MHLSB:
+            case FRAMEBUF_MHMSB:
+                lut_len = 2;
+                break;
+            case FRAMEBUF_GS2_HMSB:
+                lut_len = 4;
+                break;
+            case FRAMEBUF_GS4_HMSB:
+                lut_len = 16;
+                break;
+        }
+        if (lut_len > palette->width) {
+            lut_len = 0;
+        }
+        for (size_t i = 0; i < lut_len; ++i) {
+            lut[i] = getpixel(palette, i, 0);
+        }
+    }
 
     for (; y0 < y0end; ++y0) {
-        int cx1 = x1;
+        mp_int_t sx = walk.sx;
+        mp_int_t sy = walk.sy;
         for (int cx0 = x0; cx0 < x0end; ++cx0) {
-            uint32_t col = getpixel(source, cx1, y1);
-            if (palette) {
+            uint32_t col = getpixel(source, sx, sy);
+            if (lut_len) {
+                col = lut[col];
+            } else if (palette) {
                 col = getpixel(palette, col, 0);
             }
             if (col != (uint32_t)key) {
                 setpixel(self, cx0, y0, col);
             }
-            ++cx1;
+            sx += walk.du_x;
+            sy += walk.du_y;
         }
-        ++y1;
+        walk.sx += walk.dv_x;
+        walk.sy += walk.dv_y;
     }
     return mp_const_none;
 }
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 6, framebuf_blit);
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 7, framebuf_blit);
 
 static mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ystep_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
@@ -797,6 +1046,7 @@ static mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ys
         }
         dy = -1;
     }
+    framebuf_mark_dirty(self, MIN(sx, xend + 1), MIN(y, yend + 1), MAX(sx, xend - 1) + 1, MAX(y, yend - 1) + 1);
     for (; y != yend; y += dy) {
         for (int x = sx; x != xend; x += dx) {
             setpixel(self, x, y, getpixel(self, x - xstep, y - ystep));
@@ -834,6 +1084,7 @@ static mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args_in) {
                     if (vline_data & 1) { // only draw if pixel set
                         if (0 <= y && y < self->height) { // clip y
                             setpixel(self, x0, y, col);
+                            framebuf_mark_dirty(self, x0, y, x0 + 1, y + 1);
                         }
                     }
                 }
@@ -844,6 +1095,29 @@ static mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_text_obj, 4, 5, framebuf_text);
 
+#if MICROPY_PY_FRAMEBUF_DIRTY
+static mp_obj_t framebuf_dirty(mp_obj_t self_in) {
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->dirty_x1 <= self->dirty_x0) {
+        return mp_const_none;
+    }
+    mp_obj_t tuple[4] = {
+        MP_OBJ_NEW_SMALL_INT(self->dirty_x0),
+        MP_OBJ_NEW_SMALL_INT(self->dirty_y0),
+        MP_OBJ_NEW_SMALL_INT(self->dirty_x1 - self->dirty_x0),
+        MP_OBJ_NEW_SMALL_INT(self->dirty_y1 - self->dirty_y0),
+    };
+    return mp_obj_new_tuple(4, tuple);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(framebuf_dirty_obj, framebuf_dirty);
+
+static mp_obj_t framebuf_clear_dirty(mp_obj_t self_in) {
+    framebuf_clear_dirty_rect(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(framebuf_clear_dirty_obj, framebuf_clear_dirty);
+#endif
+
 #if !MICROPY_ENABLE_DYNRUNTIME
 static const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&framebuf_fill_obj) },
@@ -860,6 +1134,10 @@ static const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_blit), MP_ROM_PTR(&framebuf_blit_obj) },
     { MP_ROM_QSTR(MP_QSTR_scroll), MP_ROM_PTR(&framebuf_scroll_obj) },
     { MP_ROM_QSTR(MP_QSTR_text), MP_ROM_PTR(&framebuf_text_obj) },
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    { MP_ROM_QSTR(MP_QSTR_dirty), MP_ROM_PTR(&framebuf_dirty_obj) },
+    { MP_ROM_QSTR(MP_QSTR_clear_dirty), MP_ROM_PTR(&framebuf_clear_dirty_obj) },
+    #endif
 };
 static MP_DEFINE_CONST_DICT(framebuf_locals_dict, framebuf_locals_dict_table);
 
@@ -874,6 +1152,200 @@ static MP_DEFINE_CONST_OBJ_TYPE(
 #endif
 
 #if !MICROPY_ENABLE_DYNRUNTIME
+// Conversion of RGB565 pixel data to tri-colour (white/black/red) planes, as
+// used by e-paper panels that have separate black/white and red/white RAM.
+
+#include "extmod/tricolour.h"
+
+// Source pixels are little-endian RGB565, as produced by LVGL.
+static inline unsigned int tri_pixel(const uint8_t *p) {
+    return p[0] | p[1] << 8;
+}
+
+// Two adjacent source pixels, the one at p in the low half.
+static inline uint32_t tri_pixel_pair(const uint8_t *p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Bit 0 is the black plane (set for white and red) and bit 1 the red plane.
+static inline unsigned int tri_planes(unsigned int cls) {
+    return (cls & TRI_CLASS_RED) * 3 | (~cls & TRI_CLASS_BLACK) >> 1;
+}
+
+static mp_obj_framebuf_t *framebuf_get_native(mp_obj_t obj) {
+    mp_obj_t native = mp_obj_cast_to_native_base(obj, MP_OBJ_FROM_PTR(&mp_type_framebuf));
+    if (native == MP_OBJ_NULL) {
+        mp_raise_TypeError(NULL);
+    }
+    return MP_OBJ_TO_PTR(native);
+}
+
+static mp_obj_t framebuf_convert_rgb565_tri(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_src, ARG_area, ARG_black, ARG_red, ARG_rotate, ARG_thresholds };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_area, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_black, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_red, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_rotate, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_thresholds, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t src;
+    mp_get_buffer_raise(args[ARG_src].u_obj, &src, MP_BUFFER_READ);
+
+    // Area is (x, y, w, h) in unrotated (logical) display coordinates.
+    mp_obj_t *items;
+    mp_obj_get_array_fixed_n(args[ARG_area].u_obj, 4, &items);
+    mp_int_t x = mp_obj_get_int(items[0]);
+    mp_int_t y = mp_obj_get_int(items[1]);
+    mp_int_t w = mp_obj_get_int(items[2]);
+    mp_int_t h = mp_obj_get_int(items[3]);
+    if (w < 1 || h < 1) {
+        return mp_const_none;
+    }
+    if ((size_t)h > src.len / 2 / (size_t)w) {
+        mp_raise_ValueError(NULL);
+    }
+
+    mp_obj_framebuf_t *black = framebuf_get_native(args[ARG_black].u_obj);
+    mp_obj_framebuf_t *red = NULL;
+    if (args[ARG_red].u_obj != mp_const_none) {
+        red = framebuf_get_native(args[ARG_red].u_obj);
+        if (red->width != black->width || red->height != black->height) {
+            mp_raise_ValueError(NULL);
+        }
+    }
+
+    mp_int_t thresholds[TRI_NUM_THRESHOLDS];
+    tri_thresholds_get(args[ARG_thresholds].u_obj, thresholds);
+    tri_tables_t tables;
+    tri_tables_init(&tables, thresholds);
+
+    // Work out the destination rectangle [dx0, dx1) x [dy0, dy1) covered by the
+    // area once rotated, and the source step for each unit move down in y.
+    mp_int_t fw = black->width;
+    mp_int_t fh = black->height;
+    mp_int_t dx0, dy0, step_y;
+    mp_int_t rotate = args[ARG_rotate].u_int;
+    switch (rotate) {
+        case 0:
+            dx0 = x;
+            dy0 = y;
+            step_y = w;
+            break;
+        case 90:
+            dx0 = y;
+            dy0 = fh - x - w;
+            step_y = -1;
+            break;
+        case 180:
+            dx0 = fw - x - w;
+            dy0 = fh - y - h;
+            step_y = -w;
+            break;
+        case 270:
+            dx0 = fw - y - h;
+            dy0 = x;
+            step_y = 1;
+            break;
+        default:
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid rotation"));
+    }
+    mp_int_t dx1 = dx0 + ((rotate == 90 || rotate == 270) ? h : w);
+    mp_int_t dy1 = dy0 + ((rotate == 90 || rotate == 270) ? w : h);
+
+    // Clip to the framebuffer.
+    dx0 = MAX(dx0, 0);
+    dy0 = MAX(dy0, 0);
+    dx1 = MIN(dx1, fw);
+    dy1 = MIN(dy1, fh);
+
+    framebuf_mark_dirty(black, dx0, dy0, dx1, dy1);
+    if (red != NULL) {
+        framebuf_mark_dirty(red, dx0, dy0, dx1, dy1);
+    }
+
+    bool fast = black->format == FRAMEBUF_MVLSB && (red == NULL || red->format == FRAMEBUF_MVLSB);
+    const uint8_t *src_buf = src.buf;
+
+    for (mp_int_t dx = dx0; dx < dx1; ++dx) {
+        // Map the top of this destination column back to a source pixel.
+        mp_int_t lx, ly;
+        switch (rotate) {
+            case 0:
+                lx = dx;
+                ly = dy0;
+                break;
+            case 90:
+                lx = fh - 1 - dy0;
+                ly = dx;
+                break;
+            case 180:
+                lx = fw - 1 - dx;
+                ly = fh - 1 - dy0;
+                break;
+            default: // 270
+                lx = dy0;
+                ly = fw - 1 - dx;
+                break;
+        }
+        const uint8_t *p = src_buf + 2 * ((ly - y) * w + (lx - x));
+
+        if (fast) {
+            // Pack up to 32 vertical pixels of each plane into a word, then
+            // store the word a byte (8 pixels) at a time.  When the column is
+            // contiguous in the source (90 and 270 degree rotation), read two
+            // source pixels per load.
+            for (mp_int_t dy = dy0; dy < dy1;) {
+                mp_int_t base = dy & ~31;
+                mp_int_t end = MIN(base + 32, dy1);
+                uint32_t kbits = 0, rbits = 0;
+                uint32_t mask = (end - base == 32 ? 0 : (uint32_t)1 << (end - base)) - ((uint32_t)1 << (dy - base));
+                if (step_y == 1 || step_y == -1) {
+                    for (; dy + 1 < end; dy += 2, p += 4 * step_y) {
+                        uint32_t pair = tri_pixel_pair(step_y == 1 ? p : p - 2);
+                        unsigned int c0 = step_y == 1 ? pair & 0xffff : pair >> 16;
+                        unsigned int c1 = step_y == 1 ? pair >> 16 : pair & 0xffff;
+                        unsigned int v = tri_planes(tri_classify(&tables, c0)) | tri_planes(tri_classify(&tables, c1)) << 2;
+                        kbits |= (uint32_t)((v & 1) | (v >> 1 & 2)) << (dy - base);
+                        rbits |= (uint32_t)((v >> 1 & 1) | (v >> 2 & 2)) << (dy - base);
+                    }
+                }
+                for (; dy < end; ++dy, p += 2 * step_y) {
+                    unsigned int v = tri_planes(tri_classify(&tables, tri_pixel(p)));
+                    kbits |= (uint32_t)(v & 1) << (dy - base);
+                    rbits |= (uint32_t)(v >> 1) << (dy - base);
+                }
+                for (mp_int_t page = MAX(dy0, base) >> 3; page * 8 < end; ++page) {
+                    unsigned int shift = page * 8 - base;
+                    uint8_t m = mask >> shift;
+                    uint8_t *b = &((uint8_t *)black->buf)[page * black->stride + dx];
+                    *b = (*b & ~m) | (kbits >> shift & m);
+                    if (red != NULL) {
+                        b = &((uint8_t *)red->buf)[page * red->stride + dx];
+                        *b = (*b & ~m) | (rbits >> shift & m);
+                    }
+                }
+            }
+        } else {
+            for (mp_int_t dy = dy0; dy < dy1; ++dy, p += 2 * step_y) {
+                unsigned int cls = tri_classify(&tables, tri_pixel(p));
+                bool is_red = cls & TRI_CLASS_RED;
+                setpixel(black, dx, dy, is_red || !(cls & TRI_CLASS_BLACK));
+                if (red != NULL) {
+                    setpixel(red, dx, dy, is_red);
+                }
+            }
+        }
+    }
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(framebuf_convert_rgb565_tri_obj, 4, framebuf_convert_rgb565_tri);
+
 // This factory function is provided for backwards compatibility with the old
 // FrameBuffer1 class which did not support a format argument.
 static mp_obj_t legacy_framebuffer1(size_t n_args, const mp_obj_t *args_in) {
@@ -886,6 +1358,7 @@ static const mp_rom_map_elem_t framebuf_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_framebuf) },
     { MP_ROM_QSTR(MP_QSTR_FrameBuffer), MP_ROM_PTR(&mp_type_framebuf) },
     { MP_ROM_QSTR(MP_QSTR_FrameBuffer1), MP_ROM_PTR(&legacy_framebuffer1_obj) },
+    { MP_ROM_QSTR(MP_QSTR_convert_rgb565_tri), MP_ROM_PTR(&framebuf_convert_rgb565_tri_obj) },
     { MP_ROM_QSTR(MP_QSTR_MVLSB), MP_ROM_INT(FRAMEBUF_MVLSB) },
     { MP_ROM_QSTR(MP_QSTR_MONO_VLSB), MP_ROM_INT(FRAMEBUF_MVLSB) },
     { MP_ROM_QSTR(MP_QSTR_RGB565), MP_ROM_INT(FRAMEBUF_RGB565) },
@@ -894,6 +1367,12 @@ static const mp_rom_map_elem_t framebuf_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_GS8), MP_ROM_INT(FRAMEBUF_GS8) },
     { MP_ROM_QSTR(MP_QSTR_MONO_HLSB), MP_ROM_INT(FRAMEBUF_MHLSB) },
     { MP_ROM_QSTR(MP_QSTR_MONO_HMSB), MP_ROM_INT(FRAMEBUF_MHMSB) },
+    { MP_ROM_QSTR(MP_QSTR_FLIP_H), MP_ROM_INT(FRAMEBUF_FLIP_H) },
+    { MP_ROM_QSTR(MP_QSTR_FLIP_V), MP_ROM_INT(FRAMEBUF_FLIP_V) },
+    { MP_ROM_QSTR(MP_QSTR_TRANSPOSE), MP_ROM_INT(FRAMEBUF_TRANSPOSE) },
+    { MP_ROM_QSTR(MP_QSTR_ROTATE_90), MP_ROM_INT(FRAMEBUF_ROTATE_90) },
+    { MP_ROM_QSTR(MP_QSTR_ROTATE_180), MP_ROM_INT(FRAMEBUF_ROTATE_180) },
+    { MP_ROM_QSTR(MP_QSTR_ROTATE_270), MP_ROM_INT(FRAMEBUF_ROTATE_270) },
 };
 
 static MP_DEFINE_CONST_DICT(framebuf_module_globals, framebuf_module_globals_table);
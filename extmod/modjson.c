@@ -25,15 +25,174 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
+#include "py/binary.h"
+#include "py/objarray.h"
 #include "py/objlist.h"
-#include "py/objstringio.h"
+#include "py/objstr.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
 #include "py/stream.h"
+#include "py/unicode.h"
 
 #if MICROPY_PY_JSON
 
+// Size of the buffer used to read from and write to streams.
+#define JSON_STREAM_BUF_SIZE (256)
+
+// The encoder below is used by dump and dumps.  It writes the common types
+// (None, bool, small int, float, str, list, tuple and dict) itself, and uses
+// the PRINT_JSON print method of everything else.  dump writes to the stream in
+// chunks of JSON_STREAM_BUF_SIZE bytes, so neither the document nor lots of
+// small writes are needed for large objects.
+
+typedef struct _json_encoder_t {
+    // print methods write into the encoder via this, and get the separators from it
+    mp_print_ext_t print;
+    mp_obj_t stream_obj;
+    vstr_t *vstr; // if non-NULL then output goes here instead of to stream_obj
+    size_t len;
+    byte buf[JSON_STREAM_BUF_SIZE];
+} json_encoder_t;
+
+static void json_encoder_flush(json_encoder_t *enc) {
+    if (enc->len > 0) {
+        mp_stream_write(enc->stream_obj, enc->buf, enc->len, MP_STREAM_RW_WRITE);
+        enc->len = 0;
+    }
+}
+
+static void json_encoder_write(void *data, const char *str, size_t len) {
+    json_encoder_t *enc = data;
+    if (enc->vstr != NULL) {
+        vstr_t *vstr = enc->vstr;
+        if (vstr->alloc - vstr->len < len) {
+            // grow geometrically, the final size isn't known
+            vstr_hint_size(vstr, MAX(len, vstr->len));
+        }
+        vstr_add_strn(vstr, str, len);
+        return;
+    }
+    while (len > 0) {
+        size_t n = MIN(len, sizeof(enc->buf) - enc->len);
+        memcpy(enc->buf + enc->len, str, n);
+        enc->len += n;
+        str += n;
+        len -= n;
+        if (enc->len == sizeof(enc->buf)) {
+            json_encoder_flush(enc);
+        }
+    }
+}
+
+static void json_encoder_write_str(json_encoder_t *enc, const char *str) {
+    json_encoder_write(enc, str, strlen(str));
+}
+
+static void json_encode(json_encoder_t *enc, mp_obj_t obj) {
+    mp_cstack_check();
+    if (mp_obj_is_small_int(obj)) {
+        char buf[sizeof(mp_int_t) * 3 + 2];
+        char *p = buf + sizeof(buf);
+        mp_int_t val = MP_OBJ_SMALL_INT_VALUE(obj);
+        mp_uint_t u = val < 0 ? -(mp_uint_t)val : (mp_uint_t)val;
+        do {
+            *--p = '0' + u % 10;
+            u /= 10;
+        } while (u != 0);
+        if (val < 0) {
+            *--p = '-';
+        }
+        json_encoder_write(enc, p, buf + sizeof(buf) - p);
+    } else if (mp_obj_is_str_or_bytes(obj)) {
+        GET_STR_DATA_LEN(obj, str_data, str_len);
+        mp_str_print_json(&enc->print.base, str_data, str_len);
+    } else if (obj == mp_const_none) {
+        json_encoder_write(enc, "null", 4);
+    } else if (obj == mp_const_true) {
+        json_encoder_write(enc, "true", 4);
+    } else if (obj == mp_const_false) {
+        json_encoder_write(enc, "false", 5);
+    #if MICROPY_PY_BUILTINS_FLOAT
+    } else if (mp_obj_is_float(obj)) {
+        MP_OBJ_TYPE_GET_SLOT(&mp_type_float, print)(&enc->print.base, obj, PRINT_JSON);
+    #endif
+    } else if (mp_obj_is_type(obj, &mp_type_list) || mp_obj_is_type(obj, &mp_type_tuple)) {
+        json_encoder_write(enc, "[", 1);
+        for (size_t i = 0;; i++) {
+            // Python code can run while an item is encoded (a __repr__, or a
+            // write to the stream) and resize the list, so re-read its items.
+            size_t len;
+            mp_obj_t *items;
+            mp_obj_get_array(obj, &len, &items);
+            if (i >= len) {
+                break;
+            }
+            if (i > 0) {
+                json_encoder_write_str(enc, enc->print.item_separator);
+            }
+            json_encode(enc, items[i]);
+        }
+        json_encoder_write(enc, "]", 1);
+    } else if (mp_obj_is_dict_or_ordereddict(obj)) {
+        mp_map_t *map = mp_obj_dict_get_map(obj);
+        bool first = true;
+        json_encoder_write(enc, "{", 1);
+        for (size_t i = 0; i < map->alloc; i++) {
+            if (!mp_map_slot_is_filled(map, i)) {
+                continue;
+            }
+            // As with lists, Python code can run while the entry is encoded and
+            // change the dict, so read the key and value before encoding either.
+            mp_obj_t key = map->table[i].key;
+            mp_obj_t value = map->table[i].value;
+            if (!first) {
+                json_encoder_write_str(enc, enc->print.item_separator);
+            }
+            first = false;
+            if (mp_obj_is_str_or_bytes(key)) {
+                json_encode(enc, key);
+            } else {
+                json_encoder_write(enc, "\"", 1);
+                json_encode(enc, key);
+                json_encoder_write(enc, "\"", 1);
+            }
+            json_encoder_write_str(enc, enc->print.key_separator);
+            json_encode(enc, value);
+        }
+        json_encoder_write(enc, "}", 1);
+    } else {
+        mp_obj_print_helper(&enc->print.base, obj, PRINT_JSON);
+    }
+}
+
+// Encode obj to the given stream, or to a new str if stream_obj is MP_OBJ_NULL.
+static mp_obj_t json_dump(mp_obj_t obj, mp_obj_t stream_obj, const char *item_separator, const char *key_separator) {
+    json_encoder_t enc;
+    enc.print.base.data = &enc;
+    enc.print.base.print_strn = json_encoder_write;
+    enc.print.item_separator = item_separator;
+    enc.print.key_separator = key_separator;
+    enc.stream_obj = stream_obj;
+    enc.len = 0;
+    if (stream_obj == MP_OBJ_NULL) {
+        // dumps(obj)
+        vstr_t vstr;
+        vstr_init(&vstr, 8);
+        enc.vstr = &vstr;
+        json_encode(&enc, obj);
+        return mp_obj_new_str_from_utf8_vstr(&vstr);
+    } else {
+        // dump(obj, stream)
+        mp_get_stream_raise(stream_obj, MP_STREAM_OP_WRITE);
+        enc.vstr = NULL;
+        json_encode(&enc, obj);
+        json_encoder_flush(&enc);
+        return mp_const_none;
+    }
+}
+
 #if MICROPY_PY_JSON_SEPARATORS
 
 enum {
@@ -50,32 +209,17 @@ static mp_obj_t mod_json_dump_helper(size_t n_args, const mp_obj_t *pos_args, mp
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all(n_args - mode, pos_args + mode, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
-    mp_print_ext_t print_ext;
-
-    if (args[ARG_separators].u_obj == mp_const_none) {
-        print_ext.item_separator = ", ";
-        print_ext.key_separator = ": ";
-    } else {
+    const char *item_separator = ", ";
+    const char *key_separator = ": ";
+    if (args[ARG_separators].u_obj != mp_const_none) {
         mp_obj_t *items;
         mp_obj_get_array_fixed_n(args[ARG_separators].u_obj, 2, &items);
-        print_ext.item_separator = mp_obj_str_get_str(items[0]);
-        print_ext.key_separator = mp_obj_str_get_str(items[1]);
+        item_separator = mp_obj_str_get_str(items[0]);
+        key_separator = mp_obj_str_get_str(items[1]);
     }
 
-    if (mode == DUMP_MODE_TO_STRING) {
-        // dumps(obj)
-        vstr_t vstr;
-        vstr_init_print(&vstr, 8, &print_ext.base);
-        mp_obj_print_helper(&print_ext.base, pos_args[0], PRINT_JSON);
-        return mp_obj_new_str_from_utf8_vstr(&vstr);
-    } else {
-        // dump(obj, stream)
-        print_ext.base.data = MP_OBJ_TO_PTR(pos_args[1]);
-        print_ext.base.print_strn = mp_stream_write_adaptor;
-        mp_get_stream_raise(pos_args[1], MP_STREAM_OP_WRITE);
-        mp_obj_print_helper(&print_ext.base, pos_args[0], PRINT_JSON);
-        return mp_const_none;
-    }
+    mp_obj_t stream_obj = mode == DUMP_MODE_TO_STRING ? MP_OBJ_NULL : pos_args[1];
+    return json_dump(pos_args[0], stream_obj, item_separator, key_separator);
 }
 
 static mp_obj_t mod_json_dump(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
@@ -91,19 +235,12 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(mod_json_dumps_obj, 1, mod_json_dumps);
 #else
 
 static mp_obj_t mod_json_dump(mp_obj_t obj, mp_obj_t stream) {
-    mp_get_stream_raise(stream, MP_STREAM_OP_WRITE);
-    mp_print_t print = {MP_OBJ_TO_PTR(stream), mp_stream_write_adaptor};
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
-    return mp_const_none;
+    return json_dump(obj, stream, ", ", ": ");
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(mod_json_dump_obj, mod_json_dump);
 
 static mp_obj_t mod_json_dumps(mp_obj_t obj) {
-    vstr_t vstr;
-    mp_print_t print;
-    vstr_init_print(&vstr, 8, &print);
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
-    return mp_obj_new_str_from_utf8_vstr(&vstr);
+    return json_dump(obj, MP_OBJ_NULL, ", ", ": ");
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(mod_json_dumps_obj, mod_json_dumps);
 
@@ -121,12 +258,21 @@ static MP_DEFINE_CONST_FUN_OBJ_1(mod_json_dumps_obj, mod_json_dumps);
 // Most of the work is parsing the primitives (null, false, true, numbers,
 // strings).  It does 1 pass over the input stream.  It tries to be fast and
 // small in code size, while not using more RAM than necessary.
+//
+// Input that is already in memory (str, bytes or any other object with the
+// buffer protocol) is parsed in place, so that strings without escapes and
+// numbers are created directly from the input.  Streams are read in chunks of
+// JSON_STREAM_BUF_SIZE bytes, and tokens that lie within one chunk are handled
+// the same way.
 
 typedef struct _json_stream_t {
     mp_obj_t stream_obj;
+    // read is NULL when the whole input is in memory
     mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
-    int errcode;
+    const byte *pos; // next byte of input
+    const byte *end; // end of the input that is in memory
     byte cur;
+    byte buf[JSON_STREAM_BUF_SIZE];
 } json_stream_t;
 
 #define S_EOF (0) // null is not allowed in json stream so is ok as EOF marker
@@ -134,20 +280,110 @@ typedef struct _json_stream_t {
 #define S_CUR(s) ((s).cur)
 #define S_NEXT(s) (json_stream_next(&(s)))
 
-static byte json_stream_next(json_stream_t *s) {
-    mp_uint_t ret = s->read(s->stream_obj, &s->cur, 1, &s->errcode);
-    if (s->errcode != 0) {
-        mp_raise_OSError(s->errcode);
+static byte json_stream_fill(json_stream_t *s) {
+    mp_uint_t ret = 0;
+    if (s->read != NULL) {
+        int errcode = 0;
+        ret = s->read(s->stream_obj, s->buf, sizeof(s->buf), &errcode);
+        if (errcode != 0) {
+            mp_raise_OSError(errcode);
+        }
+        s->pos = s->buf;
+        s->end = s->buf + ret;
     }
     if (ret == 0) {
         s->cur = S_EOF;
+    } else {
+        s->cur = *s->pos++;
     }
     return s->cur;
 }
 
-static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
-    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
-    json_stream_t s = {stream_obj, stream_p->read, 0, 0};
+// After this returns, and unless at EOF, the current byte is at s->pos[-1].
+static inline byte json_stream_next(json_stream_t *s) {
+    if (s->pos < s->end) {
+        s->cur = *s->pos++;
+        return s->cur;
+    }
+    return json_stream_fill(s);
+}
+
+static inline bool json_is_num_char(byte c, bool *flt) {
+    if (c == '.' || c == 'E' || c == 'e') {
+        *flt = true;
+        return true;
+    }
+    return c == '+' || c == '-' || unichar_isdigit(c);
+}
+
+static mp_obj_t json_new_str(const char *data, size_t len, bool is_key) {
+    #if MICROPY_PY_JSON_INTERN_KEYS
+    if (is_key && len <= MICROPY_PY_JSON_INTERN_KEYS) {
+        #if MICROPY_PY_BUILTINS_STR_UNICODE && MICROPY_PY_BUILTINS_STR_UNICODE_CHECK
+        if (!utf8_check((const byte *)data, len)) {
+            mp_raise_msg(&mp_type_UnicodeError, NULL);
+        }
+        #endif
+        return mp_obj_new_str_via_qstr(data, len);
+    }
+    #else
+    (void)is_key;
+    #endif
+    return mp_obj_new_str(data, len);
+}
+
+#if MICROPY_PY_JSON_LOAD_INTO
+// Append a number to an array being filled by load_into.  Floats going into a
+// float array are converted without creating a float object.
+static void json_array_append_num(mp_obj_t arr_in, const char *str, size_t len, bool flt) {
+    mp_obj_array_t *arr = MP_OBJ_TO_PTR(arr_in);
+    if (arr->free == 0) {
+        size_t item_sz = mp_binary_get_size('@', arr->typecode, NULL);
+        size_t add_cnt = 8 + arr->len / 2;
+        arr->items = m_renew(byte, arr->items, item_sz * arr->len, item_sz * (arr->len + add_cnt));
+        arr->free = add_cnt;
+    }
+    #if MICROPY_PY_BUILTINS_FLOAT
+    mp_float_t val;
+    if (flt && (arr->typecode == 'f' || arr->typecode == 'd')) {
+        if (!mp_parse_num_float_value(str, len, &val)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("syntax error in JSON"));
+        }
+        if (arr->typecode == 'f') {
+            ((float *)arr->items)[arr->len] = (float)val;
+        } else {
+            ((double *)arr->items)[arr->len] = (double)val;
+        }
+    } else
+    #endif
+    {
+        mp_obj_t val_obj;
+        if (flt) {
+            val_obj = mp_parse_num_float(str, len, false, NULL);
+        } else {
+            val_obj = mp_parse_num_integer(str, len, 10, NULL);
+        }
+        mp_binary_set_val_array(arr->typecode, arr->items, arr->len, val_obj);
+    }
+    arr->len++;
+    arr->free--;
+}
+#endif
+
+// Parse from stream_obj, or from the len bytes at buf if stream_obj is
+// MP_OBJ_NULL.  If into is given then the input must be an object, which is
+// stored into that dict (see load_into).
+static mp_obj_t json_parse(mp_obj_t stream_obj, const byte *buf, size_t len, mp_obj_t into) {
+    json_stream_t s;
+    s.stream_obj = stream_obj;
+    if (stream_obj == MP_OBJ_NULL) {
+        s.read = NULL;
+        s.pos = buf;
+        s.end = buf + len;
+    } else {
+        s.read = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ)->read;
+        s.pos = s.end = s.buf;
+    }
     vstr_t vstr;
     vstr_init(&vstr, 8);
     mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
@@ -156,6 +392,9 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
     mp_obj_t stack_top = MP_OBJ_NULL;
     const mp_obj_type_t *stack_top_type = NULL;
     mp_obj_t stack_key = MP_OBJ_NULL;
+    #if !MICROPY_PY_JSON_LOAD_INTO
+    (void)into;
+    #endif
     S_NEXT(s);
     for (;;) {
     cont:
@@ -164,8 +403,13 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
         }
         mp_obj_t next = MP_OBJ_NULL;
         bool enter = false;
+        const byte *tok = s.pos - 1;
         byte cur = S_CUR(s);
         S_NEXT(s);
+        if (s.read != NULL && s.pos != tok + 2) {
+            // reading the next byte refilled the buffer, so cur is gone
+            tok = NULL;
+        }
         switch (cur) {
             case ',':
             case ':':
@@ -198,8 +442,28 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
                     goto fail;
                 }
                 break;
-            case '"':
+            case '"': {
+                bool is_key = stack_key == MP_OBJ_NULL && stack_top != MP_OBJ_NULL && stack_top_type != &mp_type_list;
                 vstr_reset(&vstr);
+                if (!S_END(s)) {
+                    // fast path: look for the closing quote in memory
+                    const byte *start = s.pos - 1;
+                    const byte *p = start;
+                    while (p < s.end && *p != '"' && *p != '\\' && *p != S_EOF) {
+                        ++p;
+                    }
+                    if (p < s.end && *p == '"') {
+                        // create the string before the buffer may be refilled
+                        next = json_new_str((const char *)start, p - start, is_key);
+                        s.pos = p + 1;
+                        S_NEXT(s);
+                        break;
+                    }
+                    // hit an escape or the end of the buffer, continue below
+                    vstr_add_strn(&vstr, (const char *)start, p - start);
+                    s.pos = p;
+                    S_NEXT(s);
+                }
                 for (; !S_END(s) && S_CUR(s) != '"';) {
                     byte c = S_CUR(s);
                     if (c == '\\') {
@@ -242,8 +506,9 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
                     goto fail;
                 }
                 S_NEXT(s);
-                next = mp_obj_new_str(vstr.buf, vstr.len);
+                next = json_new_str(vstr.buf, vstr.len, is_key);
                 break;
+            }
             case '-':
             case '0':
             case '1':
@@ -256,31 +521,85 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
             case '8':
             case '9': {
                 bool flt = false;
-                vstr_reset(&vstr);
-                for (;;) {
-                    vstr_add_byte(&vstr, cur);
-                    cur = S_CUR(s);
-                    if (cur == '.' || cur == 'E' || cur == 'e') {
-                        flt = true;
-                    } else if (cur == '+' || cur == '-' || unichar_isdigit(cur)) {
-                        // pass
-                    } else {
-                        break;
+                const char *num;
+                size_t num_len;
+                const byte *p = tok;
+                if (tok != NULL) {
+                    for (p = tok + 1; p < s.end && json_is_num_char(*p, &flt); ++p) {
                     }
+                }
+                if (tok != NULL && (p < s.end || s.read == NULL)) {
+                    // fast path: the whole number is in memory
+                    num = (const char *)tok;
+                    num_len = p - tok;
+                    s.pos = p;
                     S_NEXT(s);
+                } else {
+                    vstr_reset(&vstr);
+                    if (tok != NULL) {
+                        // number continues in the next chunk of the stream
+                        vstr_add_strn(&vstr, (const char *)tok, p - tok);
+                        s.pos = p;
+                        S_NEXT(s);
+                    } else {
+                        vstr_add_byte(&vstr, cur);
+                    }
+                    while (json_is_num_char(S_CUR(s), &flt)) {
+                        vstr_add_byte(&vstr, S_CUR(s));
+                        S_NEXT(s);
+                    }
+                    num = vstr.buf;
+                    num_len = vstr.len;
+                }
+                #if MICROPY_PY_JSON_LOAD_INTO
+                if (stack_top_type == &mp_type_array) {
+                    json_array_append_num(stack_top, num, num_len, flt);
+                    goto cont;
                 }
+                #endif
                 if (flt) {
-                    next = mp_parse_num_float(vstr.buf, vstr.len, false, NULL);
+                    next = mp_parse_num_float(num, num_len, false, NULL);
                 } else {
-                    next = mp_parse_num_integer(vstr.buf, vstr.len, 10, NULL);
+                    next = mp_parse_num_integer(num, num_len, 10, NULL);
                 }
                 break;
             }
             case '[':
+                #if MICROPY_PY_JSON_LOAD_INTO
+                if (into != MP_OBJ_NULL && stack_key != MP_OBJ_NULL) {
+                    // fill an existing array in place
+                    mp_map_elem_t *elem = mp_map_lookup(mp_obj_dict_get_map(stack_top), stack_key, MP_MAP_LOOKUP);
+                    if (elem != NULL && mp_obj_is_type(elem->value, &mp_type_array)) {
+                        mp_obj_array_t *arr = MP_OBJ_TO_PTR(elem->value);
+                        arr->free += arr->len;
+                        arr->len = 0;
+                        next = elem->value;
+                        enter = true;
+                        break;
+                    }
+                }
+                #endif
                 next = mp_obj_new_list(0, NULL);
                 enter = true;
                 break;
             case '{':
+                #if MICROPY_PY_JSON_LOAD_INTO
+                if (into != MP_OBJ_NULL) {
+                    if (stack_top == MP_OBJ_NULL) {
+                        next = into;
+                        enter = true;
+                        break;
+                    } else if (stack_key != MP_OBJ_NULL) {
+                        // merge into an existing dict
+                        mp_map_elem_t *elem = mp_map_lookup(mp_obj_dict_get_map(stack_top), stack_key, MP_MAP_LOOKUP);
+                        if (elem != NULL && mp_obj_is_dict_or_ordereddict(elem->value)) {
+                            next = elem->value;
+                            enter = true;
+                            break;
+                        }
+                    }
+                }
+                #endif
                 next = mp_obj_new_dict(0);
                 enter = true;
                 break;
@@ -303,6 +622,12 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
                 goto fail;
         }
         if (stack_top == MP_OBJ_NULL) {
+            #if MICROPY_PY_JSON_LOAD_INTO
+            if (into != MP_OBJ_NULL && next != into) {
+                // load_into needs an object at the top level
+                goto fail;
+            }
+            #endif
             stack_top = next;
             stack_top_type = mp_obj_get_type(stack_top);
             if (!enter) {
@@ -313,6 +638,11 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
             // append to list or dict
             if (stack_top_type == &mp_type_list) {
                 mp_obj_list_append(stack_top, next);
+            #if MICROPY_PY_JSON_LOAD_INTO
+            } else if (stack_top_type == &mp_type_array) {
+                // arrays can only hold numbers
+                goto fail;
+            #endif
             } else {
                 if (stack_key == MP_OBJ_NULL) {
                     stack_key = next;
@@ -355,23 +685,44 @@ success:
 fail:
     mp_raise_ValueError(MP_ERROR_TEXT("syntax error in JSON"));
 }
+
+static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
+    return json_parse(stream_obj, NULL, 0, MP_OBJ_NULL);
+}
 static MP_DEFINE_CONST_FUN_OBJ_1(mod_json_load_obj, mod_json_load);
 
 static mp_obj_t mod_json_loads(mp_obj_t obj) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(obj, &bufinfo, MP_BUFFER_READ);
-    vstr_t vstr = {bufinfo.len, bufinfo.len, (char *)bufinfo.buf, true};
-    mp_obj_stringio_t sio = {{&mp_type_stringio}, &vstr, 0, MP_OBJ_NULL};
-    return mod_json_load(MP_OBJ_FROM_PTR(&sio));
+    return json_parse(MP_OBJ_NULL, bufinfo.buf, bufinfo.len, MP_OBJ_NULL);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(mod_json_loads_obj, mod_json_loads);
 
+#if MICROPY_PY_JSON_LOAD_INTO
+static mp_obj_t mod_json_load_into(mp_obj_t src, mp_obj_t target) {
+    if (!mp_obj_is_dict_or_ordereddict(target)) {
+        mp_raise_TypeError(NULL);
+    }
+    mp_buffer_info_t bufinfo;
+    if (mp_get_buffer(src, &bufinfo, MP_BUFFER_READ)) {
+        json_parse(MP_OBJ_NULL, bufinfo.buf, bufinfo.len, target);
+    } else {
+        json_parse(src, NULL, 0, target);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(mod_json_load_into_obj, mod_json_load_into);
+#endif
+
 static const mp_rom_map_elem_t mp_module_json_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_json) },
     { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&mod_json_dump_obj) },
     { MP_ROM_QSTR(MP_QSTR_dumps), MP_ROM_PTR(&mod_json_dumps_obj) },
     { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&mod_json_load_obj) },
     { MP_ROM_QSTR(MP_QSTR_loads), MP_ROM_PTR(&mod_json_loads_obj) },
+    #if MICROPY_PY_JSON_LOAD_INTO
+    { MP_ROM_QSTR(MP_QSTR_load_into), MP_ROM_PTR(&mod_json_load_into_obj) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_json_globals, mp_module_json_globals_table);
@@ -40,13 +40,19 @@
 #if MICROPY_PY_RE
 
 #define re1_5_stack_chk() mp_cstack_check()
+#define re1_5_alloc(n) m_new(char, n)
+#define re1_5_free(p, n) m_del(char, p, n)
 
 #include "lib/re1.5/re1.5.h"
 
 #define FLAG_DEBUG 0x1000
+#define FLAG_PIKEVM 0x2000
 
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if MICROPY_PY_RE_PIKEVM
+    bool pikevm;
+    #endif
     ByteProg re;
 } mp_obj_re_t;
 
@@ -194,6 +200,28 @@ static void re_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t
     mp_printf(print, "<re %p>", self);
 }
 
+// Run the compiled pattern on subj with the engine it was compiled for.
+static int re_exec_prog(mp_obj_re_t *self, Subject *subj, const char **caps, int caps_num, bool is_anchored) {
+    #if MICROPY_PY_RE_PIKEVM
+    if (self->pikevm) {
+        return re1_5_pikevm(&self->re, subj, caps, caps_num, is_anchored);
+    }
+    #endif
+    int c = is_anchored ? -1 : re1_5_firstchar(&self->re);
+    if (c < 0) {
+        return re1_5_recursiveloopprog(&self->re, subj, caps, caps_num, is_anchored);
+    }
+    // The match must start with c, so only try an anchored match where c occurs.
+    Subject s = *subj;
+    while ((s.begin = memchr(s.begin, c, s.end - s.begin)) != NULL) {
+        if (re1_5_recursiveloopprog(&self->re, &s, caps, caps_num, true)) {
+            return 1;
+        }
+        s.begin++;
+    }
+    return 0;
+}
+
 // Note: this function can't be named re_exec because it may clash with system headers, eg on FreeBSD
 static mp_obj_t re_exec_helper(bool is_anchored, uint n_args, const mp_obj_t *args) {
     (void)n_args;
@@ -211,7 +239,7 @@ static mp_obj_t re_exec_helper(bool is_anchored, uint n_args, const mp_obj_t *ar
     mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, caps, char *, caps_num);
     // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
     memset((char *)match->caps, 0, caps_num * sizeof(char *));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
+    int res = re_exec_prog(self, &subj, match->caps, caps_num, is_anchored);
     if (res == 0) {
         m_del_var(mp_obj_match_t, caps, char *, caps_num, match);
         return mp_const_none;
@@ -252,7 +280,7 @@ static mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     while (true) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char **)caps, 0, caps_num * sizeof(char *));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = re_exec_prog(self, &subj, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
@@ -312,7 +340,7 @@ static mp_obj_t re_sub_helper(size_t n_args, const mp_obj_t *args) {
     for (;;) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char *)match->caps, 0, caps_num * sizeof(char *));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, false);
+        int res = re_exec_prog(self, &subj, match->caps, caps_num, false);
 
         // If we didn't have a match, or had an empty match, it's time to stop
         if (!res || match->caps[0] == match->caps[1]) {
@@ -430,12 +458,15 @@ static mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args) {
         goto error;
     }
     mp_obj_re_t *o = mp_obj_malloc_var(mp_obj_re_t, re.insts, char, size, (mp_obj_type_t *)&re_type);
-    #if MICROPY_PY_RE_DEBUG
+    #if MICROPY_PY_RE_DEBUG || MICROPY_PY_RE_PIKEVM
     int flags = 0;
     if (n_args > 1) {
         flags = mp_obj_get_int(args[1]);
     }
     #endif
+    #if MICROPY_PY_RE_PIKEVM
+    o->pikevm = (flags & FLAG_PIKEVM) != 0;
+    #endif
     int error = re1_5_compilecode(&o->re, re_str);
     if (error != 0) {
     error:
@@ -462,6 +493,9 @@ static const mp_rom_map_elem_t mp_module_re_globals_table[] = {
     #if MICROPY_PY_RE_DEBUG
     { MP_ROM_QSTR(MP_QSTR_DEBUG), MP_ROM_INT(FLAG_DEBUG) },
     #endif
+    #if MICROPY_PY_RE_PIKEVM
+    { MP_ROM_QSTR(MP_QSTR_PIKEVM), MP_ROM_INT(FLAG_PIKEVM) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_re_globals, mp_module_re_globals_table);
@@ -481,6 +515,9 @@ MP_REGISTER_EXTENSIBLE_MODULE(MP_QSTR_re, mp_module_re);
 
 #include "lib/re1.5/compilecode.c"
 #include "lib/re1.5/recursiveloop.c"
+#if MICROPY_PY_RE_PIKEVM
+#include "lib/re1.5/pikevm.c"
+#endif
 #include "lib/re1.5/charclass.c"
 
 #if MICROPY_PY_RE_DEBUG
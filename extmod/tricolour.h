@@ -0,0 +1,109 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Beaver contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MICROPY_INCLUDED_EXTMOD_TRICOLOUR_H
+#define MICROPY_INCLUDED_EXTMOD_TRICOLOUR_H
+
+#include "py/runtime.h"
+
+// Classification of RGB565 pixels as white, black or red, for tri-colour
+// e-paper panels.  Shared by framebuf.convert_rgb565_tri and the epaper module.
+
+#define TRI_CLASS_RED (0x01)
+#define TRI_CLASS_BLACK (0x02)
+
+// Indices of the classification thresholds, which are colour component levels
+// on a 0-255 scale.  A pixel is red if its red component is at least
+// TRI_RED_MIN and its green and blue components are below TRI_RED_G_MAX and
+// TRI_RED_B_MAX.  Otherwise it is black if each of its components is below the
+// matching TRI_BLACK_*_MAX.  A limit of 256 means the component isn't checked.
+enum {
+    TRI_RED_MIN,
+    TRI_RED_G_MAX,
+    TRI_RED_B_MAX,
+    TRI_BLACK_R_MAX,
+    TRI_BLACK_G_MAX,
+    TRI_BLACK_B_MAX,
+    TRI_NUM_THRESHOLDS,
+};
+
+typedef struct _tri_tables_t {
+    uint8_t r[32];
+    uint8_t g[64];
+    uint8_t b[32];
+} tri_tables_t;
+
+// Get the thresholds from either None, for the defaults, or a sequence of
+// TRI_NUM_THRESHOLDS levels, or a sequence (red_min, red_gb_max, black_max)
+// that uses the same limits for each component.  The defaults classify pixels
+// the same way as the rgb565_to_eink function that beaver_scripts/main.py
+// used before conversion was done in C: red if red is at least 160 and green
+// below 160, otherwise black if red is below 100.
+static inline void tri_thresholds_get(mp_obj_t thresholds_in, mp_int_t *thresholds) {
+    static const int16_t defaults[TRI_NUM_THRESHOLDS] = {160, 160, 256, 100, 256, 256};
+    if (thresholds_in == mp_const_none) {
+        for (size_t i = 0; i < TRI_NUM_THRESHOLDS; ++i) {
+            thresholds[i] = defaults[i];
+        }
+        return;
+    }
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(thresholds_in, &len, &items);
+    if (len == TRI_NUM_THRESHOLDS) {
+        for (size_t i = 0; i < TRI_NUM_THRESHOLDS; ++i) {
+            thresholds[i] = mp_obj_get_int(items[i]);
+        }
+    } else if (len == 3) {
+        thresholds[TRI_RED_MIN] = mp_obj_get_int(items[0]);
+        thresholds[TRI_RED_G_MAX] = thresholds[TRI_RED_B_MAX] = mp_obj_get_int(items[1]);
+        thresholds[TRI_BLACK_R_MAX] = thresholds[TRI_BLACK_G_MAX] = thresholds[TRI_BLACK_B_MAX] = mp_obj_get_int(items[2]);
+    } else {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid thresholds"));
+    }
+}
+
+// Each table entry says which of the red and black conditions the given colour
+// component satisfies, so classifying a pixel is just three lookups ANDed
+// together.  Components are compared on a 0-255 scale.
+static inline void tri_tables_init(tri_tables_t *t, const mp_int_t *thresholds) {
+    for (unsigned int i = 0; i < 64; ++i) {
+        if (i < 32) {
+            mp_int_t rb = i << 3;
+            t->r[i] = (rb >= thresholds[TRI_RED_MIN] ? TRI_CLASS_RED : 0) | (rb < thresholds[TRI_BLACK_R_MAX] ? TRI_CLASS_BLACK : 0);
+            t->b[i] = (rb < thresholds[TRI_RED_B_MAX] ? TRI_CLASS_RED : 0) | (rb < thresholds[TRI_BLACK_B_MAX] ? TRI_CLASS_BLACK : 0);
+        }
+        mp_int_t g = i << 2;
+        t->g[i] = (g < thresholds[TRI_RED_G_MAX] ? TRI_CLASS_RED : 0) | (g < thresholds[TRI_BLACK_G_MAX] ? TRI_CLASS_BLACK : 0);
+    }
+}
+
+// Classify an RGB565 colour c, returning a combination of TRI_CLASS_* bits.
+static inline unsigned int tri_classify(const tri_tables_t *t, unsigned int c) {
+    return t->r[c >> 11] & t->g[(c >> 5) & 0x3f] & t->b[c & 0x1f];
+}
+
+#endif // MICROPY_INCLUDED_EXTMOD_TRICOLOUR_H
@@ -124,7 +124,146 @@ static mp_obj_t mp_vfs_proxy_call(mp_vfs_mount_t *vfs, qstr meth_name, size_t n_
     return mp_call_method_n_kw(n_args, 0, meth);
 }
 
+#if MICROPY_VFS_IMPORT_CACHE
+
+// Import looks for a module by doing a stat of each candidate file, which can
+// be slow on flash filesystems.  With this cache, the first time a directory
+// is searched it is listed instead, and the listing is kept in the dict
+// sys.path_importer_cache.  That maps the directory path (as used by import)
+// to a dict of the names in it, each mapped to an mp_import_stat_t, or 0 if
+// the type of the entry is not known.  A directory that doesn't exist (ENOENT
+// or ENOTDIR) maps to None, and one on a filesystem without ilistdir to False;
+// other errors from listing are not cached.  The cache is cleared whenever a
+// filesystem is mounted or unmounted, the current directory changes, or
+// something is written through the VFS.  It is not revalidated otherwise, so
+// it should only be enabled where the VFS is the only writer to the
+// filesystem.  Setting sys.path_importer_cache to None disables the cache.
+
+void mp_vfs_import_cache_clear(void) {
+    mp_obj_t cache = MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_PATH_IMPORTER_CACHE]);
+    if (mp_obj_is_type(cache, &mp_type_dict)) {
+        mp_map_t *map = mp_obj_dict_get_map(cache);
+        if (map->used != 0) {
+            mp_map_clear(map);
+        }
+    }
+}
+
+static mp_obj_t vfs_import_cache_list_dir(mp_obj_t dir) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_t entries = mp_obj_new_dict(0);
+        mp_obj_t iter = mp_vfs_ilistdir(1, &dir);
+        mp_obj_t next;
+        while ((next = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
+            size_t len;
+            mp_obj_t *items;
+            mp_obj_get_array(next, &len, &items);
+            mp_int_t type = len >= 2 ? mp_obj_get_int(items[1]) : 0;
+            int stat = 0;
+            if (type == MP_S_IFDIR) {
+                stat = MP_IMPORT_STAT_DIR;
+            } else if (type == MP_S_IFREG) {
+                stat = MP_IMPORT_STAT_FILE;
+            }
+            mp_obj_dict_store(entries, items[0], MP_OBJ_NEW_SMALL_INT(stat));
+        }
+        nlr_pop();
+        return entries;
+    } else {
+        const mp_obj_type_t *exc_type = ((mp_obj_base_t *)nlr.ret_val)->type;
+        if (mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(exc_type), MP_OBJ_FROM_PTR(&mp_type_OSError))) {
+            mp_obj_t errno_obj = mp_obj_exception_get_value(MP_OBJ_FROM_PTR(nlr.ret_val));
+            if (errno_obj == MP_OBJ_NEW_SMALL_INT(MP_ENOENT) || errno_obj == MP_OBJ_NEW_SMALL_INT(MP_ENOTDIR)) {
+                // The directory doesn't exist.
+                return mp_const_none;
+            }
+            // Some other error (eg EACCES or EIO), which may not persist, so
+            // don't cache anything.
+            return MP_OBJ_NULL;
+        }
+        if (mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(exc_type), MP_OBJ_FROM_PTR(&mp_type_AttributeError))) {
+            // The filesystem has no ilistdir method.
+            return mp_const_false;
+        }
+        nlr_jump(nlr.ret_val);
+    }
+}
+
+// Returns the stat of the path from the cache, or VFS_IMPORT_CACHE_MISS if the
+// cache can't answer and the path must be stat'd.
+#define VFS_IMPORT_CACHE_MISS (-1)
+static int vfs_import_cache_stat(mp_obj_t cache, const char *path) {
+    const char *name = strrchr(path, '/');
+    size_t dir_len;
+    if (name == NULL) {
+        name = path;
+        dir_len = 0;
+    } else {
+        dir_len = name == path ? 1 : name - path;
+        ++name;
+    }
+    size_t name_len = strlen(name);
+    if (name_len == 0) {
+        return VFS_IMPORT_CACHE_MISS;
+    }
+
+    mp_obj_t dir = MP_OBJ_NEW_QSTR(qstr_from_strn(path, dir_len));
+    mp_map_elem_t *elem = mp_map_lookup(mp_obj_dict_get_map(cache), dir, MP_MAP_LOOKUP);
+    mp_obj_t entries;
+    if (elem != NULL && (elem->value == mp_const_none || elem->value == mp_const_false || mp_obj_is_type(elem->value, &mp_type_dict))) {
+        entries = elem->value;
+    } else {
+        entries = vfs_import_cache_list_dir(dir);
+        if (entries == MP_OBJ_NULL) {
+            return VFS_IMPORT_CACHE_MISS;
+        }
+        mp_obj_dict_store(cache, dir, entries);
+    }
+    if (entries == mp_const_none) {
+        return MP_IMPORT_STAT_NO_EXIST;
+    } else if (entries == mp_const_false) {
+        return VFS_IMPORT_CACHE_MISS;
+    }
+
+    // Look up the name without allocating a str for it.
+    mp_obj_t key;
+    qstr q = qstr_find_strn(name, name_len);
+    mp_obj_str_t name_obj;
+    if (q != MP_QSTRnull) {
+        key = MP_OBJ_NEW_QSTR(q);
+    } else {
+        name_obj.base.type = &mp_type_str;
+        name_obj.hash = qstr_compute_hash((const byte *)name, name_len);
+        name_obj.len = name_len;
+        name_obj.data = (const byte *)name;
+        key = MP_OBJ_FROM_PTR(&name_obj);
+    }
+    elem = mp_map_lookup(mp_obj_dict_get_map(entries), key, MP_MAP_LOOKUP);
+    if (elem == NULL) {
+        return MP_IMPORT_STAT_NO_EXIST;
+    } else if (elem->value == MP_OBJ_NEW_SMALL_INT(MP_IMPORT_STAT_DIR)) {
+        return MP_IMPORT_STAT_DIR;
+    } else if (elem->value == MP_OBJ_NEW_SMALL_INT(MP_IMPORT_STAT_FILE)) {
+        return MP_IMPORT_STAT_FILE;
+    } else {
+        return VFS_IMPORT_CACHE_MISS;
+    }
+}
+
+#endif // MICROPY_VFS_IMPORT_CACHE
+
 mp_import_stat_t mp_vfs_import_stat(const char *path) {
+    #if MICROPY_VFS_IMPORT_CACHE
+    mp_obj_t cache = MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_PATH_IMPORTER_CACHE]);
+    if (mp_obj_is_type(cache, &mp_type_dict)) {
+        int stat = vfs_import_cache_stat(cache, path);
+        if (stat != VFS_IMPORT_CACHE_MISS) {
+            return stat;
+        }
+    }
+    #endif
+
     const char *path_out;
     mp_vfs_mount_t *vfs = mp_vfs_lookup_path(path, &path_out);
     if (vfs == MP_VFS_NONE || vfs == MP_VFS_ROOT) {
@@ -259,6 +398,7 @@ mp_obj_t mp_vfs_mount(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
         vfsp = &(*vfsp)->next;
     }
     *vfsp = vfs;
+    mp_vfs_import_cache_clear();
 
     return mp_const_none;
 }
@@ -291,6 +431,7 @@ mp_obj_t mp_vfs_umount(mp_obj_t mnt_in) {
 
     // call the underlying object to do any unmounting operation
     mp_vfs_proxy_call(vfs, MP_QSTR_umount, 0, NULL);
+    mp_vfs_import_cache_clear();
 
     return mp_const_none;
 }
@@ -318,7 +459,14 @@ mp_obj_t mp_vfs_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
     #endif
 
     mp_vfs_mount_t *vfs = lookup_path(args[ARG_file].u_obj, &args[ARG_file].u_obj);
-    return mp_vfs_proxy_call(vfs, MP_QSTR_open, 2, (mp_obj_t *)&args);
+    mp_obj_t file = mp_vfs_proxy_call(vfs, MP_QSTR_open, 2, (mp_obj_t *)&args);
+    #if MICROPY_VFS_IMPORT_CACHE
+    if (strpbrk(mp_obj_str_get_str(args[ARG_mode].u_obj), "wax+") != NULL) {
+        // The file may have been created.
+        mp_vfs_import_cache_clear();
+    }
+    #endif
+    return file;
 }
 MP_DEFINE_CONST_FUN_OBJ_KW(mp_vfs_open_obj, 0, mp_vfs_open);
 
@@ -341,6 +489,7 @@ mp_obj_t mp_vfs_chdir(mp_obj_t path_in) {
         mp_vfs_proxy_call(vfs, MP_QSTR_chdir, 1, &path_out);
     }
     MP_STATE_VM(vfs_cur) = vfs;
+    mp_vfs_import_cache_clear();
     return mp_const_none;
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mp_vfs_chdir_obj, mp_vfs_chdir);
@@ -449,14 +598,18 @@ mp_obj_t mp_vfs_mkdir(mp_obj_t path_in) {
     if (vfs == MP_VFS_ROOT || (vfs != MP_VFS_NONE && !strcmp(mp_obj_str_get_str(path_out), "/"))) {
         mp_raise_OSError(MP_EEXIST);
     }
-    return mp_vfs_proxy_call(vfs, MP_QSTR_mkdir, 1, &path_out);
+    mp_obj_t ret = mp_vfs_proxy_call(vfs, MP_QSTR_mkdir, 1, &path_out);
+    mp_vfs_import_cache_clear();
+    return ret;
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mp_vfs_mkdir_obj, mp_vfs_mkdir);
 
 mp_obj_t mp_vfs_remove(mp_obj_t path_in) {
     mp_obj_t path_out;
     mp_vfs_mount_t *vfs = lookup_path(path_in, &path_out);
-    return mp_vfs_proxy_call(vfs, MP_QSTR_remove, 1, &path_out);
+    mp_obj_t ret = mp_vfs_proxy_call(vfs, MP_QSTR_remove, 1, &path_out);
+    mp_vfs_import_cache_clear();
+    return ret;
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mp_vfs_remove_obj, mp_vfs_remove);
 
@@ -468,14 +621,18 @@ mp_obj_t mp_vfs_rename(mp_obj_t old_path_in, mp_obj_t new_path_in) {
         // can't rename across filesystems
         mp_raise_OSError(MP_EPERM);
     }
-    return mp_vfs_proxy_call(old_vfs, MP_QSTR_rename, 2, args);
+    mp_obj_t ret = mp_vfs_proxy_call(old_vfs, MP_QSTR_rename, 2, args);
+    mp_vfs_import_cache_clear();
+    return ret;
 }
 MP_DEFINE_CONST_FUN_OBJ_2(mp_vfs_rename_obj, mp_vfs_rename);
 
 mp_obj_t mp_vfs_rmdir(mp_obj_t path_in) {
     mp_obj_t path_out;
     mp_vfs_mount_t *vfs = lookup_path(path_in, &path_out);
-    return mp_vfs_proxy_call(vfs, MP_QSTR_rmdir, 1, &path_out);
+    mp_obj_t ret = mp_vfs_proxy_call(vfs, MP_QSTR_rmdir, 1, &path_out);
+    mp_vfs_import_cache_clear();
+    return ret;
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mp_vfs_rmdir_obj, mp_vfs_rmdir);
 
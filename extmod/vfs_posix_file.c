@@ -25,6 +25,7 @@
  */
 
 #include "py/mphal.h"
+#include "py/mperrno.h"
 #include "py/mpthread.h"
 #include "py/runtime.h"
 #include "py/stream.h"
@@ -39,6 +40,10 @@
 #define fsync _commit
 #else
 #include <poll.h>
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #endif
 
 typedef struct _mp_obj_vfs_posix_file_t {
@@ -211,6 +216,33 @@ static mp_uint_t vfs_posix_file_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_
             return 0;
         case MP_STREAM_GET_FILENO:
             return o->fd;
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP && !defined(_WIN32)
+        case MP_STREAM_GET_MAPPED_DATA: {
+            // The mapping outlives the file object.  It is removed only by
+            // MP_STREAM_RELEASE_MAPPED_DATA, because code loaded from it may be
+            // executed in place for as long as the program runs.
+            struct stat st;
+            void *addr = MAP_FAILED;
+            MP_THREAD_GIL_EXIT();
+            if (fstat(o->fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, o->fd, 0);
+            }
+            MP_THREAD_GIL_ENTER();
+            if (addr == MAP_FAILED) {
+                *errcode = MP_EINVAL;
+                return MP_STREAM_ERROR;
+            }
+            mp_buffer_info_t *bufinfo = (mp_buffer_info_t *)arg;
+            bufinfo->buf = addr;
+            bufinfo->len = st.st_size;
+            return 0;
+        }
+        case MP_STREAM_RELEASE_MAPPED_DATA: {
+            mp_buffer_info_t *bufinfo = (mp_buffer_info_t *)arg;
+            munmap(bufinfo->buf, bufinfo->len);
+            return 0;
+        }
+        #endif
         #if MICROPY_PY_SELECT && !MICROPY_PY_SELECT_POSIX_OPTIMISATIONS
         case MP_STREAM_POLL: {
             #ifdef _WIN32
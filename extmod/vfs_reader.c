@@ -36,46 +36,106 @@
 #if MICROPY_READER_VFS
 
 #ifndef MICROPY_READER_VFS_DEFAULT_BUFFER_SIZE
-#define MICROPY_READER_VFS_DEFAULT_BUFFER_SIZE (2 * MICROPY_BYTES_PER_GC_BLOCK - offsetof(mp_reader_vfs_t, buf))
+#define MICROPY_READER_VFS_DEFAULT_BUFFER_SIZE (2 * MICROPY_BYTES_PER_GC_BLOCK)
+#endif
+#define MICROPY_READER_VFS_MIN_BUFFER_SIZE (MICROPY_BYTES_PER_GC_BLOCK)
+#ifndef MICROPY_READER_VFS_MAX_BUFFER_SIZE
+#define MICROPY_READER_VFS_MAX_BUFFER_SIZE (16 * MICROPY_BYTES_PER_GC_BLOCK)
 #endif
-#define MICROPY_READER_VFS_MIN_BUFFER_SIZE (MICROPY_BYTES_PER_GC_BLOCK - offsetof(mp_reader_vfs_t, buf))
-#define MICROPY_READER_VFS_MAX_BUFFER_SIZE (255)
 
+// The buffer starts at the size preferred by the file (or the default) and
+// doubles each time it is refilled, up to the maximum, so small files use
+// little memory while large files need few calls to the stream.  Reads of
+// large blocks bypass the buffer altogether.
 typedef struct _mp_reader_vfs_t {
     mp_obj_t file;
-    uint8_t bufpos;
-    uint8_t buflen;
-    uint8_t bufsize;
-    byte buf[];
+    const byte *cur;
+    const byte *end;
+    byte *buf;
+    size_t bufsize;
 } mp_reader_vfs_t;
 
+static bool mp_reader_vfs_fill(mp_reader_vfs_t *reader) {
+    if (reader->end < reader->buf + reader->bufsize) {
+        // The last read reached the end of the file.
+        return false;
+    }
+    if (reader->bufsize < MICROPY_READER_VFS_MAX_BUFFER_SIZE) {
+        size_t new_size = MIN(2 * reader->bufsize, MICROPY_READER_VFS_MAX_BUFFER_SIZE);
+        byte *new_buf = m_renew_maybe(byte, reader->buf, reader->bufsize, new_size, true);
+        if (new_buf != NULL) {
+            reader->buf = new_buf;
+            reader->bufsize = new_size;
+        }
+    }
+    int errcode;
+    size_t n = mp_stream_rw(reader->file, reader->buf, reader->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+    reader->cur = reader->buf;
+    reader->end = reader->buf + n;
+    return n != 0;
+}
+
 static mp_uint_t mp_reader_vfs_readbyte(void *data) {
     mp_reader_vfs_t *reader = (mp_reader_vfs_t *)data;
-    if (reader->bufpos >= reader->buflen) {
-        if (reader->buflen < reader->bufsize) {
-            return MP_READER_EOF;
-        } else {
+    if (reader->cur >= reader->end && !mp_reader_vfs_fill(reader)) {
+        return MP_READER_EOF;
+    }
+    return *reader->cur++;
+}
+
+static size_t mp_reader_vfs_readbytes(void *data, byte *buf, size_t len) {
+    mp_reader_vfs_t *reader = (mp_reader_vfs_t *)data;
+    size_t n = 0;
+    for (;;) {
+        size_t avail = MIN(len - n, (size_t)(reader->end - reader->cur));
+        memcpy(buf + n, reader->cur, avail);
+        reader->cur += avail;
+        n += avail;
+        if (n == len) {
+            return n;
+        }
+        if (len - n >= reader->bufsize && reader->end == reader->buf + reader->bufsize) {
+            // Read a large remainder directly into the caller's buffer.
             int errcode;
-            reader->buflen = mp_stream_rw(reader->file, reader->buf, reader->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+            size_t n2 = mp_stream_rw(reader->file, buf + n, len - n, &errcode, MP_STREAM_RW_READ);
             if (errcode != 0) {
-                // TODO handle errors properly
-                return MP_READER_EOF;
+                mp_raise_OSError(errcode);
             }
-            if (reader->buflen == 0) {
-                return MP_READER_EOF;
+            if (n2 < len - n) {
+                // End of file, make sure the next fill finds it.
+                reader->cur = reader->end = reader->buf;
             }
-            reader->bufpos = 0;
+            return n + n2;
+        }
+        if (!mp_reader_vfs_fill(reader)) {
+            return n;
         }
     }
-    return reader->buf[reader->bufpos++];
 }
 
 static void mp_reader_vfs_close(void *data) {
     mp_reader_vfs_t *reader = (mp_reader_vfs_t *)data;
     mp_stream_close(reader->file);
+    m_del(byte, reader->buf, reader->bufsize);
     m_del_obj(mp_reader_vfs_t, reader);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+static void mp_reader_vfs_mapped_close(void *file_in, const byte *buf, size_t len, bool in_place) {
+    mp_obj_t file = MP_OBJ_FROM_PTR(file_in);
+    if (!in_place) {
+        // Nothing references the mapped data, so unmap it.
+        mp_buffer_info_t bufinfo = { .buf = (void *)buf, .len = len };
+        int errcode;
+        mp_get_stream(file)->ioctl(file, MP_STREAM_RELEASE_MAPPED_DATA, (uintptr_t)&bufinfo, &errcode);
+    }
+    mp_stream_close(file);
+}
+#endif
+
 void mp_reader_new_file(mp_reader_t *reader, qstr filename) {
     mp_obj_t args[2] = {
         MP_OBJ_NEW_QSTR(filename),
@@ -85,6 +145,22 @@ void mp_reader_new_file(mp_reader_t *reader, qstr filename) {
 
     const mp_stream_p_t *stream_p = mp_get_stream(file);
     int errcode = 0;
+
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    // If an .mpy file can be memory mapped then read it in place, so that its
+    // code can be executed in place.  Other files are only ever copied.
+    size_t name_len;
+    const byte *name = qstr_data(filename, &name_len);
+    if (name_len >= 4 && memcmp(name + name_len - 4, ".mpy", 4) == 0) {
+        mp_buffer_info_t bufinfo = { .buf = NULL };
+        mp_uint_t ret = stream_p->ioctl(file, MP_STREAM_GET_MAPPED_DATA, (uintptr_t)&bufinfo, &errcode);
+        if (ret != MP_STREAM_ERROR && bufinfo.buf != NULL) {
+            mp_reader_new_mem_mapped(reader, bufinfo.buf, bufinfo.len, mp_reader_vfs_mapped_close, MP_OBJ_TO_PTR(file));
+            return;
+        }
+    }
+    #endif
+
     mp_uint_t bufsize = stream_p->ioctl(file, MP_STREAM_GET_BUFFER_SIZE, 0, &errcode);
     if (bufsize == MP_STREAM_ERROR || bufsize == 0) {
         // bufsize == 0 is included here to support mpremote v1.21 and older where mount file ioctl
@@ -94,17 +170,20 @@ void mp_reader_new_file(mp_reader_t *reader, qstr filename) {
         bufsize = MIN(MICROPY_READER_VFS_MAX_BUFFER_SIZE, MAX(MICROPY_READER_VFS_MIN_BUFFER_SIZE, bufsize));
     }
 
-    mp_reader_vfs_t *rf = m_new_obj_var(mp_reader_vfs_t, buf, byte, bufsize);
+    mp_reader_vfs_t *rf = m_new_obj(mp_reader_vfs_t);
     rf->file = file;
+    rf->buf = m_new(byte, bufsize);
     rf->bufsize = bufsize;
-    rf->buflen = mp_stream_rw(rf->file, rf->buf, rf->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+    size_t n = mp_stream_rw(rf->file, rf->buf, rf->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
     if (errcode != 0) {
         mp_raise_OSError(errcode);
     }
-    rf->bufpos = 0;
+    rf->cur = rf->buf;
+    rf->end = rf->buf + n;
     reader->data = rf;
     reader->readbyte = mp_reader_vfs_readbyte;
     reader->close = mp_reader_vfs_close;
+    reader->readbytes = mp_reader_vfs_readbytes;
 }
 
 #endif // MICROPY_READER_VFS
@@ -229,6 +229,18 @@ int re1_5_compilecode(ByteProg *prog, const char *re)
     return 0;
 }
 
+// Return the character that any match must start with, or -1 if there isn't one.
+int re1_5_firstchar(ByteProg *prog)
+{
+    const char *pc = prog->insts + NON_ANCHORED_PREFIX;
+    // Skip over "Save 0"
+    pc += 2;
+    if (*pc == Char) {
+        return (unsigned char)pc[1];
+    }
+    return -1;
+}
+
 #if 0
 int main(int argc, char *argv[])
 {
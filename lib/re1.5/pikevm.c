@@ -0,0 +1,192 @@
+// Copyright 2007-2009 Russ Cox.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Pike VM: runs all threads of the program in lock step over the input, so
+// the time taken is O(len(program) * len(input)) whatever the pattern is.
+// Threads are kept in priority order, which gives the same match (and the
+// same submatches) as the backtracking engines.
+
+typedef struct Thread Thread;
+struct Thread
+{
+	const char *pc;
+	const char **sub;
+};
+
+typedef struct ThreadList ThreadList;
+struct ThreadList
+{
+	int n;
+	Thread *t;
+};
+
+typedef struct PikeVM PikeVM;
+struct PikeVM
+{
+	const char *insts;
+	int *marks;	// step at which each instruction was last added to a list
+	int step;
+	int nsubp;
+	Subject *input;
+};
+
+// Add the thread at pc, and everything reachable from it without consuming
+// input, to the list.  Each instruction is added at most once per step.
+static void
+addthread(PikeVM *vm, ThreadList *l, const char *pc, const char *sp, const char **sub)
+{
+	const char *old;
+	Thread *t;
+	int off;
+
+	if(vm->marks[pc - vm->insts] == vm->step)
+		return;
+	vm->marks[pc - vm->insts] = vm->step;
+
+	re1_5_stack_chk();
+
+	switch(*pc) {
+	case Jmp:
+		addthread(vm, l, pc + 2 + (signed char)pc[1], sp, sub);
+		return;
+	case Split:
+		addthread(vm, l, pc + 2, sp, sub);
+		addthread(vm, l, pc + 2 + (signed char)pc[1], sp, sub);
+		return;
+	case RSplit:
+		addthread(vm, l, pc + 2 + (signed char)pc[1], sp, sub);
+		addthread(vm, l, pc + 2, sp, sub);
+		return;
+	case Save:
+		off = (unsigned char)pc[1];
+		if(off >= vm->nsubp) {
+			addthread(vm, l, pc + 2, sp, sub);
+			return;
+		}
+		old = sub[off];
+		sub[off] = sp;
+		addthread(vm, l, pc + 2, sp, sub);
+		sub[off] = old;
+		return;
+	case Bol:
+		if(sp == vm->input->begin_line)
+			addthread(vm, l, pc + 1, sp, sub);
+		return;
+	case Eol:
+		if(sp == vm->input->end)
+			addthread(vm, l, pc + 1, sp, sub);
+		return;
+	}
+
+	// A consumer or Match, which waits in the list for the next step
+	t = &l->t[l->n++];
+	t->pc = pc;
+	memcpy(t->sub, sub, vm->nsubp * sizeof(*sub));
+}
+
+int
+re1_5_pikevm(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored)
+{
+	PikeVM vm;
+	ThreadList clist, nlist, tmp;
+	const char *start, *pc, *sp, **sub;
+	int i, lit, matched;
+
+	// All state goes in one block: the marks, the thread lists, the
+	// submatches of each thread, and the submatches of the new thread.
+	size_t nthr = prog->len;
+	size_t size = prog->bytelen * sizeof(int) + 2 * nthr * sizeof(Thread)
+		+ (2 * nthr + 1) * nsubp * sizeof(char*);
+	char *mem = re1_5_alloc(size);
+
+	vm.insts = prog->insts;
+	vm.marks = (int*)mem;
+	vm.step = 0;
+	vm.nsubp = nsubp;
+	vm.input = input;
+	memset(vm.marks, 0, prog->bytelen * sizeof(int));
+	clist.n = nlist.n = 0;
+	clist.t = (Thread*)(vm.marks + prog->bytelen);
+	nlist.t = clist.t + nthr;
+	sub = (const char**)(nlist.t + nthr);
+	for(i = 0; i < nsubp; i++)
+		sub[i] = nil;
+	for(i = 0; i < (int)nthr; i++) {
+		clist.t[i].sub = sub + (1 + i) * nsubp;
+		nlist.t[i].sub = sub + (1 + nthr + i) * nsubp;
+	}
+
+	// Searching is done by starting a new thread at each position of the
+	// input, with lower priority than those already running, rather than
+	// by running the non-anchored prefix of the program.  If the pattern
+	// starts with a literal character then positions can be skipped quickly
+	// whenever there are no threads running.
+	start = prog->insts + NON_ANCHORED_PREFIX;
+	lit = is_anchored ? -1 : re1_5_firstchar(prog);
+
+	matched = 0;
+	for(sp = input->begin;; sp++) {
+		if(!matched && (!is_anchored || sp == input->begin)) {
+			if(clist.n == 0) {
+				if(lit >= 0) {
+					sp = memchr(sp, lit, input->end - sp);
+					if(sp == nil)
+						break;
+				}
+				vm.step++;
+			}
+			addthread(&vm, &clist, start, sp, sub);
+		}
+		if(clist.n == 0)
+			break;
+
+		vm.step++;
+		nlist.n = 0;
+		for(i = 0; i < clist.n; i++) {
+			pc = clist.t[i].pc;
+			if(*pc == Match) {
+				// Threads of lower priority than this one are cut off
+				matched = 1;
+				memcpy(subp, clist.t[i].sub, nsubp * sizeof(*subp));
+				break;
+			}
+			if(sp >= input->end)
+				continue;
+			switch(*pc) {
+			case Char:
+				if(*sp != pc[1])
+					continue;
+				pc += 2;
+				break;
+			case Any:
+				pc++;
+				break;
+			case Class:
+			case ClassNot:
+				if(!_re1_5_classmatch(pc + 1, sp))
+					continue;
+				pc += 2 + *(unsigned char*)(pc + 1) * 2;
+				break;
+			case NamedClass:
+				if(!_re1_5_namedclassmatch(pc + 1, sp))
+					continue;
+				pc += 2;
+				break;
+			default:
+				re1_5_fatal("pikevm");
+			}
+			addthread(&vm, &nlist, pc, sp + 1, clist.t[i].sub);
+		}
+		tmp = clist;
+		clist = nlist;
+		nlist = tmp;
+		if(sp >= input->end)
+			break;
+	}
+
+	re1_5_free(mem, size);
+	return matched;
+}
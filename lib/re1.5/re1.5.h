@@ -51,6 +51,10 @@ void re1_5_fatal(char*);
 #ifndef re1_5_stack_chk
 #define re1_5_stack_chk()
 #endif
+#ifndef re1_5_alloc
+#define re1_5_alloc(n) malloc(n)
+#define re1_5_free(p, n) free(p)
+#endif
 void *mal(int);
 
 struct Prog
@@ -149,6 +153,7 @@ int re1_5_thompsonvm(ByteProg*, Subject*, const char**, int, int);
 int re1_5_sizecode(const char *re);
 int re1_5_compilecode(ByteProg *prog, const char *re);
 void re1_5_dumpcode(ByteProg *prog);
+int re1_5_firstchar(ByteProg *prog);
 void cleanmarks(ByteProg *prog);
 int _re1_5_classmatch(const char *pc, const char *sp);
 int _re1_5_namedclassmatch(const char *pc, const char *sp);
@@ -518,6 +518,7 @@ mp_lexer_t *os_mbfs_new_reader(const char *filename) {
     reader.data = fd;
     reader.readbyte = (mp_uint_t(*)(void*))file_read_byte;
     reader.close = (void(*)(void*))microbit_file_close; // no-op
+    reader.readbytes = NULL;
     return mp_lexer_new(qstr_from_str(filename), reader);
 }
 
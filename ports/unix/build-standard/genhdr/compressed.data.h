@@ -0,0 +1,239 @@
+#define MP_MAX_UNCOMPRESSED_TEXT_LEN (73)
+MP_COMPRESSED_DATA("can'\364'%q\247objec\364forma\364argumen\364functio\356argument\363no\364mus\364invali\344positiona\354'%s\247keywor\344specifie\362t\357conver\364strin\347o\346b\345require\344typ\345fo\362inde\370ar\347attribut\345%\344empt\371expecte\344implemente\344isn'\364unsupporte\344wit\350\341assignmen\364i\356outsid\345generato\362lengt\350multipl\345fro\355comple\370doesn'\364erro\362missin\347rang\345conversio\356identifie\362a\356n\357synta\370bu\364expectin\347ha\363in\364lis\364nam\345supporte\344afte\362fiel\344give\356need\363nonloca\354overflo\367sequenc\345snapsho\364tupl\345allowe\344indice\363ou\364struct\272to\357unknow\356dic\364i\363o\362zer\357buffe\362impor\364numbe\362shoul\344specificatio\356value\363incompatibl\345issubclass(\251%\361%\363an\344byte\363clas\363foun\344loca\354stor\345take\363valu\345allocatio\356expressio\356implicitl\371incomplet\345unexpecte\344.mp\371arg\363automati\343cod\345hea\360integers\254numberin\347operatio\356redefine\344sel\346callabl\345negativ\345defaul\364failed\254go\364intege\362se\364suppor\364befor\345binar\371divid\345inden\364manua\354memor\371mktim\345modul\345nativ\345retur\356switc\350")
+MP_MATCH_COMPRESSED("%c needs int or char", "\377%c\274\265\312char")
+MP_MATCH_COMPRESSED("%q index out of range", "\377\324\226\304\221\254")
+MP_MATCH_COMPRESSED("%q indices must be integers, not %s", "\377\324\303\210\222\350\207\325")
+MP_MATCH_COMPRESSED("%q() takes %d positional arguments but %d were given", "\377%q()\334\231\212\206\262\231were\273")
+MP_MATCH_COMPRESSED("'%q' argument required", "\377\201\204\223")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item assignment", "\377\213\202\251\364item\241")
+MP_MATCH_COMPRESSED("'%s' object doesn't support item deletion", "\377\213\202\251\364item deletion")
+MP_MATCH_COMPRESSED("'%s' object has no attribute '%q'", "\377\213\202\264\260\230\201")
+MP_MATCH_COMPRESSED("'%s' object isn't an iterator", "\377\213\202\235\257iterator")
+MP_MATCH_COMPRESSED("'%s' object isn't callable", "\377\213\202\235\355")
+MP_MATCH_COMPRESSED("'%s' object isn't iterable", "\377\213\202\235iterable")
+MP_MATCH_COMPRESSED("'%s' object isn't subscriptable", "\377\213\202\235subscriptable")
+MP_MATCH_COMPRESSED("'=' alignment not allowed in string format specifier", "\377'=' alignment\207\302\242\220\203\215")
+MP_MATCH_COMPRESSED("'await' outside function", "\377'await'\243\205")
+MP_MATCH_COMPRESSED("'break'/'continue' outside loop", "\377'break'/'continue'\243loop")
+MP_MATCH_COMPRESSED("'not' not implemented", "\377'not'\207\234")
+MP_MATCH_COMPRESSED("'return' outside function", "\377'return'\243\205")
+MP_MATCH_COMPRESSED("'yield' outside function", "\377'yield'\243\205")
+MP_MATCH_COMPRESSED("* arg after **", "\377*\227\271**")
+MP_MATCH_COMPRESSED("*x must be assignment target", "\377*x\210\222\241target")
+MP_MATCH_COMPRESSED("0.0 to a complex power", "\3770.0\216\240\250power")
+MP_MATCH_COMPRESSED("I/O operation on closed file", "\377I/O\352on closed file")
+MP_MATCH_COMPRESSED("LHS of keyword arg must be an id", "\377LHS\221\214\227\210\222\257id")
+MP_MATCH_COMPRESSED("[addrinfo error %d]", "\377[addrinfo\252%d]")
+MP_MATCH_COMPRESSED("__init__() should return None, not '%s'", "\377__init__()\317\376None,\207\213")
+MP_MATCH_COMPRESSED("abort() called", "abort() called")
+MP_MATCH_COMPRESSED("address %08x is not aligned to %d bytes", "\377address %08x\311\207aligned\216\231\327")
+MP_MATCH_COMPRESSED("annotation must be an identifier", "\377annotation\210\222\257\256")
+MP_MATCH_COMPRESSED("arg is an empty sequence", "\377\227\311\257\232\277")
+MP_MATCH_COMPRESSED("arg must be user-type", "\377\227\210\222user-type")
+MP_MATCH_COMPRESSED("argument name reused", "\377\204\267reused")
+MP_MATCH_COMPRESSED("argument num/types mismatch", "\377\204num/types mismatch")
+MP_MATCH_COMPRESSED("argument should be a '%q' not a '%q'", "\377\204\317\222\240\201\207\240\201")
+MP_MATCH_COMPRESSED("array/bytes required on right side", "\377array/bytes\223on right side")
+MP_MATCH_COMPRESSED("async for/with outside async function", "\377async for/with\243async\205")
+MP_MATCH_COMPRESSED("attributes not supported", "\377attributes\207\270")
+MP_MATCH_COMPRESSED("bad compile mode", "bad compile mode")
+MP_MATCH_COMPRESSED("bad typecode", "bad typecode")
+MP_MATCH_COMPRESSED("binary op %q not implemented", "\377\366op\324\207\234")
+MP_MATCH_COMPRESSED("bits must be 32 or less", "\377bits\210\22232\312less")
+MP_MATCH_COMPRESSED("buffer size must be a multiple of struct size", "\377\314size\210\222\240\246\221struct size")
+MP_MATCH_COMPRESSED("buffer too small", "\377\314\306small")
+MP_MATCH_COMPRESSED("bytecode overflow", "\377bytecode\276")
+MP_MATCH_COMPRESSED("bytes value out of range", "\377\327\335\304\221\254")
+MP_MATCH_COMPRESSED("call super().__init__() first", "call super().__init__() first")
+MP_MATCH_COMPRESSED("can't add special method to already-subclassed class", "\377\200add special method\216already-subclassed\330")
+MP_MATCH_COMPRESSED("can't assign to expression", "\377\200assign\216\337")
+MP_MATCH_COMPRESSED("can't cancel self", "\377\200cancel\354")
+MP_MATCH_COMPRESSED("can't convert %s to complex", "\377\200\217\325\216\250")
+MP_MATCH_COMPRESSED("can't convert %s to float", "\377\200\217\325\216float")
+MP_MATCH_COMPRESSED("can't convert %s to int", "\377\200\217\325\216\265")
+MP_MATCH_COMPRESSED("can't convert '%q' object to %q implicitly", "\377\200\217\201\202\216\324\340")
+MP_MATCH_COMPRESSED("can't convert NaN to int", "\377\200\217NaN\216\265")
+MP_MATCH_COMPRESSED("can't convert inf to int", "\377\200\217inf\216\265")
+MP_MATCH_COMPRESSED("can't create '%q' instances", "\377\200create\201instances")
+MP_MATCH_COMPRESSED("can't declare nonlocal in outer code", "\377\200declare\275\242outer\346")
+MP_MATCH_COMPRESSED("can't delete expression", "\377\200delete\337")
+MP_MATCH_COMPRESSED("can't do binary op between '%q' and '%q'", "\377\200do\366op between\201\326\201")
+MP_MATCH_COMPRESSED("can't do unary op of '%q'", "\377\200do unary op\221\201")
+MP_MATCH_COMPRESSED("can't implicitly convert '%q' to 'bool'", "\377\200\340\217\201\216'bool'")
+MP_MATCH_COMPRESSED("can't import name %q", "\377\200\315\267\324")
+MP_MATCH_COMPRESSED("can't load from '%q'", "\377\200load\247\201")
+MP_MATCH_COMPRESSED("can't load with '%q' index", "\377\200load\237\201\226")
+MP_MATCH_COMPRESSED("can't perform relative import", "\377\200perform relative\315")
+MP_MATCH_COMPRESSED("can't send non-None value to a just-started generator", "\377\200send non-None\335\216\240just-started\244")
+MP_MATCH_COMPRESSED("can't set attribute", "\377\200\363\230")
+MP_MATCH_COMPRESSED("can't snapshot '%s' object", "\377\200\300\213\202")
+MP_MATCH_COMPRESSED("can't snapshot qstr", "\377\200\300qstr")
+MP_MATCH_COMPRESSED("can't store '%q'", "\377\200\333\201")
+MP_MATCH_COMPRESSED("can't store to '%q'", "\377\200\333\216\201")
+MP_MATCH_COMPRESSED("can't store with '%q' index", "\377\200\333\237\201\226")
+MP_MATCH_COMPRESSED("can't switch from automatic field numbering to manual field specification", "\377\200\377\247\345\272\351\216\371\272\320")
+MP_MATCH_COMPRESSED("can't switch from manual field specification to automatic field numbering", "\377\200\377\247\371\272\320\216\345\272\351")
+MP_MATCH_COMPRESSED("can't truncate-divide a complex number", "\377\200truncate-divide\240\250\316")
+MP_MATCH_COMPRESSED("can't unambiguously get sizeof scalar", "\377\200unambiguously get sizeof scalar")
+MP_MATCH_COMPRESSED("can't wait", "\377\200wait")
+MP_MATCH_COMPRESSED("casting", "casting")
+MP_MATCH_COMPRESSED("chr() arg not in range(0x110000)", "\377chr()\227\207\242range(0x110000)")
+MP_MATCH_COMPRESSED("comparison of int and uint", "\377comparison\221\265\326uint")
+MP_MATCH_COMPRESSED("complex divide by zero", "\377\250\367by\313")
+MP_MATCH_COMPRESSED("conversion to object", "\377\255\216\202")
+MP_MATCH_COMPRESSED("default 'except' must be last", "\377\357'except'\210\222last")
+MP_MATCH_COMPRESSED("dict update sequence has wrong length", "\377\310update\277\264wrong\245")
+MP_MATCH_COMPRESSED("div/mod not implemented for uint", "\377div/mod\207\234\225uint")
+MP_MATCH_COMPRESSED("divide by zero", "\377\367by\313")
+MP_MATCH_COMPRESSED("empty", "\377\232")
+MP_MATCH_COMPRESSED("empty heap", "\377\232\347")
+MP_MATCH_COMPRESSED("empty separator", "\377\232separator")
+MP_MATCH_COMPRESSED("end of format while looking for conversion specifier", "\377end\221\203while looking\225\255\215")
+MP_MATCH_COMPRESSED("error in regex", "\377\252\242regex")
+MP_MATCH_COMPRESSED("exceptions must derive from BaseException", "\377exceptions\210derive\247BaseException")
+MP_MATCH_COMPRESSED("expected ':' after format specifier", "\377\233':'\271\203\215")
+MP_MATCH_COMPRESSED("expecting a dict for keyword args", "\377\263\240\310\225\214\344")
+MP_MATCH_COMPRESSED("expecting just a value for set", "\377\263just\240\335\225\363")
+MP_MATCH_COMPRESSED("expecting key:value for dict", "\377\263key:value\225\310")
+MP_MATCH_COMPRESSED("extra keyword arguments given", "\377extra\214\206\273")
+MP_MATCH_COMPRESSED("extra positional arguments given", "\377extra\212\206\273")
+MP_MATCH_COMPRESSED("format", "\377\203")
+MP_MATCH_COMPRESSED("format needs a dict", "\377\203\274\240\310")
+MP_MATCH_COMPRESSED("format string didn't convert all arguments", "\377\203\220didn't\217all\206")
+MP_MATCH_COMPRESSED("format string needs more arguments", "\377\203\220\274more\206")
+MP_MATCH_COMPRESSED("full", "full")
+MP_MATCH_COMPRESSED("function doesn't take keyword arguments", "\377\205\251take\214\206")
+MP_MATCH_COMPRESSED("function expected at most %d arguments, got %d", "\377\205\233at most\231arguments,\361\231")
+MP_MATCH_COMPRESSED("function got multiple values for argument '%q'", "\377\205\361\246\321\225\204\201")
+MP_MATCH_COMPRESSED("function missing %d required positional arguments", "\377\205\253\231\223\212\206")
+MP_MATCH_COMPRESSED("function missing keyword-only argument", "\377\205\253keyword-only\204")
+MP_MATCH_COMPRESSED("function missing required keyword argument '%q'", "\377\205\253\223\214\204\201")
+MP_MATCH_COMPRESSED("function missing required positional argument #%d", "\377\205\253\223\212\204#%d")
+MP_MATCH_COMPRESSED("function takes %d positional arguments but %d were given", "\377\205\334\231\212\206\262\231were\273")
+MP_MATCH_COMPRESSED("generator already executing", "\377\244already executing")
+MP_MATCH_COMPRESSED("generator ignored GeneratorExit", "\377\244ignored GeneratorExit")
+MP_MATCH_COMPRESSED("generator raised StopIteration", "\377\244raised StopIteration")
+MP_MATCH_COMPRESSED("hash is final", "\377hash\311final")
+MP_MATCH_COMPRESSED("heap must be a list", "\377\347\210\222\240\266")
+MP_MATCH_COMPRESSED("identifier redefined as global", "\377\256\353as global")
+MP_MATCH_COMPRESSED("identifier redefined as nonlocal", "\377\256\353as\275")
+MP_MATCH_COMPRESSED("import * not at module level", "\377\315*\207at\374level")
+MP_MATCH_COMPRESSED("incompatible .mpy arch", "\377\322\343arch")
+MP_MATCH_COMPRESSED("incompatible .mpy file", "\377\322\343file")
+MP_MATCH_COMPRESSED("incomplete format", "\377\341\203")
+MP_MATCH_COMPRESSED("incomplete format key", "\377\341\203key")
+MP_MATCH_COMPRESSED("incorrect padding", "incorrect padding")
+MP_MATCH_COMPRESSED("int() arg 2 must be >= 2 and <= 36", "\377int()\2272\210\222>= 2\326<= 36")
+MP_MATCH_COMPRESSED("integer needed", "\377\362needed")
+MP_MATCH_COMPRESSED("invalid format", "\377\211\203")
+MP_MATCH_COMPRESSED("invalid format specifier", "\377\211\203\215")
+MP_MATCH_COMPRESSED("invalid micropython decorator", "\377\211micropython decorator")
+MP_MATCH_COMPRESSED("invalid mktime usage", "\377\211\373usage")
+MP_MATCH_COMPRESSED("invalid rotation", "\377\211rotation")
+MP_MATCH_COMPRESSED("invalid snapshot", "\377\211\300")
+MP_MATCH_COMPRESSED("invalid syntax", "\377\211\261")
+MP_MATCH_COMPRESSED("invalid syntax for number", "\377\211\261\225\316")
+MP_MATCH_COMPRESSED("invalid thresholds", "\377\211thresholds")
+MP_MATCH_COMPRESSED("invalid waveform", "\377\211waveform")
+MP_MATCH_COMPRESSED("issubclass() arg 1 must be a class", "\377\323\2271\210\222\240\330")
+MP_MATCH_COMPRESSED("issubclass() arg 2 must be a class or a tuple of classes", "\377\323\2272\210\222\240\330\312\240\301\221classes")
+MP_MATCH_COMPRESSED("join expects a list of str/bytes objects consistent with self object", "\377join expects\240\266\221str/bytes objects consistent\237\354\202")
+MP_MATCH_COMPRESSED("keyword argument(s) not implemented - use normal args instead", "\377\214argument(s)\207\234- use normal\344instead")
+MP_MATCH_COMPRESSED("lhs and rhs should be compatible", "\377lhs\326rhs\317\222compatible")
+MP_MATCH_COMPRESSED("list modified during sort", "\377\266modified during sort")
+MP_MATCH_COMPRESSED("local '%q' has type '%q' but source is '%q'", "\377\332\201\264\224\201\262source\311\201")
+MP_MATCH_COMPRESSED("local '%q' used before type known", "\377\332\201used\365\224known")
+MP_MATCH_COMPRESSED("local variable referenced before assignment", "\377\332variable referenced\365\241")
+MP_MATCH_COMPRESSED("malformed f-string", "malformed f-string")
+MP_MATCH_COMPRESSED("math domain error", "\377math domain\252")
+MP_MATCH_COMPRESSED("memory allocation failed, allocating %u bytes", "\377\372\336\360allocating %u\327")
+MP_MATCH_COMPRESSED("memory allocation failed, heap is locked", "\377\372\336\360\347\311locked")
+MP_MATCH_COMPRESSED("memoryview offset too large", "\377memoryview offset\306large")
+MP_MATCH_COMPRESSED("mktime needs a tuple of length 8 or 9", "\377\373\274\240\301\221\2458\3129")
+MP_MATCH_COMPRESSED("multiple *x in assignment", "\377\246*x\242\241")
+MP_MATCH_COMPRESSED("multiple bases have instance lay-out conflict", "\377\246bases have instance lay-out conflict")
+MP_MATCH_COMPRESSED("must raise an object", "\377\210raise\257\202")
+MP_MATCH_COMPRESSED("must use keyword argument for key function", "\377\210use\214\204\225key\205")
+MP_MATCH_COMPRESSED("name '%q' isn't defined", "\377\267\201\235defined")
+MP_MATCH_COMPRESSED("name too long", "\377\267\306long")
+MP_MATCH_COMPRESSED("native code in .mpy unsupported", "\377\375\346\242\343\236")
+MP_MATCH_COMPRESSED("native yield", "\377\375yield")
+MP_MATCH_COMPRESSED("need more than %d values to unpack", "\377need more than\231\321\216unpack")
+MP_MATCH_COMPRESSED("negative factorial", "\377\356factorial")
+MP_MATCH_COMPRESSED("negative shift count", "\377\356shift count")
+MP_MATCH_COMPRESSED("no active exception to reraise", "\377\260active exception\216reraise")
+MP_MATCH_COMPRESSED("no binding for nonlocal found", "\377\260binding\225\275\331")
+MP_MATCH_COMPRESSED("no module named '%q'", "\377\260\374named\201")
+MP_MATCH_COMPRESSED("no such attribute", "\377\260such\230")
+MP_MATCH_COMPRESSED("non-default argument follows default argument", "\377non-default\204follows\357\204")
+MP_MATCH_COMPRESSED("non-hex digit", "non-hex digit")
+MP_MATCH_COMPRESSED("not a constant", "\377\207\240constant")
+MP_MATCH_COMPRESSED("not tracing", "\377\207tracing")
+MP_MATCH_COMPRESSED("object '%s' isn't a tuple or list", "\377\202\213\235\240\301\312\266")
+MP_MATCH_COMPRESSED("object not callable", "\377\202\207\355")
+MP_MATCH_COMPRESSED("object not in sequence", "\377\202\207\242\277")
+MP_MATCH_COMPRESSED("object of type '%s' has no len()", "\377\202\221\224\213\264\260len()")
+MP_MATCH_COMPRESSED("object with buffer protocol required", "\377\202\237\314protocol\223")
+MP_MATCH_COMPRESSED("only slices with step=1 (aka None) are supported", "\377only slices\237step=1 (aka None) are\270")
+MP_MATCH_COMPRESSED("opcode", "opcode")
+MP_MATCH_COMPRESSED("ord() expected a character, but string of length %d found", "\377ord()\233\240character,\262\220\221\245\231\331")
+MP_MATCH_COMPRESSED("overflow converting long int to machine word", "\377\276converting long\265\216machine word")
+MP_MATCH_COMPRESSED("pack expected %d items", "\377pack\233\231items")
+MP_MATCH_COMPRESSED("pop from an empty set", "\377pop\247\257\232\363")
+MP_MATCH_COMPRESSED("pop from empty list", "\377pop\247\232\266")
+MP_MATCH_COMPRESSED("popitem(): dictionary is empty", "\377popitem(): dictionary\311\232")
+MP_MATCH_COMPRESSED("positional arg after **", "\377\212\227\271**")
+MP_MATCH_COMPRESSED("positional arg after keyword arg", "\377\212\227\271\214\227")
+MP_MATCH_COMPRESSED("pow() with 3 arguments requires integers", "\377pow()\2373\206requires integers")
+MP_MATCH_COMPRESSED("requested length %d but object has length %d", "\377requested\245\231\262\202\264\245\231")
+MP_MATCH_COMPRESSED("return expected '%q' but got '%q'", "\377\376\233\201\262\361\201")
+MP_MATCH_COMPRESSED("rsplit(None,n)", "rsplit(None,n)")
+MP_MATCH_COMPRESSED("schedule queue full", "schedule queue full")
+MP_MATCH_COMPRESSED("sign not allowed in string format specifier", "\377sign\207\302\242\220\203\215")
+MP_MATCH_COMPRESSED("sign not allowed with integer format specifier 'c'", "\377sign\207\302\237\362\203\215'c'")
+MP_MATCH_COMPRESSED("single '}' encountered in format string", "\377single '}' encountered\242\203\220")
+MP_MATCH_COMPRESSED("slice step can't be zero", "\377slice step\200\222\313")
+MP_MATCH_COMPRESSED("splitting with sub-captures", "\377splitting\237sub-captures")
+MP_MATCH_COMPRESSED("start/end indices", "\377start/end\303")
+MP_MATCH_COMPRESSED("stream operation not supported", "\377stream\352\207\270")
+MP_MATCH_COMPRESSED("string argument without an encoding", "\377\220\204without\257encoding")
+MP_MATCH_COMPRESSED("string index out of range", "\377\220\226\304\221\254")
+MP_MATCH_COMPRESSED("string indices must be integers, not %s", "\377\220\303\210\222\350\207\325")
+MP_MATCH_COMPRESSED("struct: can't index", "\377\305\200\226")
+MP_MATCH_COMPRESSED("struct: index out of range", "\377\305\226\304\221\254")
+MP_MATCH_COMPRESSED("struct: no fields", "\377\305\260fields")
+MP_MATCH_COMPRESSED("substring not found", "\377substring\207\331")
+MP_MATCH_COMPRESSED("super() can't find self", "\377super()\200find\354")
+MP_MATCH_COMPRESSED("syntax error in JSON", "\377\261\252\242JSON")
+MP_MATCH_COMPRESSED("syntax error in uctypes descriptor", "\377\261\252\242uctypes descriptor")
+MP_MATCH_COMPRESSED("ticks interval overflow", "\377ticks interval\276")
+MP_MATCH_COMPRESSED("too many args", "\377\306many\344")
+MP_MATCH_COMPRESSED("too many values to unpack (expected %d)", "\377\306many\321\216unpack (expected %d)")
+MP_MATCH_COMPRESSED("tuple index out of range", "\377\301\226\304\221\254")
+MP_MATCH_COMPRESSED("type '%q' isn't an acceptable base type", "\377\224\201\235\257acceptable base\224")
+MP_MATCH_COMPRESSED("type object '%q' has no attribute '%q'", "\377\224\202\201\264\260\230\201")
+MP_MATCH_COMPRESSED("type takes 1 or 3 arguments", "\377\224\3341\3123\206")
+MP_MATCH_COMPRESSED("unexpected indent", "\377\342\370")
+MP_MATCH_COMPRESSED("unexpected keyword argument '%q'", "\377\342\214\204\201")
+MP_MATCH_COMPRESSED("unicode name escapes", "\377unicode\267escapes")
+MP_MATCH_COMPRESSED("unindent doesn't match any outer indent level", "\377unindent\251match any outer\370level")
+MP_MATCH_COMPRESSED("unknown conversion specifier %c", "\377\307\255\215%c")
+MP_MATCH_COMPRESSED("unknown format code '%c' for object of type '%s'", "\377\307\203\346'%c'\225\202\221\224\213")
+MP_MATCH_COMPRESSED("unknown type '%q'", "\377\307\224\201")
+MP_MATCH_COMPRESSED("unmatched '{' in format", "\377unmatched '{'\242\203")
+MP_MATCH_COMPRESSED("unreadable attribute", "\377unreadable\230")
+MP_MATCH_COMPRESSED("unsupported format character '%c' (0x%x) at index %d", "\377\236\203character '%c' (0x%x) at\226\231")
+MP_MATCH_COMPRESSED("unsupported type for %q: '%s'", "\377\236\224\225%q:\213")
+MP_MATCH_COMPRESSED("unsupported types for %q: '%s', '%s'", "\377\236types\225%q: '%s',\213")
+MP_MATCH_COMPRESSED("wbits", "wbits")
+MP_MATCH_COMPRESSED("wrong number of arguments", "\377wrong\316\221\206")
+MP_MATCH_COMPRESSED("zero step", "\377\313step")
+// Total input length:      6740
+// Total compressed length: 3176
+// Total data length:       1158
+// Predicted saving:        2406
+
+// gzip length:             3743
+// Percentage of gzip:      115.8%
+// zlib length:             3731
+// Percentage of zlib:      116.2%
@@ -0,0 +1,4 @@
+// This file was generated by py/makeversionhdr.py
+#define MICROPY_GIT_TAG "3c05204-dirty"
+#define MICROPY_GIT_HASH "3c05204"
+#define MICROPY_BUILD_DATE "2026-10-17"
@@ -0,0 +1,2617 @@
+Q(AF_INET)
+
+Q(AF_INET6)
+
+Q(AF_UNIX)
+
+Q(ARRAY)
+
+Q(AUTO)
+
+Q(ArithmeticError)
+
+Q(ArithmeticError)
+
+Q(AssertionError)
+
+Q(AssertionError)
+
+Q(AssertionError)
+
+Q(AttributeError)
+
+Q(AttributeError)
+
+Q(B1000000)
+
+Q(B115200)
+
+Q(B1152000)
+
+Q(B230400)
+
+Q(B460800)
+
+Q(B500000)
+
+Q(B57600)
+
+Q(B576000)
+
+Q(B921600)
+
+Q(B9600)
+
+Q(BFINT16)
+
+Q(BFINT32)
+
+Q(BFINT8)
+
+Q(BFUINT16)
+
+Q(BFUINT32)
+
+Q(BFUINT8)
+
+Q(BF_LEN)
+
+Q(BF_POS)
+
+Q(BIG_ENDIAN)
+
+Q(BaseException)
+
+Q(BaseException)
+
+Q(BaseException)
+
+Q(BytesIO)
+
+Q(BytesIO)
+
+Q(CancelledError)
+
+Q(DeflateIO)
+
+Q(DeflateIO)
+
+Q(EACCES)
+
+Q(EACCES)
+
+Q(EADDRINUSE)
+
+Q(EADDRINUSE)
+
+Q(EAGAIN)
+
+Q(EAGAIN)
+
+Q(EALREADY)
+
+Q(EALREADY)
+
+Q(EBADF)
+
+Q(EBADF)
+
+Q(ECONNABORTED)
+
+Q(ECONNABORTED)
+
+Q(ECONNREFUSED)
+
+Q(ECONNREFUSED)
+
+Q(ECONNRESET)
+
+Q(ECONNRESET)
+
+Q(EEXIST)
+
+Q(EEXIST)
+
+Q(EHOSTUNREACH)
+
+Q(EHOSTUNREACH)
+
+Q(EINPROGRESS)
+
+Q(EINPROGRESS)
+
+Q(EINVAL)
+
+Q(EINVAL)
+
+Q(EIO)
+
+Q(EIO)
+
+Q(EISDIR)
+
+Q(EISDIR)
+
+Q(ENOBUFS)
+
+Q(ENOBUFS)
+
+Q(ENODEV)
+
+Q(ENODEV)
+
+Q(ENOENT)
+
+Q(ENOENT)
+
+Q(ENOMEM)
+
+Q(ENOMEM)
+
+Q(ENOTCONN)
+
+Q(ENOTCONN)
+
+Q(EOFError)
+
+Q(EOFError)
+
+Q(EOPNOTSUPP)
+
+Q(EOPNOTSUPP)
+
+Q(EPERM)
+
+Q(EPERM)
+
+Q(ETIMEDOUT)
+
+Q(ETIMEDOUT)
+
+Q(Ellipsis)
+
+Q(Ellipsis)
+
+Q(Exception)
+
+Q(Exception)
+
+Q(FLIP_H)
+
+Q(FLIP_V)
+
+Q(FLOAT32)
+
+Q(FLOAT64)
+
+Q(FULL)
+
+Q(FileIO)
+
+Q(FileIO)
+
+Q(FileIO)
+
+Q(FrameBuffer)
+
+Q(FrameBuffer)
+
+Q(FrameBuffer1)
+
+Q(GS2_HMSB)
+
+Q(GS4_HMSB)
+
+Q(GS8)
+
+Q(GZIP)
+
+Q(GeneratorExit)
+
+Q(GeneratorExit)
+
+Q(INT)
+
+Q(INT16)
+
+Q(INT32)
+
+Q(INT64)
+
+Q(INT8)
+
+Q(IOBase)
+
+Q(IOBase)
+
+Q(ImportError)
+
+Q(ImportError)
+
+Q(IndentationError)
+
+Q(IndentationError)
+
+Q(IndexError)
+
+Q(IndexError)
+
+Q(KeyError)
+
+Q(KeyError)
+
+Q(KeyboardInterrupt)
+
+Q(KeyboardInterrupt)
+
+Q(L8)
+
+Q(LITTLE_ENDIAN)
+
+Q(LONG)
+
+Q(LONGLONG)
+
+Q(LockType)
+
+Q(LookupError)
+
+Q(LookupError)
+
+Q(MONO_HLSB)
+
+Q(MONO_HMSB)
+
+Q(MONO_VLSB)
+
+Q(MSG_DONTROUTE)
+
+Q(MSG_DONTWAIT)
+
+Q(MVLSB)
+
+Q(MemoryError)
+
+Q(MemoryError)
+
+Q(NATIVE)
+
+Q(NameError)
+
+Q(NameError)
+
+Q(None)
+
+Q(NoneType)
+
+Q(NotImplemented)
+
+Q(NotImplemented)
+
+Q(NotImplementedError)
+
+Q(NotImplementedError)
+
+Q(OSError)
+
+Q(OSError)
+
+Q(OrderedDict)
+
+Q(OrderedDict)
+
+Q(OrderedDict)
+
+Q(OverflowError)
+
+Q(OverflowError)
+
+Q(PARTIAL)
+
+Q(PIKEVM)
+
+Q(POLLERR)
+
+Q(POLLHUP)
+
+Q(POLLIN)
+
+Q(POLLOUT)
+
+Q(PTR)
+
+Q(PinBase)
+
+Q(PinBase)
+
+Q(RAW)
+
+Q(RGB565)
+
+Q(RGB565)
+
+Q(ROTATE_180)
+
+Q(ROTATE_270)
+
+Q(ROTATE_90)
+
+Q(RingIO)
+
+Q(RingIO)
+
+Q(RuntimeError)
+
+Q(RuntimeError)
+
+Q(SHORT)
+
+Q(SOCK_DGRAM)
+
+Q(SOCK_RAW)
+
+Q(SOCK_STREAM)
+
+Q(SOL_SOCKET)
+
+Q(SO_BROADCAST)
+
+Q(SO_ERROR)
+
+Q(SO_KEEPALIVE)
+
+Q(SO_LINGER)
+
+Q(SO_REUSEADDR)
+
+Q(SSD1680)
+
+Q(SSD1680)
+
+Q(Signal)
+
+Q(Signal)
+
+Q(StopAsyncIteration)
+
+Q(StopAsyncIteration)
+
+Q(StopAsyncIteration)
+
+Q(StopIteration)
+
+Q(StopIteration)
+
+Q(StringIO)
+
+Q(StringIO)
+
+Q(Struct)
+
+Q(Struct)
+
+Q(SyntaxError)
+
+Q(SyntaxError)
+
+Q(SystemExit)
+
+Q(SystemExit)
+
+Q(TCSANOW)
+
+Q(TRANSPOSE)
+
+Q(Task)
+
+Q(Task)
+
+Q(TaskQueue)
+
+Q(TaskQueue)
+
+Q(TextIOWrapper)
+
+Q(TextIOWrapper)
+
+Q(TextIOWrapper)
+
+Q(TypeError)
+
+Q(TypeError)
+
+Q(UINT)
+
+Q(UINT16)
+
+Q(UINT32)
+
+Q(UINT64)
+
+Q(UINT8)
+
+Q(ULONG)
+
+Q(ULONGLONG)
+
+Q(USHORT)
+
+Q(UnicodeError)
+
+Q(UnicodeError)
+
+Q(VOID)
+
+Q(ValueError)
+
+Q(ValueError)
+
+Q(VfsFat)
+
+Q(VfsFat)
+
+Q(VfsFat)
+
+Q(VfsLfs1)
+
+Q(VfsLfs1)
+
+Q(VfsLfs2)
+
+Q(VfsLfs2)
+
+Q(VfsLfs2)
+
+Q(VfsPosix)
+
+Q(VfsPosix)
+
+Q(VfsPosix)
+
+Q(ViperTypeError)
+
+Q(ViperTypeError)
+
+Q(ZLIB)
+
+Q(ZeroDivisionError)
+
+Q(ZeroDivisionError)
+
+Q(_)
+
+Q(_0x0a_)
+
+Q(__abs__)
+
+Q(__add__)
+
+Q(__aenter__)
+
+Q(__aenter__)
+
+Q(__aexit__)
+
+Q(__aexit__)
+
+Q(__aiter__)
+
+Q(__and__)
+
+Q(__anext__)
+
+Q(__bases__)
+
+Q(__bool__)
+
+Q(__build_class__)
+
+Q(__build_class__)
+
+Q(__call__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__class__)
+
+Q(__complex__)
+
+Q(__contains__)
+
+Q(__contains__)
+
+Q(__contains__)
+
+Q(__del__)
+
+Q(__del__)
+
+Q(__del__)
+
+Q(__del__)
+
+Q(__del__)
+
+Q(__delattr__)
+
+Q(__delattr__)
+
+Q(__delattr__)
+
+Q(__delattr__)
+
+Q(__delete__)
+
+Q(__delete__)
+
+Q(__delete__)
+
+Q(__delitem__)
+
+Q(__delitem__)
+
+Q(__dereference__)
+
+Q(__dict__)
+
+Q(__dict__)
+
+Q(__dict__)
+
+Q(__dict__)
+
+Q(__dir__)
+
+Q(__divmod__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__enter__)
+
+Q(__eq__)
+
+Q(__eq__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__exit__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__file__)
+
+Q(__float__)
+
+Q(__floordiv__)
+
+Q(__ge__)
+
+Q(__get__)
+
+Q(__get__)
+
+Q(__get__)
+
+Q(__getattr__)
+
+Q(__getattr__)
+
+Q(__getattr__)
+
+Q(__getattr__)
+
+Q(__getitem__)
+
+Q(__getitem__)
+
+Q(__getitem__)
+
+Q(__getitem__)
+
+Q(__globals__)
+
+Q(__gt__)
+
+Q(__hash__)
+
+Q(__iadd__)
+
+Q(__import__)
+
+Q(__import__)
+
+Q(__init__)
+
+Q(__init__)
+
+Q(__init__)
+
+Q(__init__)
+
+Q(__init__)
+
+Q(__int__)
+
+Q(__invert__)
+
+Q(__isub__)
+
+Q(__iter__)
+
+Q(__le__)
+
+Q(__len__)
+
+Q(__lshift__)
+
+Q(__lt__)
+
+Q(__main__)
+
+Q(__main__)
+
+Q(__main__)
+
+Q(__main__)
+
+Q(__main__)
+
+Q(__main__)
+
+Q(__main__)
+
+Q(__matmul__)
+
+Q(__mod__)
+
+Q(__module__)
+
+Q(__module__)
+
+Q(__mul__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__name__)
+
+Q(__ne__)
+
+Q(__neg__)
+
+Q(__new__)
+
+Q(__new__)
+
+Q(__new__)
+
+Q(__next__)
+
+Q(__next__)
+
+Q(__next__)
+
+Q(__next__)
+
+Q(__next__)
+
+Q(__or__)
+
+Q(__path__)
+
+Q(__path__)
+
+Q(__path__)
+
+Q(__path__)
+
+Q(__path__)
+
+Q(__pos__)
+
+Q(__pow__)
+
+Q(__qualname__)
+
+Q(__radd__)
+
+Q(__rand__)
+
+Q(__repl_print__)
+
+Q(__repl_print__)
+
+Q(__repr__)
+
+Q(__repr__)
+
+Q(__reversed__)
+
+Q(__rfloordiv__)
+
+Q(__rlshift__)
+
+Q(__rmatmul__)
+
+Q(__rmod__)
+
+Q(__rmul__)
+
+Q(__ror__)
+
+Q(__rpow__)
+
+Q(__rrshift__)
+
+Q(__rshift__)
+
+Q(__rsub__)
+
+Q(__rtruediv__)
+
+Q(__rxor__)
+
+Q(__set__)
+
+Q(__set__)
+
+Q(__set__)
+
+Q(__setattr__)
+
+Q(__setattr__)
+
+Q(__setattr__)
+
+Q(__setattr__)
+
+Q(__setitem__)
+
+Q(__setitem__)
+
+Q(__str__)
+
+Q(__sub__)
+
+Q(__traceback__)
+
+Q(__truediv__)
+
+Q(__xor__)
+
+Q(_asyncio)
+
+Q(_asyncio)
+
+Q(_brace_open__colon__hash_b_brace_close_)
+
+Q(_dot__dot__dot__space_)
+
+Q(_gt__gt__gt__space_)
+
+Q(_lt_dictcomp_gt_)
+
+Q(_lt_dictcomp_gt_)
+
+Q(_lt_genexpr_gt_)
+
+Q(_lt_genexpr_gt_)
+
+Q(_lt_lambda_gt_)
+
+Q(_lt_lambda_gt_)
+
+Q(_lt_listcomp_gt_)
+
+Q(_lt_listcomp_gt_)
+
+Q(_lt_module_gt_)
+
+Q(_lt_module_gt_)
+
+Q(_lt_other_gt_)
+
+Q(_lt_setcomp_gt_)
+
+Q(_lt_setcomp_gt_)
+
+Q(_lt_stdin_gt_)
+
+Q(_lt_stdin_gt_)
+
+Q(_lt_stdin_gt_)
+
+Q(_lt_string_gt_)
+
+Q(_lt_unknown_gt_)
+
+Q(_machine)
+
+Q(_mpy)
+
+Q(_percent__hash_o)
+
+Q(_percent__hash_x)
+
+Q(_slash_)
+
+Q(_slash_)
+
+Q(_slash_)
+
+Q(_slash_)
+
+Q(_slash_)
+
+Q(_slash_)
+
+Q(_slash_)
+
+Q(_space_)
+
+Q(_star_)
+
+Q(_star_)
+
+Q(_star_)
+
+Q(_task_queue)
+
+Q(_thread)
+
+Q(_thread)
+
+Q(a2b_base64)
+
+Q(abs)
+
+Q(abs_tol)
+
+Q(accept)
+
+Q(acos)
+
+Q(acosh)
+
+Q(acquire)
+
+Q(add)
+
+Q(addressof)
+
+Q(all)
+
+Q(allocate_lock)
+
+Q(any)
+
+Q(any)
+
+Q(append)
+
+Q(append)
+
+Q(append)
+
+Q(appendleft)
+
+Q(area)
+
+Q(args)
+
+Q(argv)
+
+Q(array)
+
+Q(array)
+
+Q(array)
+
+Q(array)
+
+Q(asin)
+
+Q(asinh)
+
+Q(atan)
+
+Q(atan2)
+
+Q(atanh)
+
+Q(atexit)
+
+Q(b2a_base64)
+
+Q(bin)
+
+Q(binascii)
+
+Q(binascii)
+
+Q(bind)
+
+Q(black)
+
+Q(blit)
+
+Q(bool)
+
+Q(bool)
+
+Q(bool)
+
+Q(bool)
+
+Q(bound_method)
+
+Q(buffer)
+
+Q(buffering)
+
+Q(builtins)
+
+Q(builtins)
+
+Q(busy)
+
+Q(busy)
+
+Q(bytearray)
+
+Q(bytearray)
+
+Q(bytearray_at)
+
+Q(bytecode)
+
+Q(byteorder)
+
+Q(bytes)
+
+Q(bytes)
+
+Q(bytes)
+
+Q(bytes_at)
+
+Q(calcsize)
+
+Q(callable)
+
+Q(cancel)
+
+Q(ceil)
+
+Q(center)
+
+Q(chdir)
+
+Q(chdir)
+
+Q(chdir)
+
+Q(chdir)
+
+Q(chdir)
+
+Q(chdir)
+
+Q(choice)
+
+Q(chr)
+
+Q(classmethod)
+
+Q(classmethod)
+
+Q(clear)
+
+Q(clear)
+
+Q(clear)
+
+Q(clear)
+
+Q(clear_dirty)
+
+Q(clock)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(close)
+
+Q(closure)
+
+Q(cmath)
+
+Q(cmath)
+
+Q(code)
+
+Q(collect)
+
+Q(collections)
+
+Q(collections)
+
+Q(collections)
+
+Q(color_format)
+
+Q(compile)
+
+Q(compile)
+
+Q(complex)
+
+Q(complex)
+
+Q(connect)
+
+Q(const)
+
+Q(const)
+
+Q(convert_rgb565_tri)
+
+Q(copy)
+
+Q(copy)
+
+Q(copy)
+
+Q(copy)
+
+Q(copysign)
+
+Q(coro)
+
+Q(cos)
+
+Q(cos)
+
+Q(cosh)
+
+Q(count)
+
+Q(count)
+
+Q(count)
+
+Q(count)
+
+Q(crc32)
+
+Q(cs)
+
+Q(cur_task)
+
+Q(cur_task)
+
+Q(data)
+
+Q(data)
+
+Q(dc)
+
+Q(decode)
+
+Q(default)
+
+Q(deflate)
+
+Q(deflate)
+
+Q(degrees)
+
+Q(delattr)
+
+Q(deleter)
+
+Q(deque)
+
+Q(deque)
+
+Q(dict)
+
+Q(dict)
+
+Q(dict_view)
+
+Q(difference)
+
+Q(difference)
+
+Q(difference_update)
+
+Q(digest)
+
+Q(dir)
+
+Q(dirty)
+
+Q(disable)
+
+Q(discard)
+
+Q(divmod)
+
+Q(doc)
+
+Q(done)
+
+Q(dump)
+
+Q(dumps)
+
+Q(e)
+
+Q(e)
+
+Q(ellipse)
+
+Q(enable)
+
+Q(encode)
+
+Q(encoding)
+
+Q(end)
+
+Q(endswith)
+
+Q(enumerate)
+
+Q(enumerate)
+
+Q(epaper)
+
+Q(epaper)
+
+Q(erf)
+
+Q(erfc)
+
+Q(errno)
+
+Q(errno)
+
+Q(errno)
+
+Q(errno)
+
+Q(errno)
+
+Q(errorcode)
+
+Q(eval)
+
+Q(eval)
+
+Q(exc_info)
+
+Q(exec)
+
+Q(exec)
+
+Q(execfile)
+
+Q(executable)
+
+Q(exit)
+
+Q(exit)
+
+Q(exp)
+
+Q(exp)
+
+Q(expm1)
+
+Q(extend)
+
+Q(extend)
+
+Q(extend)
+
+Q(fabs)
+
+Q(factorial)
+
+Q(file)
+
+Q(file)
+
+Q(fileno)
+
+Q(fileno)
+
+Q(fill)
+
+Q(fill_rect)
+
+Q(filter)
+
+Q(filter)
+
+Q(find)
+
+Q(float)
+
+Q(float)
+
+Q(floor)
+
+Q(flush)
+
+Q(flush)
+
+Q(flush)
+
+Q(flush)
+
+Q(flush_cb)
+
+Q(flush_is_last)
+
+Q(flush_ready)
+
+Q(fmod)
+
+Q(format)
+
+Q(format)
+
+Q(framebuf)
+
+Q(framebuf)
+
+Q(free)
+
+Q(free_runs)
+
+Q(frexp)
+
+Q(from_bytes)
+
+Q(fromhex)
+
+Q(fromkeys)
+
+Q(frozenset)
+
+Q(frozenset)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(function)
+
+Q(gamma)
+
+Q(gc)
+
+Q(gc)
+
+Q(generator)
+
+Q(generator)
+
+Q(generator)
+
+Q(get)
+
+Q(get_ident)
+
+Q(getaddrinfo)
+
+Q(getattr)
+
+Q(getcwd)
+
+Q(getcwd)
+
+Q(getcwd)
+
+Q(getcwd)
+
+Q(getcwd)
+
+Q(getenv)
+
+Q(getrandbits)
+
+Q(getter)
+
+Q(getvalue)
+
+Q(globals)
+
+Q(gmtime)
+
+Q(group)
+
+Q(hasattr)
+
+Q(hash)
+
+Q(hashlib)
+
+Q(hashlib)
+
+Q(heap_lock)
+
+Q(heap_unlock)
+
+Q(heapify)
+
+Q(heappop)
+
+Q(heappush)
+
+Q(heapq)
+
+Q(heapq)
+
+Q(height)
+
+Q(help)
+
+Q(hex)
+
+Q(hex)
+
+Q(hexlify)
+
+Q(hline)
+
+Q(id)
+
+Q(idle)
+
+Q(ilistdir)
+
+Q(ilistdir)
+
+Q(ilistdir)
+
+Q(ilistdir)
+
+Q(ilistdir)
+
+Q(ilistdir)
+
+Q(imag)
+
+Q(implementation)
+
+Q(index)
+
+Q(index)
+
+Q(index)
+
+Q(indices)
+
+Q(inet_ntop)
+
+Q(inet_pton)
+
+Q(inf)
+
+Q(init)
+
+Q(input)
+
+Q(insert)
+
+Q(int)
+
+Q(int)
+
+Q(int)
+
+Q(int)
+
+Q(intersection)
+
+Q(intersection)
+
+Q(intersection_update)
+
+Q(invert)
+
+Q(io)
+
+Q(io)
+
+Q(ioctl)
+
+Q(ioctl)
+
+Q(ioctl)
+
+Q(ipoll)
+
+Q(isalpha)
+
+Q(isclose)
+
+Q(isdigit)
+
+Q(isdisjoint)
+
+Q(isdisjoint)
+
+Q(isenabled)
+
+Q(isfinite)
+
+Q(isinf)
+
+Q(isinstance)
+
+Q(islower)
+
+Q(isnan)
+
+Q(isspace)
+
+Q(issubclass)
+
+Q(issubset)
+
+Q(issubset)
+
+Q(issuperset)
+
+Q(issuperset)
+
+Q(isupper)
+
+Q(items)
+
+Q(iter)
+
+Q(iter_unpack)
+
+Q(iterable)
+
+Q(iterator)
+
+Q(iterator)
+
+Q(iterator)
+
+Q(iterator)
+
+Q(iterator)
+
+Q(iterator)
+
+Q(iterator)
+
+Q(join)
+
+Q(json)
+
+Q(json)
+
+Q(kbd_intr)
+
+Q(keepends)
+
+Q(key)
+
+Q(key)
+
+Q(keys)
+
+Q(keys)
+
+Q(ldexp)
+
+Q(len)
+
+Q(lgamma)
+
+Q(libc_ver)
+
+Q(line)
+
+Q(list)
+
+Q(list)
+
+Q(listdir)
+
+Q(listen)
+
+Q(little)
+
+Q(little)
+
+Q(little)
+
+Q(load)
+
+Q(load_into)
+
+Q(loads)
+
+Q(locals)
+
+Q(localtime)
+
+Q(lock)
+
+Q(locked)
+
+Q(log)
+
+Q(log)
+
+Q(log10)
+
+Q(log10)
+
+Q(log2)
+
+Q(lookahead)
+
+Q(lower)
+
+Q(lstrip)
+
+Q(machine)
+
+Q(machine)
+
+Q(makefile)
+
+Q(map)
+
+Q(map)
+
+Q(mark_us)
+
+Q(mark_us_max)
+
+Q(mark_us_total)
+
+Q(match)
+
+Q(match)
+
+Q(match)
+
+Q(math)
+
+Q(math)
+
+Q(max)
+
+Q(max_free)
+
+Q(maximum_space_recursion_space_depth_space_exceeded)
+
+Q(maxsize)
+
+Q(mem)
+
+Q(mem16)
+
+Q(mem32)
+
+Q(mem8)
+
+Q(mem_alloc)
+
+Q(mem_current)
+
+Q(mem_free)
+
+Q(mem_info)
+
+Q(mem_peak)
+
+Q(mem_total)
+
+Q(memoryview)
+
+Q(memoryview)
+
+Q(micropython)
+
+Q(micropython)
+
+Q(micropython)
+
+Q(micropython)
+
+Q(min)
+
+Q(mkdir)
+
+Q(mkdir)
+
+Q(mkdir)
+
+Q(mkdir)
+
+Q(mkdir)
+
+Q(mkfs)
+
+Q(mkfs)
+
+Q(mkfs)
+
+Q(mktime)
+
+Q(mode)
+
+Q(modf)
+
+Q(modify)
+
+Q(module)
+
+Q(modules)
+
+Q(modules)
+
+Q(mount)
+
+Q(mount)
+
+Q(mount)
+
+Q(mount)
+
+Q(mount)
+
+Q(mount)
+
+Q(mount)
+
+Q(mtime)
+
+Q(name)
+
+Q(namedtuple)
+
+Q(nan)
+
+Q(native)
+
+Q(newline)
+
+Q(next)
+
+Q(object)
+
+Q(object)
+
+Q(object)
+
+Q(object)
+
+Q(oct)
+
+Q(off)
+
+Q(on)
+
+Q(open)
+
+Q(open)
+
+Q(open)
+
+Q(open)
+
+Q(open)
+
+Q(open)
+
+Q(opt_level)
+
+Q(ord)
+
+Q(os)
+
+Q(os)
+
+Q(pack)
+
+Q(pack)
+
+Q(pack_into)
+
+Q(pack_into)
+
+Q(partition)
+
+Q(path)
+
+Q(peek)
+
+Q(pend_throw)
+
+Q(ph_key)
+
+Q(phase)
+
+Q(pi)
+
+Q(pi)
+
+Q(pixel)
+
+Q(platform)
+
+Q(platform)
+
+Q(platform)
+
+Q(platform)
+
+Q(polar)
+
+Q(poll)
+
+Q(poll)
+
+Q(poll)
+
+Q(poly)
+
+Q(pop)
+
+Q(pop)
+
+Q(pop)
+
+Q(pop)
+
+Q(pop)
+
+Q(popitem)
+
+Q(popleft)
+
+Q(pow)
+
+Q(pow)
+
+Q(print)
+
+Q(print_exception)
+
+Q(profile_start)
+
+Q(profile_stop)
+
+Q(progsize)
+
+Q(property)
+
+Q(property)
+
+Q(ps1)
+
+Q(ps2)
+
+Q(ptr)
+
+Q(ptr)
+
+Q(ptr16)
+
+Q(ptr16)
+
+Q(ptr32)
+
+Q(ptr32)
+
+Q(ptr8)
+
+Q(ptr8)
+
+Q(push)
+
+Q(putenv)
+
+Q(python_compiler)
+
+Q(qstr_info)
+
+Q(r)
+
+Q(radians)
+
+Q(ram_x_offset)
+
+Q(randint)
+
+Q(random)
+
+Q(random)
+
+Q(random)
+
+Q(randrange)
+
+Q(range)
+
+Q(range)
+
+Q(range)
+
+Q(rb)
+
+Q(re)
+
+Q(re)
+
+Q(re)
+
+Q(read)
+
+Q(read)
+
+Q(read)
+
+Q(read)
+
+Q(read)
+
+Q(read)
+
+Q(read)
+
+Q(read)
+
+Q(readblocks)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readinto)
+
+Q(readline)
+
+Q(readline)
+
+Q(readline)
+
+Q(readline)
+
+Q(readline)
+
+Q(readline)
+
+Q(readline)
+
+Q(readline)
+
+Q(readlines)
+
+Q(readlines)
+
+Q(readlines)
+
+Q(readonly)
+
+Q(readsize)
+
+Q(real)
+
+Q(reclaimed)
+
+Q(reclaimed_total)
+
+Q(rect)
+
+Q(rect)
+
+Q(recv)
+
+Q(recvfrom)
+
+Q(red)
+
+Q(refresh)
+
+Q(register)
+
+Q(rel_tol)
+
+Q(release)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(remove)
+
+Q(rename)
+
+Q(rename)
+
+Q(rename)
+
+Q(rename)
+
+Q(rename)
+
+Q(replace)
+
+Q(repr)
+
+Q(reset)
+
+Q(reverse)
+
+Q(reverse)
+
+Q(reverse)
+
+Q(reversed)
+
+Q(reversed)
+
+Q(rfind)
+
+Q(rindex)
+
+Q(rmdir)
+
+Q(rmdir)
+
+Q(rmdir)
+
+Q(rmdir)
+
+Q(rmdir)
+
+Q(rotate)
+
+Q(round)
+
+Q(rpartition)
+
+Q(rsplit)
+
+Q(rst)
+
+Q(rstrip)
+
+Q(schedule)
+
+Q(scroll)
+
+Q(search)
+
+Q(search)
+
+Q(seed)
+
+Q(seek)
+
+Q(seek)
+
+Q(seek)
+
+Q(seek)
+
+Q(select)
+
+Q(select)
+
+Q(send)
+
+Q(send)
+
+Q(send)
+
+Q(sendto)
+
+Q(sep)
+
+Q(sep)
+
+Q(separators)
+
+Q(set)
+
+Q(set)
+
+Q(setattr)
+
+Q(setblocking)
+
+Q(setblocking)
+
+Q(setdefault)
+
+Q(setraw)
+
+Q(setsockopt)
+
+Q(setter)
+
+Q(settimeout)
+
+Q(sha256)
+
+Q(sha256)
+
+Q(sin)
+
+Q(sin)
+
+Q(single)
+
+Q(sinh)
+
+Q(size)
+
+Q(sizeof)
+
+Q(sleep)
+
+Q(sleep)
+
+Q(sleep_ms)
+
+Q(sleep_us)
+
+Q(slice)
+
+Q(slice)
+
+Q(snapshot)
+
+Q(sockaddr)
+
+Q(socket)
+
+Q(socket)
+
+Q(socket)
+
+Q(socket)
+
+Q(soft_reset)
+
+Q(sort)
+
+Q(sorted)
+
+Q(spi)
+
+Q(split)
+
+Q(split)
+
+Q(splitlines)
+
+Q(sqrt)
+
+Q(sqrt)
+
+Q(src)
+
+Q(stack_size)
+
+Q(stack_use)
+
+Q(start)
+
+Q(start)
+
+Q(start)
+
+Q(start_new_thread)
+
+Q(startswith)
+
+Q(stat)
+
+Q(stat)
+
+Q(stat)
+
+Q(stat)
+
+Q(stat)
+
+Q(stat)
+
+Q(state)
+
+Q(state)
+
+Q(staticmethod)
+
+Q(staticmethod)
+
+Q(stats)
+
+Q(stats_callback)
+
+Q(statvfs)
+
+Q(statvfs)
+
+Q(statvfs)
+
+Q(statvfs)
+
+Q(statvfs)
+
+Q(stderr)
+
+Q(stdin)
+
+Q(stdout)
+
+Q(step)
+
+Q(step)
+
+Q(stop)
+
+Q(stop)
+
+Q(str)
+
+Q(str)
+
+Q(str)
+
+Q(str)
+
+Q(strip)
+
+Q(struct)
+
+Q(struct)
+
+Q(struct)
+
+Q(struct)
+
+Q(sub)
+
+Q(sub)
+
+Q(sum)
+
+Q(super)
+
+Q(super)
+
+Q(super)
+
+Q(sweep_steps)
+
+Q(sweep_us)
+
+Q(sweep_us_max)
+
+Q(sweep_us_total)
+
+Q(symmetric_difference)
+
+Q(symmetric_difference)
+
+Q(symmetric_difference_update)
+
+Q(sync)
+
+Q(sys)
+
+Q(sys)
+
+Q(system)
+
+Q(tan)
+
+Q(tanh)
+
+Q(tau)
+
+Q(tcgetattr)
+
+Q(tcsetattr)
+
+Q(tell)
+
+Q(tell)
+
+Q(tell)
+
+Q(tell)
+
+Q(termios)
+
+Q(termios)
+
+Q(text)
+
+Q(threshold)
+
+Q(thresholds)
+
+Q(thresholds)
+
+Q(throw)
+
+Q(throw)
+
+Q(ticks_add)
+
+Q(ticks_cpu)
+
+Q(ticks_diff)
+
+Q(ticks_ms)
+
+Q(ticks_us)
+
+Q(time)
+
+Q(time)
+
+Q(time)
+
+Q(time_ns)
+
+Q(time_pulse_us)
+
+Q(to_bytes)
+
+Q(trace_diff)
+
+Q(trace_snapshot)
+
+Q(trace_start)
+
+Q(trace_stop)
+
+Q(trunc)
+
+Q(tuple)
+
+Q(tuple)
+
+Q(tuple)
+
+Q(type)
+
+Q(type)
+
+Q(uctypes)
+
+Q(uctypes)
+
+Q(uctypes)
+
+Q(uint)
+
+Q(uint)
+
+Q(umount)
+
+Q(umount)
+
+Q(umount)
+
+Q(umount)
+
+Q(umount)
+
+Q(umount)
+
+Q(unhexlify)
+
+Q(uniform)
+
+Q(union)
+
+Q(union)
+
+Q(unlink)
+
+Q(unpack)
+
+Q(unpack)
+
+Q(unpack_from)
+
+Q(unpack_from)
+
+Q(unregister)
+
+Q(unsetenv)
+
+Q(update)
+
+Q(update)
+
+Q(update)
+
+Q(upper)
+
+Q(urandom)
+
+Q(usys)
+
+Q(utf_hyphen_8)
+
+Q(utf_hyphen_8)
+
+Q(value)
+
+Q(value)
+
+Q(value)
+
+Q(value)
+
+Q(values)
+
+Q(version)
+
+Q(version)
+
+Q(version_info)
+
+Q(vfs)
+
+Q(vfs)
+
+Q(viper)
+
+Q(vline)
+
+Q(wait)
+
+Q(wb)
+
+Q(websocket)
+
+Q(websocket)
+
+Q(websocket)
+
+Q(websocket)
+
+Q(width)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write)
+
+Q(write_area)
+
+Q(writeblocks)
+
+Q(x1)
+
+Q(x2)
+
+Q(y1)
+
+Q(y2)
+
+Q(zip)
+
+Q(zip)
+
+Q(zip)
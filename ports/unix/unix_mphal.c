@@ -34,6 +34,7 @@
 #include "py/mphal.h"
 #include "py/mpthread.h"
 #include "py/runtime.h"
+#include "py/profile.h"
 #include "extmod/misc.h"
 
 #if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
@@ -72,6 +73,29 @@ static void sighandler(int signum) {
 }
 #endif
 
+#if MICROPY_PY_MICROPYTHON_PROFILE && !defined(_WIN32)
+static void prof_sighandler(int signum) {
+    (void)signum;
+    mp_prof_sample_request();
+}
+
+// Sample at a rate of CPU time used, so blocking calls aren't counted
+void mp_hal_profile_timer(mp_uint_t hz) {
+    struct itimerval it = { { 0, 0 }, { 0, 0 } };
+    if (hz != 0) {
+        struct sigaction sa;
+        sa.sa_flags = SA_RESTART;
+        sa.sa_handler = prof_sighandler;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGPROF, &sa, NULL);
+        it.it_interval.tv_sec = 1 / hz;
+        it.it_interval.tv_usec = 1000000 / hz % 1000000;
+        it.it_value = it.it_interval;
+    }
+    setitimer(ITIMER_PROF, &it, NULL);
+}
+#endif
+
 void mp_hal_set_interrupt_char(char c) {
     // configure terminal settings to (not) let ctrl-C through
     if (c == CHAR_CTRL_C) {
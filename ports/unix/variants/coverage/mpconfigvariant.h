@@ -42,3 +42,11 @@
 #define MICROPY_TRACKED_ALLOC          (1)
 #define MICROPY_WARNINGS_CATEGORY      (1)
 #define MICROPY_PY_CRYPTOLIB_CTR       (1)
+
+// Execute .mpy files in place from mapped files.  This is not enabled in the
+// other variants because modifying a file while its code is in use crashes.
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (1)
+
+// Cache directory listings for import.  This is not enabled in the other
+// variants because the cache doesn't see files created by other processes.
+#define MICROPY_VFS_IMPORT_CACHE       (1)
@@ -51,6 +51,72 @@
 #define MICROPY_LONGINT_IMPL           (MICROPY_LONGINT_IMPL_MPZ)
 #endif
 
+// Keep free lists of small multi-block runs in the GC.
+#ifndef MICROPY_GC_SIZE_CLASSES
+#define MICROPY_GC_SIZE_CLASSES        (8)
+#endif
+
+// Index large ordered maps.
+#ifndef MICROPY_OPT_MAP_ORDERED_INDEX
+#define MICROPY_OPT_MAP_ORDERED_INDEX  (1)
+#endif
+
+// Cache attribute lookups by type and attribute name, 64 entries per thread.
+#ifndef MICROPY_OPT_ATTR_CACHE
+#define MICROPY_OPT_ATTR_CACHE         (1)
+#endif
+#ifndef MICROPY_OPT_ATTR_CACHE_SIZE
+#define MICROPY_OPT_ATTR_CACHE_SIZE    (64)
+#endif
+
+// Use sub-quadratic algorithms for large mpz integers.
+#ifndef MICROPY_OPT_MPZ_FAST_MUL
+#define MICROPY_OPT_MPZ_FAST_MUL       (1)
+#endif
+
+// Share str objects between equal short strs created at runtime.
+#ifndef MICROPY_OPT_STR_INTERN
+#define MICROPY_OPT_STR_INTERN         (1)
+#endif
+
+// Sweep the heap in steps after automatic collections.
+#ifndef MICROPY_GC_INCREMENTAL_SWEEP
+#define MICROPY_GC_INCREMENTAL_SWEEP   (1)
+#endif
+
+// Index the runtime qstr pools so interning many names stays fast.
+#ifndef MICROPY_QSTR_POOL_INDEX
+#define MICROPY_QSTR_POOL_INDEX        (1)
+#endif
+
+// Intern short JSON dict keys, and provide json.load_into.
+#ifndef MICROPY_PY_JSON_INTERN_KEYS
+#define MICROPY_PY_JSON_INTERN_KEYS    (32)
+#endif
+#ifndef MICROPY_PY_JSON_LOAD_INTO
+#define MICROPY_PY_JSON_LOAD_INTO      (1)
+#endif
+
+// Provide a sampling profiler in the "micropython" module.
+#ifndef MICROPY_PY_MICROPYTHON_PROFILE
+#define MICROPY_PY_MICROPYTHON_PROFILE (1)
+#endif
+
+// Count allocations per line of Python code for gc.trace_*.
+#ifndef MICROPY_GC_ALLOC_TRACE
+#define MICROPY_GC_ALLOC_TRACE (1)
+#endif
+
+// Time collections and report fragmentation in gc.stats().
+#ifndef MICROPY_GC_STATS
+#define MICROPY_GC_STATS (1)
+#endif
+
+// Provide the linear-time Pike VM engine for re.
+#ifndef MICROPY_PY_RE_PIKEVM
+#define MICROPY_PY_RE_PIKEVM           (1)
+#endif
+
 // Enable use of C libraries that need read/write/lseek/fsync, e.g. axtls.
 #define MICROPY_STREAMS_POSIX_API      (1)
 
@@ -72,6 +138,20 @@
 // Allow loading of .mpy files.
 #define MICROPY_PERSISTENT_CODE_LOAD   (1)
 
+// Allow snapshots of module state in .mpy files, and saving them.
+#ifndef MICROPY_PERSISTENT_CODE_SNAPSHOT
+#define MICROPY_PERSISTENT_CODE_SNAPSHOT (1)
+#endif
+#ifndef MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+#define MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE (1)
+#define MICROPY_PERSISTENT_CODE_SAVE   (1)
+#endif
+
+// Inline arithmetic and comparisons on small ints in native code.
+#ifndef MICROPY_EMIT_NATIVE_INLINE_SMALL_INT
+#define MICROPY_EMIT_NATIVE_INLINE_SMALL_INT (1)
+#endif
+
 // Extra memory debugging.
 #define MICROPY_MALLOC_USES_ALLOCATED_SIZE (1)
 #define MICROPY_MEM_STATS              (1)
@@ -117,6 +197,9 @@
 // Enable the "websocket" module.
 #define MICROPY_PY_WEBSOCKET           (1)
 
+// Enable the "epaper" module, driven by Python-level SPI and pin objects.
+#define MICROPY_PY_EPAPER              (1)
+
 // Enable the "machine" module, mostly for machine.mem*.
 #define MICROPY_PY_MACHINE             (1)
 #define MICROPY_PY_MACHINE_PULSE       (1)
@@ -96,6 +96,7 @@ static void mp_reader_new_mem_dedent(mp_reader_t *reader, const byte *buf, size_
     reader->data = rm;
     reader->readbyte = mp_reader_mem_dedent_readbyte;
     reader->close = mp_reader_mem_dedent_close;
+    reader->readbytes = NULL;
 }
 
 mp_lexer_t *mp_lexer_new_from_str_len_dedent(qstr src_name, const char *str, size_t len, size_t free_len) {
@@ -65,7 +65,7 @@
 #define OPCODE_SUB_R64_FROM_RM64 (0x29)
 #define OPCODE_SUB_I32_FROM_RM64 (0x81) /* /5 */
 #define OPCODE_SUB_I8_FROM_RM64  (0x83) /* /5 */
-// #define OPCODE_SHL_RM32_BY_I8    (0xc1) /* /4 */
+#define OPCODE_SHL_RM64_BY_I8    (0xc1) /* /4 */
 // #define OPCODE_SHR_RM32_BY_I8    (0xc1) /* /5 */
 // #define OPCODE_SAR_RM32_BY_I8    (0xc1) /* /7 */
 #define OPCODE_SHL_RM64_CL       (0xd3) /* /4 */
@@ -76,6 +76,7 @@
 #define OPCODE_CMP_R64_WITH_RM64 (0x39) /* /r */
 // #define OPCODE_CMP_RM32_WITH_R32 (0x3b)
 #define OPCODE_TEST_R8_WITH_RM8  (0x84) /* /r */
+#define OPCODE_TEST_I8_WITH_RM8  (0xf6) /* /0 */
 #define OPCODE_TEST_R64_WITH_RM64 (0x85) /* /r */
 #define OPCODE_JMP_REL8          (0xeb)
 #define OPCODE_JMP_REL32         (0xe9)
@@ -410,6 +411,22 @@ void asm_x64_mul_r64_r64(asm_x64_t *as, int dest_r64, int src_r64) {
     asm_x64_write_byte_3(as, 0x0f, 0xaf, MODRM_R64(dest_r64) | MODRM_RM_REG | MODRM_RM_R64(src_r64));
 }
 
+void asm_x64_add_r64_i32(asm_x64_t *as, int dest_r64, int src_i32) {
+    // use REX prefix for 64 bit operation
+    if (SIGNED_FIT8(src_i32)) {
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_W | REX_B_FROM_R64(dest_r64), OPCODE_ADD_I8_TO_RM32, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(dest_r64));
+        asm_x64_write_byte_1(as, src_i32 & 0xff);
+    } else {
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_W | REX_B_FROM_R64(dest_r64), OPCODE_ADD_I32_TO_RM32, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(dest_r64));
+        asm_x64_write_word32(as, src_i32);
+    }
+}
+
+void asm_x64_shl_r64_by_imm(asm_x64_t *as, int dest_r64, int imm) {
+    asm_x64_write_byte_3(as, REX_PREFIX | REX_W | REX_B_FROM_R64(dest_r64), OPCODE_SHL_RM64_BY_I8, MODRM_R64(4) | MODRM_RM_REG | MODRM_RM_R64(dest_r64));
+    asm_x64_write_byte_1(as, imm);
+}
+
 /*
 void asm_x64_sub_i32_from_r32(asm_x64_t *as, int src_i32, int dest_r32) {
     if (SIGNED_FIT8(src_i32)) {
@@ -438,11 +455,6 @@ static void asm_x64_sub_r64_i32(asm_x64_t *as, int dest_r64, int src_i32) {
 }
 
 /*
-void asm_x64_shl_r32_by_imm(asm_x64_t *as, int r32, int imm) {
-    asm_x64_write_byte_2(as, OPCODE_SHL_RM32_BY_I8, MODRM_R64(4) | MODRM_RM_REG | MODRM_RM_R64(r32));
-    asm_x64_write_byte_1(as, imm);
-}
-
 void asm_x64_shr_r32_by_imm(asm_x64_t *as, int r32, int imm) {
     asm_x64_write_byte_2(as, OPCODE_SHR_RM32_BY_I8, MODRM_R64(5) | MODRM_RM_REG | MODRM_RM_R64(r32));
     asm_x64_write_byte_1(as, imm);
@@ -476,6 +488,16 @@ void asm_x64_test_r8_with_r8(asm_x64_t *as, int src_r64_a, int src_r64_b) {
     asm_x64_write_byte_2(as, OPCODE_TEST_R8_WITH_RM8, MODRM_R64(src_r64_a) | MODRM_RM_REG | MODRM_RM_R64(src_r64_b));
 }
 
+void asm_x64_test_r8_with_i8(asm_x64_t *as, int src_r64, int src_i8) {
+    if (src_r64 < 4) {
+        asm_x64_write_byte_2(as, OPCODE_TEST_I8_WITH_RM8, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(src_r64));
+    } else {
+        // need a REX prefix to access the low byte of rsp, rbp, rsi, rdi and r8-r15
+        asm_x64_write_byte_3(as, REX_PREFIX | REX_B_FROM_R64(src_r64), OPCODE_TEST_I8_WITH_RM8, MODRM_R64(0) | MODRM_RM_REG | MODRM_RM_R64(src_r64));
+    }
+    asm_x64_write_byte_1(as, src_i8);
+}
+
 void asm_x64_test_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b) {
     asm_x64_generic_r64_r64(as, src_r64_b, src_r64_a, OPCODE_TEST_R64_WITH_RM64);
 }
@@ -545,6 +567,8 @@ void asm_x64_entry(asm_x64_t *as, int num_locals) {
     asm_x64_push_r64(as, ASM_X64_REG_RBX);
     asm_x64_push_r64(as, ASM_X64_REG_R12);
     asm_x64_push_r64(as, ASM_X64_REG_R13);
+    asm_x64_push_r64(as, ASM_X64_REG_R14);
+    asm_x64_push_r64(as, ASM_X64_REG_R15);
     num_locals |= 1; // make it odd so stack is aligned on 16 byte boundary
     asm_x64_sub_r64_i32(as, ASM_X64_REG_RSP, num_locals * WORD_SIZE);
     as->num_locals = num_locals;
@@ -552,6 +576,8 @@ void asm_x64_entry(asm_x64_t *as, int num_locals) {
 
 void asm_x64_exit(asm_x64_t *as) {
     asm_x64_sub_r64_i32(as, ASM_X64_REG_RSP, -as->num_locals * WORD_SIZE);
+    asm_x64_pop_r64(as, ASM_X64_REG_R15);
+    asm_x64_pop_r64(as, ASM_X64_REG_R14);
     asm_x64_pop_r64(as, ASM_X64_REG_R13);
     asm_x64_pop_r64(as, ASM_X64_REG_R12);
     asm_x64_pop_r64(as, ASM_X64_REG_RBX);
@@ -60,6 +60,7 @@
 #define ASM_X64_REG_R15 (15)
 
 // condition codes, used for jcc and setcc (despite their j-name!)
+#define ASM_X64_CC_JO  (0x0) // overflow, signed
 #define ASM_X64_CC_JB  (0x2) // below, unsigned
 #define ASM_X64_CC_JAE (0x3) // above or equal, unsigned
 #define ASM_X64_CC_JZ  (0x4)
@@ -108,8 +109,11 @@ void asm_x64_sar_r64_cl(asm_x64_t *as, int dest_r64);
 void asm_x64_add_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
 void asm_x64_sub_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
 void asm_x64_mul_r64_r64(asm_x64_t *as, int dest_r64, int src_r64);
+void asm_x64_add_r64_i32(asm_x64_t *as, int dest_r64, int src_i32);
+void asm_x64_shl_r64_by_imm(asm_x64_t *as, int dest_r64, int imm);
 void asm_x64_cmp_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b);
 void asm_x64_test_r8_with_r8(asm_x64_t *as, int src_r64_a, int src_r64_b);
+void asm_x64_test_r8_with_i8(asm_x64_t *as, int src_r64, int src_i8);
 void asm_x64_test_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b);
 void asm_x64_setcc_r8(asm_x64_t *as, int jcc_type, int dest_r8);
 void asm_x64_jmp_reg(asm_x64_t *as, int src_r64);
@@ -149,7 +153,9 @@ void asm_x64_call_ind(asm_x64_t *as, size_t fun_id, int temp_r32);
 #define REG_LOCAL_1 ASM_X64_REG_RBX
 #define REG_LOCAL_2 ASM_X64_REG_R12
 #define REG_LOCAL_3 ASM_X64_REG_R13
-#define REG_LOCAL_NUM (3)
+#define REG_LOCAL_4 ASM_X64_REG_R14
+#define REG_LOCAL_5 ASM_X64_REG_R15
+#define REG_LOCAL_NUM (5)
 
 // Holds a pointer to mp_fun_table
 #define REG_FUN_TABLE ASM_X64_REG_FUN_TABLE
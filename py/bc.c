@@ -325,8 +325,10 @@ void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw
     #if MICROPY_STACKLESS
     code_state->prev = NULL;
     #endif
-    #if MICROPY_PY_SYS_SETTRACE
+    #if MICROPY_VM_CODE_STATE_CHAIN
     code_state->prev_state = NULL;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE
     code_state->frame = NULL;
     #endif
     mp_setup_code_state_helper(code_state, n_args, n_kw, args);
@@ -343,3 +345,28 @@ void mp_setup_code_state_native(mp_code_state_native_t *code_state, size_t n_arg
     mp_setup_code_state_helper((mp_code_state_t *)code_state, n_args, n_kw, args);
 }
 #endif
+
+#if MICROPY_PY_MICROPYTHON_PROFILE || MICROPY_GC_ALLOC_TRACE
+// Print the position offset bytes into a bytecode function as
+// "function (file:line)"
+void mp_bytecode_print_location(const mp_print_t *print, const mp_obj_fun_bc_t *fun_bc, size_t offset) {
+    const byte *ip = fun_bc->bytecode;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    const byte *line_info_top = ip + n_info;
+    const byte *bytecode_start = ip + n_info + n_cell;
+    qstr block_name = mp_decode_uint_value(ip);
+    for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
+        ip = mp_decode_uint_skip(ip);
+    }
+    #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+    block_name = fun_bc->context->constants.qstr_table[block_name];
+    qstr source_file = fun_bc->context->constants.qstr_table[0];
+    #else
+    qstr source_file = fun_bc->context->constants.source_file;
+    #endif
+    size_t bc = fun_bc->bytecode + offset - bytecode_start;
+    size_t source_line = mp_bytecode_get_source_line(ip, line_info_top, bc);
+    mp_printf(print, "%q (%q:%u)", block_name, source_file, (uint)source_line);
+}
+#endif
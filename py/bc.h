@@ -218,15 +218,24 @@ typedef struct _mp_compiled_module_t {
     const struct _mp_raw_code_t *rc;
     #if MICROPY_PERSISTENT_CODE_SAVE
     bool has_native;
-    size_t n_qstr;
     size_t n_obj;
     #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_PERSISTENT_CODE_SNAPSHOT
+    size_t n_qstr;
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SNAPSHOT
+    const byte *snapshot; // snapshot of the module's state, if any
+    size_t snapshot_len;
+    #endif
 } mp_compiled_module_t;
 
 // Outer level struct defining a frozen module.
 typedef struct _mp_frozen_module_t {
     const mp_module_constants_t constants;
     const void *proto_fun;
+    #if MICROPY_PERSISTENT_CODE_SNAPSHOT
+    const byte *snapshot; // snapshot of the module's state (prefixed by the size of qstr_table and its length), or NULL
+    #endif
 } mp_frozen_module_t;
 
 // State for an executing function.
@@ -244,8 +253,10 @@ typedef struct _mp_code_state_t {
     #if MICROPY_STACKLESS
     struct _mp_code_state_t *prev;
     #endif
-    #if MICROPY_PY_SYS_SETTRACE
+    #if MICROPY_VM_CODE_STATE_CHAIN
     struct _mp_code_state_t *prev_state;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE
     struct _mp_obj_frame_t *frame;
     #endif
     // Variable-length
@@ -285,6 +296,7 @@ void mp_bytecode_print(const mp_print_t *print, const struct _mp_raw_code_t *rc,
 void mp_bytecode_print2(const mp_print_t *print, const byte *ip, size_t len, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
 const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start, const byte *ip, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
 #define mp_bytecode_print_inst(print, code, x_table) mp_bytecode_print2(print, code, 1, x_table)
+void mp_bytecode_print_location(const mp_print_t *print, const struct _mp_obj_fun_bc_t *fun_bc, size_t offset);
 
 // Helper macros to access pointer with least significant bits holding flags
 #define MP_TAGPTR_PTR(x) ((void *)((uintptr_t)(x) & ~((uintptr_t)3)))
@@ -196,6 +196,19 @@ static void do_execute_proto_fun(const mp_module_context_t *context, mp_proto_fu
 }
 #endif
 
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT && (MICROPY_HAS_FILE_READER || MICROPY_MODULE_FROZEN_MPY)
+static void do_restore_snapshot(const mp_module_context_t *context, size_t n_qstr, mp_proto_fun_t proto_fun, mp_reader_t *reader, qstr source_name) {
+    #if MICROPY_PY___FILE__
+    mp_store_attr(MP_OBJ_FROM_PTR(&context->module), MP_QSTR___file__, MP_OBJ_NEW_QSTR(source_name));
+    #else
+    (void)source_name;
+    #endif
+
+    // recreate the state of the module from its snapshot, instead of executing it
+    mp_raw_code_load_snapshot(reader, context, n_qstr, proto_fun);
+}
+#endif
+
 static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     #if MICROPY_MODULE_FROZEN || MICROPY_ENABLE_COMPILER || (MICROPY_PERSISTENT_CODE_LOAD && MICROPY_HAS_FILE_READER)
     const char *file_str = vstr_null_terminated_str(file);
@@ -230,6 +243,17 @@ static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
             #else
             qstr frozen_file_qstr = MP_QSTRnull;
             #endif
+            #if MICROPY_PERSISTENT_CODE_SNAPSHOT
+            if (frozen->snapshot != NULL) {
+                const byte *snapshot = frozen->snapshot;
+                size_t n_qstr = mp_decode_uint(&snapshot);
+                size_t snapshot_len = mp_decode_uint(&snapshot);
+                mp_reader_t reader;
+                mp_reader_new_mem(&reader, snapshot, snapshot_len, MP_READER_IS_ROM);
+                do_restore_snapshot(module_obj, n_qstr, frozen->proto_fun, &reader, frozen_file_qstr);
+                return;
+            }
+            #endif
             do_execute_proto_fun(module_obj, frozen->proto_fun, frozen_file_qstr);
             return;
         }
@@ -247,6 +271,14 @@ static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
         mp_compiled_module_t cm;
         cm.context = module_obj;
         mp_raw_code_load_file(file_qstr, &cm);
+        #if MICROPY_PERSISTENT_CODE_SNAPSHOT
+        if (cm.snapshot != NULL) {
+            mp_reader_t reader;
+            mp_reader_new_mem(&reader, cm.snapshot, cm.snapshot_len, 0);
+            do_restore_snapshot(cm.context, cm.n_qstr, cm.rc, &reader, file_qstr);
+            return;
+        }
+        #endif
         do_execute_proto_fun(cm.context, cm.rc, file_qstr);
         return;
     }
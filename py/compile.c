@@ -290,6 +290,13 @@ static void reserve_labels_for_native(compiler_t *comp, int n) {
 #define reserve_labels_for_native(comp, n)
 #endif
 
+static void c_binary_op(compiler_t *comp, mp_binary_op_t op) {
+    EMIT_ARG(binary_op, op);
+    #if MICROPY_EMIT_NATIVE_INLINE_SMALL_INT
+    reserve_labels_for_native(comp, 3); // used by native's binary_op
+    #endif
+}
+
 static void compile_increase_except_level(compiler_t *comp, uint label, int kind) {
     EMIT_ARG(setup_block, label, kind);
     comp->cur_except_level += 1;
@@ -1449,7 +1456,7 @@ static void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
 
     // compile: var + step
     compile_node(comp, pn_step);
-    EMIT_ARG(binary_op, MP_BINARY_OP_INPLACE_ADD);
+    c_binary_op(comp, MP_BINARY_OP_INPLACE_ADD);
 
     EMIT_ARG(label_assign, entry_label);
 
@@ -1463,9 +1470,9 @@ static void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
     }
     assert(MP_PARSE_NODE_IS_SMALL_INT(pn_step));
     if (MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) >= 0) {
-        EMIT_ARG(binary_op, MP_BINARY_OP_LESS);
+        c_binary_op(comp, MP_BINARY_OP_LESS);
     } else {
-        EMIT_ARG(binary_op, MP_BINARY_OP_MORE);
+        c_binary_op(comp, MP_BINARY_OP_MORE);
     }
     EMIT_ARG(pop_jump_if, true, top_label);
 
@@ -1629,7 +1636,7 @@ static void compile_try_except(compiler_t *comp, mp_parse_node_t pn_body, int n_
             }
             EMIT(dup_top);
             compile_node(comp, pns_exception_expr);
-            EMIT_ARG(binary_op, MP_BINARY_OP_EXCEPTION_MATCH);
+            c_binary_op(comp, MP_BINARY_OP_EXCEPTION_MATCH);
             EMIT_ARG(pop_jump_if, false, end_finally_label);
         }
 
@@ -1824,7 +1831,7 @@ static void compile_async_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns
     EMIT(start_except_handler);
     EMIT(dup_top);
     EMIT_LOAD_GLOBAL(MP_QSTR_StopAsyncIteration);
-    EMIT_ARG(binary_op, MP_BINARY_OP_EXCEPTION_MATCH);
+    c_binary_op(comp, MP_BINARY_OP_EXCEPTION_MATCH);
     EMIT_ARG(pop_jump_if, false, try_finally_label);
     EMIT(pop_top); // pop exception instance
     EMIT_ARG(pop_except_jump, while_else_label, true);
@@ -2041,7 +2048,7 @@ static void compile_expr_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
             assert(MP_PARSE_NODE_IS_TOKEN(pns1->nodes[0]));
             mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(pns1->nodes[0]);
             mp_binary_op_t op = MP_BINARY_OP_INPLACE_OR + (tok - MP_TOKEN_DEL_PIPE_EQUAL);
-            EMIT_ARG(binary_op, op);
+            c_binary_op(comp, op);
             c_assign(comp, pns->nodes[0], ASSIGN_AUG_STORE); // lhs store for aug assign
         } else if (kind == PN_expr_stmt_assign_list) {
             int rhs = MP_PARSE_NODE_STRUCT_NUM_NODES(pns1) - 1;
@@ -2219,19 +2226,19 @@ static void compile_comparison(compiler_t *comp, mp_parse_node_struct_t *pns) {
             } else {
                 op = MP_BINARY_OP_LESS + (tok - MP_TOKEN_OP_LESS);
             }
-            EMIT_ARG(binary_op, op);
+            c_binary_op(comp, op);
         } else {
             assert(MP_PARSE_NODE_IS_STRUCT(pns->nodes[i])); // should be
             mp_parse_node_struct_t *pns2 = (mp_parse_node_struct_t *)pns->nodes[i];
             int kind = MP_PARSE_NODE_STRUCT_KIND(pns2);
             if (kind == PN_comp_op_not_in) {
-                EMIT_ARG(binary_op, MP_BINARY_OP_NOT_IN);
+                c_binary_op(comp, MP_BINARY_OP_NOT_IN);
             } else {
                 assert(kind == PN_comp_op_is); // should be
                 if (MP_PARSE_NODE_IS_NULL(pns2->nodes[0])) {
-                    EMIT_ARG(binary_op, MP_BINARY_OP_IS);
+                    c_binary_op(comp, MP_BINARY_OP_IS);
                 } else {
-                    EMIT_ARG(binary_op, MP_BINARY_OP_IS_NOT);
+                    c_binary_op(comp, MP_BINARY_OP_IS_NOT);
                 }
             }
         }
@@ -2262,7 +2269,7 @@ static void compile_binary_op(compiler_t *comp, mp_parse_node_struct_t *pns) {
     compile_node(comp, pns->nodes[0]);
     for (int i = 1; i < num_nodes; ++i) {
         compile_node(comp, pns->nodes[i]);
-        EMIT_ARG(binary_op, binary_op);
+        c_binary_op(comp, binary_op);
     }
 }
 
@@ -2273,7 +2280,7 @@ static void compile_term(compiler_t *comp, mp_parse_node_struct_t *pns) {
         compile_node(comp, pns->nodes[i + 1]);
         mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(pns->nodes[i]);
         mp_binary_op_t op = MP_BINARY_OP_LSHIFT + (tok - MP_TOKEN_OP_DBL_LESS);
-        EMIT_ARG(binary_op, op);
+        c_binary_op(comp, op);
     }
 }
 
@@ -2388,7 +2395,7 @@ static void compile_atom_expr_normal(compiler_t *comp, mp_parse_node_struct_t *p
 
 static void compile_power(compiler_t *comp, mp_parse_node_struct_t *pns) {
     compile_generic_all_nodes(comp, pns); // 2 nodes, arguments of power
-    EMIT_ARG(binary_op, MP_BINARY_OP_POWER);
+    c_binary_op(comp, MP_BINARY_OP_POWER);
 }
 
 static void compile_trailer_paren_helper(compiler_t *comp, mp_parse_node_t pn_arglist, bool is_method_call, int n_positional_extra) {
@@ -79,7 +79,11 @@ typedef struct _mp_raw_code_t {
     struct _mp_raw_code_t **children;
     #if MICROPY_PERSISTENT_CODE_SAVE
     uint32_t fun_data_len; // for mp_raw_code_save
-    uint16_t n_children;
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_PERSISTENT_CODE_SNAPSHOT
+    uint16_t n_children; // for mp_raw_code_save, and to check snapshots
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE
     #if MICROPY_EMIT_MACHINE_CODE
     uint16_t prelude_offset;
     #endif
@@ -109,7 +113,11 @@ typedef struct _mp_raw_code_truncated_t {
     struct _mp_raw_code_t **children;
     #if MICROPY_PERSISTENT_CODE_SAVE
     uint32_t fun_data_len;
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_PERSISTENT_CODE_SNAPSHOT
     uint16_t n_children;
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE
     #if MICROPY_EMIT_MACHINE_CODE
     uint16_t prelude_offset;
     #endif
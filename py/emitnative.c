@@ -86,7 +86,7 @@
 //  emit->code_state_start:     fun_obj, old_globals [optional]
 //  emit->stack_start:          Python object stack             | emit->n_state
 //                              locals (reversed, L0 at end)    |
-//                              (L0-L2 may be in regs instead)
+//                              (some locals may be in regs instead)
 
 // Native emitter needs to know the following sizes and offsets of C structs (on the target):
 #if MICROPY_DYNAMIC_COMPILER
@@ -136,6 +136,10 @@
 // their state at the start of the function and updates to locals will be lost)
 #define CAN_USE_REGS_FOR_LOCALS(emit) ((emit)->scope->exc_stack_size == 0 && !(emit->scope->scope_flags & MP_SCOPE_FLAG_GENERATOR))
 
+// Whether binary ops on objects have inline code for when both args are small ints
+#define CAN_INLINE_SMALL_INT (MICROPY_EMIT_NATIVE_INLINE_SMALL_INT && N_X64 \
+    && MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A && MICROPY_OBJ_IMMEDIATE_OBJS)
+
 // Indices within the local C stack for various variables
 #define LOCAL_IDX_EXC_VAL(emit) (NLR_BUF_IDX_RET_VAL)
 #define LOCAL_IDX_EXC_HANDLER_PC(emit) (NLR_BUF_IDX_LOCAL_1)
@@ -152,28 +156,41 @@
 // When building with the ability to save native code to .mpy files:
 //  - Qstrs are indirect via qstr_table, and REG_LOCAL_3 always points to qstr_table.
 //  - In a generator no registers are used to store locals, and REG_LOCAL_2 points to the generator state.
-//  - At most 2 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible).
+//  - At most 2 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible),
+//    or 4 on architectures with 5 local registers.
 
 #define REG_GENERATOR_STATE (REG_LOCAL_2)
 #define REG_QSTR_TABLE (REG_LOCAL_3)
+#ifdef REG_LOCAL_5
+#define MAX_REGS_FOR_LOCAL_VARS (4)
+static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_4, REG_LOCAL_5};
+#else
 #define MAX_REGS_FOR_LOCAL_VARS (2)
-
 static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, REG_LOCAL_2};
+#endif
 
 #else
 
 // When building without the ability to save native code to .mpy files:
 //  - Qstrs values are written directly into the machine code.
 //  - In a generator no registers are used to store locals, and REG_LOCAL_3 points to the generator state.
-//  - At most 3 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible).
+//  - At most 3 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible),
+//    or 5 on architectures with 5 local registers.
 
 #define REG_GENERATOR_STATE (REG_LOCAL_3)
+#ifdef REG_LOCAL_5
+#define MAX_REGS_FOR_LOCAL_VARS (5)
+static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3, REG_LOCAL_4, REG_LOCAL_5};
+#else
 #define MAX_REGS_FOR_LOCAL_VARS (3)
-
 static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3};
+#endif
 
 #endif
 
+// Marks an entry of reg_local_num that doesn't hold a local variable
+#define REG_LOCAL_UNUSED (0xffff)
+
 #define REG_LOCAL_LAST (reg_local_table[MAX_REGS_FOR_LOCAL_VARS - 1])
 
 #define EMIT_NATIVE_VIPER_TYPE_ERROR(emit, ...) do { \
@@ -253,6 +270,18 @@ typedef struct _exc_stack_entry_t {
     uint16_t is_active : 1;
 } exc_stack_entry_t;
 
+// A load or store of a local variable, at a position in the machine code
+typedef struct _local_use_t {
+    uint32_t code_pos;
+    uint16_t local_num;
+} local_use_t;
+
+// A loop, spanning machine code from a label up to a backwards jump to it
+typedef struct _loop_span_t {
+    uint32_t start;
+    uint32_t end;
+} loop_span_t;
+
 struct _emit_t {
     mp_emit_common_t *emit_common;
     mp_obj_t *error_slot;
@@ -273,6 +302,23 @@ struct _emit_t {
     size_t exc_stack_size;
     exc_stack_entry_t *exc_stack;
 
+    // The local held in each register of reg_local_table, chosen at the end of
+    // MP_PASS_STACK_SIZE from the uses of locals recorded during that pass.
+    uint16_t reg_local_num[MAX_REGS_FOR_LOCAL_VARS];
+    size_t local_use_alloc;
+    size_t local_use_len;
+    local_use_t *local_use;
+    size_t loop_alloc;
+    size_t loop_len;
+    loop_span_t *loop;
+
+    #if CAN_INLINE_SMALL_INT
+    // Code position just after an inline comparison left its result in REG_RET,
+    // and the spare label reserved by that comparison.
+    size_t compare_code_pos;
+    mp_uint_t compare_label;
+    #endif
+
     int prelude_offset;
     int prelude_ptr_index;
     int start_offset;
@@ -311,6 +357,8 @@ void EXPORT_FUN(free)(emit_t * emit) {
     mp_asm_base_deinit(&emit->as->base, false);
     m_del_obj(ASM_T, emit->as);
     m_del(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc);
+    m_del(local_use_t, emit->local_use, emit->local_use_alloc);
+    m_del(loop_span_t, emit->loop, emit->loop_alloc);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
     m_del_obj(emit_t, emit);
@@ -372,6 +420,90 @@ static void emit_native_mov_reg_qstr_obj(emit_t *emit, int reg_dest, qstr qst) {
         emit_native_mov_state_reg((emit), (local_num), (reg_temp)); \
     } while (false)
 
+// Return the register that holds the given local, or -1 if it's in the state
+static int emit_native_local_reg(emit_t *emit, mp_uint_t local_num) {
+    if (CAN_USE_REGS_FOR_LOCALS(emit)) {
+        for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+            if (emit->reg_local_num[i] == local_num) {
+                return reg_local_table[i];
+            }
+        }
+    }
+    return -1;
+}
+
+// Record a load or store of a local, for use by emit_native_alloc_local_regs
+static void emit_native_record_local_use(emit_t *emit, mp_uint_t local_num) {
+    if (emit->pass != MP_PASS_STACK_SIZE) {
+        return;
+    }
+    if (emit->local_use_len >= emit->local_use_alloc) {
+        size_t new_alloc = emit->local_use_alloc * 2 + 16;
+        emit->local_use = m_renew(local_use_t, emit->local_use, emit->local_use_alloc, new_alloc);
+        emit->local_use_alloc = new_alloc;
+    }
+    local_use_t *use = &emit->local_use[emit->local_use_len++];
+    use->code_pos = mp_asm_base_get_code_pos(&emit->as->base);
+    use->local_num = local_num;
+}
+
+// Record a jump, which closes a loop if it goes backwards to an assigned label
+static void emit_native_record_jump(emit_t *emit, mp_uint_t label) {
+    if (emit->pass != MP_PASS_STACK_SIZE) {
+        return;
+    }
+    size_t target = emit->as->base.label_offsets[label];
+    if (target == (size_t)-1) {
+        // Forward jump
+        return;
+    }
+    if (emit->loop_len >= emit->loop_alloc) {
+        size_t new_alloc = emit->loop_alloc * 2 + 4;
+        emit->loop = m_renew(loop_span_t, emit->loop, emit->loop_alloc, new_alloc);
+        emit->loop_alloc = new_alloc;
+    }
+    loop_span_t *loop = &emit->loop[emit->loop_len++];
+    loop->start = target;
+    loop->end = mp_asm_base_get_code_pos(&emit->as->base);
+}
+
+// Choose which locals to keep in registers, based on the uses recorded during
+// MP_PASS_STACK_SIZE.  A local lives for the whole function so there are no live
+// ranges to split, and the registers simply go to the locals with the highest
+// weight, where each use counts 8 times more for every loop it's nested in.
+static void emit_native_alloc_local_regs(emit_t *emit) {
+    size_t num_locals = emit->scope->num_locals;
+    if (num_locals == 0 || !CAN_USE_REGS_FOR_LOCALS(emit)) {
+        return;
+    }
+    uint32_t *weight = m_new0(uint32_t, num_locals);
+    for (size_t i = 0; i < emit->local_use_len; ++i) {
+        local_use_t *use = &emit->local_use[i];
+        unsigned int depth = 0;
+        for (size_t j = 0; j < emit->loop_len; ++j) {
+            if (emit->loop[j].start <= use->code_pos && use->code_pos <= emit->loop[j].end) {
+                ++depth;
+            }
+        }
+        uint32_t w = (uint32_t)1 << (3 * MIN(depth, 7));
+        weight[use->local_num] = weight[use->local_num] > UINT32_MAX - w ? UINT32_MAX : weight[use->local_num] + w;
+    }
+    for (int r = 0; r < MAX_REGS_FOR_LOCAL_VARS; ++r) {
+        size_t best = 0;
+        for (size_t i = 1; i < num_locals; ++i) {
+            if (weight[i] > weight[best]) {
+                best = i;
+            }
+        }
+        if (weight[best] == 0) {
+            break;
+        }
+        emit->reg_local_num[r] = best;
+        weight[best] = 0;
+    }
+    m_del(uint32_t, weight, num_locals);
+}
+
 static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     DEBUG_printf("start_pass(pass=%u, scope=%p)\n", pass, scope);
 
@@ -380,6 +512,18 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
     emit->stack_size = 0;
     emit->scope = scope;
 
+    // locals are only put in registers once their uses are known
+    if (pass == MP_PASS_STACK_SIZE) {
+        for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+            emit->reg_local_num[i] = REG_LOCAL_UNUSED;
+        }
+        emit->local_use_len = 0;
+        emit->loop_len = 0;
+    }
+    #if CAN_INLINE_SMALL_INT
+    emit->compare_code_pos = (size_t)-1;
+    #endif
+
     // allocate memory for keeping track of the types of locals
     if (emit->local_vtype_alloc < scope->num_locals) {
         emit->local_vtype = m_renew(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc, scope->num_locals);
@@ -442,17 +586,6 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         // Work out size of state (locals plus stack)
         // n_state counts all stack and locals, even those in registers
         emit->n_state = scope->num_locals + scope->stack_size;
-        int num_locals_in_regs = 0;
-        if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            num_locals_in_regs = scope->num_locals;
-            if (num_locals_in_regs > MAX_REGS_FOR_LOCAL_VARS) {
-                num_locals_in_regs = MAX_REGS_FOR_LOCAL_VARS;
-            }
-            // Need a spot for REG_LOCAL_LAST (see below)
-            if (scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1) {
-                --num_locals_in_regs;
-            }
-        }
 
         // Work out where the locals and Python stack start within the C stack
         if (NEED_GLOBAL_EXC_HANDLER(emit)) {
@@ -466,7 +599,7 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         }
 
         // Entry to function
-        ASM_ENTRY(emit->as, emit->stack_start + emit->n_state - num_locals_in_regs);
+        ASM_ENTRY(emit->as, emit->stack_start + emit->n_state);
 
         #if N_X86
         asm_x86_mov_arg_to_r32(emit->as, 0, REG_PARENT_ARG_1);
@@ -513,16 +646,18 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
                 emit_call_with_imm_arg(emit, MP_F_CONVERT_OBJ_TO_NATIVE, emit->local_vtype[i], REG_ARG_2);
                 r = REG_RET;
             }
-            // REG_LOCAL_LAST points to the args array so be sure not to overwrite it if it's still needed
-            if (i < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit) && (i != MAX_REGS_FOR_LOCAL_VARS - 1 || emit->scope->num_pos_args == MAX_REGS_FOR_LOCAL_VARS)) {
-                ASM_MOV_REG_REG(emit->as, reg_local_table[i], r);
+            // REG_LOCAL_LAST points to the args array so be sure not to overwrite it
+            int reg_local = emit_native_local_reg(emit, i);
+            if (reg_local != -1 && reg_local != REG_LOCAL_LAST) {
+                ASM_MOV_REG_REG(emit->as, reg_local, r);
             } else {
                 emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), r);
             }
         }
         // Get local from the stack back into REG_LOCAL_LAST if this reg couldn't be written to above
-        if (emit->scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1 && CAN_USE_REGS_FOR_LOCALS(emit)) {
-            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, MAX_REGS_FOR_LOCAL_VARS - 1));
+        int last_local_num = emit->reg_local_num[MAX_REGS_FOR_LOCAL_VARS - 1];
+        if (last_local_num < emit->scope->num_pos_args && CAN_USE_REGS_FOR_LOCALS(emit)) {
+            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, last_local_num));
         }
 
         emit_native_global_exc_entry(emit);
@@ -622,8 +757,10 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
 
         // cache some locals in registers, but only if no exception handlers
         if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS && i < scope->num_locals; ++i) {
-                ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, i));
+            for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+                if (emit->reg_local_num[i] != REG_LOCAL_UNUSED) {
+                    ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, emit->reg_local_num[i]));
+                }
             }
         }
 
@@ -695,6 +832,10 @@ static bool emit_native_end_pass(emit_t *emit) {
     assert(emit->stack_size == 0);
     assert(emit->exc_stack_size == 0);
 
+    if (emit->pass == MP_PASS_STACK_SIZE) {
+        emit_native_alloc_local_regs(emit);
+    }
+
     if (emit->pass == MP_PASS_EMIT) {
         void *f = mp_asm_base_get_code(&emit->as->base);
         mp_uint_t f_len = mp_asm_base_get_code_size(&emit->as->base);
@@ -1410,8 +1551,10 @@ static void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("local '%q' used before type known"), qst);
     }
     emit_native_pre(emit);
-    if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_post_push_reg(emit, vtype, reg_local_table[local_num]);
+    emit_native_record_local_use(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local != -1) {
+        emit_post_push_reg(emit, vtype, reg_local);
     } else {
         need_reg_single(emit, REG_TEMP0, 0);
         emit_native_mov_reg_state(emit, REG_TEMP0, LOCAL_IDX_LOCAL_VAR(emit, local_num));
@@ -1656,8 +1799,10 @@ static void emit_native_load_subscr(emit_t *emit) {
 
 static void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
-    if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_pre_pop_reg(emit, &vtype, reg_local_table[local_num]);
+    emit_native_record_local_use(emit, local_num);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local != -1) {
+        emit_pre_pop_reg(emit, &vtype, reg_local);
     } else {
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
         emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, local_num), REG_TEMP0);
@@ -2029,6 +2174,7 @@ static void emit_native_jump(emit_t *emit, mp_uint_t label) {
     emit_native_pre(emit);
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
+    emit_native_record_jump(emit, label);
     ASM_JUMP(emit->as, label);
     emit_post(emit);
     mp_asm_base_suppress_code(&emit->as->base);
@@ -2036,6 +2182,33 @@ static void emit_native_jump(emit_t *emit, mp_uint_t label) {
 
 static void emit_native_jump_helper(emit_t *emit, bool cond, mp_uint_t label, bool pop) {
     vtype_kind_t vtype = peek_vtype(emit, 0);
+    emit_native_record_jump(emit, label);
+    #if CAN_INLINE_SMALL_INT
+    stack_info_t *si = peek_stack(emit, 0);
+    if (pop && vtype == VTYPE_PYOBJ && si->kind == STACK_REG && si->data.u_reg == REG_RET
+        && mp_asm_base_get_code_pos(&emit->as->base) == emit->compare_code_pos) {
+        // The result of an inline comparison is usually True or False, so test
+        // for those directly and only call mp_obj_is_true for other objects.
+        mp_uint_t label_skip = emit->compare_label;
+        emit_pre_pop_reg(emit, &vtype, REG_RET);
+        need_stack_settled(emit);
+        ASM_MOV_REG_IMM(emit->as, REG_ARG_1, (mp_uint_t)mp_const_true);
+        ASM_JUMP_IF_REG_EQ(emit->as, REG_RET, REG_ARG_1, cond ? label : label_skip);
+        ASM_MOV_REG_IMM(emit->as, REG_ARG_1, (mp_uint_t)mp_const_false);
+        ASM_JUMP_IF_REG_EQ(emit->as, REG_RET, REG_ARG_1, cond ? label_skip : label);
+        ASM_MOV_REG_REG(emit->as, REG_ARG_1, REG_RET);
+        emit_call(emit, MP_F_OBJ_IS_TRUE);
+        if (cond) {
+            ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label, true);
+        } else {
+            ASM_JUMP_IF_REG_ZERO(emit->as, REG_RET, label, true);
+        }
+        mp_asm_base_label_assign(&emit->as->base, label_skip);
+        emit_post(emit);
+        emit->compare_code_pos = (size_t)-1;
+        return;
+    }
+    #endif
     if (vtype == VTYPE_PYOBJ) {
         emit_pre_pop_reg(emit, &vtype, REG_ARG_1);
         if (!pop) {
@@ -2386,6 +2559,112 @@ static void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
     }
 }
 
+#if CAN_INLINE_SMALL_INT
+// Emit a binary op on two objects, with inline code for when both are small ints
+// and the result is a small int (or a bool), and a call to mp_binary_op otherwise.
+// Returns false if the op has no inline version.
+// Note: 3 labels are reserved for this function, starting at *emit->label_slot
+static bool emit_native_binary_op_small_int(emit_t *emit, mp_binary_op_t op) {
+    mp_binary_op_t fast_op = op;
+    if (MP_BINARY_OP_INPLACE_OR <= op && op <= MP_BINARY_OP_INPLACE_SUBTRACT) {
+        // small ints are immutable so inplace and normal ops are equivalent
+        fast_op += MP_BINARY_OP_OR - MP_BINARY_OP_INPLACE_OR;
+    }
+    bool is_compare = MP_BINARY_OP_LESS <= fast_op && fast_op <= MP_BINARY_OP_NOT_EQUAL;
+    if (!is_compare && !(MP_BINARY_OP_OR <= fast_op && fast_op <= MP_BINARY_OP_SUBTRACT)) {
+        return false;
+    }
+    if (fast_op == MP_BINARY_OP_LSHIFT || fast_op == MP_BINARY_OP_RSHIFT) {
+        return false;
+    }
+
+    // A small int constant on the right doesn't need its tag checked
+    stack_info_t *si_rhs = peek_stack(emit, 0);
+    bool rhs_is_small_int = si_rhs->kind == STACK_IMM && si_rhs->vtype == VTYPE_INT;
+    mp_int_t rhs_tagged = rhs_is_small_int ? (mp_int_t)MP_OBJ_NEW_SMALL_INT(si_rhs->data.u_imm) : 0;
+
+    vtype_kind_t vtype_lhs, vtype_rhs;
+    emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
+    need_reg_all(emit);
+
+    mp_uint_t label_slow = *emit->label_slot;
+    mp_uint_t label_done = *emit->label_slot + 1;
+
+    // Check that both args are small ints
+    if (rhs_is_small_int) {
+        asm_x64_test_r8_with_i8(emit->as, REG_ARG_2, 1);
+    } else {
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        asm_x64_and_r64_r64(emit->as, REG_RET, REG_ARG_3);
+        asm_x64_test_r8_with_i8(emit->as, REG_RET, 1);
+    }
+    asm_x64_jcc_label(emit->as, ASM_X64_CC_JZ, label_slow);
+
+    // Compute the result into REG_RET, working on the tagged values directly
+    if (is_compare) {
+        static const byte ops[6] = {
+            ASM_X64_CC_JL,
+            ASM_X64_CC_JG,
+            ASM_X64_CC_JE,
+            ASM_X64_CC_JLE,
+            ASM_X64_CC_JGE,
+            ASM_X64_CC_JNE,
+        };
+        assert((mp_int_t)mp_const_true - (mp_int_t)mp_const_false == 16);
+        asm_x64_xor_r64_r64(emit->as, REG_RET, REG_RET);
+        asm_x64_cmp_r64_with_r64(emit->as, REG_ARG_3, REG_ARG_2);
+        asm_x64_setcc_r8(emit->as, ops[fast_op - MP_BINARY_OP_LESS], REG_RET);
+        asm_x64_shl_r64_by_imm(emit->as, REG_RET, 4);
+        asm_x64_add_r64_i32(emit->as, REG_RET, (mp_int_t)mp_const_false);
+    } else if (fast_op == MP_BINARY_OP_ADD) {
+        if (rhs_is_small_int && rhs_tagged - 1 == (int32_t)(rhs_tagged - 1)) {
+            ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+            asm_x64_add_r64_i32(emit->as, REG_RET, rhs_tagged - 1);
+        } else {
+            ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_3);
+            asm_x64_add_r64_i32(emit->as, REG_RET, -1);
+            asm_x64_add_r64_r64(emit->as, REG_RET, REG_ARG_2);
+        }
+        asm_x64_jcc_label(emit->as, ASM_X64_CC_JO, label_slow);
+    } else if (fast_op == MP_BINARY_OP_SUBTRACT) {
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        if (rhs_is_small_int && 1 - rhs_tagged == (int32_t)(1 - rhs_tagged)) {
+            asm_x64_add_r64_i32(emit->as, REG_RET, 1 - rhs_tagged);
+            asm_x64_jcc_label(emit->as, ASM_X64_CC_JO, label_slow);
+        } else {
+            asm_x64_sub_r64_r64(emit->as, REG_RET, REG_ARG_3);
+            asm_x64_jcc_label(emit->as, ASM_X64_CC_JO, label_slow);
+            asm_x64_add_r64_i32(emit->as, REG_RET, 1);
+        }
+    } else {
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        if (fast_op == MP_BINARY_OP_OR) {
+            asm_x64_or_r64_r64(emit->as, REG_RET, REG_ARG_3);
+        } else if (fast_op == MP_BINARY_OP_AND) {
+            asm_x64_and_r64_r64(emit->as, REG_RET, REG_ARG_3);
+        } else {
+            asm_x64_xor_r64_r64(emit->as, REG_RET, REG_ARG_3);
+            asm_x64_add_r64_i32(emit->as, REG_RET, 1);
+        }
+    }
+    ASM_JUMP(emit->as, label_done);
+
+    // Slow path, for other types and for results that don't fit in a small int
+    mp_asm_base_label_assign(&emit->as->base, label_slow);
+    emit_call_with_imm_arg(emit, MP_F_BINARY_OP, op, REG_ARG_1);
+    mp_asm_base_label_assign(&emit->as->base, label_done);
+
+    emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
+
+    if (is_compare) {
+        // Let a following conditional jump test the result without a call
+        emit->compare_code_pos = mp_asm_base_get_code_pos(&emit->as->base);
+        emit->compare_label = *emit->label_slot + 2;
+    }
+    return true;
+}
+#endif
+
 static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
     DEBUG_printf("binary_op(" UINT_FMT ")\n", op);
     vtype_kind_t vtype_lhs = peek_vtype(emit, 1);
@@ -2657,6 +2936,11 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
                 MP_ERROR_TEXT("binary op %q not implemented"), mp_binary_op_method_name[op]);
         }
     } else if (vtype_lhs == VTYPE_PYOBJ && vtype_rhs == VTYPE_PYOBJ) {
+        #if CAN_INLINE_SMALL_INT
+        if (emit_native_binary_op_small_int(emit, op)) {
+            return;
+        }
+        #endif
         emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
         bool invert = false;
         if (op == MP_BINARY_OP_NOT_IN) {
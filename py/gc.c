@@ -32,6 +32,15 @@
 #include "py/gc.h"
 #include "py/runtime.h"
 
+#if MICROPY_GC_ALLOC_TRACE
+#include "py/bc.h"
+#include "py/objfun.h"
+#endif
+
+#if MICROPY_GC_STATS
+#include "py/mphal.h"
+#endif
+
 #if MICROPY_DEBUG_VALGRIND
 #include <valgrind/memcheck.h>
 #endif
@@ -92,6 +101,14 @@
 #define ATB_HEAD_TO_MARK(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_MARK << BLOCK_SHIFT(block)); } while (0)
 #define ATB_MARK_TO_HEAD(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_TAIL << BLOCK_SHIFT(block))); } while (0)
 
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// Outside a collection, a head is still marked if an incremental sweep hasn't
+// reached it yet.
+#define ATB_KIND_IS_HEAD(kind) ((kind) & AT_HEAD)
+#else
+#define ATB_KIND_IS_HEAD(kind) ((kind) == AT_HEAD)
+#endif
+
 #define BLOCK_FROM_PTR(area, ptr) (((byte *)(ptr) - area->gc_pool_start) / BYTES_PER_BLOCK)
 #define PTR_FROM_BLOCK(area, block) (((block) * BYTES_PER_BLOCK + (uintptr_t)area->gc_pool_start))
 
@@ -210,6 +227,26 @@ void gc_init(void *start, void *end) {
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
 
+    #if MICROPY_GC_SIZE_CLASSES
+    // the size-class lists are built by the first sweep
+    memset(MP_STATE_MEM(gc_size_class_free), 0, sizeof(MP_STATE_MEM(gc_size_class_free)));
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    MP_STATE_MEM(gc_sweep).area = NULL;
+    MP_STATE_MEM(gc_sweep_defer) = false;
+    #endif
+
+    #if MICROPY_GC_ALLOC_TRACE
+    // any trace table was in the old heap
+    MP_STATE_VM(gc_trace) = NULL;
+    #endif
+
+    #if MICROPY_GC_STATS
+    memset(&MP_STATE_MEM(gc_stats), 0, sizeof(MP_STATE_MEM(gc_stats)));
+    MP_STATE_VM(gc_stats_callback)[0] = MP_OBJ_NULL;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_MEM(gc_mutex));
     #endif
@@ -370,6 +407,111 @@ static inline mp_state_mem_area_t *gc_get_ptr_area(const void *ptr) {
     && ptr < (void *)MP_STATE_MEM(area).gc_pool_end         /* must be below end of pool */ \
     )
 
+#if MICROPY_GC_SIZE_CLASSES
+
+// Single-block allocations already have a fast path in the table scan (see
+// gc_last_free_atb_index), and taking them from a list would stop that index
+// advancing, so the size classes start at 2 blocks.
+#define GC_SIZE_CLASS_MIN_BLOCKS (2)
+#define GC_SIZE_CLASS(n_blocks) ((n_blocks) - GC_SIZE_CLASS_MIN_BLOCKS)
+#define GC_NUM_SIZE_CLASSES (MICROPY_GC_SIZE_CLASSES - 1)
+
+// Maximum number of list entries looked at by one allocation.
+#define GC_SIZE_CLASS_MAX_TRIES (8)
+
+// A free run of blocks on a size-class list.  This lives in the first block of
+// the run itself.  The lists are only hints: since a run was listed its blocks
+// may have been allocated by a table scan, and perhaps freed again, overwriting
+// the entry.  So entries carry a check word, and runs are checked against the
+// allocation table before use.
+typedef struct _gc_free_run_t {
+    struct _gc_free_run_t *next;
+    size_t n_blocks;
+    uintptr_t check;
+} gc_free_run_t;
+
+#define GC_FREE_RUN_CHECK(run) (((uintptr_t)(run)->next + (run)->n_blocks) ^ ~(uintptr_t)(run))
+
+static inline void gc_free_run_set(gc_free_run_t *run, gc_free_run_t *next, size_t n_blocks) {
+    run->next = next;
+    run->n_blocks = n_blocks;
+    run->check = GC_FREE_RUN_CHECK(run);
+}
+
+static inline gc_free_run_t **gc_size_class_list(size_t n_blocks) {
+    return (gc_free_run_t **)&MP_STATE_MEM(gc_size_class_free)[GC_SIZE_CLASS(MIN(n_blocks, MICROPY_GC_SIZE_CLASSES))];
+}
+
+// Add a free run of n_blocks blocks to the front of its size-class list.
+static void gc_size_class_push(mp_state_mem_area_t *area, size_t block, size_t n_blocks) {
+    if (n_blocks < GC_SIZE_CLASS_MIN_BLOCKS) {
+        return;
+    }
+    gc_free_run_t **list = gc_size_class_list(n_blocks);
+    gc_free_run_t *run = (gc_free_run_t *)PTR_FROM_BLOCK(area, block);
+    gc_free_run_set(run, *list, n_blocks);
+    *list = run;
+}
+
+// Return the area of a listed run if its entry is intact.
+static mp_state_mem_area_t *gc_free_run_area(gc_free_run_t *run) {
+    mp_state_mem_area_t *area;
+    #if MICROPY_GC_SPLIT_HEAP
+    area = gc_get_ptr_area(run);
+    #else
+    area = VERIFY_PTR((void *)run) ? &MP_STATE_MEM(area) : NULL;
+    #endif
+    if (area == NULL
+        || ATB_GET_KIND(area, BLOCK_FROM_PTR(area, run)) != AT_FREE
+        || run->check != GC_FREE_RUN_CHECK(run)) {
+        return NULL;
+    }
+    return area;
+}
+
+// Take a free run of n_blocks blocks from the smallest suitable size class,
+// putting any remainder of the run back on its list.
+static bool gc_size_class_take(size_t n_blocks, mp_state_mem_area_t **area_out, size_t *block_out) {
+    for (size_t n = MIN(n_blocks, MICROPY_GC_SIZE_CLASSES); n <= MICROPY_GC_SIZE_CLASSES; n++) {
+        gc_free_run_t **list = gc_size_class_list(n);
+        for (size_t tries = 0; *list != NULL; tries++) {
+            gc_free_run_t *run = *list;
+            mp_state_mem_area_t *area = gc_free_run_area(run);
+            if (area == NULL || tries == GC_SIZE_CLASS_MAX_TRIES) {
+                // drop the rest of the list; it's rebuilt by the next sweep
+                *list = NULL;
+                break;
+            }
+            size_t block = BLOCK_FROM_PTR(area, run);
+            size_t run_blocks = MIN(run->n_blocks, area->gc_alloc_table_byte_len * BLOCKS_PER_ATB - block);
+            if (run_blocks < n_blocks) {
+                // only possible for allocations larger than the largest class
+                break;
+            }
+            // only the blocks being claimed are checked, the rest of the run
+            // stays a hint
+            size_t n_free = 1;
+            while (n_free < n_blocks && ATB_GET_KIND(area, block + n_free) == AT_FREE) {
+                n_free++;
+            }
+            *list = run->next;
+            if (n_free == n_blocks) {
+                if (run_blocks > n_blocks && ATB_GET_KIND(area, block + n_blocks) == AT_FREE) {
+                    gc_size_class_push(area, block + n_blocks, run_blocks - n_blocks);
+                }
+                *area_out = area;
+                *block_out = block;
+                return true;
+            }
+            // part of the run has since been allocated; keep what's left
+            gc_size_class_push(area, block, n_free);
+        }
+    }
+    return false;
+}
+
+#endif // MICROPY_GC_SIZE_CLASSES
+
 #ifndef TRACE_MARK
 #if DEBUG_PRINT
 #define TRACE_MARK(block, ptr) DEBUG_printf("gc_mark(%p)\n", ptr)
@@ -477,24 +619,110 @@ static void gc_deal_with_stack_overflow(void) {
     }
 }
 
-static void gc_sweep(void) {
+#if MICROPY_GC_SIZE_CLASSES
+// Append a free run to its size-class list, given the last run on each list.
+static void gc_sweep_add_free_run(mp_state_mem_sweep_t *sweep, mp_state_mem_area_t *area, size_t block, size_t n_blocks) {
+    if (n_blocks < GC_SIZE_CLASS_MIN_BLOCKS) {
+        return;
+    }
+    size_t c = GC_SIZE_CLASS(MIN(n_blocks, MICROPY_GC_SIZE_CLASSES));
+    gc_free_run_t *run = (gc_free_run_t *)PTR_FROM_BLOCK(area, block);
+    gc_free_run_t *tail = sweep->size_class_tail[c];
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // the tail may have been allocated since the last step
+    if (tail != NULL && gc_free_run_area(tail) == NULL) {
+        tail = NULL;
+    }
+    #endif
+    if (tail == NULL) {
+        gc_free_run_set(run, MP_STATE_MEM(gc_size_class_free)[c], n_blocks);
+        MP_STATE_MEM(gc_size_class_free)[c] = run;
+    } else {
+        gc_free_run_set(run, tail->next, n_blocks);
+        gc_free_run_set(tail, run, tail->n_blocks);
+    }
+    sweep->size_class_tail[c] = run;
+}
+#endif
+
+#if MICROPY_GC_STATS
+// Function to schedule after each collection, and its argument.
+MP_REGISTER_ROOT_POINTER(mp_obj_t gc_stats_callback[2]);
+
+// Account for a step of a sweep, which is the whole sweep unless incremental.
+static void gc_stats_sweep_step(mp_uint_t start, size_t n_reclaimed, bool finished) {
+    mp_state_mem_stats_t *stats = &MP_STATE_MEM(gc_stats);
+    stats->sweep_us_cur += mp_hal_ticks_us() - start;
+    stats->sweep_steps_cur++;
+    stats->reclaimed_cur += n_reclaimed;
+    if (finished) {
+        stats->sweep_steps = stats->sweep_steps_cur;
+        stats->sweep_us = stats->sweep_us_cur;
+        stats->sweep_us_max = MAX(stats->sweep_us_max, stats->sweep_us);
+        stats->sweep_us_total += stats->sweep_us;
+        stats->reclaimed = stats->reclaimed_cur;
+        stats->reclaimed_total += stats->reclaimed;
+        #if MICROPY_ENABLE_SCHEDULER
+        // the callback runs later, when Python code can allocate again
+        if (MP_STATE_VM(gc_stats_callback)[0] != MP_OBJ_NULL) {
+            mp_sched_schedule(MP_STATE_VM(gc_stats_callback)[0], MP_STATE_VM(gc_stats_callback)[1]);
+        }
+        #endif
+    }
+}
+#endif
+
+static void gc_sweep_start(mp_state_mem_sweep_t *sweep) {
     #if MICROPY_PY_GC_COLLECT_RETVAL
     MP_STATE_MEM(gc_collected) = 0;
     #endif
+    #if MICROPY_GC_STATS
+    MP_STATE_MEM(gc_stats).sweep_us_cur = 0;
+    MP_STATE_MEM(gc_stats).sweep_steps_cur = 0;
+    MP_STATE_MEM(gc_stats).reclaimed_cur = 0;
+    #endif
+    #if MICROPY_GC_SIZE_CLASSES
+    // rebuild the size-class lists from the free runs found by this sweep,
+    // appending so that the lowest runs are used first
+    for (size_t c = 0; c < GC_NUM_SIZE_CLASSES; c++) {
+        MP_STATE_MEM(gc_size_class_free)[c] = NULL;
+        sweep->size_class_tail[c] = NULL;
+    }
+    #endif
+    sweep->area = &MP_STATE_MEM(area);
+    #if MICROPY_GC_SPLIT_HEAP_AUTO
+    sweep->prev_area = NULL;
+    #endif
+    sweep->block = 0;
+    sweep->last_used_block = 0;
+    sweep->n_free = 0;
+}
+
+// Sweep at most max_blocks blocks, stopping early once a free run of at least
+// want_blocks blocks has been found.  Returns true if the sweep is finished.
+static bool gc_sweep_step(mp_state_mem_sweep_t *sweep, size_t max_blocks, size_t want_blocks) {
     // free unmarked heads and their tails
+    mp_state_mem_area_t *area = sweep->area;
+    size_t block = sweep->block;
+    size_t last_used_block = sweep->last_used_block;
     int free_tail = 0;
-    #if MICROPY_GC_SPLIT_HEAP_AUTO
-    mp_state_mem_area_t *prev_area = NULL;
+    size_t n_free = sweep->n_free;
+    #if MICROPY_GC_STATS
+    mp_uint_t start = mp_hal_ticks_us();
+    size_t n_reclaimed = 0;
     #endif
-    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+    while (area != NULL) {
         size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
         if (area->gc_last_used_block < end_block) {
             end_block = area->gc_last_used_block + 1;
         }
+        size_t stop_block = end_block;
+        if (max_blocks < end_block - block) {
+            stop_block = block + max_blocks;
+        }
+        max_blocks -= stop_block - block;
 
-        size_t last_used_block = 0;
-
-        for (size_t block = 0; block < end_block; block++) {
+        for (; block < stop_block; block++) {
             MICROPY_GC_HOOK_LOOP(block);
             switch (ATB_GET_KIND(area, block)) {
                 case AT_HEAD:
@@ -525,6 +753,18 @@ static void gc_sweep(void) {
                     #if MICROPY_PY_GC_COLLECT_RETVAL
                     MP_STATE_MEM(gc_collected)++;
                     #endif
+                    #if MICROPY_GC_INCREMENTAL_SWEEP
+                    // allocations may have moved past this block since the
+                    // sweep started (see gc_free)
+                    #if MICROPY_GC_SPLIT_HEAP
+                    if (MP_STATE_MEM(gc_last_free_area) != area) {
+                        MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+                    }
+                    #endif
+                    if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+                        area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
+                    }
+                    #endif
                     // fall through to free the head
                     MP_FALLTHROUGH
 
@@ -534,6 +774,9 @@ static void gc_sweep(void) {
                         #if CLEAR_ON_SWEEP
                         memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
                         #endif
+                        #if MICROPY_GC_STATS
+                        n_reclaimed++;
+                        #endif
                     } else {
                         last_used_block = block;
                     }
@@ -545,30 +788,136 @@ static void gc_sweep(void) {
                     last_used_block = block;
                     break;
             }
+
+            if (ATB_GET_KIND(area, block) == AT_FREE) {
+                n_free++;
+            } else if (n_free > 0) {
+                #if MICROPY_GC_SIZE_CLASSES
+                gc_sweep_add_free_run(sweep, area, block - n_free, n_free);
+                #endif
+                n_free = 0;
+            }
+            if (n_free >= want_blocks) {
+                block++;
+                break;
+            }
+        }
+
+        // Don't pause part way through freeing an object.  Its remaining
+        // tails would follow on from the blocks freed so far, and so would
+        // look like part of whatever is allocated there before the next step.
+        for (; free_tail && block < end_block && ATB_GET_KIND(area, block) == AT_TAIL; block++) {
+            ATB_ANY_TO_FREE(area, block);
+            #if CLEAR_ON_SWEEP
+            memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+            #endif
+            n_free++;
+            #if MICROPY_GC_STATS
+            n_reclaimed++;
+            #endif
         }
 
+        if (block < end_block) {
+            // Pause the sweep.  Until the next step, blocks before this one
+            // may be allocated, so end the current free run here.
+            #if MICROPY_GC_SIZE_CLASSES
+            gc_sweep_add_free_run(sweep, area, block - n_free, n_free);
+            #endif
+            sweep->area = area;
+            sweep->block = block;
+            sweep->last_used_block = last_used_block;
+            sweep->n_free = 0;
+            #if MICROPY_GC_STATS
+            gc_stats_sweep_step(start, n_reclaimed, false);
+            #endif
+            return false;
+        }
+
+        #if MICROPY_GC_SIZE_CLASSES
+        // the last run extends past the swept blocks to the end of the area
+        size_t n_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        gc_sweep_add_free_run(sweep, area, end_block - n_free, n_free + n_blocks - end_block);
+        #endif
+
         area->gc_last_used_block = last_used_block;
 
         #if MICROPY_GC_SPLIT_HEAP_AUTO
         // Free any empty area, aside from the first one
-        if (last_used_block == 0 && prev_area != NULL) {
+        if (last_used_block == 0 && sweep->prev_area != NULL) {
             DEBUG_printf("gc_sweep free empty area %p\n", area);
-            NEXT_AREA(prev_area) = NEXT_AREA(area);
+            NEXT_AREA(sweep->prev_area) = NEXT_AREA(area);
+            #if MICROPY_GC_INCREMENTAL_SWEEP
+            if (MP_STATE_MEM(gc_last_free_area) == area) {
+                MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+            }
+            #endif
             MP_PLAT_FREE_HEAP(area);
-            area = prev_area;
+            area = sweep->prev_area;
         }
-        prev_area = area;
+        sweep->prev_area = area;
         #endif
+
+        area = NEXT_AREA(area);
+        block = 0;
+        last_used_block = 0;
+        n_free = 0;
+    }
+    sweep->area = NULL;
+    #if MICROPY_GC_STATS
+    gc_stats_sweep_step(start, n_reclaimed, true);
+    #endif
+    return true;
+}
+
+#if MICROPY_GC_INCREMENTAL_SWEEP
+
+// Return whether an incremental sweep is yet to reach the given block, in
+// which case a new allocation there must be marked to survive the sweep.  Also
+// make sure the sweep knows about blocks newly in use in the current area.
+static bool gc_sweep_claim(mp_state_mem_area_t *area, size_t start_block, size_t end_block) {
+    mp_state_mem_sweep_t *sweep = &MP_STATE_MEM(gc_sweep);
+    for (mp_state_mem_area_t *a = sweep->area; a != NULL; a = NEXT_AREA(a)) {
+        if (a == area) {
+            if (a != sweep->area || start_block >= sweep->block) {
+                return true;
+            }
+            sweep->last_used_block = MAX(sweep->last_used_block, end_block);
+            break;
+        }
     }
+    return false;
 }
 
+// Finish any sweep in progress.  Must be called with the GC locked.
+static void gc_sweep_finish(void) {
+    if (MP_STATE_MEM(gc_sweep).area != NULL) {
+        gc_sweep_step(&MP_STATE_MEM(gc_sweep), SIZE_MAX, SIZE_MAX);
+    }
+}
+
+#else
+
+static void gc_sweep(void) {
+    mp_state_mem_sweep_t sweep;
+    gc_sweep_start(&sweep);
+    gc_sweep_step(&sweep, SIZE_MAX, SIZE_MAX);
+}
+
+#endif
+
 void gc_collect_start(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_finish();
+    #endif
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
+    #if MICROPY_GC_STATS
+    MP_STATE_MEM(gc_stats).mark_start = mp_hal_ticks_us();
+    #endif
 
     // Trace root pointers.  This relies on the root pointers being organised
     // correctly in the mp_state_ctx structure.  We scan nlr_top, dict_locals,
@@ -632,7 +981,21 @@ void gc_collect_root(void **ptrs, size_t len) {
 
 void gc_collect_end(void) {
     gc_deal_with_stack_overflow();
+    #if MICROPY_GC_STATS
+    mp_state_mem_stats_t *stats = &MP_STATE_MEM(gc_stats);
+    stats->collections++;
+    stats->mark_us = mp_hal_ticks_us() - stats->mark_start;
+    stats->mark_us_max = MAX(stats->mark_us_max, stats->mark_us);
+    stats->mark_us_total += stats->mark_us;
+    #endif
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_start(&MP_STATE_MEM(gc_sweep));
+    if (!MP_STATE_MEM(gc_sweep_defer)) {
+        gc_sweep_finish();
+    }
+    #else
     gc_sweep();
+    #endif
     #if MICROPY_GC_SPLIT_HEAP
     MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
     #endif
@@ -646,10 +1009,28 @@ void gc_collect_end(void) {
 void gc_sweep_all(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    gc_sweep_finish();
+    MP_STATE_MEM(gc_sweep_defer) = false;
+    #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
+    #if MICROPY_GC_STATS
+    MP_STATE_MEM(gc_stats).mark_start = mp_hal_ticks_us();
+    #endif
     gc_collect_end();
 }
 
+#if MICROPY_GC_INCREMENTAL_SWEEP
+// Run an automatic collection, leaving the sweep to later allocations.
+static void gc_collect_deferred(void) {
+    MP_STATE_MEM(gc_sweep_defer) = true;
+    gc_collect();
+    MP_STATE_MEM(gc_sweep_defer) = false;
+}
+#else
+#define gc_collect_deferred gc_collect
+#endif
+
 void gc_info(gc_info_t *info) {
     GC_ENTER();
     info->total = 0;
@@ -659,6 +1040,9 @@ void gc_info(gc_info_t *info) {
     info->num_1block = 0;
     info->num_2block = 0;
     info->max_block = 0;
+    #if MICROPY_GC_STATS
+    memset(info->free_runs, 0, sizeof(info->free_runs));
+    #endif
     for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
         bool finish = false;
         info->total += area->gc_pool_end - area->gc_pool_start;
@@ -673,6 +1057,9 @@ void gc_info(gc_info_t *info) {
                     break;
 
                 case AT_HEAD:
+                #if MICROPY_GC_INCREMENTAL_SWEEP
+                case AT_MARK:
+                #endif
                     info->used += 1;
                     len = 1;
                     break;
@@ -682,9 +1069,11 @@ void gc_info(gc_info_t *info) {
                     len += 1;
                     break;
 
+                #if !MICROPY_GC_INCREMENTAL_SWEEP
                 case AT_MARK:
                     // shouldn't happen
                     break;
+                #endif
             }
 
             block++;
@@ -694,7 +1083,7 @@ void gc_info(gc_info_t *info) {
                 kind = ATB_GET_KIND(area, block);
             }
 
-            if (finish || kind == AT_FREE || kind == AT_HEAD) {
+            if (finish || kind == AT_FREE || ATB_KIND_IS_HEAD(kind)) {
                 if (len == 1) {
                     info->num_1block += 1;
                 } else if (len == 2) {
@@ -703,10 +1092,19 @@ void gc_info(gc_info_t *info) {
                 if (len > info->max_block) {
                     info->max_block = len;
                 }
-                if (finish || kind == AT_HEAD) {
+                if (finish || ATB_KIND_IS_HEAD(kind)) {
                     if (len_free > info->max_free) {
                         info->max_free = len_free;
                     }
+                    #if MICROPY_GC_STATS
+                    if (len_free > 0) {
+                        size_t bucket = 0;
+                        while (bucket < GC_FREE_RUN_BUCKETS - 1 && len_free >> (bucket + 1)) {
+                            bucket++;
+                        }
+                        info->free_runs[bucket] += 1;
+                    }
+                    #endif
                     len_free = 0;
                 }
             }
@@ -723,6 +1121,46 @@ void gc_info(gc_info_t *info) {
     GC_EXIT();
 }
 
+#if MICROPY_GC_ALLOC_TRACE
+// Number of slots to probe before charging an allocation to trace->other.
+#define GC_TRACE_MAX_PROBE (8)
+
+MP_REGISTER_ROOT_POINTER(struct _gc_trace_t *gc_trace);
+
+// Charge an allocation to the bytecode instruction that is running.  This is
+// called with the GC mutex held so must not allocate.
+static void gc_trace_record(size_t n_bytes) {
+    gc_trace_t *trace = MP_STATE_VM(gc_trace);
+    if (trace == NULL) {
+        return;
+    }
+    gc_trace_entry_t *e = &trace->unknown;
+    const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    if (code_state != NULL) {
+        const void *fun_bc = code_state->fun_bc;
+        size_t offset = code_state->ip - code_state->fun_bc->bytecode;
+        size_t mask = trace->alloc - 1;
+        size_t i = (((uintptr_t)fun_bc >> 4) ^ (offset * 31)) & mask;
+        e = &trace->other;
+        for (size_t n = 0; n < GC_TRACE_MAX_PROBE; ++n, i = (i + 1) & mask) {
+            gc_trace_entry_t *slot = &trace->table[i];
+            if (slot->fun_bc == NULL) {
+                slot->fun_bc = fun_bc;
+                slot->offset = offset;
+                e = slot;
+                break;
+            }
+            if (slot->fun_bc == fun_bc && slot->offset == offset) {
+                e = slot;
+                break;
+            }
+        }
+    }
+    e->count += 1;
+    e->bytes += n_bytes;
+}
+#endif
+
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     bool has_finaliser = alloc_flags & GC_ALLOC_FLAG_HAS_FINALISER;
     size_t n_blocks = ((n_bytes + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1))) / BYTES_PER_BLOCK;
@@ -753,14 +1191,30 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     #if MICROPY_GC_ALLOC_THRESHOLD
     if (!collected && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
         GC_EXIT();
-        gc_collect();
+        gc_collect_deferred();
         collected = 1;
         GC_ENTER();
     }
     #endif
 
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // advance any sweep in progress, finalisers must not allocate
+    if (MP_STATE_MEM(gc_sweep).area != NULL) {
+        MP_STATE_THREAD(gc_lock_depth)++;
+        gc_sweep_step(&MP_STATE_MEM(gc_sweep), MICROPY_GC_INCREMENTAL_SWEEP_STEP, SIZE_MAX);
+        MP_STATE_THREAD(gc_lock_depth)--;
+    }
+    #endif
+
     for (;;) {
 
+        #if MICROPY_GC_SIZE_CLASSES
+        if (n_blocks >= GC_SIZE_CLASS_MIN_BLOCKS && gc_size_class_take(n_blocks, &area, &start_block)) {
+            end_block = start_block + n_blocks - 1;
+            goto claim;
+        }
+        #endif
+
         #if MICROPY_GC_SPLIT_HEAP
         area = MP_STATE_MEM(gc_last_free_area);
         #else
@@ -791,6 +1245,16 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             #endif
         }
 
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        // sweep until there's a big enough free run, then try again
+        if (MP_STATE_MEM(gc_sweep).area != NULL) {
+            MP_STATE_THREAD(gc_lock_depth)++;
+            gc_sweep_step(&MP_STATE_MEM(gc_sweep), SIZE_MAX, n_blocks);
+            MP_STATE_THREAD(gc_lock_depth)--;
+            continue;
+        }
+        #endif
+
         GC_EXIT();
         // nothing found!
         if (collected) {
@@ -803,9 +1267,18 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             return NULL;
         }
         DEBUG_printf("gc_alloc(" UINT_FMT "): no free mem, triggering GC\n", n_bytes);
-        gc_collect();
+        gc_collect_deferred();
         collected = 1;
         GC_ENTER();
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        // The collection hasn't freed anything yet, so sweep until there's room
+        // rather than scanning the whole heap again first.
+        if (MP_STATE_MEM(gc_sweep).area != NULL) {
+            MP_STATE_THREAD(gc_lock_depth)++;
+            gc_sweep_step(&MP_STATE_MEM(gc_sweep), SIZE_MAX, n_blocks);
+            MP_STATE_THREAD(gc_lock_depth)--;
+        }
+        #endif
     }
 
     // found, ending at block i inclusive
@@ -826,11 +1299,20 @@ found:
         area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB;
     }
 
+    #if MICROPY_GC_SIZE_CLASSES
+claim:
+    #endif
     area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
     // mark first block as used head
     ATB_FREE_TO_HEAD(area, start_block);
 
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    if (MP_STATE_MEM(gc_sweep).area != NULL && gc_sweep_claim(area, start_block, end_block)) {
+        ATB_HEAD_TO_MARK(area, start_block);
+    }
+    #endif
+
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
     for (size_t bl = start_block + 1; bl <= end_block; bl++) {
@@ -846,6 +1328,10 @@ found:
     MP_STATE_MEM(gc_alloc_amount) += n_blocks;
     #endif
 
+    #if MICROPY_GC_ALLOC_TRACE
+    gc_trace_record(n_blocks * BYTES_PER_BLOCK);
+    #endif
+
     GC_EXIT();
 
     #if MICROPY_GC_CONSERVATIVE_CLEAR
@@ -911,7 +1397,7 @@ void gc_free(void *ptr) {
     #endif
 
     size_t block = BLOCK_FROM_PTR(area, ptr);
-    assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    assert(ATB_KIND_IS_HEAD(ATB_GET_KIND(area, block)));
 
     #if MICROPY_ENABLE_FINALISER
     FTB_CLEAR(area, block);
@@ -938,11 +1424,19 @@ void gc_free(void *ptr) {
     }
 
     // free head and all of its tail blocks
+    #if MICROPY_GC_SIZE_CLASSES
+    size_t start_block = block;
+    #endif
     do {
         ATB_ANY_TO_FREE(area, block);
         block += 1;
     } while (ATB_GET_KIND(area, block) == AT_TAIL);
 
+    #if MICROPY_GC_SIZE_CLASSES
+    // make the freed blocks the next ones handed out for this size
+    gc_size_class_push(area, start_block, block - start_block);
+    #endif
+
     GC_EXIT();
 
     #if EXTENSIVE_HEAP_PROFILING
@@ -966,7 +1460,7 @@ size_t gc_nbytes(const void *ptr) {
 
     if (area) {
         size_t block = BLOCK_FROM_PTR(area, ptr);
-        if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        if (ATB_KIND_IS_HEAD(ATB_GET_KIND(area, block))) {
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
@@ -1012,7 +1506,7 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     area = &MP_STATE_MEM(area);
     #endif
     size_t block = BLOCK_FROM_PTR(area, ptr);
-    assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    assert(ATB_KIND_IS_HEAD(ATB_GET_KIND(area, block)));
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -1088,6 +1582,16 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
 
         area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
+        #if MICROPY_GC_INCREMENTAL_SWEEP
+        if (MP_STATE_MEM(gc_sweep).area != NULL) {
+            gc_sweep_claim(area, block, end_block - 1);
+        }
+        #endif
+
+        #if MICROPY_GC_ALLOC_TRACE
+        gc_trace_record((new_blocks - n_blocks) * BYTES_PER_BLOCK);
+        #endif
+
         GC_EXIT();
 
         #if MICROPY_GC_CONSERVATIVE_CLEAR
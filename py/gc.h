@@ -67,6 +67,10 @@ void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
 void *gc_realloc(void *ptr, size_t n_bytes, bool allow_move);
 
+// Number of buckets in gc_info_t.free_runs.  Bucket i counts the runs of
+// 2**i to 2**(i+1)-1 free blocks, and the last bucket counts all longer runs.
+#define GC_FREE_RUN_BUCKETS (10)
+
 typedef struct _gc_info_t {
     size_t total;
     size_t used;
@@ -78,10 +82,32 @@ typedef struct _gc_info_t {
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     size_t max_new_split;
     #endif
+    #if MICROPY_GC_STATS
+    size_t free_runs[GC_FREE_RUN_BUCKETS];
+    #endif
 } gc_info_t;
 
 void gc_info(gc_info_t *info);
 void gc_dump_info(const mp_print_t *print);
 void gc_dump_alloc_table(const mp_print_t *print);
 
+#if MICROPY_GC_ALLOC_TRACE
+// Bytes and number of allocations made at one bytecode offset.
+typedef struct _gc_trace_entry_t {
+    const void *fun_bc; // NULL if the entry is unused
+    size_t offset;
+    size_t count;
+    size_t bytes;
+} gc_trace_entry_t;
+
+// Table of allocation sites, held in MP_STATE_VM(gc_trace) while tracing.
+// alloc must be a power of 2.
+typedef struct _gc_trace_t {
+    size_t alloc;
+    gc_trace_entry_t unknown; // allocations made outside bytecode
+    gc_trace_entry_t other; // allocations from sites that didn't fit
+    gc_trace_entry_t table[];
+} gc_trace_t;
+#endif
+
 #endif // MICROPY_INCLUDED_PY_GC_H
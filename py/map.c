@@ -32,6 +32,7 @@
 #include "py/mpconfig.h"
 #include "py/misc.h"
 #include "py/runtime.h"
+#include "py/objstr.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
@@ -83,9 +84,174 @@ static size_t get_hash_alloc_greater_or_equal_to(size_t x) {
     return (x + x / 2) | 1;
 }
 
+static mp_uint_t map_hash(mp_obj_t index) {
+    // fast path for common case of qstr
+    if (mp_obj_is_qstr(index)) {
+        return qstr_hash(MP_OBJ_QSTR_VALUE(index));
+    } else if (mp_obj_is_exact_type(index, &mp_type_str) && ((mp_obj_str_t *)MP_OBJ_TO_PTR(index))->hash != 0) {
+        // use the hash cached in the str object
+        return ((mp_obj_str_t *)MP_OBJ_TO_PTR(index))->hash;
+    } else {
+        return MP_OBJ_SMALL_INT_VALUE(mp_unary_op(MP_UNARY_OP_HASH, index));
+    }
+}
+
+/******************************************************************************/
+/* ordered map hash index                                                     */
+
+#if MICROPY_OPT_MAP_ORDERED_INDEX
+
+// An indexed ordered map keeps its entries in insertion order in map->table,
+// followed in the same allocation by this header and an open-addressed array
+// of slots.  Each slot is 0 if empty, else 1 + the position of an entry in the
+// table.  Slots are 8, 16 or 32 bits depending on the size of the table.
+// Removing an entry leaves it in place as deleted (key MP_OBJ_SENTINEL) until
+// the table is next resized, so later entries don't need to move.
+typedef struct _mp_map_index_t {
+    size_t end; // number of positions used in the table, including deleted entries
+    size_t fill; // number of non-empty slots
+    size_t mask; // number of slots minus 1
+} mp_map_index_t;
+
+#define MAP_INDEX(map) ((mp_map_index_t *)&(map)->table[(map)->alloc])
+
+static size_t map_index_slot_size(size_t alloc) {
+    return alloc < 0xff ? 1 : alloc < 0xffff ? 2 : 4;
+}
+
+// Number of slots for a table of alloc entries, keeping the index at most 2/3 full.
+static size_t map_index_num_slots(size_t alloc) {
+    size_t n = 8;
+    while (n < alloc + alloc / 2) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static size_t map_index_alloc_bytes(size_t alloc) {
+    return alloc * sizeof(mp_map_elem_t) + sizeof(mp_map_index_t) + map_index_num_slots(alloc) * map_index_slot_size(alloc);
+}
+
+static inline size_t map_index_get(const mp_map_index_t *index, size_t slot_size, size_t i) {
+    const void *slots = index + 1;
+    if (slot_size == 1) {
+        return ((const uint8_t *)slots)[i];
+    } else if (slot_size == 2) {
+        return ((const uint16_t *)slots)[i];
+    } else {
+        return ((const uint32_t *)slots)[i];
+    }
+}
+
+static inline void map_index_set(mp_map_index_t *index, size_t slot_size, size_t i, size_t value) {
+    void *slots = index + 1;
+    if (slot_size == 1) {
+        ((uint8_t *)slots)[i] = value;
+    } else if (slot_size == 2) {
+        ((uint16_t *)slots)[i] = value;
+    } else {
+        ((uint32_t *)slots)[i] = value;
+    }
+}
+
+// Move the entries of an ordered map to a new indexed table with room for
+// about half as many entries again, dropping deleted entries.  The map is
+// unchanged if hashing a key raises an exception.
+static void map_ordered_reindex(mp_map_t *map) {
+    size_t new_alloc = map->used + map->used / 2 + 4;
+    mp_map_elem_t *new_table = (mp_map_elem_t *)m_new0(byte, map_index_alloc_bytes(new_alloc));
+    mp_map_index_t *index = (mp_map_index_t *)&new_table[new_alloc];
+    size_t slot_size = map_index_slot_size(new_alloc);
+    index->mask = map_index_num_slots(new_alloc) - 1;
+    size_t old_end = map->is_indexed ? MAP_INDEX(map)->end : map->used;
+    size_t pos = 0;
+    for (size_t i = 0; i < old_end; i++) {
+        mp_obj_t key = map->table[i].key;
+        if (key == MP_OBJ_NULL || key == MP_OBJ_SENTINEL) {
+            continue;
+        }
+        size_t slot = map_hash(key) & index->mask;
+        while (map_index_get(index, slot_size, slot) != 0) {
+            slot = (slot + 1) & index->mask;
+        }
+        map_index_set(index, slot_size, slot, pos + 1);
+        new_table[pos++] = map->table[i];
+    }
+    index->end = pos;
+    index->fill = pos;
+    if (map->is_indexed) {
+        m_del(byte, map->table, map_index_alloc_bytes(map->alloc));
+    } else {
+        m_del(mp_map_elem_t, map->table, map->alloc);
+    }
+    map->alloc = new_alloc;
+    map->table = new_table;
+    map->is_indexed = 1;
+}
+
+static mp_map_elem_t *map_ordered_index_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind, bool compare_only_ptrs) {
+    mp_map_index_t *map_index = MAP_INDEX(map);
+    size_t slot_size = map_index_slot_size(map->alloc);
+    size_t slot = map_hash(index) & map_index->mask;
+    for (;;) {
+        size_t value = map_index_get(map_index, slot_size, slot);
+        if (value == 0) {
+            break;
+        }
+        // slots may refer to deleted or reused entries, which won't match
+        mp_map_elem_t *elem = &map->table[value - 1];
+        if (elem->key == index || (!compare_only_ptrs && mp_map_slot_is_filled(map, value - 1) && mp_obj_equal(elem->key, index))) {
+            if (MP_UNLIKELY(lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND)) {
+                // leave the entry deleted in place, trimming deleted entries
+                // from the end of the table so they can be reused
+                --map->used;
+                elem->key = MP_OBJ_SENTINEL;
+                while (map_index->end > 0 && map->table[map_index->end - 1].key == MP_OBJ_SENTINEL) {
+                    map->table[--map_index->end].key = MP_OBJ_NULL;
+                }
+            } else {
+                MAP_CACHE_SET(index, value - 1);
+            }
+            return elem;
+        }
+        slot = (slot + 1) & map_index->mask;
+    }
+    if (MP_LIKELY(lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)) {
+        return NULL;
+    }
+    if (map_index->end == map->alloc || map_index->fill >= map->alloc) {
+        map_ordered_reindex(map);
+        return map_ordered_index_lookup(map, index, lookup_kind, compare_only_ptrs);
+    }
+    size_t pos = map_index->end++;
+    map_index->fill++;
+    map_index_set(map_index, slot_size, slot, pos + 1);
+    mp_map_elem_t *elem = &map->table[pos];
+    elem->key = index;
+    elem->value = MP_OBJ_NULL;
+    map->used++;
+    if (!mp_obj_is_qstr(index)) {
+        map->all_keys_are_qstrs = 0;
+    }
+    return elem;
+}
+
+#endif // MICROPY_OPT_MAP_ORDERED_INDEX
+
 /******************************************************************************/
 /* map                                                                        */
 
+static void map_free_table(mp_map_t *map) {
+    #if MICROPY_OPT_MAP_ORDERED_INDEX
+    if (map->is_indexed) {
+        m_del(byte, map->table, map_index_alloc_bytes(map->alloc));
+        map->is_indexed = 0;
+        return;
+    }
+    #endif
+    m_del(mp_map_elem_t, map->table, map->alloc);
+}
+
 void mp_map_init(mp_map_t *map, size_t n) {
     if (n == 0) {
         map->alloc = 0;
@@ -98,6 +264,9 @@ void mp_map_init(mp_map_t *map, size_t n) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->is_ordered = 0;
+    #if MICROPY_OPT_MAP_ORDERED_INDEX
+    map->is_indexed = 0;
+    #endif
 }
 
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
@@ -106,20 +275,23 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 1;
     map->is_ordered = 1;
+    #if MICROPY_OPT_MAP_ORDERED_INDEX
+    map->is_indexed = 0;
+    #endif
     map->table = (mp_map_elem_t *)table;
 }
 
 // Differentiate from mp_map_clear() - semantics is different
 void mp_map_deinit(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        map_free_table(map);
     }
     map->used = map->alloc = 0;
 }
 
 void mp_map_clear(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        map_free_table(map);
     }
     map->alloc = 0;
     map->used = 0;
@@ -189,7 +361,13 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
     }
 
     // if the map is an ordered array then we must do a brute force linear search
+    // (unless it's big enough to have been given an index)
     if (map->is_ordered) {
+        #if MICROPY_OPT_MAP_ORDERED_INDEX
+        if (map->is_indexed) {
+            return map_ordered_index_lookup(map, index, lookup_kind, compare_only_ptrs);
+        }
+        #endif
         for (mp_map_elem_t *elem = &map->table[0], *top = &map->table[map->used]; elem < top; elem++) {
             if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
                 #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
@@ -213,6 +391,12 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
         if (MP_LIKELY(lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)) {
             return NULL;
         }
+        #if MICROPY_OPT_MAP_ORDERED_INDEX
+        if (map->used >= MICROPY_OPT_MAP_ORDERED_INDEX_MIN) {
+            map_ordered_reindex(map);
+            return map_ordered_index_lookup(map, index, lookup_kind, compare_only_ptrs);
+        }
+        #endif
         if (map->used == map->alloc) {
             // TODO: Alloc policy
             map->alloc += 4;
@@ -241,13 +425,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
         }
     }
 
-    // get hash of index, with fast path for common case of qstr
-    mp_uint_t hash;
-    if (mp_obj_is_qstr(index)) {
-        hash = qstr_hash(MP_OBJ_QSTR_VALUE(index));
-    } else {
-        hash = MP_OBJ_SMALL_INT_VALUE(mp_unary_op(MP_UNARY_OP_HASH, index));
-    }
+    mp_uint_t hash = map_hash(index);
 
     size_t pos = hash % map->alloc;
     size_t start_pos = pos;
@@ -321,6 +499,19 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
     }
 }
 
+// Return the most recently added entry of an ordered map, or NULL if it's empty.
+mp_map_elem_t *mp_map_ordered_last(mp_map_t *map) {
+    assert(map->is_ordered);
+    size_t end = map->used;
+    #if MICROPY_OPT_MAP_ORDERED_INDEX
+    if (map->is_indexed) {
+        // deleted entries are never left at the end
+        end = MAP_INDEX(map)->end;
+    }
+    #endif
+    return end == 0 ? NULL : &map->table[end - 1];
+}
+
 /******************************************************************************/
 /* set                                                                        */
 
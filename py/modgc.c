@@ -28,6 +28,17 @@
 #include "py/obj.h"
 #include "py/gc.h"
 
+#if MICROPY_GC_STATS || MICROPY_GC_ALLOC_TRACE
+#include "py/runtime.h"
+#endif
+
+#if MICROPY_GC_ALLOC_TRACE
+#include "py/bc.h"
+#include "py/nlr.h"
+#include "py/objfun.h"
+#include "py/objtuple.h"
+#endif
+
 #if MICROPY_PY_GC && MICROPY_ENABLE_GC
 
 // collect(): run a garbage collection
@@ -100,6 +111,207 @@ static mp_obj_t gc_threshold(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_threshold_obj, 0, 1, gc_threshold);
 #endif
 
+#if MICROPY_GC_STATS
+static mp_obj_t gc_stats_new_int(uint64_t val) {
+    if (val == (mp_uint_t)val) {
+        return mp_obj_new_int_from_uint(val);
+    }
+    return mp_obj_new_int_from_ull(val);
+}
+
+static void gc_stats_store(mp_obj_t dict, qstr key, uint64_t val) {
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(key), gc_stats_new_int(val));
+}
+
+// stats(): return a dict of collection times and heap fragmentation
+static mp_obj_t gc_stats(void) {
+    gc_info_t info;
+    gc_info(&info);
+    mp_state_mem_stats_t stats = MP_STATE_MEM(gc_stats);
+    mp_obj_t dict = mp_obj_new_dict(13);
+    gc_stats_store(dict, MP_QSTR_collections, stats.collections);
+    gc_stats_store(dict, MP_QSTR_mark_us, stats.mark_us);
+    gc_stats_store(dict, MP_QSTR_mark_us_max, stats.mark_us_max);
+    gc_stats_store(dict, MP_QSTR_mark_us_total, stats.mark_us_total);
+    gc_stats_store(dict, MP_QSTR_sweep_us, stats.sweep_us);
+    gc_stats_store(dict, MP_QSTR_sweep_us_max, stats.sweep_us_max);
+    gc_stats_store(dict, MP_QSTR_sweep_us_total, stats.sweep_us_total);
+    gc_stats_store(dict, MP_QSTR_sweep_steps, stats.sweep_steps);
+    gc_stats_store(dict, MP_QSTR_reclaimed, (uint64_t)stats.reclaimed * MICROPY_BYTES_PER_GC_BLOCK);
+    gc_stats_store(dict, MP_QSTR_reclaimed_total, stats.reclaimed_total * MICROPY_BYTES_PER_GC_BLOCK);
+    gc_stats_store(dict, MP_QSTR_free, info.free);
+    gc_stats_store(dict, MP_QSTR_max_free, (uint64_t)info.max_free * MICROPY_BYTES_PER_GC_BLOCK);
+    mp_obj_t runs[GC_FREE_RUN_BUCKETS];
+    for (size_t i = 0; i < GC_FREE_RUN_BUCKETS; ++i) {
+        runs[i] = mp_obj_new_int_from_uint(info.free_runs[i]);
+    }
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_free_runs), mp_obj_new_tuple(GC_FREE_RUN_BUCKETS, runs));
+    return dict;
+}
+MP_DEFINE_CONST_FUN_OBJ_0(gc_stats_obj, gc_stats);
+
+#if MICROPY_ENABLE_SCHEDULER
+// Scheduled after each collection to pass the stats to the callback.
+static mp_obj_t gc_stats_notify(mp_obj_t callback) {
+    return mp_call_function_1(callback, gc_stats());
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(gc_stats_notify_obj, gc_stats_notify);
+
+// stats_callback(callback): call callback(stats()) after each collection, or
+// stop if callback is None
+static mp_obj_t gc_stats_callback(mp_obj_t callback) {
+    if (callback == mp_const_none) {
+        MP_STATE_VM(gc_stats_callback)[0] = MP_OBJ_NULL;
+    } else {
+        if (!mp_obj_is_callable(callback)) {
+            mp_raise_TypeError(MP_ERROR_TEXT("object not callable"));
+        }
+        MP_STATE_VM(gc_stats_callback)[1] = callback;
+        MP_STATE_VM(gc_stats_callback)[0] = MP_OBJ_FROM_PTR(&gc_stats_notify_obj);
+    }
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_1(gc_stats_callback_obj, gc_stats_callback);
+#endif
+#endif
+
+#if MICROPY_GC_ALLOC_TRACE
+// trace_start(size=256): start counting allocations at up to size sites
+static mp_obj_t gc_trace_start(size_t n_args, const mp_obj_t *args) {
+    // largest table whose size in bytes fits in a size_t
+    const size_t max_alloc = (SIZE_MAX - sizeof(gc_trace_t)) / sizeof(gc_trace_entry_t);
+    mp_int_t size = n_args > 0 ? mp_obj_get_int(args[0]) : 256;
+    if (size <= 0 || (size_t)size > max_alloc) {
+        mp_raise_ValueError(NULL);
+    }
+    size_t alloc = 1;
+    while (alloc < (size_t)size) {
+        alloc <<= 1;
+    }
+    if (alloc > max_alloc) {
+        mp_raise_ValueError(NULL);
+    }
+    MP_STATE_VM(gc_trace) = NULL;
+    gc_trace_t *trace = m_malloc0(sizeof(gc_trace_t) + alloc * sizeof(gc_trace_entry_t));
+    trace->alloc = alloc;
+    MP_STATE_VM(gc_trace) = trace;
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_trace_start_obj, 0, 1, gc_trace_start);
+
+// trace_stop(): stop counting allocations and discard the counts
+static mp_obj_t gc_trace_stop(void) {
+    MP_STATE_VM(gc_trace) = NULL;
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_0(gc_trace_stop_obj, gc_trace_stop);
+
+// Add the counts of one trace entry to the dict under the given site name.
+static void gc_trace_add(mp_obj_t dict, mp_obj_t site, const gc_trace_entry_t *e) {
+    if (e->count == 0) {
+        return;
+    }
+    mp_obj_t bytes = mp_obj_new_int_from_uint(e->bytes);
+    mp_obj_t count = mp_obj_new_int_from_uint(e->count);
+    mp_map_elem_t *elem = mp_map_lookup(mp_obj_dict_get_map(dict), site, MP_MAP_LOOKUP);
+    if (elem != NULL) {
+        // merge with another instruction on the same line
+        mp_obj_tuple_t *prev = MP_OBJ_TO_PTR(elem->value);
+        bytes = mp_binary_op(MP_BINARY_OP_ADD, bytes, prev->items[0]);
+        count = mp_binary_op(MP_BINARY_OP_ADD, count, prev->items[1]);
+    }
+    mp_obj_t items[2] = { bytes, count };
+    mp_obj_dict_store(dict, site, mp_obj_new_tuple(2, items));
+}
+
+static void gc_trace_snapshot_into(mp_obj_t dict, const gc_trace_t *trace) {
+    gc_trace_add(dict, MP_OBJ_NEW_QSTR(MP_QSTR__lt_unknown_gt_), &trace->unknown);
+    gc_trace_add(dict, MP_OBJ_NEW_QSTR(MP_QSTR__lt_other_gt_), &trace->other);
+    for (size_t i = 0; i < trace->alloc; ++i) {
+        const gc_trace_entry_t *e = &trace->table[i];
+        if (e->fun_bc != NULL) {
+            vstr_t vstr;
+            mp_print_t print;
+            vstr_init_print(&vstr, 32, &print);
+            mp_bytecode_print_location(&print, e->fun_bc, e->offset);
+            gc_trace_add(dict, mp_obj_new_str_from_vstr(&vstr), e);
+        }
+    }
+}
+
+// trace_snapshot(): return a dict mapping "function (file:line)" to a tuple
+// of (bytes, count) allocated by that line since tracing started
+static mp_obj_t gc_trace_snapshot(void) {
+    gc_trace_t *trace = MP_STATE_VM(gc_trace);
+    if (trace == NULL) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("not tracing"));
+    }
+    // don't count the snapshot itself; trace stays reachable from the stack
+    MP_STATE_VM(gc_trace) = NULL;
+    mp_obj_t dict = mp_obj_new_dict(0);
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        gc_trace_snapshot_into(dict, trace);
+        nlr_pop();
+        MP_STATE_VM(gc_trace) = trace;
+    } else {
+        MP_STATE_VM(gc_trace) = trace;
+        nlr_jump(nlr.ret_val);
+    }
+    return dict;
+}
+MP_DEFINE_CONST_FUN_OBJ_0(gc_trace_snapshot_obj, gc_trace_snapshot);
+
+// Append (bytes_diff, count_diff, site) to list if either is non-zero.
+static void gc_trace_diff_item(mp_obj_t list, mp_obj_t site, mp_obj_t new_value, mp_obj_t old_value) {
+    mp_obj_t items[3];
+    mp_obj_t *new_items = NULL;
+    mp_obj_t *old_items = NULL;
+    if (new_value != MP_OBJ_NULL) {
+        mp_obj_get_array_fixed_n(new_value, 2, &new_items);
+    }
+    if (old_value != MP_OBJ_NULL) {
+        mp_obj_get_array_fixed_n(old_value, 2, &old_items);
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        mp_obj_t n = new_items ? new_items[i] : MP_OBJ_NEW_SMALL_INT(0);
+        items[i] = old_items ? mp_binary_op(MP_BINARY_OP_SUBTRACT, n, old_items[i]) : n;
+    }
+    if (mp_obj_is_true(items[0]) || mp_obj_is_true(items[1])) {
+        items[2] = site;
+        mp_obj_list_append(list, mp_obj_new_tuple(3, items));
+    }
+}
+
+// trace_diff(new, old): return a list of (bytes_diff, count_diff, site) for
+// the sites that changed between two snapshots, largest first
+static mp_obj_t gc_trace_diff(mp_obj_t new_in, mp_obj_t old_in) {
+    if (!mp_obj_is_dict_or_ordereddict(new_in) || !mp_obj_is_dict_or_ordereddict(old_in)) {
+        mp_raise_TypeError(NULL);
+    }
+    mp_map_t *new_map = mp_obj_dict_get_map(new_in);
+    mp_map_t *old_map = mp_obj_dict_get_map(old_in);
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < new_map->alloc; ++i) {
+        if (mp_map_slot_is_filled(new_map, i)) {
+            mp_map_elem_t *old = mp_map_lookup(old_map, new_map->table[i].key, MP_MAP_LOOKUP);
+            gc_trace_diff_item(list, new_map->table[i].key, new_map->table[i].value, old ? old->value : MP_OBJ_NULL);
+        }
+    }
+    for (size_t i = 0; i < old_map->alloc; ++i) {
+        if (mp_map_slot_is_filled(old_map, i) && mp_map_lookup(new_map, old_map->table[i].key, MP_MAP_LOOKUP) == NULL) {
+            gc_trace_diff_item(list, old_map->table[i].key, MP_OBJ_NULL, old_map->table[i].value);
+        }
+    }
+    mp_obj_t kw[2] = { MP_OBJ_NEW_QSTR(MP_QSTR_reverse), mp_const_true };
+    mp_map_t kw_args;
+    mp_map_init_fixed_table(&kw_args, 1, kw);
+    mp_obj_list_sort(1, &list, &kw_args);
+    return list;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(gc_trace_diff_obj, gc_trace_diff);
+#endif
+
 static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_gc) },
     { MP_ROM_QSTR(MP_QSTR_collect), MP_ROM_PTR(&gc_collect_obj) },
@@ -111,6 +323,18 @@ static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     #if MICROPY_GC_ALLOC_THRESHOLD
     { MP_ROM_QSTR(MP_QSTR_threshold), MP_ROM_PTR(&gc_threshold_obj) },
     #endif
+    #if MICROPY_GC_STATS
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&gc_stats_obj) },
+    #if MICROPY_ENABLE_SCHEDULER
+    { MP_ROM_QSTR(MP_QSTR_stats_callback), MP_ROM_PTR(&gc_stats_callback_obj) },
+    #endif
+    #endif
+    #if MICROPY_GC_ALLOC_TRACE
+    { MP_ROM_QSTR(MP_QSTR_trace_start), MP_ROM_PTR(&gc_trace_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_stop), MP_ROM_PTR(&gc_trace_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_snapshot), MP_ROM_PTR(&gc_trace_snapshot_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_diff), MP_ROM_PTR(&gc_trace_diff_obj) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_gc_globals, mp_module_gc_globals_table);
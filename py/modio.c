@@ -78,6 +78,12 @@ static mp_uint_t iobase_write(mp_obj_t obj, const void *buf, mp_uint_t size, int
 }
 
 static mp_uint_t iobase_ioctl(mp_obj_t obj, mp_uint_t request, uintptr_t arg, int *errcode) {
+    if (request == MP_STREAM_GET_MAPPED_DATA || request == MP_STREAM_RELEASE_MAPPED_DATA) {
+        // The argument points to an mp_buffer_info_t, which Python code can't
+        // fill in, so a Python stream can't be memory mapped.
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
     mp_obj_t dest[4];
     mp_load_method(obj, MP_QSTR_ioctl, dest);
     dest[2] = mp_obj_new_int_from_uint(request);
@@ -25,12 +25,17 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "py/builtin.h"
 #include "py/cstack.h"
 #include "py/runtime.h"
 #include "py/gc.h"
 #include "py/mphal.h"
+#include "py/compile.h"
+#include "py/persistentcode.h"
+#include "py/profile.h"
+#include "py/stream.h"
 
 #if MICROPY_PY_MICROPYTHON
 
@@ -166,6 +171,69 @@ static mp_obj_t mp_micropython_schedule(mp_obj_t function, mp_obj_t arg) {
 static MP_DEFINE_CONST_FUN_OBJ_2(mp_micropython_schedule_obj, mp_micropython_schedule);
 #endif
 
+#if MICROPY_PY_MICROPYTHON_PROFILE
+static mp_obj_t mp_micropython_profile_start(size_t n_args, const mp_obj_t *args) {
+    return mp_prof_profile_start(n_args, args);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_profile_start_obj, 1, 2, mp_micropython_profile_start);
+
+static mp_obj_t mp_micropython_profile_stop(void) {
+    return mp_prof_profile_stop();
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_profile_stop_obj, mp_micropython_profile_stop);
+#endif
+
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+static mp_obj_t mp_micropython_snapshot(mp_obj_t name_in, mp_obj_t source_in, mp_obj_t file_in) {
+    qstr name = mp_obj_str_get_qstr(name_in);
+    const char *source = mp_obj_str_get_str(source_in);
+    qstr source_qstr = qstr_from_str(source);
+
+    // Create a fresh module.
+    mp_map_lookup(&MP_STATE_VM(mp_loaded_modules_dict).map, MP_OBJ_NEW_QSTR(name), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+    mp_obj_t module = mp_obj_new_module(name);
+    #if MICROPY_PY___FILE__
+    mp_store_attr(module, MP_QSTR___file__, MP_OBJ_NEW_QSTR(source_qstr));
+    #endif
+
+    // Load the .mpy file, or compile the .py file.
+    mp_compiled_module_t cm;
+    cm.context = MP_OBJ_TO_PTR(module);
+    size_t len = strlen(source);
+    if (len >= 4 && strcmp(source + len - 4, ".mpy") == 0) {
+        mp_raw_code_load_file(source_qstr, &cm);
+    } else {
+        #if MICROPY_ENABLE_COMPILER
+        mp_lexer_t *lex = mp_lexer_new_from_file(source_qstr);
+        mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+        mp_compile_to_raw_code(&parse_tree, source_qstr, false, &cm);
+        #else
+        mp_raise_msg(&mp_type_ImportError, MP_ERROR_TEXT("script compilation not supported"));
+        #endif
+    }
+
+    // Execute the module in its context.
+    nlr_jump_callback_node_globals_locals_t ctx;
+    ctx.globals = mp_globals_get();
+    ctx.locals = mp_locals_get();
+    mp_globals_set(cm.context->module.globals);
+    mp_locals_set(cm.context->module.globals);
+    nlr_push_jump_callback(&ctx.callback, mp_globals_locals_set_from_nlr_jump_callback);
+    mp_call_function_0(mp_make_function_from_proto_fun(cm.rc, cm.context, NULL));
+    nlr_pop_jump_callback(true);
+
+    // Save the module's code and a snapshot of its state.
+    mp_obj_t args[2] = {file_in, MP_OBJ_NEW_QSTR(MP_QSTR_wb)};
+    mp_obj_t file = mp_builtin_open(2, args, (mp_map_t *)&mp_const_empty_map);
+    mp_print_t print = {MP_OBJ_TO_PTR(file), mp_stream_write_adaptor};
+    mp_raw_code_save_snapshot(&cm, &print);
+    mp_stream_close(file);
+
+    return module;
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(mp_micropython_snapshot_obj, mp_micropython_snapshot);
+#endif
+
 static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_micropython) },
     { MP_ROM_QSTR(MP_QSTR_const), MP_ROM_PTR(&mp_identity_obj) },
@@ -206,6 +274,13 @@ static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_ENABLE_SCHEDULER
     { MP_ROM_QSTR(MP_QSTR_schedule), MP_ROM_PTR(&mp_micropython_schedule_obj) },
     #endif
+    #if MICROPY_PY_MICROPYTHON_PROFILE
+    { MP_ROM_QSTR(MP_QSTR_profile_start), MP_ROM_PTR(&mp_micropython_profile_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_profile_stop), MP_ROM_PTR(&mp_micropython_profile_stop_obj) },
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+    { MP_ROM_QSTR(MP_QSTR_snapshot), MP_ROM_PTR(&mp_micropython_snapshot_obj) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_micropython_globals, mp_module_micropython_globals_table);
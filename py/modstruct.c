@@ -257,6 +257,247 @@ static mp_obj_t struct_pack_into(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
 
+#if MICROPY_PY_STRUCT_STRUCT
+
+// A Struct compiles its format into a table with one entry per value, giving
+// its offset and size, so packing and unpacking don't need to parse the format
+// or look up the size and alignment of each value again.
+
+// Integers that fit in a machine word are converted directly
+#define STRUCT_FIELD_INT (0)
+#define STRUCT_FIELD_BYTES (1)
+#define STRUCT_FIELD_OTHER (2)
+
+typedef struct _struct_field_t {
+    size_t offset;
+    size_t size;
+    char val_type;
+    uint8_t kind;
+} struct_field_t;
+
+typedef struct _mp_obj_struct_t {
+    mp_obj_base_t base;
+    mp_obj_t format;
+    size_t size;
+    size_t num_items;
+    char fmt_type;
+    bool big_endian;
+    struct_field_t fields[];
+} mp_obj_struct_t;
+
+static mp_obj_t struct_struct_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    const char *fmt = mp_obj_str_get_str(args[0]);
+    size_t total_sz;
+    size_t num_items = calc_size_items(fmt, &total_sz);
+    mp_obj_struct_t *self = mp_obj_malloc_var(mp_obj_struct_t, fields, struct_field_t, num_items, type);
+    self->format = args[0];
+    self->size = total_sz;
+    self->num_items = num_items;
+    self->fmt_type = get_fmt_type(&fmt);
+    self->big_endian = self->fmt_type == '>' || (self->fmt_type == '@' && MP_ENDIANNESS_BIG);
+
+    // Lay out the fields the same way as calc_size_items
+    size_t offset = 0;
+    struct_field_t *f = self->fields;
+    for (; *fmt; fmt++) {
+        mp_uint_t cnt = 1;
+        if (unichar_isdigit(*fmt)) {
+            cnt = get_fmt_num(&fmt);
+        }
+        if (*fmt == 'x') {
+            offset += cnt;
+        } else if (*fmt == 's') {
+            f->offset = offset;
+            f->size = cnt;
+            f->val_type = 's';
+            f->kind = STRUCT_FIELD_BYTES;
+            ++f;
+            offset += cnt;
+        } else {
+            size_t align;
+            size_t sz = mp_binary_get_size(self->fmt_type, *fmt, &align);
+            uint8_t kind = STRUCT_FIELD_OTHER;
+            if (sz <= sizeof(mp_uint_t) && strchr("bBhHiIlLqQP", *fmt) != NULL) {
+                kind = STRUCT_FIELD_INT;
+            }
+            while (cnt--) {
+                offset = (offset + align - 1) & ~(align - 1);
+                f->offset = offset;
+                f->size = sz;
+                f->val_type = *fmt;
+                f->kind = kind;
+                ++f;
+                offset += sz;
+            }
+        }
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// Return a pointer to offset in the buffer, checking there's room for a record
+static byte *struct_struct_get_ptr(mp_obj_struct_t *self, mp_buffer_info_t *bufinfo, mp_int_t offset) {
+    if (offset < 0) {
+        // negative offsets are relative to the end of the buffer
+        offset += bufinfo->len;
+    }
+    if (offset < 0 || (size_t)offset > bufinfo->len || self->size > bufinfo->len - offset) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    return (byte *)bufinfo->buf + offset;
+}
+
+static mp_obj_t struct_struct_unpack_ptr(mp_obj_struct_t *self, const byte *p) {
+    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->num_items, NULL));
+    for (size_t i = 0; i < self->num_items; ++i) {
+        const struct_field_t *f = &self->fields[i];
+        const byte *fp = p + f->offset;
+        mp_obj_t item;
+        if (f->kind == STRUCT_FIELD_INT) {
+            if (f->val_type > 'Z') {
+                item = mp_obj_new_int((mp_int_t)mp_binary_get_int(f->size, true, self->big_endian, fp));
+            } else {
+                item = mp_obj_new_int_from_uint((mp_uint_t)mp_binary_get_int(f->size, false, self->big_endian, fp));
+            }
+        } else if (f->kind == STRUCT_FIELD_BYTES) {
+            item = mp_obj_new_bytes(fp, f->size);
+        } else {
+            byte *ptr = (byte *)fp;
+            item = mp_binary_get_val(self->fmt_type, f->val_type, ptr, &ptr);
+        }
+        res->items[i] = item;
+    }
+    return MP_OBJ_FROM_PTR(res);
+}
+
+static void struct_struct_pack_ptr(mp_obj_struct_t *self, byte *p, size_t n_args, const mp_obj_t *args) {
+    if (n_args != self->num_items) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("pack expected %d items"), (int)self->num_items);
+    }
+    memset(p, 0, self->size);
+    for (size_t i = 0; i < n_args; ++i) {
+        const struct_field_t *f = &self->fields[i];
+        byte *fp = p + f->offset;
+        if (f->kind == STRUCT_FIELD_INT && mp_obj_is_small_int(args[i])) {
+            mp_binary_set_int(f->size, self->big_endian, fp, MP_OBJ_SMALL_INT_VALUE(args[i]));
+        } else if (f->kind == STRUCT_FIELD_BYTES) {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(args[i], &bufinfo, MP_BUFFER_READ);
+            memcpy(fp, bufinfo.buf, MIN(bufinfo.len, f->size));
+        } else {
+            mp_binary_set_val(self->fmt_type, f->val_type, args[i], fp, &fp);
+        }
+    }
+}
+
+static mp_obj_t struct_struct_pack(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->size);
+    struct_struct_pack_ptr(self, (byte *)vstr.buf, n_args - 1, &args[1]);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_struct_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_struct_pack);
+
+static mp_obj_t struct_struct_pack_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    byte *p = struct_struct_get_ptr(self, &bufinfo, mp_obj_get_int(args[2]));
+    struct_struct_pack_ptr(self, p, n_args - 3, &args[3]);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_struct_pack_into);
+
+static mp_obj_t struct_struct_unpack_from(size_t n_args, const mp_obj_t *args) {
+    // As with the unpack function, unpack only requires the buffer to be big
+    // enough, rather than exactly the right size
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
+    mp_int_t offset = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+    return struct_struct_unpack_ptr(self, struct_struct_get_ptr(self, &bufinfo, offset));
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_struct_unpack_from_obj, 2, 3, struct_struct_unpack_from);
+
+typedef struct _mp_obj_struct_it_t {
+    mp_obj_base_t base;
+    mp_obj_struct_t *st;
+    mp_obj_t buf;
+    size_t offset;
+} mp_obj_struct_it_t;
+
+static mp_obj_t struct_it_iternext(mp_obj_t self_in) {
+    mp_obj_struct_it_t *self = MP_OBJ_TO_PTR(self_in);
+    // get the buffer each time in case it has been resized
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(self->buf, &bufinfo, MP_BUFFER_READ);
+    if (self->offset > bufinfo.len || self->st->size > bufinfo.len - self->offset) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    mp_obj_t res = struct_struct_unpack_ptr(self->st, (const byte *)bufinfo.buf + self->offset);
+    self->offset += self->st->size;
+    return res;
+}
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_struct_it,
+    MP_QSTR_iterator,
+    MP_TYPE_FLAG_ITER_IS_ITERNEXT,
+    iter, struct_it_iternext
+    );
+
+static mp_obj_t struct_struct_iter_unpack(mp_obj_t self_in, mp_obj_t buf_in) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    if (self->size == 0 || bufinfo.len % self->size != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer size must be a multiple of struct size"));
+    }
+    mp_obj_struct_it_t *o = mp_obj_malloc(mp_obj_struct_it_t, &mp_type_struct_it);
+    o->st = self;
+    o->buf = buf_in;
+    o->offset = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(struct_struct_iter_unpack_obj, struct_struct_iter_unpack);
+
+static void struct_struct_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        return;
+    }
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    if (attr == MP_QSTR_format) {
+        dest[0] = self->format;
+    } else if (attr == MP_QSTR_size) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(self->size);
+    } else {
+        // continue lookup in locals_dict
+        dest[1] = MP_OBJ_SENTINEL;
+    }
+}
+
+static const mp_rom_map_elem_t struct_struct_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_pack), MP_ROM_PTR(&struct_struct_pack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_struct_pack_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_struct_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_struct_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_struct_iter_unpack_obj) },
+};
+static MP_DEFINE_CONST_DICT(struct_struct_locals_dict, struct_struct_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_struct_struct,
+    MP_QSTR_Struct,
+    MP_TYPE_FLAG_NONE,
+    make_new, struct_struct_make_new,
+    attr, struct_struct_attr,
+    locals_dict, &struct_struct_locals_dict
+    );
+
+#endif // MICROPY_PY_STRUCT_STRUCT
+
 static const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_struct) },
     { MP_ROM_QSTR(MP_QSTR_calcsize), MP_ROM_PTR(&struct_calcsize_obj) },
@@ -264,6 +505,9 @@ static const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_pack_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_unpack_from_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_unpack_from_obj) },
+    #if MICROPY_PY_STRUCT_STRUCT
+    { MP_ROM_QSTR(MP_QSTR_Struct), MP_ROM_PTR(&mp_type_struct_struct) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_struct_globals, mp_module_struct_globals_table);
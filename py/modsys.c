@@ -237,6 +237,10 @@ MP_DEFINE_CONST_FUN_OBJ_1(mp_sys_settrace_obj, mp_sys_settrace);
 #error "MICROPY_PY_SYS_TRACEBACKLIMIT requires MICROPY_PY_SYS_ATTR_DELEGATION"
 #endif
 
+#if MICROPY_VFS_IMPORT_CACHE && !MICROPY_PY_SYS_ATTR_DELEGATION
+#error "MICROPY_VFS_IMPORT_CACHE requires MICROPY_PY_SYS_ATTR_DELEGATION"
+#endif
+
 #if MICROPY_PY_SYS_ATTR_DELEGATION && !MICROPY_MODULE_ATTR_DELEGATION
 #error "MICROPY_PY_SYS_ATTR_DELEGATION requires MICROPY_MODULE_ATTR_DELEGATION"
 #endif
@@ -256,6 +260,9 @@ static const uint16_t sys_mutable_keys[] = {
     #if MICROPY_PY_SYS_TRACEBACKLIMIT
     MP_QSTR_tracebacklimit,
     #endif
+    #if MICROPY_VFS_IMPORT_CACHE
+    MP_QSTR_path_importer_cache,
+    #endif
     MP_QSTRnull,
 };
 
@@ -200,6 +200,42 @@
 #define MICROPY_GC_ALLOC_THRESHOLD (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Largest allocation, in blocks, for which the GC keeps segregated lists of
+// free runs, built during sweep and fed by gc_free, so that small multi-block
+// allocations don't need to scan the allocation table.  Must be 0 (disabled)
+// or at least 2.
+#ifndef MICROPY_GC_SIZE_CLASSES
+#define MICROPY_GC_SIZE_CLASSES (0)
+#endif
+
+// Whether automatic collections (those triggered by gc_alloc) leave the sweep
+// phase to be done in steps by subsequent allocations, rather than sweeping
+// the whole heap before returning.  Only the sweep is incremental: marking is
+// still done in one go, as there is no write barrier.
+#ifndef MICROPY_GC_INCREMENTAL_SWEEP
+#define MICROPY_GC_INCREMENTAL_SWEEP (0)
+#endif
+
+// Number of blocks swept by each allocation while an incremental sweep is in
+// progress.  This should be well above the number of blocks in a typical
+// allocation so the sweep finishes before the heap fills up again.
+#ifndef MICROPY_GC_INCREMENTAL_SWEEP_STEP
+#define MICROPY_GC_INCREMENTAL_SWEEP_STEP (128)
+#endif
+
+// Whether to provide gc.trace_start() and related functions, which count the
+// allocations made by each line of Python code
+#ifndef MICROPY_GC_ALLOC_TRACE
+#define MICROPY_GC_ALLOC_TRACE (0)
+#endif
+
+// Whether to provide gc.stats(), which reports how long collections take and
+// how fragmented the free memory is.  Collections are timed with
+// mp_hal_ticks_us(), so the port must provide it.
+#ifndef MICROPY_GC_STATS
+#define MICROPY_GC_STATS (0)
+#endif
+
 // Number of bytes to allocate initially when creating new chunks to store
 // interned string data.  Smaller numbers lead to more chunks being needed
 // and more wastage at the end of the chunk.  Larger numbers lead to wasted
@@ -299,6 +335,13 @@
 #endif
 #endif
 
+// Whether to keep a hash index over the qstr pools allocated at runtime, so
+// looking up an interned string doesn't need a linear search of those pools.
+// It uses at least 2 words of heap per runtime qstr.
+#ifndef MICROPY_QSTR_POOL_INDEX
+#define MICROPY_QSTR_POOL_INDEX (0)
+#endif
+
 // Avoid using C stack when making Python function calls. C stack still
 // may be used if there's no free heap.
 #ifndef MICROPY_STACKLESS
@@ -330,6 +373,27 @@
 #define MICROPY_PERSISTENT_CODE_LOAD (0)
 #endif
 
+// Whether the bytecode and str/bytes constants of .mpy files in memory-mapped
+// storage are referenced in place when loaded, rather than copied to the heap.
+// Qstr data is always copied.  Requires the file to stay unmodified while its
+// code is in use, so should only be enabled for immutable storage.
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_XIP
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (0)
+#endif
+
+// Whether .mpy files can carry a snapshot of the state of their module, which
+// import restores instead of running the module's top-level code.  Requires
+// MICROPY_PERSISTENT_CODE_LOAD.
+#ifndef MICROPY_PERSISTENT_CODE_SNAPSHOT
+#define MICROPY_PERSISTENT_CODE_SNAPSHOT (0)
+#endif
+
+// Whether to support saving .mpy files with a snapshot, via micropython.snapshot.
+// Requires MICROPY_PERSISTENT_CODE_SAVE.
+#ifndef MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+#define MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE (0)
+#endif
+
 // Whether to support saving of persistent code, i.e. for mpy-cross to
 // generate .mpy files. Enabling this enables additional metadata on raw code
 // objects which is also required for sys.settrace.
@@ -414,6 +478,12 @@
 // Convenience definition for whether any native emitter is enabled
 #define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_XTENSA || MICROPY_EMIT_XTENSAWIN || MICROPY_EMIT_RV32 || MICROPY_EMIT_NATIVE_DEBUG)
 
+// Whether native code has inline fast paths for arithmetic and comparisons on
+// small ints, rather than always calling the runtime (currently x64 only)
+#ifndef MICROPY_EMIT_NATIVE_INLINE_SMALL_INT
+#define MICROPY_EMIT_NATIVE_INLINE_SMALL_INT (0)
+#endif
+
 // Some architectures cannot read byte-wise from executable memory.  In this case
 // the prelude for a native function (which usually sits after the machine code)
 // must be separated and placed somewhere where it can be read byte-wise.
@@ -565,12 +635,70 @@
 #define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
 #endif
 
+// Give ordered maps in RAM (eg OrderedDict) a hash index once they have
+// MICROPY_OPT_MAP_ORDERED_INDEX_MIN entries, so lookup and removal don't need
+// a linear search.  Costs about 1.5 bytes per entry for tables of up to 254
+// entries, 3 bytes up to 65534 entries, and 6 bytes beyond that.
+#ifndef MICROPY_OPT_MAP_ORDERED_INDEX
+#define MICROPY_OPT_MAP_ORDERED_INDEX (0)
+#endif
+
+#ifndef MICROPY_OPT_MAP_ORDERED_INDEX_MIN
+#define MICROPY_OPT_MAP_ORDERED_INDEX_MIN (16)
+#endif
+
+// Cache the result of LOAD_ATTR and LOAD_METHOD lookups on class and native
+// type attributes, in a table of MICROPY_OPT_ATTR_CACHE_SIZE entries indexed
+// by the type and attribute name.  Uses 5 words of RAM per entry, per thread.
+#ifndef MICROPY_OPT_ATTR_CACHE
+#define MICROPY_OPT_ATTR_CACHE (0)
+#endif
+
+// Number of entries in the attribute cache, must be a power of 2.
+#ifndef MICROPY_OPT_ATTR_CACHE_SIZE
+#define MICROPY_OPT_ATTR_CACHE_SIZE (16)
+#endif
+
+// Whether to keep a per-thread cache of recently created str objects, indexed
+// by their hash, and return a cached str instead of creating an equal one.
+// Applies to strs up to MICROPY_OPT_STR_INTERN_MAX_LEN bytes created at runtime
+// (eg by slicing, str.split, str.join and bytes.decode), so equal strs often
+// share one object, making dict lookups with them compare by identity.
+// Uses 1 word of RAM per entry, per thread.
+#ifndef MICROPY_OPT_STR_INTERN
+#define MICROPY_OPT_STR_INTERN (0)
+#endif
+
+// Number of entries in the str intern cache, must be a power of 2.
+#ifndef MICROPY_OPT_STR_INTERN_SIZE
+#define MICROPY_OPT_STR_INTERN_SIZE (128)
+#endif
+
+// Maximum length in bytes of strs that go in the str intern cache.
+#ifndef MICROPY_OPT_STR_INTERN_MAX_LEN
+#define MICROPY_OPT_STR_INTERN_MAX_LEN (32)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
 #define MICROPY_OPT_MPZ_BITWISE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether to multiply large mpz integers with Karatsuba's method, square them
+// with a dedicated routine, and convert large ones to and from strings by
+// divide-and-conquer.  These are faster than quadratic, which matters for
+// numbers with hundreds of digits or more.
+#ifndef MICROPY_OPT_MPZ_FAST_MUL
+#define MICROPY_OPT_MPZ_FAST_MUL (0)
+#endif
+
+// Number of mpz digits both operands must have to use Karatsuba multiplication.
+// Must be at least 16.
+#ifndef MICROPY_MPZ_KARATSUBA_THRESHOLD
+#define MICROPY_MPZ_KARATSUBA_THRESHOLD (32)
+#endif
+
 
 // Whether math.factorial is large, fast and recursive (1) or small and slow (0).
 #ifndef MICROPY_OPT_MATH_FACTORIAL
@@ -1011,6 +1139,12 @@ typedef double mp_float_t;
 #define MICROPY_VFS_LFS2 (0)
 #endif
 
+// Whether import caches the listings of the directories it searches, as
+// sys.path_importer_cache, instead of doing a stat for each candidate file
+#ifndef MICROPY_VFS_IMPORT_CACHE
+#define MICROPY_VFS_IMPORT_CACHE (0)
+#endif
+
 /*****************************************************************************/
 /* Fine control over Python builtins, classes, modules, etc                  */
 
@@ -1299,6 +1433,17 @@ typedef double mp_float_t;
 #define MICROPY_PY_MICROPYTHON_RINGIO (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether to provide "micropython.profile_start" and "micropython.profile_stop",
+// a sampling profiler (the port must provide mp_hal_profile_timer)
+#ifndef MICROPY_PY_MICROPYTHON_PROFILE
+#define MICROPY_PY_MICROPYTHON_PROFILE (0)
+#endif
+
+// Maximum number of frames recorded in each sample by the sampling profiler
+#ifndef MICROPY_PY_MICROPYTHON_PROFILE_DEPTH
+#define MICROPY_PY_MICROPYTHON_PROFILE_DEPTH (16)
+#endif
+
 // Whether to provide "array" module. Note that large chunk of the
 // underlying code is shared with "bytearray" builtin type, so to
 // get real savings, it should be disabled too.
@@ -1443,6 +1588,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_STRUCT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Whether to provide "struct.Struct" class, with a precompiled format
+#ifndef MICROPY_PY_STRUCT_STRUCT
+#define MICROPY_PY_STRUCT_STRUCT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether to provide "sys" module
 #ifndef MICROPY_PY_SYS
 #define MICROPY_PY_SYS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
@@ -1518,6 +1668,10 @@ typedef double mp_float_t;
 #define MICROPY_PY_SYS_SETTRACE (0)
 #endif
 
+// Whether the VM keeps a chain of the code states being executed, for
+// sys.settrace, the sampling profiler and allocation tracing (internal)
+#define MICROPY_VM_CODE_STATE_CHAIN (MICROPY_PY_SYS_SETTRACE || MICROPY_PY_MICROPYTHON_PROFILE || MICROPY_GC_ALLOC_TRACE)
+
 // Whether to provide "sys.getsizeof" function
 #ifndef MICROPY_PY_SYS_GETSIZEOF
 #define MICROPY_PY_SYS_GETSIZEOF (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
@@ -1653,6 +1807,18 @@ typedef double mp_float_t;
 #define MICROPY_PY_JSON_SEPARATORS (1)
 #endif
 
+// Whether json.load/loads should intern dict keys of up to this many bytes as
+// qstrs, so keys repeated throughout a document share one object.  Interned
+// keys are never freed, so this is best used with trusted input.  0 disables.
+#ifndef MICROPY_PY_JSON_INTERN_KEYS
+#define MICROPY_PY_JSON_INTERN_KEYS (0)
+#endif
+
+// Whether to provide json.load_into, for parsing into existing dicts and arrays
+#ifndef MICROPY_PY_JSON_LOAD_INTO
+#define MICROPY_PY_JSON_LOAD_INTO (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
+#endif
+
 #ifndef MICROPY_PY_OS
 #define MICROPY_PY_OS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -1677,6 +1843,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_RE_MATCH_SPAN_START_END (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
 #endif
 
+// Whether to provide the linear-time Pike VM engine, selected per pattern
+// with the re.PIKEVM flag to re.compile
+#ifndef MICROPY_PY_RE_PIKEVM
+#define MICROPY_PY_RE_PIKEVM (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
+#endif
+
 #ifndef MICROPY_PY_RE_SUB
 #define MICROPY_PY_RE_SUB (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -1832,6 +2004,16 @@ typedef double mp_float_t;
 #define MICROPY_PY_FRAMEBUF (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether FrameBuffer objects track a dirty rectangle (FrameBuffer.dirty())
+#ifndef MICROPY_PY_FRAMEBUF_DIRTY
+#define MICROPY_PY_FRAMEBUF_DIRTY (MICROPY_PY_FRAMEBUF)
+#endif
+
+// Whether to provide the "epaper" module with native e-paper panel drivers
+#ifndef MICROPY_PY_EPAPER
+#define MICROPY_PY_EPAPER (0)
+#endif
+
 #ifndef MICROPY_PY_BTREE
 #define MICROPY_PY_BTREE (0)
 #endif
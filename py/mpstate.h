@@ -53,6 +53,9 @@ enum {
     #if MICROPY_PY_SYS_TRACEBACKLIMIT
     MP_SYS_MUTABLE_TRACEBACKLIMIT,
     #endif
+    #if MICROPY_VFS_IMPORT_CACHE
+    MP_SYS_MUTABLE_PATH_IMPORTER_CACHE,
+    #endif
     MP_SYS_MUTABLE_NUM,
 };
 #endif // MICROPY_PY_SYS_ATTR_DELEGATION
@@ -77,6 +80,17 @@ typedef struct _mp_sched_item_t {
     mp_obj_t arg;
 } mp_sched_item_t;
 
+#if MICROPY_OPT_ATTR_CACHE
+// Records that attr of instances of type was found as member in owner.
+typedef struct _mp_attr_cache_entry_t {
+    const mp_obj_type_t *type;
+    const mp_obj_type_t *owner;
+    mp_obj_t member;
+    qstr attr;
+    size_t version;
+} mp_attr_cache_entry_t;
+#endif
+
 // This structure holds information about a single contiguous area of
 // memory reserved for the memory manager.
 typedef struct _mp_state_mem_area_t {
@@ -96,6 +110,41 @@ typedef struct _mp_state_mem_area_t {
     size_t gc_last_used_block; // The block ID of the highest block allocated in the area
 } mp_state_mem_area_t;
 
+// This structure holds the progress of a sweep of the heap.
+typedef struct _mp_state_mem_sweep_t {
+    // area being swept, or NULL if no sweep is in progress
+    mp_state_mem_area_t *area;
+    #if MICROPY_GC_SPLIT_HEAP_AUTO
+    mp_state_mem_area_t *prev_area;
+    #endif
+    size_t block;
+    size_t last_used_block;
+    size_t n_free;
+    #if MICROPY_GC_SIZE_CLASSES
+    // last run added to each size-class list
+    void *size_class_tail[MICROPY_GC_SIZE_CLASSES - 1];
+    #endif
+} mp_state_mem_sweep_t;
+
+// Collection times in microseconds and reclaimed memory in blocks, for
+// gc.stats().  The *_cur fields accumulate over the sweep in progress.
+typedef struct _mp_state_mem_stats_t {
+    size_t collections;
+    mp_uint_t mark_start;
+    mp_uint_t mark_us;
+    mp_uint_t mark_us_max;
+    uint64_t mark_us_total;
+    mp_uint_t sweep_us_cur;
+    mp_uint_t sweep_us;
+    mp_uint_t sweep_us_max;
+    uint64_t sweep_us_total;
+    size_t sweep_steps_cur;
+    size_t sweep_steps;
+    size_t reclaimed_cur;
+    size_t reclaimed;
+    uint64_t reclaimed_total;
+} mp_state_mem_stats_t;
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
@@ -127,10 +176,27 @@ typedef struct _mp_state_mem_t {
     mp_state_mem_area_t *gc_last_free_area;
     #endif
 
+    #if MICROPY_GC_SIZE_CLASSES
+    // Lists of free runs of 2 to MICROPY_GC_SIZE_CLASSES blocks (the last
+    // list also holds longer runs), linked through the free blocks.
+    void *gc_size_class_free[MICROPY_GC_SIZE_CLASSES - 1];
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL_SWEEP
+    // Sweep being done in steps by gc_alloc, and whether the next collection
+    // should leave its sweep to be done that way.
+    mp_state_mem_sweep_t gc_sweep;
+    bool gc_sweep_defer;
+    #endif
+
     #if MICROPY_PY_GC_COLLECT_RETVAL
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_STATS
+    mp_state_mem_stats_t gc_stats;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
@@ -149,6 +215,11 @@ typedef struct _mp_state_vm_t {
 
     qstr_pool_t *last_pool;
 
+    #if MICROPY_QSTR_POOL_INDEX
+    // open-addressing hash table of the qstrs in the runtime pools
+    struct _qstr_index_t *qstr_index;
+    #endif
+
     #if MICROPY_TRACKED_ALLOC
     struct _m_tracked_node_t *m_tracked_head;
     #endif
@@ -233,6 +304,15 @@ typedef struct _mp_state_vm_t {
     uint8_t sched_idx;
     #endif
 
+    #if MICROPY_PY_MICROPYTHON_PROFILE
+    // set by the sampling profiler's timer to request a sample
+    volatile bool prof_sample_pending;
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    // This is a global mutex used to make the profiler's buffer thread-safe.
+    mp_thread_mutex_t prof_mutex;
+    #endif
+    #endif
+
     #if MICROPY_ENABLE_VM_ABORT
     bool vm_abort;
     nlr_buf_t *nlr_abort;
@@ -247,6 +327,12 @@ typedef struct _mp_state_vm_t {
     // See mp_map_lookup.
     uint8_t map_lookup_cache[MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE];
     #endif
+
+    #if MICROPY_OPT_ATTR_CACHE
+    // Bumped whenever a class attribute is stored or deleted, which
+    // invalidates all entries in attr_cache.
+    size_t attr_cache_version;
+    #endif
 } mp_state_vm_t;
 
 // This structure holds state that is specific to a given thread. Everything
@@ -291,12 +377,26 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
+    #endif
+    #if MICROPY_VM_CODE_STATE_CHAIN
     struct _mp_code_state_t *current_code_state;
     #endif
 
     #if MICROPY_PY_SSL_MBEDTLS_NEED_ACTIVE_CONTEXT
     struct _mp_obj_ssl_context_t *tls_ssl_context;
     #endif
+
+    #if MICROPY_OPT_ATTR_CACHE
+    // See mp_load_method_cached.  This is per thread so that entries are never
+    // updated concurrently, and is in the root section so cached objects stay
+    // alive.
+    mp_attr_cache_entry_t attr_cache[MICROPY_OPT_ATTR_CACHE_SIZE];
+    #endif
+
+    #if MICROPY_OPT_STR_INTERN
+    // Recently created str objects, indexed by hash.  See objstr.c.
+    mp_obj_t str_intern[MICROPY_OPT_STR_INTERN_SIZE];
+    #endif
 } mp_state_thread_t;
 
 // This structure combines the above 3 structures.
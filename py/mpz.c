@@ -457,6 +457,160 @@ static size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *
     return ilen;
 }
 
+#if MICROPY_OPT_MPZ_FAST_MUL
+
+/* computes i = i + j
+   returns the carry out of the most significant digit of i
+   assumes ilen >= jlen; i and j need not be normalised
+*/
+static mpz_dig_t mpn_add_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_t carry = 0;
+
+    ilen -= jlen;
+
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        carry += (mpz_dbl_dig_t)*idig + (mpz_dbl_dig_t)*jdig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    for (; ilen > 0 && carry != 0; --ilen, ++idig) {
+        carry += *idig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    return carry;
+}
+
+/* computes i = i - j
+   assumes ilen >= jlen; assumes i >= j; i and j need not be normalised
+*/
+static void mpn_sub_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_signed_t borrow = 0;
+
+    ilen -= jlen;
+
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        borrow += (mpz_dbl_dig_t)*idig - (mpz_dbl_dig_t)*jdig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+
+    for (; ilen > 0 && borrow != 0; --ilen, ++idig) {
+        borrow += *idig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+}
+
+/* computes i = j * j
+   fills all 2 * jlen digits of i; j need not be normalised
+   computes each product of two different digits once, and doubles the sum of them
+*/
+static void mpn_sqr(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen) {
+    memset(idig, 0, 2 * jlen * sizeof(mpz_dig_t));
+
+    for (size_t a = 0; a + 1 < jlen; ++a) {
+        mpz_dig_t *id = idig + 2 * a + 1;
+        mpz_dbl_dig_t carry = 0;
+        for (const mpz_dig_t *jd = jdig + a + 1; jd < jdig + jlen; ++jd, ++id) {
+            carry += (mpz_dbl_dig_t)*id + (mpz_dbl_dig_t)jdig[a] * (mpz_dbl_dig_t)*jd;
+            *id = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        *id = carry;
+    }
+
+    mpz_dbl_dig_t carry = 0;
+    mpz_dbl_dig_t shift = 0;
+    for (size_t a = 0; a < jlen; ++a) {
+        mpz_dbl_dig_t sq = (mpz_dbl_dig_t)jdig[a] * (mpz_dbl_dig_t)jdig[a];
+        for (size_t n = 0; n < 2; ++n) {
+            mpz_dig_t *id = idig + 2 * a + n;
+            shift = ((mpz_dbl_dig_t)*id << 1) | shift;
+            carry += (shift & DIG_MASK) + (sq & DIG_MASK);
+            *id = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+            shift >>= DIG_SIZE;
+            sq >>= DIG_SIZE;
+        }
+    }
+}
+
+// Amount of scratch memory needed by mpn_mul_fast, in digits.
+#define MPN_MUL_FAST_TMP_LEN(jlen) (6 * (jlen))
+
+/* computes i = j * k
+   fills all jlen + klen digits of i; j and k need not be normalised
+   assumes jlen >= klen > 0; assumes tmp has MPN_MUL_FAST_TMP_LEN(jlen) digits
+   squares if j and k are the same
+   uses Karatsuba's method once both operands have at least
+   MICROPY_MPZ_KARATSUBA_THRESHOLD digits
+*/
+static void mpn_mul_fast(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen, mpz_dig_t *tmp) {
+    bool sqr = jdig == kdig && jlen == klen;
+
+    if (klen < MICROPY_MPZ_KARATSUBA_THRESHOLD) {
+        if (sqr) {
+            mpn_sqr(idig, jdig, jlen);
+        } else {
+            memset(idig, 0, (jlen + klen) * sizeof(mpz_dig_t));
+            mpn_mul(idig, (mpz_dig_t *)jdig, jlen, (mpz_dig_t *)kdig, klen);
+        }
+        return;
+    }
+
+    size_t m = (jlen + 1) / 2;
+
+    if (klen <= m) {
+        // k is much shorter than j, so multiply k by each klen-digit piece of j
+        mpz_dig_t *prod = tmp;
+        tmp += 2 * klen;
+        memset(idig, 0, (jlen + klen) * sizeof(mpz_dig_t));
+        for (size_t pos = 0; pos < jlen; pos += klen) {
+            size_t plen = MIN(klen, jlen - pos);
+            if (plen == klen) {
+                mpn_mul_fast(prod, jdig + pos, plen, kdig, klen, tmp);
+            } else {
+                mpn_mul_fast(prod, kdig, klen, jdig + pos, plen, tmp);
+            }
+            mpn_add_inpl(idig + pos, jlen + klen - pos, prod, plen + klen);
+        }
+        return;
+    }
+
+    // With j = j1 * B^m + j0 and k = k1 * B^m + k0, where B is the digit base:
+    //   j * k = z2 * B^2m + z1 * B^m + z0
+    //   z0 = j0 * k0, z2 = j1 * k1, z1 = (j0 + j1) * (k0 + k1) - z0 - z2
+    size_t j1len = jlen - m;
+    size_t k1len = klen - m;
+    mpn_mul_fast(idig, jdig, m, kdig, m, tmp);
+    mpn_mul_fast(idig + 2 * m, jdig + m, j1len, kdig + m, k1len, tmp);
+
+    mpz_dig_t *jsum = tmp;
+    tmp += m + 1;
+    memcpy(jsum, jdig, m * sizeof(mpz_dig_t));
+    jsum[m] = mpn_add_inpl(jsum, m, jdig + m, j1len);
+    mpz_dig_t *ksum = jsum;
+    if (!sqr) {
+        ksum = tmp;
+        tmp += m + 1;
+        memcpy(ksum, kdig, m * sizeof(mpz_dig_t));
+        ksum[m] = mpn_add_inpl(ksum, m, kdig + m, k1len);
+    }
+    mpz_dig_t *z1 = tmp;
+    tmp += 2 * m + 2;
+    mpn_mul_fast(z1, jsum, m + 1, ksum, m + 1, tmp);
+    mpn_sub_inpl(z1, 2 * m + 2, idig, 2 * m);
+    mpn_sub_inpl(z1, 2 * m + 2, idig + 2 * m, j1len + k1len);
+
+    // the top digits of z1 are zero, since the whole product fits in i
+    mpn_add_inpl(idig + m, jlen + klen - m, z1, MIN(2 * m + 2, jlen + klen - m));
+}
+
+#endif
+
 /* natural_div - quo * den + new_num = old_num (ie num is replaced with rem)
    assumes den != 0
    assumes num_dig has enough memory to be extended by 1 digit
@@ -813,6 +967,110 @@ void mpz_set_from_float(mpz_t *z, mp_float_t src) {
 }
 #endif
 
+// Returns the value of the digit c, or 36 if it's not a digit.
+static unsigned int mpz_digit_value(char c) {
+    if ('0' <= c && c <= '9') {
+        return c - '0';
+    } else if ('A' <= c && c <= 'Z') {
+        return c - ('A' - 10);
+    } else if ('a' <= c && c <= 'z') {
+        return c - ('a' - 10);
+    } else {
+        return 36;
+    }
+}
+
+// Returns the largest power of base that fits in a digit, and its exponent in *n.
+static mpz_dig_t mpz_big_base(unsigned int base, unsigned int *n) {
+    mpz_dig_t big_base = base;
+    *n = 1;
+    while ((mpz_dbl_dig_t)big_base * base <= DIG_MASK) {
+        big_base *= base;
+        *n += 1;
+    }
+    return big_base;
+}
+
+// Sets z (which must be non-negative) to z * base**len + the value of the
+// len digits in str, which must all be valid.  Takes as many digits as fit
+// in an mpz digit at a time.
+static void mpz_mul_add_str(mpz_t *z, const char *str, size_t len, unsigned int base) {
+    unsigned int big_n;
+    mpz_big_base(base, &big_n);
+    mpz_need_dig(z, z->len + len * 8 / DIG_SIZE + 1);
+    for (const char *top = str + len; str < top;) {
+        mpz_dig_t mul = 1;
+        mpz_dig_t add = 0;
+        for (unsigned int n = 0; n < big_n && str < top; ++n, ++str) {
+            mul *= base;
+            add = add * base + mpz_digit_value(*str);
+        }
+        z->len = mpn_mul_dig_add_dig(z->dig, z->len, mul, add);
+    }
+}
+
+#if MICROPY_OPT_MPZ_FAST_MUL
+
+// Numbers with more than this many digits are converted to and from strings by
+// splitting them into halves, which is faster than a digit at a time because
+// the multiplication is faster than quadratic.
+#define MPZ_STR_DC_THRESHOLD (2 * MICROPY_MPZ_KARATSUBA_THRESHOLD)
+
+#ifndef MPZ_FROM_STR_DC_THRESHOLD
+#define MPZ_FROM_STR_DC_THRESHOLD (1000)
+#endif
+
+// Maximum number of powers of the base used when converting to and from
+// strings, enough for strings of 2**32 digits.
+#define MPZ_STR_DC_MAX_POWS (32)
+
+// Sets pows[l] to big_base ** (2 ** l) for l up to and including level, starting
+// from the first one that's not set yet, and returns the new number set.
+static size_t mpz_str_dc_pows(mpz_t *pows, size_t num_pows, size_t level, mpz_dig_t big_base) {
+    for (; num_pows <= level; ++num_pows) {
+        mpz_init_zero(&pows[num_pows]);
+        if (num_pows == 0) {
+            mpz_set_from_int(&pows[0], big_base);
+        } else {
+            mpz_mul_inpl(&pows[num_pows], &pows[num_pows - 1], &pows[num_pows - 1]);
+        }
+    }
+    return num_pows;
+}
+
+// Sets z to the value of the len digits in str (which must all be valid), by
+// splitting off the low big_n * 2 ** l digits (with l as large as possible) and
+// converting each part separately, then combining them with pows[l].
+static size_t mpz_set_from_str_dc(mpz_t *z, const char *str, size_t len, unsigned int base, mpz_t *pows, size_t num_pows) {
+    unsigned int big_n;
+    mpz_dig_t big_base = mpz_big_base(base, &big_n);
+
+    if (len < MPZ_FROM_STR_DC_THRESHOLD) {
+        z->len = 0;
+        mpz_mul_add_str(z, str, len, base);
+        return num_pows;
+    }
+
+    size_t level = 0;
+    while (((size_t)big_n << (level + 1)) < len) {
+        ++level;
+    }
+    size_t low_len = (size_t)big_n << level;
+    num_pows = mpz_str_dc_pows(pows, num_pows, level, big_base);
+
+    mpz_t low;
+    mpz_init_zero(&low);
+    num_pows = mpz_set_from_str_dc(&low, str + len - low_len, low_len, base, pows, num_pows);
+    num_pows = mpz_set_from_str_dc(z, str, len - low_len, base, pows, num_pows);
+    mpz_mul_inpl(z, z, &pows[level]);
+    mpz_add_inpl(z, z, &low);
+    mpz_deinit(&low);
+
+    return num_pows;
+}
+
+#endif
+
 // returns number of bytes from str that were processed
 size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
     assert(base <= 36);
@@ -820,7 +1078,26 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
     const char *cur = str;
     const char *top = str + len;
 
-    mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
+    // find the digits that are valid in this base
+    for (; cur < top && mpz_digit_value(*cur) < base; ++cur) { // XXX UTF8 next char
+    }
+    len = cur - str;
+
+    z->neg = 0;
+    z->len = 0;
+
+    #if MICROPY_OPT_MPZ_FAST_MUL
+    if (len >= 2 * MPZ_FROM_STR_DC_THRESHOLD) {
+        mpz_t pows[MPZ_STR_DC_MAX_POWS];
+        size_t num_pows = mpz_set_from_str_dc(z, str, len, base, pows, 0);
+        while (num_pows > 0) {
+            mpz_deinit(&pows[--num_pows]);
+        }
+    } else
+    #endif
+    {
+        mpz_mul_add_str(z, str, len, base);
+    }
 
     if (neg) {
         z->neg = 1;
@@ -828,26 +1105,7 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
         z->neg = 0;
     }
 
-    z->len = 0;
-    for (; cur < top; ++cur) { // XXX UTF8 next char
-        // mp_uint_t v = char_to_numeric(cur#); // XXX UTF8 get char
-        mp_uint_t v = *cur;
-        if ('0' <= v && v <= '9') {
-            v -= '0';
-        } else if ('A' <= v && v <= 'Z') {
-            v -= 'A' - 10;
-        } else if ('a' <= v && v <= 'z') {
-            v -= 'a' - 10;
-        } else {
-            break;
-        }
-        if (v >= base) {
-            break;
-        }
-        z->len = mpn_mul_dig_add_dig(z->dig, z->len, base, v);
-    }
-
-    return cur - str;
+    return len;
 }
 
 void mpz_set_from_bytes(mpz_t *z, bool big_endian, size_t len, const byte *buf) {
@@ -1306,8 +1564,28 @@ void mpz_mul_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
     }
 
     mpz_need_dig(dest, lhs->len + rhs->len); // min mem l+r-1, max mem l+r
-    memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
-    dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    #if MICROPY_OPT_MPZ_FAST_MUL
+    if (lhs == rhs || (lhs->len >= MICROPY_MPZ_KARATSUBA_THRESHOLD && rhs->len >= MICROPY_MPZ_KARATSUBA_THRESHOLD)) {
+        if (lhs->len < rhs->len) {
+            const mpz_t *t = lhs;
+            lhs = rhs;
+            rhs = t;
+        }
+        mpz_dig_t *tmp = NULL;
+        size_t tmp_len = 0;
+        if (rhs->len >= MICROPY_MPZ_KARATSUBA_THRESHOLD) {
+            tmp_len = MPN_MUL_FAST_TMP_LEN(lhs->len);
+            tmp = m_new(mpz_dig_t, tmp_len);
+        }
+        mpn_mul_fast(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len, tmp);
+        m_del(mpz_dig_t, tmp, tmp_len);
+        dest->len = mpn_remove_trailing_zeros(dest->dig, dest->dig + lhs->len + rhs->len);
+    } else
+    #endif
+    {
+        memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
+        dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    }
 
     if (lhs->neg == rhs->neg) {
         dest->neg = 0;
@@ -1663,6 +1941,91 @@ char *mpz_as_str(const mpz_t *i, unsigned int base) {
 }
 #endif
 
+// Writes the number in dig (which is destroyed) to str in the given base, least
+// significant character first, and returns the end of the characters.  Writes
+// at least width characters, padding with zeros, and at least one.  Divides by
+// the largest power of base that fits in a digit, to get several characters
+// per pass over the digits.
+static char *mpn_as_str(mpz_dig_t *dig, size_t ilen, unsigned int base, char base_char, char comma, size_t width, char *str) {
+    unsigned int big_n;
+    mpz_dig_t big_base = mpz_big_base(base, &big_n);
+    char *s = str;
+    char *last_comma = str;
+    for (;;) {
+        mpz_dbl_dig_t a = 0;
+
+        // compute next remainder
+        for (size_t n = ilen; n > 0; --n) {
+            a = (a << DIG_SIZE) | dig[n - 1];
+            dig[n - 1] = a / big_base;
+            a %= big_base;
+        }
+
+        // the number gets shorter as it's divided
+        while (ilen > 0 && dig[ilen - 1] == 0) {
+            --ilen;
+        }
+
+        for (unsigned int n = 0; n < big_n; ++n) {
+            // convert to character
+            mpz_dig_t c = a % base + '0';
+            a /= base;
+            if (c > '9') {
+                c += base_char - '9' - 1;
+            }
+            *s++ = c;
+
+            // check if number is zero
+            if (ilen == 0 && a == 0 && (size_t)(s - str) >= width) {
+                return s;
+            }
+            if (comma && (s - last_comma) == 3) {
+                *s++ = comma;
+                last_comma = s;
+            }
+        }
+    }
+}
+
+#if MICROPY_OPT_MPZ_FAST_MUL
+// Writes the number z to str in the given base, least significant character
+// first, and returns the end of the characters.  z must be less than
+// pows[level] ** 2, unless width is 0.  Writes at least width characters,
+// padding with zeros.  z is split into q * pows[level] + r, where pows[l] is
+// big_base ** (2 ** l), and each part converted separately.
+static char *mpz_as_str_dc(const mpz_t *z, unsigned int base, char base_char, size_t width, char *str, mpz_t *pows, size_t level) {
+    if (z->len < MPZ_STR_DC_THRESHOLD) {
+        mpz_dig_t *dig = m_new(mpz_dig_t, z->len);
+        memcpy(dig, z->dig, z->len * sizeof(mpz_dig_t));
+        str = mpn_as_str(dig, z->len, base, base_char, '\0', width, str);
+        m_del(mpz_dig_t, dig, z->len);
+        return str;
+    }
+
+    if (width == 0 && mpz_cmp(z, &pows[level]) < 0) {
+        return mpz_as_str_dc(z, base, base_char, 0, str, pows, level - 1);
+    }
+
+    unsigned int big_n;
+    mpz_big_base(base, &big_n);
+    size_t r_width = (size_t)big_n << level;
+    mpz_t q, r;
+    mpz_init_zero(&q);
+    mpz_init_zero(&r);
+    mpz_divmod_inpl(&q, &r, z, &pows[level]);
+    str = mpz_as_str_dc(&r, base, base_char, r_width, str, pows, level - 1);
+    if (width == 0) {
+        // q may still be too big for the next level down
+        str = mpz_as_str_dc(&q, base, base_char, 0, str, pows, level);
+    } else {
+        str = mpz_as_str_dc(&q, base, base_char, width - r_width, str, pows, level - 1);
+    }
+    mpz_deinit(&q);
+    mpz_deinit(&r);
+    return str;
+}
+#endif
+
 // assumes enough space in str as calculated by mp_int_format_size
 // base must be between 2 and 32 inclusive
 // returns length of string, not including null byte
@@ -1684,48 +2047,35 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
         return s - str;
     }
 
-    // make a copy of mpz digits, so we can do the div/mod calculation
-    mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
-    memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
-
-    // convert
-    char *last_comma = str;
-    bool done;
-    do {
-        mpz_dig_t *d = dig + ilen;
-        mpz_dbl_dig_t a = 0;
-
-        // compute next remainder
-        while (--d >= dig) {
-            a = (a << DIG_SIZE) | *d;
-            *d = a / base;
-            a %= base;
+    #if MICROPY_OPT_MPZ_FAST_MUL
+    if (ilen >= 2 * MPZ_STR_DC_THRESHOLD && !comma) {
+        // split using the largest power of the base that's not longer than half of i
+        unsigned int big_n;
+        mpz_dig_t big_base = mpz_big_base(base, &big_n);
+        mpz_t pows[MPZ_STR_DC_MAX_POWS];
+        size_t num_pows = mpz_str_dc_pows(pows, 0, 0, big_base);
+        while (pows[num_pows - 1].len * 2 < ilen) {
+            num_pows = mpz_str_dc_pows(pows, num_pows, num_pows, big_base);
         }
-
-        // convert to character
-        a += '0';
-        if (a > '9') {
-            a += base_char - '9' - 1;
-        }
-        *s++ = a;
-
-        // check if number is zero
-        done = true;
-        for (d = dig; d < dig + ilen; ++d) {
-            if (*d != 0) {
-                done = false;
-                break;
-            }
+        mpz_t abs = *i;
+        abs.neg = 0;
+        s = mpz_as_str_dc(&abs, base, base_char, 0, s, pows, num_pows - 1);
+        while (num_pows > 0) {
+            mpz_deinit(&pows[--num_pows]);
         }
-        if (!done && comma && (s - last_comma) == 3) {
-            *s++ = comma;
-            last_comma = s;
-        }
-    }
-    while (!done);
+    } else
+    #endif
+    {
+        // make a copy of mpz digits, so we can do the div/mod calculation
+        mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
+        memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
 
-    // free the copy of the digits array
-    m_del(mpz_dig_t, dig, ilen);
+        // convert
+        s = mpn_as_str(dig, ilen, base, base_char, comma, 0, s);
+
+        // free the copy of the digits array
+        m_del(mpz_dig_t, dig, ilen);
+    }
 
     if (prefix) {
         const char *p = &prefix[strlen(prefix)];
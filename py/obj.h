@@ -463,7 +463,12 @@ typedef struct _mp_map_t {
     size_t all_keys_are_qstrs : 1;
     size_t is_fixed : 1;    // if set, table is fixed/read-only and can't be modified
     size_t is_ordered : 1;  // if set, table is an ordered array, not a hash map
+    #if MICROPY_OPT_MAP_ORDERED_INDEX
+    size_t is_indexed : 1;  // if set, ordered table is followed by a hash index
+    size_t used : (8 * sizeof(size_t) - 4);
+    #else
     size_t used : (8 * sizeof(size_t) - 3);
+    #endif
     size_t alloc;
     mp_map_elem_t *table;
 } mp_map_t;
@@ -487,6 +492,7 @@ mp_map_t *mp_map_new(size_t n);
 void mp_map_deinit(mp_map_t *map);
 void mp_map_free(mp_map_t *map);
 mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind);
+mp_map_elem_t *mp_map_ordered_last(mp_map_t *map);
 void mp_map_clear(mp_map_t *map);
 void mp_map_dump(mp_map_t *map);
 
@@ -839,6 +845,8 @@ extern const mp_obj_type_t mp_type_fun_bc;
 extern const mp_obj_type_t mp_type_fun_native;
 extern const mp_obj_type_t mp_type_fun_viper;
 extern const mp_obj_type_t mp_type_fun_asm;
+extern const mp_obj_type_t mp_type_closure;
+extern const mp_obj_type_t mp_type_cell;
 extern const mp_obj_type_t mp_type_module;
 extern const mp_obj_type_t mp_type_staticmethod;
 extern const mp_obj_type_t mp_type_classmethod;
@@ -985,6 +993,9 @@ mp_obj_t mp_obj_new_str_from_utf8_vstr(vstr_t *vstr); // input data must be vali
 #endif
 mp_obj_t mp_obj_new_bytes_from_vstr(vstr_t *vstr);
 mp_obj_t mp_obj_new_bytes(const byte *data, size_t len);
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+mp_obj_t mp_obj_new_str_static(const mp_obj_type_t *type, const byte *data, size_t len); // data must be null terminated and never freed
+#endif
 mp_obj_t mp_obj_new_bytearray(size_t n, const void *items);
 mp_obj_t mp_obj_new_bytearray_by_ref(size_t n, void *items);
 #if MICROPY_PY_BUILTINS_FLOAT
@@ -1068,6 +1079,23 @@ static inline void mp_obj_cell_set(mp_obj_t self_in, mp_obj_t obj) {
     self->obj = obj;
 }
 
+// closure
+
+typedef struct _mp_obj_closure_t {
+    mp_obj_base_t base;
+    mp_obj_t fun;
+    size_t n_closed;
+    mp_obj_t closed[];
+} mp_obj_closure_t;
+
+// bound method
+
+typedef struct _mp_obj_bound_meth_t {
+    mp_obj_base_t base;
+    mp_obj_t meth;
+    mp_obj_t self;
+} mp_obj_bound_meth_t;
+
 // int
 // For long int, returns value truncated to mp_int_t
 mp_int_t mp_obj_int_get_truncated(mp_const_obj_t self_in);
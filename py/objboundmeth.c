@@ -29,12 +29,6 @@
 #include "py/obj.h"
 #include "py/runtime.h"
 
-typedef struct _mp_obj_bound_meth_t {
-    mp_obj_base_t base;
-    mp_obj_t meth;
-    mp_obj_t self;
-} mp_obj_bound_meth_t;
-
 #if MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_DETAILED
 static void bound_meth_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind) {
     (void)kind;
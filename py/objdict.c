@@ -262,6 +262,21 @@ static MP_DEFINE_CONST_FUN_OBJ_1(dict_clear_obj, dict_clear);
 mp_obj_t mp_obj_dict_copy(mp_obj_t self_in) {
     mp_check_self(mp_obj_is_dict_or_ordereddict(self_in));
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_OPT_MAP_ORDERED_INDEX
+    if (self->map.is_indexed) {
+        // rebuild the index rather than copying it
+        mp_obj_t other_out = mp_obj_new_dict(0);
+        mp_obj_dict_t *other = MP_OBJ_TO_PTR(other_out);
+        other->base.type = self->base.type;
+        other->map.is_ordered = 1;
+        size_t cur = 0;
+        mp_map_elem_t *next;
+        while ((next = dict_iter_next(self, &cur)) != NULL) {
+            mp_map_lookup(&other->map, next->key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = next->value;
+        }
+        return other_out;
+    }
+    #endif
     mp_obj_t other_out = mp_obj_new_dict(self->map.alloc);
     mp_obj_dict_t *other = MP_OBJ_TO_PTR(other_out);
     other->base.type = self->base.type;
@@ -358,12 +373,15 @@ static mp_obj_t dict_popitem(mp_obj_t self_in) {
     if (self->map.used == 0) {
         mp_raise_msg(&mp_type_KeyError, MP_ERROR_TEXT("popitem(): dictionary is empty"));
     }
-    size_t cur = 0;
     #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
     if (self->map.is_ordered) {
-        cur = self->map.used - 1;
+        mp_map_elem_t *last = mp_map_ordered_last(&self->map);
+        mp_obj_t items[] = {last->key, last->value};
+        mp_map_lookup(&self->map, last->key, MP_MAP_LOOKUP_REMOVE_IF_FOUND)->value = MP_OBJ_NULL;
+        return mp_obj_new_tuple(2, items);
     }
     #endif
+    size_t cur = 0;
     mp_map_elem_t *next = dict_iter_next(self, &cur);
     assert(next);
     self->map.used--;
@@ -29,7 +29,6 @@
 
 #include "py/objlist.h"
 #include "py/runtime.h"
-#include "py/cstack.h"
 
 static mp_obj_t mp_obj_new_list_iterator(mp_obj_t list, size_t cur, mp_obj_iter_buf_t *iter_buf);
 static mp_obj_list_t *list_new(size_t n);
@@ -290,39 +289,278 @@ static mp_obj_t list_pop(size_t n_args, const mp_obj_t *args) {
     return ret;
 }
 
-static void mp_quicksort(mp_obj_t *head, mp_obj_t *tail, mp_obj_t key_fn, mp_obj_t binop_less_result) {
-    mp_cstack_check();
-    while (head < tail) {
-        mp_obj_t *h = head - 1;
-        mp_obj_t *t = tail;
-        mp_obj_t v = key_fn == MP_OBJ_NULL ? tail[0] : mp_call_function_1(key_fn, tail[0]); // get pivot using key_fn
-        for (;;) {
-            do {++h;
-            } while (h < t && mp_binary_op(MP_BINARY_OP_LESS, key_fn == MP_OBJ_NULL ? h[0] : mp_call_function_1(key_fn, h[0]), v) == binop_less_result);
-            do {--t;
-            } while (h < t && mp_binary_op(MP_BINARY_OP_LESS, v, key_fn == MP_OBJ_NULL ? t[0] : mp_call_function_1(key_fn, t[0])) == binop_less_result);
-            if (h >= t) {
-                break;
-            }
-            mp_obj_t x = h[0];
-            h[0] = t[0];
-            t[0] = x;
+// List sorting uses a natural merge sort (a simplified timsort), which is
+// stable and takes O(n) comparisons on data that is already in order.  The
+// array being sorted has elements of w words, the first being the key to
+// compare.  With a key function each element is a (key, item) pair so keys are
+// only computed once.  If all keys are small ints, floats or strs then they are
+// compared directly, which can't raise, and the list's items are sorted in
+// place.  Otherwise a copy is sorted, so that the list is left unchanged if a
+// comparison raises an exception.
+
+// Runs shorter than this are extended with an insertion sort
+#define LIST_SORT_MIN_RUN (32)
+
+// Enough pending runs for any array that fits in memory
+#define LIST_SORT_MAX_RUNS (sizeof(size_t) * 8 * 3 / 2)
+
+enum {
+    LIST_SORT_KIND_ANY,
+    LIST_SORT_KIND_SMALL_INT,
+    #if MICROPY_PY_BUILTINS_FLOAT
+    LIST_SORT_KIND_FLOAT,
+    #endif
+    LIST_SORT_KIND_STR,
+};
+
+typedef struct _list_sort_t {
+    mp_obj_t *a;
+    mp_obj_t *tmp;
+    size_t w;
+    uint8_t kind;
+} list_sort_t;
+
+static uint8_t list_sort_kind(mp_obj_t o) {
+    if (mp_obj_is_small_int(o)) {
+        return LIST_SORT_KIND_SMALL_INT;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    } else if (mp_obj_is_float(o)) {
+        return LIST_SORT_KIND_FLOAT;
+    #endif
+    } else if (mp_obj_is_str(o)) {
+        return LIST_SORT_KIND_STR;
+    } else {
+        return LIST_SORT_KIND_ANY;
+    }
+}
+
+static bool list_sort_lt(const list_sort_t *s, mp_obj_t lhs, mp_obj_t rhs) {
+    switch (s->kind) {
+        case LIST_SORT_KIND_SMALL_INT:
+            return MP_OBJ_SMALL_INT_VALUE(lhs) < MP_OBJ_SMALL_INT_VALUE(rhs);
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case LIST_SORT_KIND_FLOAT:
+            return mp_obj_float_get(lhs) < mp_obj_float_get(rhs);
+        #endif
+        case LIST_SORT_KIND_STR: {
+            size_t lhs_len, rhs_len;
+            const char *lhs_data = mp_obj_str_get_data(lhs, &lhs_len);
+            const char *rhs_data = mp_obj_str_get_data(rhs, &rhs_len);
+            int cmp = memcmp(lhs_data, rhs_data, MIN(lhs_len, rhs_len));
+            return cmp < 0 || (cmp == 0 && lhs_len < rhs_len);
+        }
+        default:
+            return mp_obj_is_true(mp_binary_op(MP_BINARY_OP_LESS, lhs, rhs));
+    }
+}
+
+static inline mp_obj_t *list_sort_elem(const list_sort_t *s, mp_obj_t *base, size_t i) {
+    return base + i * s->w;
+}
+
+static inline void list_sort_move(const list_sort_t *s, mp_obj_t *dest, const mp_obj_t *src, size_t n) {
+    memmove(dest, src, n * s->w * sizeof(mp_obj_t));
+}
+
+static void list_sort_reverse(const list_sort_t *s, mp_obj_t *base, size_t n) {
+    for (size_t i = 0, j = n - 1; i < j; ++i, --j) {
+        mp_obj_t *x = list_sort_elem(s, base, i);
+        mp_obj_t *y = list_sort_elem(s, base, j);
+        for (size_t k = 0; k < s->w; ++k) {
+            mp_obj_t t = x[k];
+            x[k] = y[k];
+            y[k] = t;
         }
-        mp_obj_t x = h[0];
-        h[0] = tail[0];
-        tail[0] = x;
-        // do the smaller recursive call first, to keep stack within O(log(N))
-        if (t - head < tail - h - 1) {
-            mp_quicksort(head, t, key_fn, binop_less_result);
-            head = h + 1;
+    }
+}
+
+// Return the first element in [lo, hi) whose key is greater than key
+static size_t list_sort_upper_bound(const list_sort_t *s, size_t lo, size_t hi, mp_obj_t key) {
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (list_sort_lt(s, key, *list_sort_elem(s, s->a, mid))) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Return the first element in [lo, hi) whose key is not less than key
+static size_t list_sort_lower_bound(const list_sort_t *s, size_t lo, size_t hi, mp_obj_t key) {
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (list_sort_lt(s, *list_sort_elem(s, s->a, mid), key)) {
+            lo = mid + 1;
         } else {
-            mp_quicksort(h + 1, tail, key_fn, binop_less_result);
-            tail = t;
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Sort [lo, hi) with a binary insertion sort, given that [lo, start) is sorted
+static void list_sort_insertion(list_sort_t *s, size_t lo, size_t start, size_t hi) {
+    mp_obj_t x[2];
+    for (; start < hi; ++start) {
+        mp_obj_t *e = list_sort_elem(s, s->a, start);
+        size_t pos = list_sort_upper_bound(s, lo, start, e[0]);
+        if (pos < start) {
+            list_sort_move(s, x, e, 1);
+            list_sort_move(s, list_sort_elem(s, s->a, pos + 1), list_sort_elem(s, s->a, pos), start - pos);
+            list_sort_move(s, list_sort_elem(s, s->a, pos), x, 1);
+        }
+    }
+}
+
+// Return the length of the run starting at lo, reversing it if it's descending
+static size_t list_sort_count_run(list_sort_t *s, size_t lo, size_t hi) {
+    size_t i = lo + 1;
+    if (i == hi) {
+        return 1;
+    }
+    if (list_sort_lt(s, *list_sort_elem(s, s->a, i), *list_sort_elem(s, s->a, lo))) {
+        // Strictly descending, so reversing it keeps the sort stable
+        while (++i < hi && list_sort_lt(s, *list_sort_elem(s, s->a, i), *list_sort_elem(s, s->a, i - 1))) {
+        }
+        list_sort_reverse(s, list_sort_elem(s, s->a, lo), i - lo);
+    } else {
+        while (++i < hi && !list_sort_lt(s, *list_sort_elem(s, s->a, i), *list_sort_elem(s, s->a, i - 1))) {
+        }
+    }
+    return i - lo;
+}
+
+// Merge the adjacent sorted runs [lo, mid) and [mid, hi)
+static void list_sort_merge(list_sort_t *s, size_t lo, size_t mid, size_t hi) {
+    // Elements at the start of the left run and the end of the right run may
+    // already be in their final place
+    lo = list_sort_upper_bound(s, lo, mid, *list_sort_elem(s, s->a, mid));
+    if (lo == mid) {
+        return;
+    }
+    hi = list_sort_lower_bound(s, mid, hi, *list_sort_elem(s, s->a, mid - 1));
+
+    // Copy the shorter run to tmp and merge into the space it leaves
+    size_t na = mid - lo;
+    size_t nb = hi - mid;
+    mp_obj_t *a = list_sort_elem(s, s->a, lo);
+    mp_obj_t *b = list_sort_elem(s, s->a, mid);
+    mp_obj_t *end_b = list_sort_elem(s, s->a, hi);
+    size_t w = s->w;
+    if (na <= nb) {
+        // Merge forwards, from the start of tmp (the left run) and b
+        list_sort_move(s, s->tmp, a, na);
+        mp_obj_t *t = s->tmp;
+        mp_obj_t *end_t = list_sort_elem(s, s->tmp, na);
+        while (t < end_t && b < end_b) {
+            if (list_sort_lt(s, b[0], t[0])) {
+                list_sort_move(s, a, b, 1);
+                b += w;
+            } else {
+                list_sort_move(s, a, t, 1);
+                t += w;
+            }
+            a += w;
+        }
+        list_sort_move(s, a, t, (end_t - t) / w);
+    } else {
+        // Merge backwards, from the end of a and tmp (the right run)
+        list_sort_move(s, s->tmp, b, nb);
+        mp_obj_t *t = list_sort_elem(s, s->tmp, nb);
+        mp_obj_t *dest = end_b;
+        while (t > s->tmp && b > a) {
+            dest -= w;
+            if (list_sort_lt(s, t[-w], b[-w])) {
+                b -= w;
+                list_sort_move(s, dest, b, 1);
+            } else {
+                t -= w;
+                list_sort_move(s, dest, t, 1);
+            }
+        }
+        list_sort_move(s, a, s->tmp, (t - s->tmp) / w);
+    }
+}
+
+static void list_sort_run(list_sort_t *s, size_t n) {
+    // Compute the minimum run length so that n / min_run is a power of 2, or
+    // just under one, to keep merges balanced
+    size_t min_run = n;
+    size_t r = 0;
+    while (min_run >= LIST_SORT_MIN_RUN) {
+        r |= min_run & 1;
+        min_run >>= 1;
+    }
+    min_run += r;
+
+    // Start of each pending run, with runs[n_runs] being the end of the last one
+    size_t runs[LIST_SORT_MAX_RUNS + 1];
+    size_t n_runs = 0;
+    runs[0] = 0;
+    for (size_t lo = 0; lo < n;) {
+        size_t len = list_sort_count_run(s, lo, n);
+        if (len < min_run) {
+            size_t forced = MIN(min_run, n - lo);
+            list_sort_insertion(s, lo, lo + len, lo + forced);
+            len = forced;
+        }
+        lo += len;
+        runs[++n_runs] = lo;
+
+        // Merge runs while their lengths don't decrease fast enough, which
+        // keeps merges balanced and bounds the number of pending runs
+        #define RUN_LEN(i) (runs[(i) + 1] - runs[(i)])
+        while (n_runs > 1) {
+            size_t k = n_runs - 2;
+            if ((k > 0 && RUN_LEN(k - 1) <= RUN_LEN(k) + RUN_LEN(k + 1))
+                || (k > 1 && RUN_LEN(k - 2) <= RUN_LEN(k - 1) + RUN_LEN(k))) {
+                if (RUN_LEN(k - 1) < RUN_LEN(k + 1)) {
+                    --k;
+                }
+            } else if (RUN_LEN(k) > RUN_LEN(k + 1)) {
+                break;
+            }
+            list_sort_merge(s, runs[k], runs[k + 1], runs[k + 2]);
+            memmove(&runs[k + 1], &runs[k + 2], (n_runs - k - 1) * sizeof(size_t));
+            --n_runs;
         }
+        #undef RUN_LEN
+        assert(n_runs < LIST_SORT_MAX_RUNS);
+    }
+
+    // Merge all remaining runs
+    while (n_runs > 1) {
+        --n_runs;
+        list_sort_merge(s, runs[n_runs - 1], runs[n_runs], runs[n_runs + 1]);
+        runs[n_runs] = runs[n_runs + 1];
+    }
+}
+
+// Sort n elements of w words in-place
+static void list_sort_elems(mp_obj_t *a, size_t n, size_t w, uint8_t kind, bool reverse) {
+    list_sort_t s;
+    s.a = a;
+    s.w = w;
+    s.kind = kind;
+
+    // To keep equal elements in order when sorting in reverse, reverse the
+    // elements before and after sorting
+    if (reverse) {
+        list_sort_reverse(&s, a, n);
+    }
+
+    // tmp needs space for the shorter of two runs being merged
+    s.tmp = m_new(mp_obj_t, n / 2 * w);
+    list_sort_run(&s, n);
+    m_del(mp_obj_t, s.tmp, n / 2 * w);
+
+    if (reverse) {
+        list_sort_reverse(&s, a, n);
     }
 }
 
-// TODO Python defines sort to be stable but ours is not
 mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_key, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
@@ -339,10 +577,47 @@ mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     mp_check_self(mp_obj_is_type(pos_args[0], &mp_type_list));
     mp_obj_list_t *self = MP_OBJ_TO_PTR(pos_args[0]);
 
-    if (self->len > 1) {
-        mp_quicksort(self->items, self->items + self->len - 1,
-            args.key.u_obj == mp_const_none ? MP_OBJ_NULL : args.key.u_obj,
-            args.reverse.u_bool ? mp_const_false : mp_const_true);
+    size_t n = self->len;
+    if (n <= 1) {
+        return mp_const_none;
+    }
+
+    // Build the array of elements to sort: the items themselves, or pairs of
+    // (key, item) with the key function called once per item
+    size_t w = 1;
+    mp_obj_t *elems = self->items;
+    if (args.key.u_obj != mp_const_none) {
+        w = 2;
+        elems = m_new(mp_obj_t, n * 2);
+        for (size_t i = 0; i < n; ++i) {
+            elems[i * 2] = mp_call_function_1(args.key.u_obj, self->items[i]);
+            elems[i * 2 + 1] = self->items[i];
+        }
+    }
+
+    // Use a fast comparison if all keys are of the same simple type
+    uint8_t kind = list_sort_kind(elems[0]);
+    for (size_t i = 1; i < n && kind != LIST_SORT_KIND_ANY; ++i) {
+        if (list_sort_kind(elems[i * w]) != kind) {
+            kind = LIST_SORT_KIND_ANY;
+        }
+    }
+
+    if (w == 1 && kind != LIST_SORT_KIND_ANY) {
+        list_sort_elems(self->items, n, 1, kind, args.reverse.u_bool);
+    } else {
+        if (w == 1) {
+            elems = m_new(mp_obj_t, n);
+            memcpy(elems, self->items, n * sizeof(mp_obj_t));
+        }
+        list_sort_elems(elems, n, w, kind, args.reverse.u_bool);
+        if (self->len != n) {
+            mp_raise_ValueError(MP_ERROR_TEXT("list modified during sort"));
+        }
+        for (size_t i = 0; i < n; ++i) {
+            self->items[i] = elems[i * w + w - 1];
+        }
+        m_del(mp_obj_t, elems, n * w);
     }
 
     return mp_const_none;
@@ -43,6 +43,11 @@ static NORETURN void bad_implicit_conversion(mp_obj_t self_in);
 
 static mp_obj_t mp_obj_new_str_type_from_vstr(const mp_obj_type_t *type, vstr_t *vstr);
 
+#if MICROPY_OPT_STR_INTERN
+static mp_obj_t str_intern_lookup(const byte *data, size_t len);
+static mp_obj_t str_intern_add(mp_obj_t str);
+#endif
+
 static void str_check_arg_type(const mp_obj_type_t *self_type, const mp_obj_t arg) {
     // String operations generally need the args type to match the object they're called on,
     // e.g. str.find(str), byte.startswith(byte)
@@ -114,12 +119,18 @@ void mp_str_print_json(const mp_print_t *print, const byte *str_data, size_t str
     // for JSON spec, see http://www.ietf.org/rfc/rfc4627.txt
     // if we are given a valid utf8-encoded string, we will print it in a JSON-conforming way
     mp_print_str(print, "\"");
+    const byte *run = str_data;
     for (const byte *s = str_data, *top = str_data + str_len; s < top; s++) {
+        if (*s >= 32 && *s != '"' && *s != '\\') {
+            // normal and utf-8 encoded chars are printed in runs
+            continue;
+        }
+        if (s > run) {
+            print->print_strn(print->data, (const char *)run, s - run);
+        }
+        run = s + 1;
         if (*s == '"' || *s == '\\') {
             mp_printf(print, "\\%c", *s);
-        } else if (*s >= 32) {
-            // this will handle normal and utf-8 encoded chars
-            mp_printf(print, "%c", *s);
         } else if (*s == '\n') {
             mp_print_str(print, "\\n");
         } else if (*s == '\r') {
@@ -131,6 +142,9 @@ void mp_str_print_json(const mp_print_t *print, const byte *str_data, size_t str
             mp_printf(print, "\\u%04x", *s);
         }
     }
+    if (str_data + str_len > run) {
+        print->print_strn(print->data, (const char *)run, str_data + str_len - run);
+    }
     mp_print_str(print, "\"");
 }
 #endif
@@ -199,9 +213,19 @@ mp_obj_t mp_obj_str_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_
                     return MP_OBJ_NEW_QSTR(q);
                 }
 
+                #if MICROPY_OPT_STR_INTERN
+                mp_obj_t cached = str_intern_lookup(str_data, str_len);
+                if (cached != MP_OBJ_NULL) {
+                    return cached;
+                }
+                #endif
+
                 mp_obj_str_t *o = MP_OBJ_TO_PTR(mp_obj_new_str_copy(type, NULL, str_len));
                 o->data = str_data;
                 o->hash = str_hash;
+                #if MICROPY_OPT_STR_INTERN
+                str_intern_add(MP_OBJ_FROM_PTR(o));
+                #endif
                 return MP_OBJ_FROM_PTR(o);
             } else {
                 mp_buffer_info_t bufinfo;
@@ -2195,6 +2219,39 @@ MP_DEFINE_CONST_OBJ_TYPE(
 // The zero-length bytes object, with data that includes a null-terminating byte
 const mp_obj_str_t mp_const_empty_bytes_obj = {{&mp_type_bytes}, 0, 0, (const byte *)""};
 
+#if MICROPY_OPT_STR_INTERN
+
+// The str intern cache holds recently created str objects of up to
+// MICROPY_OPT_STR_INTERN_MAX_LEN bytes, indexed by hash.  When a new str would
+// be equal to the cached one with the same index, the cached one is returned
+// instead, so that, for example, the words split from a text end up sharing
+// objects.  Entries are simply replaced on collision.
+
+static mp_obj_t str_intern_lookup(const byte *data, size_t len) {
+    if (len > MICROPY_OPT_STR_INTERN_MAX_LEN) {
+        return MP_OBJ_NULL;
+    }
+    size_t hash = qstr_compute_hash(data, len);
+    mp_obj_t cached = MP_STATE_THREAD(str_intern)[hash & (MICROPY_OPT_STR_INTERN_SIZE - 1)];
+    if (cached != MP_OBJ_NULL) {
+        mp_obj_str_t *o = MP_OBJ_TO_PTR(cached);
+        if (o->hash == hash && o->len == len && memcmp(o->data, data, len) == 0) {
+            return cached;
+        }
+    }
+    return MP_OBJ_NULL;
+}
+
+static mp_obj_t str_intern_add(mp_obj_t str) {
+    mp_obj_str_t *o = MP_OBJ_TO_PTR(str);
+    if (o->len <= MICROPY_OPT_STR_INTERN_MAX_LEN) {
+        MP_STATE_THREAD(str_intern)[o->hash & (MICROPY_OPT_STR_INTERN_SIZE - 1)] = str;
+    }
+    return str;
+}
+
+#endif
+
 // Create a str/bytes object using the given data.  New memory is allocated and
 // the data is copied across.  This function should only be used if the type is bytes,
 // or if the type is str and the string data is known to be not interned.
@@ -2238,10 +2295,16 @@ static mp_obj_t mp_obj_new_str_type_from_vstr(const mp_obj_type_t *type, vstr_t
     // if not a bytes object, look if a qstr with this data already exists
     if (type == &mp_type_str) {
         qstr q = qstr_find_strn(vstr->buf, vstr->len);
-        if (q != MP_QSTRnull) {
+        mp_obj_t existing = q != MP_QSTRnull ? MP_OBJ_NEW_QSTR(q) : MP_OBJ_NULL;
+        #if MICROPY_OPT_STR_INTERN
+        if (existing == MP_OBJ_NULL) {
+            existing = str_intern_lookup((byte *)vstr->buf, vstr->len);
+        }
+        #endif
+        if (existing != MP_OBJ_NULL) {
             vstr_clear(vstr);
             vstr->alloc = 0;
-            return MP_OBJ_NEW_QSTR(q);
+            return existing;
         }
     }
 
@@ -2263,6 +2326,11 @@ static mp_obj_t mp_obj_new_str_type_from_vstr(const mp_obj_type_t *type, vstr_t
     o->len = vstr->len;
     o->hash = qstr_compute_hash(data, vstr->len);
     o->data = data;
+    #if MICROPY_OPT_STR_INTERN
+    if (type == &mp_type_str) {
+        str_intern_add(MP_OBJ_FROM_PTR(o));
+    }
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -2298,7 +2366,15 @@ mp_obj_t mp_obj_new_str(const char *data, size_t len) {
         return MP_OBJ_NEW_QSTR(q);
     } else {
         // no existing qstr, don't make one
+        #if MICROPY_OPT_STR_INTERN
+        mp_obj_t cached = str_intern_lookup((const byte *)data, len);
+        if (cached != MP_OBJ_NULL) {
+            return cached;
+        }
+        return str_intern_add(mp_obj_new_str_copy(&mp_type_str, (const byte *)data, len));
+        #else
         return mp_obj_new_str_copy(&mp_type_str, (const byte *)data, len);
+        #endif
     }
 }
 
@@ -2321,6 +2397,24 @@ mp_obj_t mp_obj_new_bytes(const byte *data, size_t len) {
     return mp_obj_new_str_copy(&mp_type_bytes, data, len);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// Create a str/bytes object that references the given data instead of a copy of it.
+mp_obj_t mp_obj_new_str_static(const mp_obj_type_t *type, const byte *data, size_t len) {
+    assert(data[len] == '\0');
+    if (type == &mp_type_str) {
+        qstr q = qstr_find_strn((const char *)data, len);
+        if (q != MP_QSTRnull) {
+            return MP_OBJ_NEW_QSTR(q);
+        }
+    }
+    mp_obj_str_t *o = mp_obj_malloc(mp_obj_str_t, type);
+    o->len = len;
+    o->hash = qstr_compute_hash(data, len);
+    o->data = data;
+    return MP_OBJ_FROM_PTR(o);
+}
+#endif
+
 bool mp_obj_str_equal(mp_obj_t s1, mp_obj_t s2) {
     if (mp_obj_is_qstr(s1) && mp_obj_is_qstr(s2)) {
         return s1 == s2;
@@ -111,6 +111,13 @@ mp_obj_instance_t *mp_obj_new_instance(const mp_obj_type_t *class, const mp_obj_
     return o;
 }
 
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT || MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+size_t mp_obj_instance_num_native_bases(const mp_obj_type_t *cls) {
+    const mp_obj_type_t *native_base;
+    return instance_count_native_bases(cls, &native_base);
+}
+#endif
+
 // TODO
 // This implements depth-first left-to-right MRO, which is not compliant with Python3 MRO
 // http://python-history.blogspot.com/2010/06/method-resolution-order.html
@@ -583,6 +590,60 @@ static mp_obj_t instance_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t
     return res;
 }
 
+#if MICROPY_OPT_ATTR_CACHE
+
+// Search the same way as mp_obj_class_lookup, but just return the raw member
+// and the type it was found in.  Returns 1 if found, 0 if not found, and -1
+// if a native base was reached, because native bases can provide attributes
+// through their sub-object so the result can't be cached.
+static int class_lookup_member(const mp_obj_type_t *type, qstr attr, const mp_obj_type_t **owner, mp_obj_t *member) {
+    for (;;) {
+        if (mp_obj_is_native_type(type)) {
+            return -1;
+        }
+        if (MP_OBJ_TYPE_HAS_SLOT(type, locals_dict)) {
+            mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
+            mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+            if (elem != NULL) {
+                *owner = type;
+                *member = elem->value;
+                return 1;
+            }
+        }
+        if (!MP_OBJ_TYPE_HAS_SLOT(type, parent)) {
+            return 0;
+        #if MICROPY_MULTIPLE_INHERITANCE
+        } else if (((mp_obj_base_t *)MP_OBJ_TYPE_GET_SLOT(type, parent))->type == &mp_type_tuple) {
+            const mp_obj_tuple_t *parent_tuple = MP_OBJ_TYPE_GET_SLOT(type, parent);
+            const mp_obj_t *item = parent_tuple->items;
+            const mp_obj_t *top = item + parent_tuple->len - 1;
+            for (; item < top; ++item) {
+                const mp_obj_type_t *bt = (const mp_obj_type_t *)MP_OBJ_TO_PTR(*item);
+                if (bt == &mp_type_object) {
+                    continue;
+                }
+                int found = class_lookup_member(bt, attr, owner, member);
+                if (found != 0) {
+                    return found;
+                }
+            }
+            type = (const mp_obj_type_t *)MP_OBJ_TO_PTR(*item);
+        #endif
+        } else {
+            type = MP_OBJ_TYPE_GET_SLOT(type, parent);
+        }
+        if (type == &mp_type_object) {
+            return 0;
+        }
+    }
+}
+
+bool mp_obj_class_lookup_member(const mp_obj_type_t *type, qstr attr, const mp_obj_type_t **owner, mp_obj_t *member) {
+    return class_lookup_member(type, attr, owner, member) > 0;
+}
+
+#endif
+
 static void mp_obj_instance_load_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
     // logic: look in instance members then class locals
     assert(mp_obj_is_instance_type(mp_obj_get_type(self_in)));
@@ -1076,6 +1137,11 @@ static void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
     } else {
         // delete/store attribute
 
+        #if MICROPY_OPT_ATTR_CACHE
+        // any cached lookup may have gone through this type
+        MP_STATE_VM(attr_cache_version) += 1;
+        #endif
+
         if (MP_OBJ_TYPE_HAS_SLOT(self, locals_dict)) {
             assert(mp_obj_is_dict_or_ordereddict(MP_OBJ_FROM_PTR(MP_OBJ_TYPE_GET_SLOT(self, locals_dict)))); // MicroPython restriction, for now
             mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(self, locals_dict)->map;
@@ -1122,7 +1188,9 @@ MP_DEFINE_CONST_OBJ_TYPE(
     attr, type_attr
     );
 
-mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict) {
+// Create a class, in o if it's not NULL, which must then be zeroed and have room
+// for MP_OBJ_TYPE_CLASS_MAX_SLOTS slots.
+static mp_obj_type_t *type_new(mp_obj_type_t *o, qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict) {
     // Verify input objects have expected type
     if (!mp_obj_is_type(bases_tuple, &mp_type_tuple)) {
         mp_raise_TypeError(NULL);
@@ -1173,7 +1241,9 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
     // (currently 10, plus 1 for base, plus 1 for base-protocol).
     // Note: mp_obj_type_t is (2 + 3 + #slots) words, so going from 11 to 12 slots
     // moves from 4 to 5 gc blocks.
-    mp_obj_type_t *o = m_new_obj_var0(mp_obj_type_t, slots, void *, 10 + (bases_len ? 1 : 0) + (base_protocol ? 1 : 0));
+    if (o == NULL) {
+        o = m_new_obj_var0(mp_obj_type_t, slots, void *, 10 + (bases_len ? 1 : 0) + (base_protocol ? 1 : 0));
+    }
     o->base.type = &mp_type_type;
     o->flags = base_flags;
     o->name = name;
@@ -1241,9 +1311,19 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
         }
     }
 
-    return MP_OBJ_FROM_PTR(o);
+    return o;
 }
 
+mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict) {
+    return MP_OBJ_FROM_PTR(type_new(NULL, name, bases_tuple, locals_dict));
+}
+
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT
+void mp_obj_type_init(mp_obj_type_t *o, qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict) {
+    type_new(o, name, bases_tuple, locals_dict);
+}
+#endif
+
 /******************************************************************************/
 // super object
 
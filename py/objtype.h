@@ -42,6 +42,19 @@ typedef struct _mp_obj_instance_t {
 mp_obj_instance_t *mp_obj_new_instance(const mp_obj_type_t *cls, const mp_obj_type_t **native_base);
 #endif
 
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT || MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+// used with snapshots, to find how many subobj entries an instance has
+size_t mp_obj_instance_num_native_bases(const mp_obj_type_t *cls);
+#endif
+
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT
+// the most slots that a class created by mp_obj_new_type has
+#define MP_OBJ_TYPE_CLASS_MAX_SLOTS (12)
+// used when restoring a snapshot, to create a class in zeroed memory that other
+// objects already refer to, which has room for MP_OBJ_TYPE_CLASS_MAX_SLOTS slots
+void mp_obj_type_init(mp_obj_type_t *o, qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict);
+#endif
+
 // these need to be exposed so mp_obj_is_callable can work correctly
 bool mp_obj_instance_is_callable(mp_obj_t self_in);
 mp_obj_t mp_obj_instance_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
@@ -49,6 +62,11 @@ mp_obj_t mp_obj_instance_call(mp_obj_t self_in, size_t n_args, size_t n_kw, cons
 #define mp_obj_is_instance_type(type) ((type)->flags & MP_TYPE_FLAG_INSTANCE_TYPE)
 #define mp_obj_is_native_type(type) (!((type)->flags & MP_TYPE_FLAG_INSTANCE_TYPE))
 
+#if MICROPY_OPT_ATTR_CACHE
+// used by mp_load_method_cached to find a cacheable class attribute
+bool mp_obj_class_lookup_member(const mp_obj_type_t *type, qstr attr, const mp_obj_type_t **owner, mp_obj_t *member);
+#endif
+
 // this needs to be exposed for mp_getiter
 mp_obj_t mp_obj_instance_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf);
 
@@ -48,4 +48,10 @@ static inline mp_obj_t mp_parse_num_complex(const char *str, size_t len, mp_lexe
 mp_obj_t mp_parse_num_float(const char *str, size_t len, bool allow_imag, mp_lexer_t *lex);
 #endif
 
+#if MICROPY_PY_BUILTINS_FLOAT
+// Parse an optionally negative decimal number (no spaces, inf, nan or complex)
+// without creating an object.  Returns false if str isn't exactly such a number.
+bool mp_parse_num_float_value(const char *str, size_t len, mp_float_t *value);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_PARSENUM_H
@@ -63,6 +63,74 @@ typedef struct _bytecode_prelude_t {
     uint code_info_size;
 } bytecode_prelude_t;
 
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT || MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+
+// A snapshot of the state of a module can follow the outer raw code of a .mpy
+// file, as a uint giving its length and then the snapshot data, in which case
+// MPY_FEATURE_SNAPSHOT is set in the header.  Restoring it
+// recreates the objects reachable from the module's globals, without running
+// the module's top-level code.  The snapshot data contains:
+//  - the number of objects, then a shell for each object, being its kind and
+//    either the whole object (for constants) or enough to allocate it (for
+//    mutable objects);
+//  - the number of records, then the records, each being an object id and the
+//    contents of that object, which create the immutable objects (eg functions
+//    and tuples) and fill in the mutable ones (eg lists and classes);
+//  - the number of entries in the module's globals dict, then the entries.
+// Mutable objects are allocated before any records are processed, so that they
+// can be part of cycles, and records are ordered so that the objects a record
+// depends on are complete before it is processed.  References to objects are
+// a uint with the kind of reference in the low 2 bits.  qstrs are indices into
+// the qstr table of the .mpy file, and functions are found by their path in the
+// tree of raw code.
+
+enum {
+    SNAPSHOT_REF_OBJ,
+    SNAPSHOT_REF_SMALL_INT,
+    SNAPSHOT_REF_QSTR,
+    SNAPSHOT_REF_SPECIAL,
+};
+
+enum {
+    SNAPSHOT_SPECIAL_NULL,
+    SNAPSHOT_SPECIAL_NONE,
+    SNAPSHOT_SPECIAL_FALSE,
+    SNAPSHOT_SPECIAL_TRUE,
+    SNAPSHOT_SPECIAL_ELLIPSIS,
+    SNAPSHOT_SPECIAL_INT, // followed by a small int that doesn't fit in a ref
+    SNAPSHOT_SPECIAL_CONST, // followed by an immediate constant object, eg a float
+    SNAPSHOT_SPECIAL_MODULE, // followed by the qstr of the module name
+    SNAPSHOT_SPECIAL_MODULE_ATTR, // followed by the qstrs of the module and attribute names
+};
+
+enum {
+    // constant objects, with no record
+    SNAPSHOT_OBJ_CONST, // saved in the same way as the .mpy constant table
+    SNAPSHOT_OBJ_BYTEARRAY,
+    // immutable objects, created by their record
+    SNAPSHOT_OBJ_TUPLE,
+    SNAPSHOT_OBJ_FROZENSET,
+    SNAPSHOT_OBJ_FUN,
+    SNAPSHOT_OBJ_CLOSURE,
+    SNAPSHOT_OBJ_BOUND_METH,
+    SNAPSHOT_OBJ_STATICMETHOD,
+    SNAPSHOT_OBJ_CLASSMETHOD,
+    SNAPSHOT_OBJ_PROPERTY,
+    // mutable objects, allocated from their shell and filled in by their record
+    SNAPSHOT_OBJ_LIST,
+    SNAPSHOT_OBJ_DICT,
+    SNAPSHOT_OBJ_ORDEREDDICT,
+    SNAPSHOT_OBJ_SET,
+    SNAPSHOT_OBJ_CELL,
+    SNAPSHOT_OBJ_TYPE,
+    SNAPSHOT_OBJ_INSTANCE,
+};
+
+#define SNAPSHOT_OBJ_HAS_RECORD(kind) ((kind) >= SNAPSHOT_OBJ_TUPLE)
+#define SNAPSHOT_OBJ_IS_MUTABLE(kind) ((kind) >= SNAPSHOT_OBJ_LIST)
+
+#endif
+
 #endif // MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE
 
 #if MICROPY_PERSISTENT_CODE_LOAD
@@ -152,20 +220,29 @@ void mp_native_relocate(void *ri_in, uint8_t *text, uintptr_t reloc_text) {
 
 #endif
 
+static NORETURN void raise_incompatible(void) {
+    mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+}
+
 static int read_byte(mp_reader_t *reader) {
-    return reader->readbyte(reader->data);
+    mp_uint_t b = reader->readbyte(reader->data);
+    if (b == MP_READER_EOF) {
+        // The file is truncated.
+        raise_incompatible();
+    }
+    return b;
 }
 
 static void read_bytes(mp_reader_t *reader, byte *buf, size_t len) {
-    while (len-- > 0) {
-        *buf++ = reader->readbyte(reader->data);
+    if (mp_reader_readbytes(reader, buf, len) != len) {
+        raise_incompatible();
     }
 }
 
 static size_t read_uint(mp_reader_t *reader) {
     size_t unum = 0;
     for (;;) {
-        byte b = reader->readbyte(reader->data);
+        byte b = read_byte(reader);
         unum = (unum << 7) | (b & 0x7f);
         if ((b & 0x80) == 0) {
             break;
@@ -216,6 +293,19 @@ static mp_obj_t load_obj(mp_reader_t *reader) {
             }
             return MP_OBJ_FROM_PTR(tuple);
         }
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+        if (obj_type == MP_PERSISTENT_OBJ_STR || obj_type == MP_PERSISTENT_OBJ_BYTES) {
+            // If possible, reference the memory-mapped string data.
+            const byte *rom = mp_reader_try_read_rom(reader, len + 1);
+            if (rom != NULL) {
+                if (rom[len] != '\0') {
+                    raise_incompatible();
+                }
+                const mp_obj_type_t *type = obj_type == MP_PERSISTENT_OBJ_STR ? &mp_type_str : &mp_type_bytes;
+                return mp_obj_new_str_static(type, rom, len);
+            }
+        }
+        #endif
         vstr_t vstr;
         vstr_init_len(&vstr, len);
         read_bytes(reader, (byte *)vstr.buf, len);
@@ -257,10 +347,17 @@ static mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
     #endif
 
     if (kind == MP_CODE_BYTECODE) {
-        // Allocate memory for the bytecode
-        fun_data = m_new(uint8_t, fun_data_len);
-        // Load bytecode
-        read_bytes(reader, fun_data, fun_data_len);
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+        // If possible, execute the bytecode in place from the memory-mapped data.
+        fun_data = (uint8_t *)mp_reader_try_read_rom(reader, fun_data_len);
+        if (fun_data == NULL)
+        #endif
+        {
+            // Allocate memory for the bytecode
+            fun_data = m_new(uint8_t, fun_data_len);
+            // Load bytecode
+            read_bytes(reader, fun_data, fun_data_len);
+        }
 
     #if MICROPY_EMIT_MACHINE_CODE
     } else {
@@ -396,6 +493,9 @@ static mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
             );
     #endif
     }
+    #if MICROPY_PERSISTENT_CODE_SNAPSHOT && !MICROPY_PERSISTENT_CODE_SAVE
+    rc->n_children = n_children;
+    #endif
     return rc;
 }
 
@@ -411,7 +511,7 @@ void mp_raw_code_load(mp_reader_t *reader, mp_compiled_module_t *cm) {
         || header[1] != MPY_VERSION
         || (arch != MP_NATIVE_ARCH_NONE && MPY_FEATURE_DECODE_SUB_VERSION(header[2]) != MPY_SUB_VERSION)
         || header[3] > MP_SMALL_INT_BITS) {
-        mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+        raise_incompatible();
     }
     if (MPY_FEATURE_DECODE_ARCH(header[2]) != MP_NATIVE_ARCH_NONE) {
         if (!MPY_FEATURE_ARCH_TEST(arch)) {
@@ -442,11 +542,31 @@ void mp_raw_code_load(mp_reader_t *reader, mp_compiled_module_t *cm) {
     // Load top-level module.
     cm->rc = load_raw_code(reader, cm->context);
 
+    #if MICROPY_PERSISTENT_CODE_SNAPSHOT
+    // Load the snapshot of the module's state, if there is one.
+    cm->snapshot = NULL;
+    cm->snapshot_len = 0;
+    if (header[2] & MPY_FEATURE_SNAPSHOT) {
+        size_t len = read_uint(reader);
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+        cm->snapshot = mp_reader_try_read_rom(reader, len);
+        #endif
+        if (cm->snapshot == NULL) {
+            byte *buf = m_new(byte, len);
+            read_bytes(reader, buf, len);
+            cm->snapshot = buf;
+        }
+        cm->snapshot_len = len;
+    }
+    #endif
+
     #if MICROPY_PERSISTENT_CODE_SAVE
     cm->has_native = MPY_FEATURE_DECODE_ARCH(header[2]) != MP_NATIVE_ARCH_NONE;
-    cm->n_qstr = n_qstr;
     cm->n_obj = n_obj;
     #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_PERSISTENT_CODE_SNAPSHOT
+    cm->n_qstr = n_qstr;
+    #endif
 
     // Deregister exception handler and close the reader.
     nlr_pop_jump_callback(true);
@@ -468,6 +588,344 @@ void mp_raw_code_load_file(qstr filename, mp_compiled_module_t *context) {
 
 #endif // MICROPY_HAS_FILE_READER
 
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT
+
+#include "py/objtype.h"
+
+// Set in the kind of a mutable object once its record has filled it in.
+#define SNAPSHOT_KIND_FILLED (0x80)
+
+typedef struct _snapshot_load_t {
+    mp_reader_t *reader;
+    const mp_module_context_t *context;
+    size_t n_qstr;
+    mp_proto_fun_t proto_fun;
+    size_t n_obj;
+    mp_obj_t *objs;
+    byte *kinds;
+} snapshot_load_t;
+
+static NORETURN void snapshot_raise_invalid(void) {
+    mp_raise_ValueError(MP_ERROR_TEXT("invalid snapshot"));
+}
+
+static qstr snapshot_get_qstr(snapshot_load_t *sl, size_t idx) {
+    if (idx >= sl->n_qstr) {
+        snapshot_raise_invalid();
+    }
+    return sl->context->constants.qstr_table[idx];
+}
+
+static qstr snapshot_load_qstr(snapshot_load_t *sl) {
+    return snapshot_get_qstr(sl, read_uint(sl->reader));
+}
+
+static mp_obj_t snapshot_load_ref(snapshot_load_t *sl) {
+    size_t ref = read_uint(sl->reader);
+    size_t arg = ref >> 2;
+    switch (ref & 3) {
+        case SNAPSHOT_REF_OBJ:
+            if (arg >= sl->n_obj || sl->objs[arg] == MP_OBJ_NULL) {
+                snapshot_raise_invalid();
+            }
+            return sl->objs[arg];
+        case SNAPSHOT_REF_SMALL_INT:
+            return MP_OBJ_NEW_SMALL_INT((arg & 1) ? -(mp_int_t)(arg >> 1) - 1 : (mp_int_t)(arg >> 1));
+        case SNAPSHOT_REF_QSTR:
+            return MP_OBJ_NEW_QSTR(snapshot_get_qstr(sl, arg));
+    }
+    switch (arg) {
+        case SNAPSHOT_SPECIAL_NULL:
+            return MP_OBJ_NULL;
+        case SNAPSHOT_SPECIAL_NONE:
+            return mp_const_none;
+        case SNAPSHOT_SPECIAL_FALSE:
+            return mp_const_false;
+        case SNAPSHOT_SPECIAL_TRUE:
+            return mp_const_true;
+        case SNAPSHOT_SPECIAL_ELLIPSIS:
+            return MP_OBJ_FROM_PTR(&mp_const_ellipsis_obj);
+        case SNAPSHOT_SPECIAL_INT: {
+            size_t n = read_uint(sl->reader);
+            return mp_obj_new_int((n & 1) ? -(mp_int_t)(n >> 1) - 1 : (mp_int_t)(n >> 1));
+        }
+        case SNAPSHOT_SPECIAL_CONST:
+            return load_obj(sl->reader);
+        case SNAPSHOT_SPECIAL_MODULE:
+        case SNAPSHOT_SPECIAL_MODULE_ATTR: {
+            qstr module_name = snapshot_load_qstr(sl);
+            mp_map_elem_t *elem = mp_map_lookup(&MP_STATE_VM(mp_loaded_modules_dict).map, MP_OBJ_NEW_QSTR(module_name), MP_MAP_LOOKUP);
+            mp_obj_t module;
+            if (elem != NULL) {
+                module = elem->value;
+            } else {
+                module = mp_import_name(module_name, mp_const_true, MP_OBJ_NEW_SMALL_INT(0));
+            }
+            if (arg == SNAPSHOT_SPECIAL_MODULE) {
+                return module;
+            }
+            return mp_load_attr(module, snapshot_load_qstr(sl));
+        }
+        default:
+            snapshot_raise_invalid();
+    }
+}
+
+static mp_obj_t snapshot_load_fun(snapshot_load_t *sl) {
+    // Find the raw code by its path from the outer raw code.
+    mp_proto_fun_t proto_fun = sl->proto_fun;
+    for (size_t depth = read_uint(sl->reader); depth > 0; --depth) {
+        // A frozen function without children may be just its bytecode.
+        if (mp_proto_fun_is_bytecode(proto_fun)) {
+            snapshot_raise_invalid();
+        }
+        const mp_raw_code_t *rc = proto_fun;
+        size_t child = read_uint(sl->reader);
+        if (child >= rc->n_children) {
+            snapshot_raise_invalid();
+        }
+        proto_fun = rc->children[child];
+    }
+
+    // Load the default positional args and the default keyword args dict.
+    size_t n_def = read_uint(sl->reader);
+    mp_obj_t def_args[2] = {MP_OBJ_NULL, MP_OBJ_NULL};
+    if (n_def >> 1 != 0) {
+        def_args[0] = mp_obj_new_tuple(n_def >> 1, NULL);
+        mp_obj_tuple_t *tuple = MP_OBJ_TO_PTR(def_args[0]);
+        for (size_t i = 0; i < tuple->len; ++i) {
+            tuple->items[i] = snapshot_load_ref(sl);
+        }
+    }
+    if (n_def & 1) {
+        def_args[1] = snapshot_load_ref(sl);
+    }
+    return mp_make_function_from_proto_fun(proto_fun, sl->context, def_args);
+}
+
+static mp_obj_t snapshot_load_immutable(snapshot_load_t *sl, byte kind) {
+    switch (kind) {
+        case SNAPSHOT_OBJ_TUPLE: {
+            size_t n = read_uint(sl->reader);
+            mp_obj_tuple_t *tuple = MP_OBJ_TO_PTR(mp_obj_new_tuple(n, NULL));
+            for (size_t i = 0; i < n; ++i) {
+                tuple->items[i] = snapshot_load_ref(sl);
+            }
+            return MP_OBJ_FROM_PTR(tuple);
+        }
+        #if MICROPY_PY_BUILTINS_FROZENSET
+        case SNAPSHOT_OBJ_FROZENSET: {
+            mp_obj_t set = mp_obj_new_set(0, NULL);
+            for (size_t n = read_uint(sl->reader); n > 0; --n) {
+                mp_obj_set_store(set, snapshot_load_ref(sl));
+            }
+            ((mp_obj_base_t *)MP_OBJ_TO_PTR(set))->type = &mp_type_frozenset;
+            return set;
+        }
+        #endif
+        case SNAPSHOT_OBJ_FUN:
+            return snapshot_load_fun(sl);
+        case SNAPSHOT_OBJ_CLOSURE: {
+            mp_obj_t fun = snapshot_load_ref(sl);
+            size_t n = read_uint(sl->reader);
+            mp_obj_closure_t *closure = mp_obj_malloc_var(mp_obj_closure_t, closed, mp_obj_t, n, &mp_type_closure);
+            closure->fun = fun;
+            closure->n_closed = n;
+            for (size_t i = 0; i < n; ++i) {
+                closure->closed[i] = snapshot_load_ref(sl);
+            }
+            return MP_OBJ_FROM_PTR(closure);
+        }
+        case SNAPSHOT_OBJ_BOUND_METH: {
+            mp_obj_t meth = snapshot_load_ref(sl);
+            mp_obj_t self = snapshot_load_ref(sl);
+            return mp_obj_new_bound_meth(meth, self);
+        }
+        case SNAPSHOT_OBJ_STATICMETHOD:
+        case SNAPSHOT_OBJ_CLASSMETHOD: {
+            const mp_obj_type_t *type = kind == SNAPSHOT_OBJ_STATICMETHOD ? &mp_type_staticmethod : &mp_type_classmethod;
+            mp_obj_static_class_method_t *o = mp_obj_malloc(mp_obj_static_class_method_t, type);
+            o->fun = snapshot_load_ref(sl);
+            return MP_OBJ_FROM_PTR(o);
+        }
+        #if MICROPY_PY_BUILTINS_PROPERTY
+        case SNAPSHOT_OBJ_PROPERTY: {
+            mp_obj_t args[3];
+            for (size_t i = 0; i < 3; ++i) {
+                args[i] = snapshot_load_ref(sl);
+            }
+            return MP_OBJ_TYPE_GET_SLOT(&mp_type_property, make_new)(&mp_type_property, 3, 0, args);
+        }
+        #endif
+        default:
+            snapshot_raise_invalid();
+    }
+}
+
+static void snapshot_fill_mutable(snapshot_load_t *sl, byte kind, mp_obj_t o) {
+    switch (kind) {
+        case SNAPSHOT_OBJ_LIST: {
+            size_t len;
+            mp_obj_t *items;
+            mp_obj_list_get(o, &len, &items);
+            for (size_t i = 0; i < len; ++i) {
+                items[i] = snapshot_load_ref(sl);
+            }
+            break;
+        }
+        case SNAPSHOT_OBJ_DICT:
+        case SNAPSHOT_OBJ_ORDEREDDICT:
+            for (size_t n = read_uint(sl->reader); n > 0; --n) {
+                mp_obj_t key = snapshot_load_ref(sl);
+                mp_obj_t value = snapshot_load_ref(sl);
+                mp_obj_dict_store(o, key, value);
+            }
+            break;
+        #if MICROPY_PY_BUILTINS_SET
+        case SNAPSHOT_OBJ_SET:
+            for (size_t n = read_uint(sl->reader); n > 0; --n) {
+                mp_obj_set_store(o, snapshot_load_ref(sl));
+            }
+            break;
+        #endif
+        case SNAPSHOT_OBJ_CELL:
+            mp_obj_cell_set(o, snapshot_load_ref(sl));
+            break;
+        case SNAPSHOT_OBJ_TYPE: {
+            // Create the class in the shell that other objects already refer to.
+            qstr name = snapshot_load_qstr(sl);
+            size_t n_bases = read_uint(sl->reader);
+            mp_obj_tuple_t *bases = MP_OBJ_TO_PTR(mp_obj_new_tuple(n_bases, NULL));
+            for (size_t i = 0; i < n_bases; ++i) {
+                bases->items[i] = snapshot_load_ref(sl);
+            }
+            mp_obj_t locals_dict = snapshot_load_ref(sl);
+            mp_obj_type_init(MP_OBJ_TO_PTR(o), name, MP_OBJ_FROM_PTR(bases), locals_dict);
+            break;
+        }
+        case SNAPSHOT_OBJ_INSTANCE: {
+            // The shell has no subobj entries, so its class, which is filled in
+            // before its instances, must have no native base.
+            mp_obj_instance_t *self = MP_OBJ_TO_PTR(o);
+            if (!mp_obj_is_instance_type(self->base.type) || mp_obj_instance_num_native_bases(self->base.type) != 0) {
+                snapshot_raise_invalid();
+            }
+            for (size_t n = read_uint(sl->reader); n > 0; --n) {
+                mp_obj_t key = snapshot_load_ref(sl);
+                mp_obj_t value = snapshot_load_ref(sl);
+                mp_map_lookup(&self->members, key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = value;
+            }
+            break;
+        }
+        default:
+            snapshot_raise_invalid();
+    }
+}
+
+static mp_obj_t snapshot_load_shell(snapshot_load_t *sl, byte kind) {
+    switch (kind) {
+        case SNAPSHOT_OBJ_CONST:
+            return load_obj(sl->reader);
+        #if MICROPY_PY_BUILTINS_BYTEARRAY
+        case SNAPSHOT_OBJ_BYTEARRAY: {
+            size_t len = read_uint(sl->reader);
+            byte *buf = m_new(byte, len);
+            read_bytes(sl->reader, buf, len);
+            return mp_obj_new_bytearray_by_ref(len, buf);
+        }
+        #endif
+        case SNAPSHOT_OBJ_LIST:
+            return mp_obj_new_list(read_uint(sl->reader), NULL);
+        case SNAPSHOT_OBJ_DICT:
+            return mp_obj_new_dict(read_uint(sl->reader));
+        #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
+        case SNAPSHOT_OBJ_ORDEREDDICT:
+            return mp_obj_dict_make_new(&mp_type_ordereddict, 0, 0, NULL);
+        #endif
+        #if MICROPY_PY_BUILTINS_SET
+        case SNAPSHOT_OBJ_SET:
+            return mp_obj_new_set(0, NULL);
+        #endif
+        case SNAPSHOT_OBJ_CELL:
+            return mp_obj_new_cell(MP_OBJ_NULL);
+        case SNAPSHOT_OBJ_TYPE: {
+            mp_obj_type_t *type = m_new_obj_var0(mp_obj_type_t, slots, void *, MP_OBJ_TYPE_CLASS_MAX_SLOTS);
+            type->base.type = &mp_type_type;
+            return MP_OBJ_FROM_PTR(type);
+        }
+        case SNAPSHOT_OBJ_INSTANCE: {
+            mp_obj_t type = snapshot_load_ref(sl);
+            if (!mp_obj_is_type(type, &mp_type_type)) {
+                snapshot_raise_invalid();
+            }
+            mp_obj_instance_t *o = mp_obj_malloc(mp_obj_instance_t, MP_OBJ_TO_PTR(type));
+            mp_map_init(&o->members, 0);
+            return MP_OBJ_FROM_PTR(o);
+        }
+        default:
+            // Immutable objects are created later, by their record.
+            if (!SNAPSHOT_OBJ_HAS_RECORD(kind) || SNAPSHOT_OBJ_IS_MUTABLE(kind)) {
+                snapshot_raise_invalid();
+            }
+            return MP_OBJ_NULL;
+    }
+}
+
+void mp_raw_code_load_snapshot(mp_reader_t *reader, const mp_module_context_t *context, size_t n_qstr, mp_proto_fun_t proto_fun) {
+    // Set exception handler to close the reader if an exception is raised.
+    MP_DEFINE_NLR_JUMP_CALLBACK_FUNCTION_1(ctx, reader->close, reader->data);
+    nlr_push_jump_callback(&ctx.callback, mp_call_function_1_from_nlr_jump_callback);
+
+    snapshot_load_t sl = {reader, context, n_qstr, proto_fun, 0, NULL, NULL};
+
+    // Allocate all the objects, so records can refer to mutable objects before
+    // they are filled in.
+    sl.n_obj = read_uint(reader);
+    sl.objs = m_new0(mp_obj_t, sl.n_obj);
+    sl.kinds = m_new(byte, sl.n_obj);
+    for (size_t i = 0; i < sl.n_obj; ++i) {
+        sl.kinds[i] = read_byte(reader);
+        sl.objs[i] = snapshot_load_shell(&sl, sl.kinds[i]);
+    }
+
+    // Create the immutable objects and fill in the mutable ones.
+    for (size_t n = read_uint(reader); n > 0; --n) {
+        size_t id = read_uint(reader);
+        if (id >= sl.n_obj || !SNAPSHOT_OBJ_HAS_RECORD(sl.kinds[id]) || (sl.kinds[id] & SNAPSHOT_KIND_FILLED)) {
+            snapshot_raise_invalid();
+        }
+        if (SNAPSHOT_OBJ_IS_MUTABLE(sl.kinds[id])) {
+            snapshot_fill_mutable(&sl, sl.kinds[id], sl.objs[id]);
+            sl.kinds[id] |= SNAPSHOT_KIND_FILLED;
+        } else {
+            sl.objs[id] = snapshot_load_immutable(&sl, sl.kinds[id]);
+        }
+    }
+
+    // Every mutable object must have been filled in, so that its contents, and
+    // the class of an instance, have been checked.
+    for (size_t i = 0; i < sl.n_obj; ++i) {
+        if (SNAPSHOT_OBJ_IS_MUTABLE(sl.kinds[i]) && !(sl.kinds[i] & SNAPSHOT_KIND_FILLED)) {
+            snapshot_raise_invalid();
+        }
+    }
+
+    // Populate the module's globals.
+    for (size_t n = read_uint(reader); n > 0; --n) {
+        mp_obj_t key = snapshot_load_ref(&sl);
+        mp_obj_t value = snapshot_load_ref(&sl);
+        mp_obj_dict_store(MP_OBJ_FROM_PTR(context->module.globals), key, value);
+    }
+
+    m_del(mp_obj_t, sl.objs, sl.n_obj);
+    m_del(byte, sl.kinds, sl.n_obj);
+
+    // Deregister exception handler and close the reader.
+    nlr_pop_jump_callback(true);
+}
+
+#endif // MICROPY_PERSISTENT_CODE_SNAPSHOT
+
 #endif // MICROPY_PERSISTENT_CODE_LOAD
 
 #if MICROPY_PERSISTENT_CODE_SAVE
@@ -601,16 +1059,16 @@ static void save_raw_code(mp_print_t *print, const mp_raw_code_t *rc) {
     }
 }
 
-void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print) {
+static void save_module(mp_compiled_module_t *cm, mp_print_t *print, byte features) {
     // header contains:
     //  byte  'M'
     //  byte  version
-    //  byte  native arch (and sub-version if native)
+    //  byte  native arch (and sub-version if native), and other features
     //  byte  number of bits in a small int
     byte header[4] = {
         'M',
         MPY_VERSION,
-        cm->has_native ? MPY_FEATURE_ENCODE_SUB_VERSION(MPY_SUB_VERSION) | MPY_FEATURE_ENCODE_ARCH(MPY_FEATURE_ARCH_DYNAMIC) : 0,
+        features | (cm->has_native ? MPY_FEATURE_ENCODE_SUB_VERSION(MPY_SUB_VERSION) | MPY_FEATURE_ENCODE_ARCH(MPY_FEATURE_ARCH_DYNAMIC) : 0),
         #if MICROPY_DYNAMIC_COMPILER
         mp_dynamic_compiler.small_int_bits,
         #else
@@ -637,6 +1095,619 @@ void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print) {
     save_raw_code(print, cm->rc);
 }
 
+void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print) {
+    save_module(cm, print, 0);
+}
+
+#if MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+
+#include "py/cstack.h"
+#include "py/objfun.h"
+#include "py/objmodule.h"
+#include "py/objtype.h"
+
+// The maximum depth of a function in the raw code tree that can be snapshotted.
+#define SNAPSHOT_MAX_FUN_DEPTH (16)
+
+// Key for maps of objects, so that the maps never call __hash__ or __eq__.
+#define SNAPSHOT_KEY(o) MP_OBJ_NEW_SMALL_INT((uintptr_t)MP_OBJ_TO_PTR(o) >> 2)
+
+// How snapshot_contents processes the children of an object.
+enum {
+    SNAPSHOT_MODE_VISIT,
+    SNAPSHOT_MODE_DEPS_IMMUTABLE,
+    SNAPSHOT_MODE_DEPS_MUTABLE,
+    SNAPSHOT_MODE_WRITE,
+};
+
+typedef struct _snapshot_save_t {
+    mp_compiled_module_t *cm;
+    mp_obj_t module_name;
+    mp_map_t names; // object -> qstr of module name, or tuple of module and attribute qstrs
+    mp_map_t ids; // object -> id
+    mp_obj_t objs; // list of objects, in id order
+    vstr_t kinds;
+    byte *done;
+    mp_map_t qstrs; // qstr -> index in qstr_table
+    qstr_short_t *qstr_table;
+    size_t n_qstr;
+    size_t n_records;
+    vstr_t shells;
+    vstr_t records;
+    mp_print_t shells_print;
+    mp_print_t records_print;
+} snapshot_save_t;
+
+static void snapshot_visit(snapshot_save_t *ss, mp_obj_t o);
+static void snapshot_emit(snapshot_save_t *ss, mp_obj_t o, bool mutable);
+
+static NORETURN void snapshot_raise_unsupported(mp_obj_t o) {
+    mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("can't snapshot '%s' object"), mp_obj_get_type_str(o));
+}
+
+static bool snapshot_is_immediate(mp_obj_t o) {
+    return o == MP_OBJ_NULL || !mp_obj_is_obj(o)
+           || o == mp_const_none || o == mp_const_false || o == mp_const_true
+           || MP_OBJ_TO_PTR(o) == &mp_const_ellipsis_obj;
+}
+
+static bool snapshot_is_fun(mp_obj_t o) {
+    return mp_obj_is_type(o, &mp_type_fun_bc) || mp_obj_is_type(o, &mp_type_gen_wrap)
+           #if MICROPY_EMIT_NATIVE
+           || mp_obj_is_type(o, &mp_type_fun_native) || mp_obj_is_type(o, &mp_type_native_gen_wrap)
+           || mp_obj_is_type(o, &mp_type_fun_viper)
+           #endif
+    ;
+}
+
+static bool snapshot_is_const(mp_obj_t o) {
+    const mp_obj_type_t *type = mp_obj_get_type(o);
+    return type == &mp_type_str || type == &mp_type_bytes || type == &mp_type_int
+           #if MICROPY_PY_BUILTINS_FLOAT
+           || type == &mp_type_float
+           #endif
+           #if MICROPY_PY_BUILTINS_COMPLEX
+           || type == &mp_type_complex
+           #endif
+    ;
+}
+
+// Whether the object belongs to the module being snapshotted, so must be saved
+// even if it's also reachable from another module.
+static bool snapshot_is_own(snapshot_save_t *ss, mp_obj_t o) {
+    if (snapshot_is_fun(o)) {
+        return ((mp_obj_fun_bc_t *)MP_OBJ_TO_PTR(o))->context == ss->cm->context;
+    }
+    if (mp_obj_is_type(o, &mp_type_type) && mp_obj_is_instance_type((mp_obj_type_t *)MP_OBJ_TO_PTR(o))) {
+        mp_obj_dict_t *locals_dict = MP_OBJ_TYPE_GET_SLOT_OR_NULL((mp_obj_type_t *)MP_OBJ_TO_PTR(o), locals_dict);
+        mp_map_elem_t *elem = mp_map_lookup(&locals_dict->map, MP_OBJ_NEW_QSTR(MP_QSTR___module__), MP_MAP_LOOKUP);
+        return elem != NULL && mp_obj_equal(elem->value, ss->module_name);
+    }
+    return false;
+}
+
+static byte snapshot_kind(snapshot_save_t *ss, mp_obj_t o) {
+    if (snapshot_is_const(o)) {
+        return SNAPSHOT_OBJ_CONST;
+    } else if (snapshot_is_fun(o)) {
+        if (!snapshot_is_own(ss, o)) {
+            snapshot_raise_unsupported(o);
+        }
+        return SNAPSHOT_OBJ_FUN;
+    }
+    const mp_obj_type_t *type = mp_obj_get_type(o);
+    if (0) {
+    #if MICROPY_PY_BUILTINS_BYTEARRAY
+    } else if (type == &mp_type_bytearray) {
+        return SNAPSHOT_OBJ_BYTEARRAY;
+    #endif
+    } else if (type == &mp_type_tuple) {
+        return SNAPSHOT_OBJ_TUPLE;
+    #if MICROPY_PY_BUILTINS_FROZENSET
+    } else if (type == &mp_type_frozenset) {
+        return SNAPSHOT_OBJ_FROZENSET;
+    #endif
+    } else if (type == &mp_type_closure) {
+        return SNAPSHOT_OBJ_CLOSURE;
+    } else if (type == &mp_type_bound_meth) {
+        return SNAPSHOT_OBJ_BOUND_METH;
+    } else if (type == &mp_type_staticmethod) {
+        return SNAPSHOT_OBJ_STATICMETHOD;
+    } else if (type == &mp_type_classmethod) {
+        return SNAPSHOT_OBJ_CLASSMETHOD;
+    #if MICROPY_PY_BUILTINS_PROPERTY
+    } else if (type == &mp_type_property) {
+        return SNAPSHOT_OBJ_PROPERTY;
+    #endif
+    } else if (type == &mp_type_list) {
+        return SNAPSHOT_OBJ_LIST;
+    } else if (type == &mp_type_dict) {
+        return SNAPSHOT_OBJ_DICT;
+    #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
+    } else if (type == &mp_type_ordereddict) {
+        return SNAPSHOT_OBJ_ORDEREDDICT;
+    #endif
+    #if MICROPY_PY_BUILTINS_SET
+    } else if (type == &mp_type_set) {
+        return SNAPSHOT_OBJ_SET;
+    #endif
+    } else if (type == &mp_type_cell) {
+        return SNAPSHOT_OBJ_CELL;
+    } else if (type == &mp_type_type && mp_obj_is_instance_type((mp_obj_type_t *)MP_OBJ_TO_PTR(o))) {
+        return SNAPSHOT_OBJ_TYPE;
+    } else if (mp_obj_is_instance_type(type) && mp_obj_instance_num_native_bases(type) == 0) {
+        return SNAPSHOT_OBJ_INSTANCE;
+    }
+    snapshot_raise_unsupported(o);
+}
+
+static mp_map_elem_t *snapshot_lookup(mp_map_t *map, mp_obj_t o) {
+    return mp_map_lookup(map, SNAPSHOT_KEY(o), MP_MAP_LOOKUP);
+}
+
+static size_t snapshot_qstr_index(snapshot_save_t *ss, qstr qst) {
+    mp_map_elem_t *elem = mp_map_lookup(&ss->qstrs, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+    if (elem->value == MP_OBJ_NULL) {
+        // Append the qstr to the module's qstr table.
+        if (qst > (qstr_short_t)-1) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("can't snapshot qstr"));
+        }
+        ss->qstr_table = m_renew(qstr_short_t, ss->qstr_table, ss->n_qstr, ss->n_qstr + 1);
+        ss->qstr_table[ss->n_qstr] = qst;
+        elem->value = MP_OBJ_NEW_SMALL_INT(ss->n_qstr++);
+    }
+    return MP_OBJ_SMALL_INT_VALUE(elem->value);
+}
+
+static void snapshot_save_special(mp_print_t *print, size_t special) {
+    mp_print_uint(print, special << 2 | SNAPSHOT_REF_SPECIAL);
+}
+
+static void snapshot_save_ref(snapshot_save_t *ss, mp_print_t *print, mp_obj_t o) {
+    if (o == MP_OBJ_NULL) {
+        snapshot_save_special(print, SNAPSHOT_SPECIAL_NULL);
+    } else if (mp_obj_is_small_int(o)) {
+        // Save the value zigzag encoded, so small negative numbers stay small.
+        mp_int_t value = MP_OBJ_SMALL_INT_VALUE(o);
+        size_t n = value < 0 ? (~(size_t)value) << 1 | 1 : (size_t)value << 1;
+        if (n >> (MP_BYTES_PER_OBJ_WORD * 8 - 2) == 0) {
+            mp_print_uint(print, n << 2 | SNAPSHOT_REF_SMALL_INT);
+        } else {
+            snapshot_save_special(print, SNAPSHOT_SPECIAL_INT);
+            mp_print_uint(print, n);
+        }
+    } else if (mp_obj_is_qstr(o)) {
+        mp_print_uint(print, snapshot_qstr_index(ss, MP_OBJ_QSTR_VALUE(o)) << 2 | SNAPSHOT_REF_QSTR);
+    } else if (o == mp_const_none) {
+        snapshot_save_special(print, SNAPSHOT_SPECIAL_NONE);
+    } else if (o == mp_const_false) {
+        snapshot_save_special(print, SNAPSHOT_SPECIAL_FALSE);
+    } else if (o == mp_const_true) {
+        snapshot_save_special(print, SNAPSHOT_SPECIAL_TRUE);
+    } else if (MP_OBJ_TO_PTR(o) == &mp_const_ellipsis_obj) {
+        snapshot_save_special(print, SNAPSHOT_SPECIAL_ELLIPSIS);
+    } else if (!mp_obj_is_obj(o)) {
+        snapshot_save_special(print, SNAPSHOT_SPECIAL_CONST);
+        save_obj(print, o);
+    } else {
+        mp_map_elem_t *elem = snapshot_lookup(&ss->ids, o);
+        if (elem != NULL) {
+            mp_print_uint(print, MP_OBJ_SMALL_INT_VALUE(elem->value) << 2 | SNAPSHOT_REF_OBJ);
+            return;
+        }
+        elem = snapshot_lookup(&ss->names, o);
+        assert(elem != NULL);
+        if (mp_obj_is_qstr(elem->value)) {
+            snapshot_save_special(print, SNAPSHOT_SPECIAL_MODULE);
+            mp_print_uint(print, snapshot_qstr_index(ss, MP_OBJ_QSTR_VALUE(elem->value)));
+        } else {
+            size_t len;
+            mp_obj_t *items;
+            mp_obj_tuple_get(elem->value, &len, &items);
+            snapshot_save_special(print, SNAPSHOT_SPECIAL_MODULE_ATTR);
+            mp_print_uint(print, snapshot_qstr_index(ss, MP_OBJ_QSTR_VALUE(items[0])));
+            mp_print_uint(print, snapshot_qstr_index(ss, MP_OBJ_QSTR_VALUE(items[1])));
+        }
+    }
+}
+
+static void snapshot_uint(snapshot_save_t *ss, int mode, size_t n) {
+    if (mode == SNAPSHOT_MODE_WRITE) {
+        mp_print_uint(&ss->records_print, n);
+    }
+}
+
+// Process a child of an object.  A soft dependency is a mutable object that
+// should be filled in before its parent, eg so that it hashes correctly.
+static void snapshot_child(snapshot_save_t *ss, int mode, mp_obj_t o, bool soft_dep) {
+    switch (mode) {
+        case SNAPSHOT_MODE_VISIT:
+            snapshot_visit(ss, o);
+            break;
+        case SNAPSHOT_MODE_DEPS_IMMUTABLE:
+            snapshot_emit(ss, o, false);
+            break;
+        case SNAPSHOT_MODE_DEPS_MUTABLE:
+            if (soft_dep) {
+                snapshot_emit(ss, o, true);
+            }
+            break;
+        default:
+            snapshot_save_ref(ss, &ss->records_print, o);
+            break;
+    }
+}
+
+static bool snapshot_find_fun(const mp_raw_code_t *rc, const void *fun_data, size_t *path, size_t depth, size_t *path_len) {
+    if (rc->fun_data == fun_data) {
+        *path_len = depth;
+        return true;
+    }
+    if (depth < SNAPSHOT_MAX_FUN_DEPTH) {
+        for (size_t i = 0; i < rc->n_children; ++i) {
+            path[depth] = i;
+            if (snapshot_find_fun(rc->children[i], fun_data, path, depth + 1, path_len)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void snapshot_contents_iterable(snapshot_save_t *ss, int mode, mp_obj_t o, bool soft_dep) {
+    snapshot_uint(ss, mode, MP_OBJ_SMALL_INT_VALUE(mp_obj_len(o)));
+    mp_obj_iter_buf_t iter_buf;
+    mp_obj_t iterable = mp_getiter(o, &iter_buf);
+    mp_obj_t item;
+    while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+        snapshot_child(ss, mode, item, soft_dep);
+    }
+}
+
+static void snapshot_contents_map(snapshot_save_t *ss, int mode, const mp_map_t *map, bool soft_dep) {
+    snapshot_uint(ss, mode, map->used);
+    for (size_t i = 0; i < map->alloc; ++i) {
+        if (mp_map_slot_is_filled(map, i)) {
+            snapshot_child(ss, mode, map->table[i].key, soft_dep);
+            snapshot_child(ss, mode, map->table[i].value, false);
+        }
+    }
+}
+
+// Process the children of an object, to visit them, to emit the records they
+// need before the object's own record, or to write the object's record.
+static void snapshot_contents(snapshot_save_t *ss, int mode, mp_obj_t o, byte kind) {
+    switch (kind) {
+        case SNAPSHOT_OBJ_TUPLE: {
+            size_t len;
+            mp_obj_t *items;
+            mp_obj_tuple_get(o, &len, &items);
+            snapshot_uint(ss, mode, len);
+            for (size_t i = 0; i < len; ++i) {
+                snapshot_child(ss, mode, items[i], false);
+            }
+            break;
+        }
+        case SNAPSHOT_OBJ_FROZENSET:
+        case SNAPSHOT_OBJ_SET:
+            snapshot_contents_iterable(ss, mode, o, true);
+            break;
+        case SNAPSHOT_OBJ_FUN: {
+            mp_obj_fun_bc_t *fun = MP_OBJ_TO_PTR(o);
+            if (mode == SNAPSHOT_MODE_WRITE) {
+                size_t path[SNAPSHOT_MAX_FUN_DEPTH];
+                size_t depth;
+                if (!snapshot_find_fun(ss->cm->rc, fun->bytecode, path, 0, &depth)) {
+                    snapshot_raise_unsupported(o);
+                }
+                snapshot_uint(ss, mode, depth);
+                for (size_t i = 0; i < depth; ++i) {
+                    snapshot_uint(ss, mode, path[i]);
+                }
+            }
+            size_t n_def_args = 0;
+            bool has_def_kw_args = false;
+            #if MICROPY_EMIT_NATIVE
+            if (!mp_obj_is_type(o, &mp_type_fun_viper))
+            #endif
+            {
+                const uint8_t *bc = fun->bytecode;
+                #if MICROPY_EMIT_NATIVE
+                if (mp_obj_is_type(o, &mp_type_fun_native) || mp_obj_is_type(o, &mp_type_native_gen_wrap)) {
+                    bc = mp_obj_fun_native_get_prelude_ptr(fun);
+                }
+                #endif
+                MP_BC_PRELUDE_SIG_DECODE(bc);
+                n_def_args = n_def_pos_args;
+                has_def_kw_args = (scope_flags & MP_SCOPE_FLAG_DEFKWARGS) != 0;
+            }
+            snapshot_uint(ss, mode, n_def_args << 1 | has_def_kw_args);
+            for (size_t i = 0; i < n_def_args + has_def_kw_args; ++i) {
+                snapshot_child(ss, mode, fun->extra_args[i], false);
+            }
+            break;
+        }
+        case SNAPSHOT_OBJ_CLOSURE: {
+            mp_obj_closure_t *closure = MP_OBJ_TO_PTR(o);
+            snapshot_child(ss, mode, closure->fun, false);
+            snapshot_uint(ss, mode, closure->n_closed);
+            for (size_t i = 0; i < closure->n_closed; ++i) {
+                snapshot_child(ss, mode, closure->closed[i], false);
+            }
+            break;
+        }
+        case SNAPSHOT_OBJ_BOUND_METH: {
+            mp_obj_bound_meth_t *bound_meth = MP_OBJ_TO_PTR(o);
+            snapshot_child(ss, mode, bound_meth->meth, false);
+            snapshot_child(ss, mode, bound_meth->self, false);
+            break;
+        }
+        case SNAPSHOT_OBJ_STATICMETHOD:
+        case SNAPSHOT_OBJ_CLASSMETHOD:
+            snapshot_child(ss, mode, ((mp_obj_static_class_method_t *)MP_OBJ_TO_PTR(o))->fun, false);
+            break;
+        #if MICROPY_PY_BUILTINS_PROPERTY
+        case SNAPSHOT_OBJ_PROPERTY: {
+            const mp_obj_t *proxy = mp_obj_property_get(o);
+            for (size_t i = 0; i < 3; ++i) {
+                snapshot_child(ss, mode, proxy[i], false);
+            }
+            break;
+        }
+        #endif
+        case SNAPSHOT_OBJ_LIST: {
+            size_t len;
+            mp_obj_t *items;
+            mp_obj_list_get(o, &len, &items);
+            for (size_t i = 0; i < len; ++i) {
+                snapshot_child(ss, mode, items[i], false);
+            }
+            break;
+        }
+        case SNAPSHOT_OBJ_DICT:
+        case SNAPSHOT_OBJ_ORDEREDDICT:
+            snapshot_contents_map(ss, mode, &((mp_obj_dict_t *)MP_OBJ_TO_PTR(o))->map, true);
+            break;
+        case SNAPSHOT_OBJ_CELL:
+            snapshot_child(ss, mode, mp_obj_cell_get(o), false);
+            break;
+        case SNAPSHOT_OBJ_TYPE: {
+            const mp_obj_type_t *type = MP_OBJ_TO_PTR(o);
+            if (mode == SNAPSHOT_MODE_WRITE) {
+                mp_print_uint(&ss->records_print, snapshot_qstr_index(ss, type->name));
+            }
+            size_t n_bases = 0;
+            mp_obj_t *bases = NULL;
+            mp_obj_t parent = MP_OBJ_FROM_PTR(MP_OBJ_TYPE_GET_SLOT_OR_NULL(type, parent));
+            if (parent == MP_OBJ_NULL) {
+                // no bases
+            } else if (mp_obj_is_type(parent, &mp_type_tuple)) {
+                mp_obj_tuple_get(parent, &n_bases, &bases);
+            } else {
+                n_bases = 1;
+                bases = &parent;
+            }
+            snapshot_uint(ss, mode, n_bases);
+            for (size_t i = 0; i < n_bases; ++i) {
+                snapshot_child(ss, mode, bases[i], true);
+            }
+            snapshot_child(ss, mode, MP_OBJ_FROM_PTR(MP_OBJ_TYPE_GET_SLOT(type, locals_dict)), true);
+            break;
+        }
+        case SNAPSHOT_OBJ_INSTANCE: {
+            mp_obj_instance_t *self = MP_OBJ_TO_PTR(o);
+            if (mode == SNAPSHOT_MODE_DEPS_MUTABLE) {
+                // Fill in the class before its instances, so they hash correctly.
+                snapshot_emit(ss, MP_OBJ_FROM_PTR(self->base.type), true);
+            }
+            snapshot_contents_map(ss, mode, &self->members, false);
+            break;
+        }
+    }
+}
+
+static void snapshot_visit(snapshot_save_t *ss, mp_obj_t o) {
+    mp_cstack_check();
+    if (snapshot_is_immediate(o) || snapshot_lookup(&ss->ids, o) != NULL) {
+        return;
+    }
+    if (!snapshot_is_const(o) && !snapshot_is_own(ss, o) && snapshot_lookup(&ss->names, o) != NULL) {
+        // Refer to the object by its name in another module.
+        return;
+    }
+    byte kind = snapshot_kind(ss, o);
+    if (kind == SNAPSHOT_OBJ_INSTANCE) {
+        // The shell of an instance refers to its class, so visit that first.
+        snapshot_visit(ss, MP_OBJ_FROM_PTR(mp_obj_get_type(o)));
+        if (snapshot_lookup(&ss->ids, o) != NULL) {
+            return;
+        }
+    }
+
+    // Assign the object an id and save its shell.
+    size_t id = ss->kinds.len;
+    mp_map_lookup(&ss->ids, SNAPSHOT_KEY(o), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = MP_OBJ_NEW_SMALL_INT(id);
+    mp_obj_list_append(ss->objs, o);
+    vstr_add_byte(&ss->kinds, kind);
+    vstr_add_byte(&ss->shells, kind);
+    switch (kind) {
+        case SNAPSHOT_OBJ_CONST:
+            save_obj(&ss->shells_print, o);
+            break;
+        case SNAPSHOT_OBJ_BYTEARRAY: {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(o, &bufinfo, MP_BUFFER_READ);
+            mp_print_uint(&ss->shells_print, bufinfo.len);
+            mp_print_bytes(&ss->shells_print, bufinfo.buf, bufinfo.len);
+            break;
+        }
+        case SNAPSHOT_OBJ_LIST:
+        case SNAPSHOT_OBJ_DICT:
+            mp_print_uint(&ss->shells_print, MP_OBJ_SMALL_INT_VALUE(mp_obj_len(o)));
+            break;
+        case SNAPSHOT_OBJ_INSTANCE:
+            snapshot_save_ref(ss, &ss->shells_print, MP_OBJ_FROM_PTR(mp_obj_get_type(o)));
+            break;
+    }
+
+    snapshot_contents(ss, SNAPSHOT_MODE_VISIT, o, kind);
+}
+
+// Write the record of an object, after the records it depends on.
+static void snapshot_emit(snapshot_save_t *ss, mp_obj_t o, bool mutable) {
+    if (snapshot_is_immediate(o)) {
+        return;
+    }
+    mp_map_elem_t *elem = snapshot_lookup(&ss->ids, o);
+    if (elem == NULL) {
+        return;
+    }
+    size_t id = MP_OBJ_SMALL_INT_VALUE(elem->value);
+    byte kind = ss->kinds.buf[id];
+    if (!SNAPSHOT_OBJ_HAS_RECORD(kind) || SNAPSHOT_OBJ_IS_MUTABLE(kind) != mutable || ss->done[id]) {
+        return;
+    }
+    mp_cstack_check();
+    ss->done[id] = 1;
+    snapshot_contents(ss, mutable ? SNAPSHOT_MODE_DEPS_MUTABLE : SNAPSHOT_MODE_DEPS_IMMUTABLE, o, kind);
+    mp_print_uint(&ss->records_print, id);
+    snapshot_contents(ss, SNAPSHOT_MODE_WRITE, o, kind);
+    ss->n_records += 1;
+}
+
+// Give names to the modules in the given map, and to the objects they contain.
+static void snapshot_add_names(snapshot_save_t *ss, const mp_map_t *modules, bool attrs) {
+    for (size_t i = 0; i < modules->alloc; ++i) {
+        if (!mp_map_slot_is_filled(modules, i)) {
+            continue;
+        }
+        mp_obj_t module_name = MP_OBJ_NEW_QSTR(mp_obj_str_get_qstr(modules->table[i].key));
+        mp_obj_t module = modules->table[i].value;
+        if (!attrs) {
+            mp_map_elem_t *elem = mp_map_lookup(&ss->names, SNAPSHOT_KEY(module), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+            if (elem->value == MP_OBJ_NULL) {
+                elem->value = module_name;
+            }
+        } else if (mp_obj_is_type(module, &mp_type_module) && module != MP_OBJ_FROM_PTR(&ss->cm->context->module)) {
+            const mp_map_t *globals = &mp_obj_module_get_globals(module)->map;
+            for (size_t j = 0; j < globals->alloc; ++j) {
+                if (mp_map_slot_is_filled(globals, j) && mp_obj_is_qstr(globals->table[j].key)
+                    && !snapshot_is_immediate(globals->table[j].value)) {
+                    mp_map_elem_t *elem = mp_map_lookup(&ss->names, SNAPSHOT_KEY(globals->table[j].value), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+                    if (elem->value == MP_OBJ_NULL) {
+                        mp_obj_t name[2] = {module_name, globals->table[j].key};
+                        elem->value = mp_obj_new_tuple(2, name);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void mp_raw_code_save_snapshot(mp_compiled_module_t *cm, mp_print_t *print) {
+    mp_module_context_t *context = cm->context;
+    mp_map_t *globals = &context->module.globals->map;
+
+    snapshot_save_t ss;
+    ss.cm = cm;
+    ss.module_name = mp_obj_dict_get(MP_OBJ_FROM_PTR(context->module.globals), MP_OBJ_NEW_QSTR(MP_QSTR___name__));
+    mp_map_init(&ss.names, 0);
+    mp_map_init(&ss.ids, 0);
+    ss.objs = mp_obj_new_list(0, NULL);
+    vstr_init(&ss.kinds, 16);
+    ss.n_records = 0;
+    vstr_init_print(&ss.shells, 16, &ss.shells_print);
+    vstr_init_print(&ss.records, 16, &ss.records_print);
+
+    // Start with the module's own qstr table, and extend it as needed.
+    mp_map_init(&ss.qstrs, 0);
+    ss.n_qstr = cm->n_qstr;
+    ss.qstr_table = m_new(qstr_short_t, ss.n_qstr);
+    for (size_t i = 0; i < ss.n_qstr; ++i) {
+        ss.qstr_table[i] = context->constants.qstr_table[i];
+        mp_map_elem_t *elem = mp_map_lookup(&ss.qstrs, MP_OBJ_NEW_QSTR(ss.qstr_table[i]), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+        if (elem->value == MP_OBJ_NULL) {
+            elem->value = MP_OBJ_NEW_SMALL_INT(i);
+        }
+    }
+
+    // Objects in other modules are saved by name, so they stay shared.
+    snapshot_add_names(&ss, &mp_builtin_module_map, false);
+    snapshot_add_names(&ss, &mp_builtin_extensible_module_map, false);
+    snapshot_add_names(&ss, &MP_STATE_VM(mp_loaded_modules_dict).map, false);
+    snapshot_add_names(&ss, &mp_builtin_module_map, true);
+    snapshot_add_names(&ss, &mp_builtin_extensible_module_map, true);
+    snapshot_add_names(&ss, &MP_STATE_VM(mp_loaded_modules_dict).map, true);
+
+    // Find all objects reachable from the module's globals, except those set
+    // when the module is imported.
+    for (size_t i = 0; i < globals->alloc; ++i) {
+        if (mp_map_slot_is_filled(globals, i)
+            && globals->table[i].key != MP_OBJ_NEW_QSTR(MP_QSTR___name__)
+            && globals->table[i].key != MP_OBJ_NEW_QSTR(MP_QSTR___file__)) {
+            snapshot_visit(&ss, globals->table[i].key);
+            snapshot_visit(&ss, globals->table[i].value);
+        }
+    }
+
+    // Write the records: first creating the immutable objects, then filling in
+    // the mutable ones.
+    size_t n_obj = ss.kinds.len;
+    ss.done = m_new0(byte, n_obj);
+    for (size_t pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < n_obj; ++i) {
+            snapshot_emit(&ss, ((mp_obj_list_t *)MP_OBJ_TO_PTR(ss.objs))->items[i], pass == 1);
+        }
+    }
+
+    // Assemble the snapshot data.
+    vstr_t data;
+    mp_print_t data_print;
+    vstr_init_print(&data, ss.shells.len + ss.records.len + 16, &data_print);
+    mp_print_uint(&data_print, n_obj);
+    mp_print_bytes(&data_print, (const byte *)ss.shells.buf, ss.shells.len);
+    mp_print_uint(&data_print, ss.n_records);
+    mp_print_bytes(&data_print, (const byte *)ss.records.buf, ss.records.len);
+    size_t n_globals = 0;
+    vstr_t globals_data;
+    mp_print_t globals_print;
+    vstr_init_print(&globals_data, 16, &globals_print);
+    for (size_t i = 0; i < globals->alloc; ++i) {
+        if (mp_map_slot_is_filled(globals, i)
+            && globals->table[i].key != MP_OBJ_NEW_QSTR(MP_QSTR___name__)
+            && globals->table[i].key != MP_OBJ_NEW_QSTR(MP_QSTR___file__)) {
+            snapshot_save_ref(&ss, &globals_print, globals->table[i].key);
+            snapshot_save_ref(&ss, &globals_print, globals->table[i].value);
+            n_globals += 1;
+        }
+    }
+    mp_print_uint(&data_print, n_globals);
+    mp_print_bytes(&data_print, (const byte *)globals_data.buf, globals_data.len);
+    vstr_clear(&globals_data);
+
+    // Save the module with its extended qstr table, followed by the snapshot.
+    mp_module_context_t snapshot_context = *context;
+    snapshot_context.constants.qstr_table = ss.qstr_table;
+    mp_compiled_module_t snapshot_cm = *cm;
+    snapshot_cm.context = &snapshot_context;
+    snapshot_cm.n_qstr = ss.n_qstr;
+    save_module(&snapshot_cm, print, MPY_FEATURE_SNAPSHOT);
+    mp_print_uint(print, data.len);
+    mp_print_bytes(print, (const byte *)data.buf, data.len);
+
+    vstr_clear(&data);
+    vstr_clear(&ss.records);
+    vstr_clear(&ss.shells);
+    vstr_clear(&ss.kinds);
+    m_del(byte, ss.done, n_obj);
+    m_del(qstr_short_t, ss.qstr_table, ss.n_qstr);
+    mp_map_deinit(&ss.qstrs);
+    mp_map_deinit(&ss.ids);
+    mp_map_deinit(&ss.names);
+}
+
+#endif // MICROPY_PERSISTENT_CODE_SNAPSHOT_SAVE
+
 #if MICROPY_PERSISTENT_CODE_SAVE_FILE
 
 #include <unistd.h>
@@ -45,7 +45,10 @@
 
 // Macros to encode/decode native architecture to/from the feature byte
 #define MPY_FEATURE_ENCODE_ARCH(arch) ((arch) << 2)
-#define MPY_FEATURE_DECODE_ARCH(feat) ((feat) >> 2)
+#define MPY_FEATURE_DECODE_ARCH(feat) (((feat) >> 2) & 0x1f)
+
+// Bit in the feature byte that is set when a snapshot follows the outer raw code
+#define MPY_FEATURE_SNAPSHOT (0x80)
 
 // Define the host architecture
 #if MICROPY_EMIT_X86
@@ -122,6 +125,9 @@ void mp_raw_code_load_file(qstr filename, mp_compiled_module_t *ctx);
 void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print);
 void mp_raw_code_save_file(mp_compiled_module_t *cm, qstr filename);
 
+void mp_raw_code_load_snapshot(mp_reader_t *reader, const mp_module_context_t *context, size_t n_qstr, mp_proto_fun_t proto_fun);
+void mp_raw_code_save_snapshot(mp_compiled_module_t *cm, mp_print_t *print);
+
 void mp_native_relocate(void *reloc, uint8_t *text, uintptr_t reloc_text);
 
 #endif // MICROPY_INCLUDED_PY_PERSISTENTCODE_H
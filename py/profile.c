@@ -975,3 +975,124 @@ void mp_prof_print_instr(const byte *ip, mp_code_state_t *code_state) {
 #endif // MICROPY_PROF_INSTR_DEBUG_PRINT_ENABLE
 
 #endif // MICROPY_PY_SYS_SETTRACE
+
+#if MICROPY_PY_MICROPYTHON_PROFILE
+
+#if !MICROPY_ENABLE_SCHEDULER
+#error "MICROPY_PY_MICROPYTHON_PROFILE requires MICROPY_ENABLE_SCHEDULER"
+#endif
+
+// Each sample is the number of frames, followed by the function and bytecode
+// offset of each frame, innermost first.  Holding the functions keeps their
+// bytecode alive until the samples are reported.
+#define PROF_SAMPLE_WORDS (1 + 2 * MICROPY_PY_MICROPYTHON_PROFILE_DEPTH)
+
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#define PROF_ENTER() mp_thread_mutex_lock(&MP_STATE_VM(prof_mutex), 1)
+#define PROF_EXIT() mp_thread_mutex_unlock(&MP_STATE_VM(prof_mutex))
+#else
+#define PROF_ENTER()
+#define PROF_EXIT()
+#endif
+
+typedef struct _mp_prof_samples_t {
+    size_t n_samples;
+    size_t head;
+    size_t count;
+    uintptr_t data[];
+} mp_prof_samples_t;
+
+void mp_prof_sample_request(void) {
+    MP_STATE_VM(prof_sample_pending) = true;
+    if (MP_STATE_VM(sched_state) == MP_SCHED_IDLE) {
+        MP_STATE_VM(sched_state) = MP_SCHED_PENDING;
+    }
+}
+
+// Any thread may take a sample, so the buffer is only accessed, and only
+// replaced, while holding prof_mutex.
+void mp_prof_sample(void) {
+    MP_STATE_VM(prof_sample_pending) = false;
+    PROF_ENTER();
+    mp_prof_samples_t *s = MP_STATE_VM(prof_samples);
+    if (s == NULL) {
+        PROF_EXIT();
+        return;
+    }
+    uintptr_t *sample = &s->data[s->head * PROF_SAMPLE_WORDS];
+    size_t depth = 0;
+    for (const mp_code_state_t *cs = MP_STATE_THREAD(current_code_state);
+         cs != NULL && depth < MICROPY_PY_MICROPYTHON_PROFILE_DEPTH; cs = cs->prev_state) {
+        sample[1 + depth * 2] = (uintptr_t)cs->fun_bc;
+        sample[2 + depth * 2] = cs->ip - cs->fun_bc->bytecode;
+        ++depth;
+    }
+    if (depth != 0) {
+        // only keep the sample if Python code is running
+        sample[0] = depth;
+        s->head = (s->head + 1) % s->n_samples;
+        ++s->count;
+    }
+    PROF_EXIT();
+}
+
+mp_obj_t mp_prof_profile_start(size_t n_args, const mp_obj_t *args) {
+    mp_int_t hz = mp_obj_get_int(args[0]);
+    mp_int_t n_samples = n_args > 1 ? mp_obj_get_int(args[1]) : 512;
+    // the largest buffer whose size in bytes fits in a size_t
+    const size_t max_samples = (SIZE_MAX - sizeof(mp_prof_samples_t)) / (PROF_SAMPLE_WORDS * sizeof(uintptr_t));
+    if (hz <= 0 || hz > 1000000 || n_samples <= 0 || (size_t)n_samples > max_samples) {
+        mp_raise_ValueError(NULL);
+    }
+    mp_hal_profile_timer(0);
+    mp_prof_samples_t *s = m_new_obj_var(mp_prof_samples_t, data, uintptr_t, n_samples * PROF_SAMPLE_WORDS);
+    s->n_samples = n_samples;
+    s->head = 0;
+    s->count = 0;
+    PROF_ENTER();
+    MP_STATE_VM(prof_samples) = s;
+    PROF_EXIT();
+    mp_hal_profile_timer(hz);
+    return mp_const_none;
+}
+
+mp_obj_t mp_prof_profile_stop(void) {
+    mp_hal_profile_timer(0);
+    // Once the buffer is detached no other thread can be sampling into it.
+    PROF_ENTER();
+    mp_prof_samples_t *s = MP_STATE_VM(prof_samples);
+    MP_STATE_VM(prof_samples) = NULL;
+    PROF_EXIT();
+    MP_STATE_VM(prof_sample_pending) = false;
+    mp_obj_t stacks = mp_obj_new_dict(0);
+    if (s == NULL) {
+        return stacks;
+    }
+
+    // Count the samples with each stack, outermost frame first
+    size_t n = MIN(s->count, s->n_samples);
+    size_t first = s->count > s->n_samples ? s->head : 0;
+    vstr_t vstr;
+    mp_print_t print;
+    vstr_init_print(&vstr, 64, &print);
+    for (size_t i = 0; i < n; ++i) {
+        const uintptr_t *sample = &s->data[(first + i) % s->n_samples * PROF_SAMPLE_WORDS];
+        vstr_reset(&vstr);
+        for (size_t j = sample[0]; j > 0; --j) {
+            if (j < sample[0]) {
+                vstr_add_byte(&vstr, ';');
+            }
+            mp_bytecode_print_location(&print, (const mp_obj_fun_bc_t *)sample[j * 2 - 1], sample[j * 2]);
+        }
+        mp_obj_t key = mp_obj_new_str(vstr.buf, vstr.len);
+        mp_map_elem_t *elem = mp_map_lookup(mp_obj_dict_get_map(stacks), key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+        elem->value = MP_OBJ_NEW_SMALL_INT(elem->value == MP_OBJ_NULL ? 1 : MP_OBJ_SMALL_INT_VALUE(elem->value) + 1);
+    }
+    vstr_clear(&vstr);
+    m_del_var(mp_prof_samples_t, data, uintptr_t, s->n_samples * PROF_SAMPLE_WORDS, s);
+    return stacks;
+}
+
+MP_REGISTER_ROOT_POINTER(struct _mp_prof_samples_t *prof_samples);
+
+#endif // MICROPY_PY_MICROPYTHON_PROFILE
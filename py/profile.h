@@ -78,4 +78,23 @@ void mp_prof_print_instr(const byte *ip, mp_code_state_t *code_state);
 #endif
 
 #endif // MICROPY_PY_SYS_SETTRACE
+
+#if MICROPY_PY_MICROPYTHON_PROFILE
+
+// This is the implementation for micropython.profile_start/profile_stop
+mp_obj_t mp_prof_profile_start(size_t n_args, const mp_obj_t *args);
+mp_obj_t mp_prof_profile_stop(void);
+
+// Ask for a sample to be taken at the next check for pending events.  This
+// may be called asynchronously, from a timer interrupt or signal handler.
+void mp_prof_sample_request(void);
+
+// Take a sample of the stack of the current thread.
+void mp_prof_sample(void);
+
+// Provided by the port: call mp_prof_sample_request hz times a second, or
+// stop doing so if hz is 0.
+void mp_hal_profile_timer(mp_uint_t hz);
+
+#endif // MICROPY_PY_MICROPYTHON_PROFILE
 #endif // MICROPY_INCLUDED_PY_PROFILING_H
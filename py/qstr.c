@@ -60,13 +60,16 @@
 // allocated pool is twice this size.  The value here must be <= MP_QSTRnumber_of.
 #define MICROPY_ALLOC_QSTR_ENTRIES_INIT (10)
 
-// this must match the equivalent function in makeqstrdata.py
-size_t qstr_compute_hash(const byte *data, size_t len) {
+static size_t qstr_compute_hash_full(const byte *data, size_t len) {
     // djb2 algorithm; see http://www.cse.yorku.ca/~oz/hash.html
     size_t hash = 5381;
     for (const byte *top = data + len; data < top; data++) {
         hash = ((hash << 5) + hash) ^ (*data); // hash * 33 ^ data
     }
+    return hash;
+}
+
+static size_t qstr_truncate_hash(size_t hash) {
     hash &= Q_HASH_MASK;
     // Make sure that valid hash is never zero, zero means "hash not computed"
     if (hash == 0) {
@@ -75,6 +78,11 @@ size_t qstr_compute_hash(const byte *data, size_t len) {
     return hash;
 }
 
+// this must match the equivalent function in makeqstrdata.py
+size_t qstr_compute_hash(const byte *data, size_t len) {
+    return qstr_truncate_hash(qstr_compute_hash_full(data, len));
+}
+
 // The first pool is the static qstr table. The contents must remain stable as
 // it is part of the .mpy ABI. See the top of py/persistentcode.c and
 // static_qstr_list in makeqstrdata.py. This pool is unsorted (although in a
@@ -178,10 +186,17 @@ extern const qstr_pool_t MICROPY_QSTR_EXTRA_POOL;
 #define CONST_POOL mp_qstr_const_pool
 #endif
 
+// The first qstr that is allocated at runtime rather than being in ROM.
+#define QSTR_FIRST_RUNTIME (CONST_POOL.total_prev_len + CONST_POOL.len)
+
 void qstr_init(void) {
     MP_STATE_VM(last_pool) = (qstr_pool_t *)&CONST_POOL; // we won't modify the const_pool since it has no allocated room left
     MP_STATE_VM(qstr_last_chunk) = NULL;
 
+    #if MICROPY_QSTR_POOL_INDEX
+    MP_STATE_VM(qstr_index) = NULL;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_VM(qstr_mutex));
     #endif
@@ -199,10 +214,89 @@ static const qstr_pool_t *find_qstr(qstr *q) {
     return pool;
 }
 
+#if MICROPY_QSTR_POOL_INDEX
+
+// The index is an open-addressing hash table with linear probing, keyed on the
+// full (untruncated) hash of each string, which holds the ids of all qstrs in
+// the runtime pools.  Empty slots are zero, which is never a runtime qstr.  It
+// is resized along with the pool chain so that it is at most half full.
+//
+// The number of slots is stored with the slots, and a new table is published
+// with a single store of MP_STATE_VM(qstr_index), so a thread that searches
+// without holding qstr_mutex always sees a table together with its own size.
+
+typedef struct _qstr_index_t {
+    size_t alloc; // number of slots, a power of 2
+    qstr slots[];
+} qstr_index_t;
+
+static void qstr_index_insert(qstr_index_t *index, size_t full_hash, qstr q) {
+    size_t mask = index->alloc - 1;
+    size_t i = full_hash & mask;
+    while (index->slots[i] != MP_QSTRnull) {
+        i = (i + 1) & mask;
+    }
+    index->slots[i] = q;
+}
+
+// qstr_mutex must be taken while in this function
+static void qstr_index_resize(size_t n_slots) {
+    size_t alloc = 16;
+    while (alloc < n_slots) {
+        alloc <<= 1;
+    }
+    // The old index stays in place until the new one is complete, and is not
+    // freed in case a thread is still searching it; the GC will reclaim it.
+    qstr_index_t *index = m_malloc_maybe(sizeof(qstr_index_t) + alloc * sizeof(qstr));
+    if (index == NULL) {
+        // Fall back to searching the runtime pools linearly.
+        MP_STATE_VM(qstr_index) = NULL;
+        return;
+    }
+    index->alloc = alloc;
+    memset(index->slots, 0, alloc * sizeof(qstr));
+    for (const qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != &CONST_POOL; pool = pool->prev) {
+        for (size_t at = 0; at < pool->len; ++at) {
+            size_t full_hash = qstr_compute_hash_full((const byte *)pool->qstrs[at], pool->lengths[at]);
+            qstr_index_insert(index, full_hash, pool->total_prev_len + at);
+        }
+    }
+    MP_STATE_VM(qstr_index) = index;
+}
+
+static qstr qstr_index_find(const qstr_index_t *index, const char *str, size_t str_len, size_t full_hash) {
+    size_t mask = index->alloc - 1;
+    #if MICROPY_QSTR_BYTES_IN_HASH
+    size_t str_hash = qstr_truncate_hash(full_hash);
+    #endif
+    for (size_t i = full_hash & mask; index->slots[i] != MP_QSTRnull; i = (i + 1) & mask) {
+        qstr at = index->slots[i];
+        const qstr_pool_t *pool = find_qstr(&at);
+        if (
+            #if MICROPY_QSTR_BYTES_IN_HASH
+            pool->hashes[at] == str_hash &&
+            #endif
+            pool->lengths[at] == str_len
+            && memcmp(pool->qstrs[at], str, str_len) == 0) {
+            return index->slots[i];
+        }
+    }
+    return MP_QSTRnull;
+}
+
+#endif // MICROPY_QSTR_POOL_INDEX
+
 // qstr_mutex must be taken while in this function
 static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
+    #if MICROPY_QSTR_POOL_INDEX
+    size_t full_hash = qstr_compute_hash_full((const byte *)q_ptr, len);
+    #endif
     #if MICROPY_QSTR_BYTES_IN_HASH
+    #if MICROPY_QSTR_POOL_INDEX
+    mp_uint_t hash = qstr_truncate_hash(full_hash);
+    #else
     mp_uint_t hash = qstr_compute_hash((const byte *)q_ptr, len);
+    #endif
     DEBUG_printf("QSTR: add hash=%d len=%d data=%.*s\n", hash, len, len, q_ptr);
     #else
     DEBUG_printf("QSTR: add len=%d data=%.*s\n", len, len, q_ptr);
@@ -244,6 +338,11 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
         pool->len = 0;
         MP_STATE_VM(last_pool) = pool;
         DEBUG_printf("QSTR: allocate new pool of size %d\n", MP_STATE_VM(last_pool)->alloc);
+
+        #if MICROPY_QSTR_POOL_INDEX
+        // Size the index for when all runtime pools are full.
+        qstr_index_resize(2 * (pool->total_prev_len + new_alloc - QSTR_FIRST_RUNTIME));
+        #endif
     }
 
     // add the new qstr
@@ -255,6 +354,12 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
     MP_STATE_VM(last_pool)->qstrs[at] = q_ptr;
     MP_STATE_VM(last_pool)->len++;
 
+    #if MICROPY_QSTR_POOL_INDEX
+    if (MP_STATE_VM(qstr_index) != NULL) {
+        qstr_index_insert(MP_STATE_VM(qstr_index), full_hash, MP_STATE_VM(last_pool)->total_prev_len + at);
+    }
+    #endif
+
     // return id for the newly-added qstr
     return MP_STATE_VM(last_pool)->total_prev_len + at;
 }
@@ -265,13 +370,33 @@ qstr qstr_find_strn(const char *str, size_t str_len) {
         return MP_QSTR_;
     }
 
+    #if MICROPY_QSTR_POOL_INDEX
+    // work out hash of str
+    size_t full_hash = qstr_compute_hash_full((const byte *)str, str_len);
+    #if MICROPY_QSTR_BYTES_IN_HASH
+    size_t str_hash = qstr_truncate_hash(full_hash);
+    #endif
+
+    // search the runtime pools using the index, if there is one
+    const qstr_pool_t *first_pool = MP_STATE_VM(last_pool);
+    const qstr_index_t *index = MP_STATE_VM(qstr_index);
+    if (index != NULL) {
+        qstr q = qstr_index_find(index, str, str_len, full_hash);
+        if (q != MP_QSTRnull) {
+            return q;
+        }
+        first_pool = &CONST_POOL;
+    }
+    #else
     #if MICROPY_QSTR_BYTES_IN_HASH
     // work out hash of str
     size_t str_hash = qstr_compute_hash((const byte *)str, str_len);
     #endif
+    const qstr_pool_t *first_pool = MP_STATE_VM(last_pool);
+    #endif
 
     // search pools for the data
-    for (const qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != NULL; pool = pool->prev) {
+    for (const qstr_pool_t *pool = first_pool; pool != NULL; pool = pool->prev) {
         size_t low = 0;
         size_t high = pool->len - 1;
 
@@ -418,6 +543,11 @@ void qstr_pool_info(size_t *n_pool, size_t *n_qstr, size_t *n_str_data_bytes, si
                 + sizeof(qstr_len_t)) * pool->alloc;
         #endif
     }
+    #if MICROPY_QSTR_POOL_INDEX
+    if (MP_STATE_VM(qstr_index) != NULL) {
+        *n_total_bytes += sizeof(qstr_index_t) + MP_STATE_VM(qstr_index)->alloc * sizeof(qstr);
+    }
+    #endif
     *n_total_bytes += *n_str_data_bytes;
     QSTR_EXIT();
 }
@@ -25,6 +25,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include "py/runtime.h"
@@ -32,11 +33,30 @@
 #include "py/mpthread.h"
 #include "py/reader.h"
 
+size_t mp_reader_readbytes(const mp_reader_t *reader, byte *buf, size_t len) {
+    if (reader->readbytes != NULL) {
+        return reader->readbytes(reader->data, buf, len);
+    }
+    for (size_t i = 0; i < len; ++i) {
+        mp_uint_t c = reader->readbyte(reader->data);
+        if (c == MP_READER_EOF) {
+            return i;
+        }
+        buf[i] = c;
+    }
+    return len;
+}
+
 typedef struct _mp_reader_mem_t {
-    size_t free_len; // if >0 mem is freed on close by: m_free(beg, free_len)
+    size_t free_len; // if >0 and not MP_READER_IS_ROM, mem is freed on close by: m_free(beg, free_len)
     const byte *beg;
     const byte *cur;
     const byte *end;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    mp_reader_mapped_close_t mapped_close; // if not NULL, called on close
+    void *mapped_close_arg;
+    bool in_place; // set when data is handed out by mp_reader_try_read_rom
+    #endif
 } mp_reader_mem_t;
 
 static mp_uint_t mp_reader_mem_readbyte(void *data) {
@@ -48,24 +68,73 @@ static mp_uint_t mp_reader_mem_readbyte(void *data) {
     }
 }
 
+static size_t mp_reader_mem_readbytes(void *data, byte *buf, size_t len) {
+    mp_reader_mem_t *reader = (mp_reader_mem_t *)data;
+    len = MIN(len, (size_t)(reader->end - reader->cur));
+    memcpy(buf, reader->cur, len);
+    reader->cur += len;
+    return len;
+}
+
 static void mp_reader_mem_close(void *data) {
     mp_reader_mem_t *reader = (mp_reader_mem_t *)data;
-    if (reader->free_len > 0) {
+    if (reader->free_len > 0 && reader->free_len != MP_READER_IS_ROM) {
         m_del(char, (char *)reader->beg, reader->free_len);
     }
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    if (reader->mapped_close != NULL) {
+        reader->mapped_close(reader->mapped_close_arg, reader->beg, reader->end - reader->beg, reader->in_place);
+    }
+    #endif
     m_del_obj(mp_reader_mem_t, reader);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// If the reader is reading from ROM or mapped memory, then return a pointer to the
+// next len bytes, which stay valid for the life of the program, and skip over them.
+// Otherwise return NULL and don't consume any input.
+const byte *mp_reader_try_read_rom(const mp_reader_t *reader, size_t len) {
+    if (reader->readbyte != mp_reader_mem_readbyte) {
+        return NULL;
+    }
+    mp_reader_mem_t *rm = reader->data;
+    if (rm->free_len != MP_READER_IS_ROM || (size_t)(rm->end - rm->cur) < len) {
+        return NULL;
+    }
+    const byte *data = rm->cur;
+    rm->cur += len;
+    rm->in_place = true;
+    return data;
+}
+#endif
+
 void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t free_len) {
     mp_reader_mem_t *rm = m_new_obj(mp_reader_mem_t);
     rm->free_len = free_len;
     rm->beg = buf;
     rm->cur = buf;
     rm->end = buf + len;
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    rm->mapped_close = NULL;
+    rm->mapped_close_arg = NULL;
+    rm->in_place = false;
+    #endif
     reader->data = rm;
     reader->readbyte = mp_reader_mem_readbyte;
     reader->close = mp_reader_mem_close;
+    reader->readbytes = mp_reader_mem_readbytes;
+}
+
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// Read from memory that stays mapped only if it is used in place; close(close_arg, ...)
+// is called when the reader is closed, so the memory can be unmapped if it is unused.
+void mp_reader_new_mem_mapped(mp_reader_t *reader, const byte *buf, size_t len, mp_reader_mapped_close_t close, void *close_arg) {
+    mp_reader_new_mem(reader, buf, len, MP_READER_IS_ROM);
+    mp_reader_mem_t *rm = reader->data;
+    rm->mapped_close = close;
+    rm->mapped_close_arg = close_arg;
 }
+#endif
 
 #if MICROPY_READER_POSIX
 
@@ -89,8 +158,12 @@ static mp_uint_t mp_reader_posix_readbyte(void *data) {
         } else {
             MP_THREAD_GIL_EXIT();
             int n = read(reader->fd, reader->buf, sizeof(reader->buf));
+            int err = errno;
             MP_THREAD_GIL_ENTER();
-            if (n <= 0) {
+            if (n == -1) {
+                mp_raise_OSError(err);
+            }
+            if (n == 0) {
                 reader->len = 0;
                 return MP_READER_EOF;
             }
@@ -101,6 +174,29 @@ static mp_uint_t mp_reader_posix_readbyte(void *data) {
     return reader->buf[reader->pos++];
 }
 
+static size_t mp_reader_posix_readbytes(void *data, byte *buf, size_t len) {
+    mp_reader_posix_t *reader = (mp_reader_posix_t *)data;
+    // Use up what is left in the buffer, then read the rest directly into buf.
+    size_t n = MIN(len, reader->len - reader->pos);
+    memcpy(buf, reader->buf + reader->pos, n);
+    reader->pos += n;
+    while (n < len && reader->len != 0) {
+        MP_THREAD_GIL_EXIT();
+        ssize_t n2 = read(reader->fd, buf + n, len - n);
+        int err = errno;
+        MP_THREAD_GIL_ENTER();
+        if (n2 == -1) {
+            mp_raise_OSError(err);
+        }
+        if (n2 == 0) {
+            reader->len = 0;
+            break;
+        }
+        n += n2;
+    }
+    return n;
+}
+
 static void mp_reader_posix_close(void *data) {
     mp_reader_posix_t *reader = (mp_reader_posix_t *)data;
     if (reader->close_fd) {
@@ -130,6 +226,7 @@ void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd) {
     reader->data = rp;
     reader->readbyte = mp_reader_posix_readbyte;
     reader->close = mp_reader_posix_close;
+    reader->readbytes = mp_reader_posix_readbytes;
 }
 
 #if !MICROPY_VFS_POSIX
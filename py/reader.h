@@ -31,15 +31,29 @@
 // the readbyte function must return the next byte in the input stream
 // it must return MP_READER_EOF if end of stream
 // it can be called again after returning MP_READER_EOF, and in that case must return MP_READER_EOF
+// the optional readbytes function reads up to len bytes into buf and returns the number
+// read, which is less than len only at the end of the stream; it may be NULL
 #define MP_READER_EOF ((mp_uint_t)(-1))
 
+// passed as free_len to mp_reader_new_mem when the memory is never freed or modified
+#define MP_READER_IS_ROM ((size_t)(-1))
+
 typedef struct _mp_reader_t {
     void *data;
     mp_uint_t (*readbyte)(void *data);
     void (*close)(void *data);
+    size_t (*readbytes)(void *data, byte *buf, size_t len);
 } mp_reader_t;
 
+size_t mp_reader_readbytes(const mp_reader_t *reader, byte *buf, size_t len);
 void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t free_len);
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// called when a mapped memory reader is closed; in_place is true if data was handed
+// out by mp_reader_try_read_rom, in which case the memory must stay mapped
+typedef void (*mp_reader_mapped_close_t)(void *arg, const byte *buf, size_t len, bool in_place);
+const byte *mp_reader_try_read_rom(const mp_reader_t *reader, size_t len);
+void mp_reader_new_mem_mapped(mp_reader_t *reader, const byte *buf, size_t len, mp_reader_mapped_close_t close, void *close_arg);
+#endif
 void mp_reader_new_file(mp_reader_t *reader, qstr filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
@@ -123,6 +123,16 @@ void mp_init(void) {
     MP_STATE_VM(persistent_code_root_pointers) = MP_OBJ_NULL;
     #endif
 
+    #if MICROPY_OPT_ATTR_CACHE
+    // entries may refer to types from before a soft reset
+    memset(MP_STATE_THREAD(attr_cache), 0, sizeof(MP_STATE_THREAD(attr_cache)));
+    MP_STATE_VM(attr_cache_version) = 0;
+    #endif
+
+    #if MICROPY_OPT_STR_INTERN
+    memset(MP_STATE_THREAD(str_intern), 0, sizeof(MP_STATE_THREAD(str_intern)));
+    #endif
+
     #if MICROPY_PY_OS_DUPTERM
     for (size_t i = 0; i < MICROPY_PY_OS_DUPTERM; ++i) {
         MP_STATE_VM(dupterm_objs[i]) = MP_OBJ_NULL;
@@ -160,13 +170,25 @@ void mp_init(void) {
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
+    #endif
+    #if MICROPY_VM_CODE_STATE_CHAIN
     MP_STATE_THREAD(current_code_state) = NULL;
     #endif
+    #if MICROPY_PY_MICROPYTHON_PROFILE
+    MP_STATE_VM(prof_samples) = NULL;
+    #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+    mp_thread_mutex_init(&MP_STATE_VM(prof_mutex));
+    #endif
+    #endif
 
     #if MICROPY_PY_SYS_TRACEBACKLIMIT
     MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_TRACEBACKLIMIT]) = MP_OBJ_NEW_SMALL_INT(1000);
     #endif
 
+    #if MICROPY_VFS_IMPORT_CACHE
+    MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_PATH_IMPORTER_CACHE]) = mp_obj_new_dict(0);
+    #endif
+
     #if MICROPY_PY_BLUETOOTH
     MP_STATE_VM(bluetooth) = MP_OBJ_NULL;
     #endif
@@ -1247,6 +1269,77 @@ void mp_load_method(mp_obj_t base, qstr attr, mp_obj_t *dest) {
     }
 }
 
+#if MICROPY_OPT_ATTR_CACHE
+
+// Acts like mp_load_method but first tries the given cache entry, and refills
+// the entry after a miss.  An entry remembers which type's locals dict an
+// attribute was found in, which only depends on the type of base (and not
+// on base itself) for:
+//  - instances of user classes without special accessors and without native
+//    bases, provided the instance's own members don't shadow the attribute;
+//  - native types with no attr slot and a fixed locals dict.
+// Class attributes can change, so storing or deleting any class attribute
+// invalidates all entries by bumping attr_cache_version.  Entries are indexed
+// by type and attr, so all the instructions that look up the same attribute
+// of the same type share one entry.
+void mp_load_method_cached(mp_obj_t base, qstr attr, mp_obj_t *dest) {
+    const mp_obj_type_t *type = mp_obj_get_type(base);
+    size_t version = MP_STATE_VM(attr_cache_version);
+    size_t index = (((uintptr_t)type >> 3) ^ attr) & (MICROPY_OPT_ATTR_CACHE_SIZE - 1);
+    mp_attr_cache_entry_t *entry = &MP_STATE_THREAD(attr_cache)[index];
+    if (entry->type == type && entry->attr == attr && entry->version == version) {
+        if (mp_obj_is_instance_type(type)) {
+            mp_obj_instance_t *self = MP_OBJ_TO_PTR(base);
+            mp_map_elem_t *elem = mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+            if (elem != NULL) {
+                dest[0] = elem->value;
+                dest[1] = MP_OBJ_NULL;
+                return;
+            }
+        }
+        dest[0] = MP_OBJ_NULL;
+        dest[1] = MP_OBJ_NULL;
+        mp_convert_member_lookup(base, entry->owner, entry->member, dest);
+        return;
+    }
+
+    mp_load_method(base, attr, dest);
+
+    // These are handled before the type's attributes are searched.
+    if (attr == MP_QSTR___class__ || attr == MP_QSTR___next__ || attr == MP_QSTR___dict__) {
+        return;
+    }
+    const mp_obj_type_t *owner;
+    mp_obj_t member;
+    if (mp_obj_is_instance_type(type)) {
+        if (type->flags & MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS
+            || !mp_obj_class_lookup_member(type, attr, &owner, &member)) {
+            return;
+        }
+    } else {
+        if (MP_OBJ_TYPE_HAS_SLOT(type, attr) || !MP_OBJ_TYPE_HAS_SLOT(type, locals_dict)) {
+            return;
+        }
+        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
+        if (!locals_map->is_fixed) {
+            return;
+        }
+        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem == NULL) {
+            return;
+        }
+        owner = type;
+        member = elem->value;
+    }
+    entry->type = type;
+    entry->owner = owner;
+    entry->member = member;
+    entry->attr = attr;
+    entry->version = version;
+}
+
+#endif
+
 // Acts like mp_load_method_maybe but catches AttributeError, and all other exceptions if requested
 void mp_load_method_protected(mp_obj_t obj, qstr attr, mp_obj_t *dest, bool catch_all_exc) {
     nlr_buf_t nlr;
@@ -168,6 +168,24 @@ static inline void mp_thread_init_state(mp_state_thread_t *ts, size_t stack_size
     ts->nlr_jump_callback_top = NULL;
     ts->mp_pending_exception = MP_OBJ_NULL;
 
+    #if MICROPY_VM_CODE_STATE_CHAIN
+    // Not running any Python code yet
+    ts->current_code_state = NULL;
+    #endif
+
+    #if MICROPY_OPT_ATTR_CACHE
+    // Start with all entries of the attribute cache invalid
+    for (size_t i = 0; i < MICROPY_OPT_ATTR_CACHE_SIZE; ++i) {
+        ts->attr_cache[i].type = NULL;
+    }
+    #endif
+
+    #if MICROPY_OPT_STR_INTERN
+    for (size_t i = 0; i < MICROPY_OPT_STR_INTERN_SIZE; ++i) {
+        ts->str_intern[i] = MP_OBJ_NULL;
+    }
+    #endif
+
     // If locals/globals are not given, inherit from main thread
     if (locals == NULL) {
         locals = mp_state_ctx.thread.dict_locals;
@@ -225,6 +243,9 @@ void mp_convert_member_lookup(mp_obj_t obj, const mp_obj_type_t *type, mp_obj_t
 void mp_load_method(mp_obj_t base, qstr attr, mp_obj_t *dest);
 void mp_load_method_maybe(mp_obj_t base, qstr attr, mp_obj_t *dest);
 void mp_load_method_protected(mp_obj_t obj, qstr attr, mp_obj_t *dest, bool catch_all_exc);
+#if MICROPY_OPT_ATTR_CACHE
+void mp_load_method_cached(mp_obj_t base, qstr attr, mp_obj_t *dest);
+#endif
 void mp_load_super_method(qstr attr, mp_obj_t *dest);
 void mp_store_attr(mp_obj_t base, qstr attr, mp_obj_t val);
 
@@ -28,6 +28,7 @@
 
 #include "py/mphal.h"
 #include "py/runtime.h"
+#include "py/profile.h"
 
 // Schedules an exception on the main thread (for exceptions "thrown" by async
 // sources such as interrupts and UNIX signal handlers).
@@ -210,6 +211,13 @@ MP_REGISTER_ROOT_POINTER(mp_sched_item_t sched_queue[MICROPY_SCHEDULER_DEPTH]);
 // Called periodically from the VM or from "waiting" code (e.g. sleep) to
 // process background tasks and pending exceptions (e.g. KeyboardInterrupt).
 void mp_handle_pending(bool raise_exc) {
+    #if MICROPY_PY_MICROPYTHON_PROFILE
+    // Take a sample for the profiler, before anything else runs.
+    if (MP_STATE_VM(prof_sample_pending)) {
+        mp_prof_sample();
+    }
+    #endif
+
     // Handle pending VM abort.
     #if MICROPY_ENABLE_VM_ABORT
     if (MP_STATE_VM(vm_abort) && mp_thread_is_main_thread()) {
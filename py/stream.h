@@ -44,6 +44,8 @@
 #define MP_STREAM_SET_DATA_OPTS (9)  // Set data/message options
 #define MP_STREAM_GET_FILENO    (10) // Get fileno of underlying file
 #define MP_STREAM_GET_BUFFER_SIZE (11) // Get preferred buffer size for file
+#define MP_STREAM_GET_MAPPED_DATA (12) // Get memory-mapped contents of file (arg is mp_buffer_info_t *)
+#define MP_STREAM_RELEASE_MAPPED_DATA (13) // Unmap contents from MP_STREAM_GET_MAPPED_DATA (arg is mp_buffer_info_t *)
 
 // These poll ioctl values are compatible with Linux
 #define MP_STREAM_POLL_RD       (0x0001)
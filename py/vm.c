@@ -187,6 +187,16 @@
     } \
 } while(0)
 
+#elif MICROPY_VM_CODE_STATE_CHAIN
+
+// Only keep the chain of code states, for the sampling profiler and
+// allocation tracing
+#define FRAME_SETUP() (MP_STATE_THREAD(current_code_state) = code_state)
+#define FRAME_ENTER() (code_state->prev_state = MP_STATE_THREAD(current_code_state))
+#define FRAME_LEAVE() (MP_STATE_THREAD(current_code_state) = code_state->prev_state)
+#define FRAME_UPDATE()
+#define TRACE_TICK(current_ip, current_sp, is_exception)
+
 #else // MICROPY_PY_SYS_SETTRACE
 #define FRAME_SETUP()
 #define FRAME_ENTER()
@@ -412,9 +422,21 @@ dispatch_loop:
                         obj = elem->value;
                     } else
                     #endif
+                    #if MICROPY_OPT_ATTR_CACHE
+                    {
+                        mp_obj_t dest[2];
+                        mp_load_method_cached(top, qst, dest);
+                        if (dest[1] == MP_OBJ_NULL) {
+                            obj = dest[0];
+                        } else {
+                            obj = mp_obj_new_bound_meth(dest[0], dest[1]);
+                        }
+                    }
+                    #else
                     {
                         obj = mp_load_attr(top, qst);
                     }
+                    #endif
                     SET_TOP(obj);
                     DISPATCH();
                 }
@@ -422,7 +444,11 @@ dispatch_loop:
                 ENTRY(MP_BC_LOAD_METHOD): {
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_QSTR;
+                    #if MICROPY_OPT_ATTR_CACHE
+                    mp_load_method_cached(*sp, qst, sp);
+                    #else
                     mp_load_method(*sp, qst, sp);
+                    #endif
                     sp += 1;
                     DISPATCH();
                 }
@@ -257,6 +257,7 @@ static void mp_reader_new_stdin(mp_reader_t *reader, mp_reader_stdin_t *reader_s
     reader->data = reader_stdin;
     reader->readbyte = mp_reader_stdin_readbyte;
     reader->close = mp_reader_stdin_close;
+    reader->readbytes = NULL;
 }
 
 static int do_reader_stdin(int c) {
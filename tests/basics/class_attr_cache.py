@@ -0,0 +1,95 @@
+# test that repeated attribute lookups see changes to classes and instances
+
+
+class A:
+    x = 1
+
+    def f(self):
+        return "A.f"
+
+
+class B(A):
+    pass
+
+
+class C:
+    def f(self):
+        return "C.f"
+
+
+def get(o):
+    return o.x
+
+
+def call(o):
+    return o.f()
+
+
+a = A()
+b = B()
+for i in range(3):
+    print(get(a), get(b), call(a), call(b), call(C()))
+
+# class attributes replaced
+A.x = 2
+B.f = lambda self: "B.f"
+for i in range(3):
+    print(get(a), get(b), call(a), call(b))
+
+# instance attributes shadow class attributes
+b.x = 3
+b.f = lambda: "b.f"
+for i in range(3):
+    print(get(a), get(b), call(a), call(b))
+
+# class attributes removed
+del b.x
+del B.f
+del A.x
+for o in (a, b):
+    try:
+        get(o)
+    except AttributeError:
+        print("AttributeError")
+print(call(a), call(b))
+
+# methods of builtin types
+def append(l, v):
+    l.append(v)
+
+
+l = []
+for i in range(3):
+    append(l, i)
+print(l)
+
+
+# a subclass of a builtin type overriding a method
+class L(list):
+    def append(self, v):
+        super().append(v * 10)
+
+
+l = L()
+for i in range(3):
+    append(l, i)
+    append([], i)
+print(l)
+
+# __class__, __dict__ and bound methods
+o = A()
+o.y = 1
+for i in range(3):
+    print(o.__class__ is A, o.__dict__, a.f() == o.f(), o.f.__name__)
+
+
+# multiple inheritance
+class D(C, B):
+    pass
+
+
+for i in range(3):
+    print(call(D()))
+C.f = lambda self: "C.f2"
+for i in range(3):
+    print(call(D()))
@@ -0,0 +1,31 @@
+# test multiplication and squaring of large ints, of sizes where faster than
+# quadratic methods may be used
+
+seed = 1
+
+
+# deterministic pseudo-random numbers with the given number of bits
+def rnd(bits):
+    global seed
+    r = 0
+    for _ in range(bits // 16 + 1):
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+        r = (r << 16) | (seed >> 15)
+    return r >> (16 - bits % 16) | 1 << (bits - 1)
+
+
+for bits in (400, 512, 1000, 1024, 2000, 3000, 5000, 10000, 20000):
+    a = rnd(bits)
+    b = rnd(bits)
+    c = rnd(bits // 3)
+    m = (1 << bits) - 1
+    for x, y in ((a, b), (a, c), (c, a), (a, a), (m, m), (m, a), (a, 1 << bits), (-a, b), (a, -c), (-a, -a)):
+        p = x * y
+        print(bits, p % 1000000007, p & 0xFFFFFFFF, p >> (2 * bits - 32))
+    print(a * b == b * a, (a * b) // b == a, a**2 == a * a, (a * b) % a == 0)
+    print((a + b) * (a - b) == a * a - b * b, (a * b) * c == a * (b * c))
+
+# powers, which square repeatedly
+print(3**5000 % 1000000007, 3**5000 >> 7900)
+print(pow(12345, 2000, 10**50))
+print((7**3000) // (7**1500) == 7**1500)
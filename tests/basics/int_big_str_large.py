@@ -0,0 +1,35 @@
+# test conversion of large ints to and from strings, of sizes where faster
+# than quadratic methods may be used
+
+seed = 1
+
+
+# deterministic pseudo-random digits
+def rnd_digits(n):
+    global seed
+    s = ""
+    for _ in range(n):
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+        s += "0123456789"[(seed >> 16) % 10]
+    return "1" + s[1:]
+
+
+for n in (100, 500, 999, 1000, 1001, 2000, 2001, 3000, 4100):
+    s = rnd_digits(n)
+    i = int(s)
+    print(n, i % 1000000007, str(i) == s, str(-i) == "-" + s)
+    print(int("-" + s) == -i, int("000" + s) == i, int(s + "0") == i * 10)
+    print(str(i * 10**100)[-101:], len(str(i * 10**100)))
+    print(hex(i)[-20:], oct(i)[-20:], bin(i)[-20:])
+    print(int(hex(i), 16) == i, int(oct(i)[2:], 8) == i, int(bin(i), 2) == i)
+    print(str(10 ** (n - 1)) == "1" + "0" * (n - 1), str(10**n - 1) == "9" * n)
+
+# numbers with long runs of zeros and nines
+for n in (200, 1000, 4000):
+    i = 10**n + 1
+    print(str(i) == "1" + "0" * (n - 1) + "1", int(str(i)) == i)
+    i = 10**n - 10 ** (n // 2)
+    print(str(i) == "9" * (n - n // 2) + "0" * (n // 2), int(str(i)) == i)
+
+# formatting with separators
+print("{:,}".format(3**2000)[-50:], "{:,}".format(-(7**900))[:50])
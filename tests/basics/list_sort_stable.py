@@ -0,0 +1,48 @@
+# test that list.sort() and sorted() are stable, and call key once per item
+
+
+def rnd(n, x=[12345]):
+    x[0] = (x[0] * 1103515245 + 12345) & 0x7FFFFFFF
+    return (x[0] >> 8) % n
+
+
+# equal keys keep their original order, forwards and reversed
+for n in (0, 1, 2, 10, 31, 32, 33, 100, 1000):
+    l = [(rnd(10), i) for i in range(n)]
+    for rev in (False, True):
+        a = sorted(l, key=lambda x: x[0], reverse=rev)
+        print(n, rev, a == sorted(l, key=lambda x: x[0] * 1000000 + (-x[1] if rev else x[1]), reverse=rev))
+
+# runs that are already ordered, reversed, or partly ordered
+l = list(range(100)) + list(range(50)) + list(range(100, 0, -1)) + [5] * 20
+print(sorted(l) == sorted(sorted(l)), sorted(l)[:5], sorted(l)[-5:])
+print(sorted(l, key=lambda x: x % 7)[:12])
+
+# mixed keys of different types
+print(sorted([3, 1.5, True, 2, -0.5, 10**20, -(10**20)]))
+print(sorted(["b", "ab", "a", "", "ba", "abc"]))
+print(sorted(["b", "ab", "a", "", "ba", "abc"], key=len))
+
+# key is called exactly once per item
+calls = []
+
+
+def key(x):
+    calls.append(x)
+    return -x
+
+
+l = [rnd(100) for _ in range(200)]
+l.sort(key=key)
+print(len(calls), l[:5])
+
+# an exception from a comparison leaves the list unchanged
+l = [3, 2, 1, "x", 0]
+try:
+    l.sort()
+except TypeError:
+    print("TypeError", l)
+try:
+    sorted([1, 2, 3], key=lambda x: 1 / (x - 2))
+except ZeroDivisionError:
+    print("ZeroDivisionError")
@@ -0,0 +1,59 @@
+# test OrderedDict with enough entries to be indexed
+
+try:
+    from collections import OrderedDict
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# build up, keeping insertion order
+d = OrderedDict()
+for i in range(100):
+    d[i * 7 % 100] = i
+print(len(d), list(d)[:10], d[49], d[0])
+print(99 in d, 100 in d, d.get(100))
+
+# delete from the middle, start and end, then re-add
+for k in range(0, 100, 3):
+    del d[k]
+del d[list(d)[-1]]
+print(len(d), list(d)[:10], list(d)[-5:])
+d[3] = "x"
+d[1000] = "y"
+print(list(d)[-3:], d[3], d[1000])
+
+# popitem takes from the end
+print(d.popitem(), d.popitem(), len(d))
+for _ in range(len(d) - 2):
+    d.popitem()
+print(list(d.items()))
+
+# drain and refill
+d.clear()
+for i in range(50):
+    d[str(i)] = i
+print(len(d), list(d.items())[-3:])
+for i in range(0, 50, 2):
+    d.pop(str(i))
+print(len(d), list(d.keys())[:5], d["49"])
+
+# mixed key types, including non-interned strings
+d = OrderedDict()
+for i in range(40):
+    d[i] = i
+    d[str(i) * 20] = i
+    d[(i, i)] = i
+print(len(d), d[39], d["5" * 20], d[(7, 7)])
+for i in range(40):
+    del d["%d" % i * 20]
+print(len(d), list(d)[:4])
+
+# copy and equality keep the order
+c = d.copy()
+print(type(c).__name__, c == d, list(c)[-4:])
+print(OrderedDict.fromkeys(range(30)) == OrderedDict.fromkeys(range(30)))
+
+# setdefault and update
+d = OrderedDict.fromkeys(range(20), 0)
+d.update({i: 1 for i in range(15, 25)})
+print(d.setdefault(30, 5), d.setdefault(5, 5), len(d), list(d.items())[-6:])
@@ -0,0 +1,29 @@
+# test strs created at runtime in various ways as dict keys and set items
+
+text = "alpha beta gamma alpha delta beta alpha " + "x" * 40 + " " + "x" * 40
+words = text.split()
+
+# count words built by split, slicing, join, concatenation and decode
+d = {}
+for w in words:
+    d[w] = d.get(w, 0) + 1
+for w in (text[0:5], text[6:10], "".join(["al", "pha"]), "be" + "ta", b"gamma".decode()):
+    d[w] = d.get(w, 0) + 1
+for w in (text[40:80], "".join(["x"] * 40)):
+    d[w] = d.get(w, 0) + 1
+print(sorted(d.items()))
+
+# the same str built in different ways is the same key
+s = set(words)
+s.add(str(b"delta", "utf-8"))
+s.add("del" + "ta")
+print(sorted(s))
+
+# many distinct strs, so that they are replaced in any cache
+keys = ["key%d" % i for i in range(300)]
+d = dict((k, i) for i, k in enumerate(keys))
+print(len(d), all(d["key%d" % i] == i for i in range(300)))
+print(all(("key%d" % i) == ("key" + str(i)) for i in range(300)))
+
+# strs that compare unequal
+print("abc"[:2] == "ab", "abc"[:2] == "ac", "abc"[1:] != "bc")
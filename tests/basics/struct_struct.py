@@ -0,0 +1,68 @@
+# test struct.Struct
+try:
+    import struct
+
+    struct.Struct
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+for fmt in ("<bBhHiI", ">bBhHiI", "!hxxI", "<2b3s2H", "@bhib", "<q", ">Q"):
+    s = struct.Struct(fmt)
+    print(fmt, s.format, s.size, s.size == struct.calcsize(fmt))
+
+# pack and unpack round trips
+s = struct.Struct("<bBhHiI4s")
+b = s.pack(-1, 255, -300, 65000, -(2**29), 2**30 - 1, b"ab")
+print(b, b == struct.pack("<bBhHiI4s", -1, 255, -300, 65000, -(2**29), 2**30 - 1, b"ab"))
+print(s.unpack(b))
+s = struct.Struct(">hxxI2s")
+b = s.pack(-2, 0x12345678, b"xyz")
+print(b, s.unpack(b))
+
+# native alignment matches the module functions
+s = struct.Struct("@bhbib")
+b = s.pack(1, 2, 3, 4, 5)
+print(b == struct.pack("@bhbib", 1, 2, 3, 4, 5), s.unpack(b))
+
+# values that aren't small ints
+s = struct.Struct("<qH")
+print(s.unpack(s.pack(-5, True)))
+
+# unpack_from and pack_into with offsets
+s = struct.Struct("<HH")
+buf = bytearray(10)
+s.pack_into(buf, 2, 0x1234, 0x5678)
+s.pack_into(buf, -4, 1, 2)
+print(buf)
+print(s.unpack_from(buf, 2), s.unpack_from(buf, -4), s.unpack_from(buf))
+
+# iter_unpack over a buffer
+s = struct.Struct("<bH")
+data = s.pack(1, 2) + s.pack(-3, 4) + s.pack(5, 65535)
+print(list(s.iter_unpack(data)))
+print(list(s.iter_unpack(memoryview(data)[3:])))
+print(list(s.iter_unpack(b"")))
+
+# errors
+for args in ((1,), (1, 2, 3)):
+    try:
+        s.pack(*args)
+    except Exception:
+        print("pack error")
+try:
+    s.unpack_from(b"12", 0)
+except Exception:
+    print("unpack error")
+try:
+    s.pack_into(bytearray(4), 2, 1, 2)
+except Exception:
+    print("pack_into error")
+try:
+    s.iter_unpack(b"1234")
+except Exception:
+    print("iter_unpack error")
+try:
+    struct.Struct("<Z")
+except Exception:
+    print("format error")
@@ -0,0 +1,206 @@
+# Test the epaper.SSD1680 driver against a fake SPI bus and pins.
+
+try:
+    import epaper
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+class Bus:
+    def __init__(self):
+        self.log = []
+        self.dc = 0
+        self.cs = 1
+        self.busy_count = 0
+
+    # The SPI object only needs a write method.
+    def write(self, buf):
+        assert self.cs == 0
+        self.log.append((self.dc, bytes(buf)))
+
+    def pin_dc(self, v):
+        self.dc = v
+
+    def pin_cs(self, v):
+        if v and not self.cs:
+            self.log.append(None)
+        self.cs = v
+
+    def pin_rst(self, v):
+        pass
+
+    # Report busy for a couple of polls after each request.
+    def pin_busy(self):
+        if self.busy_count:
+            self.busy_count -= 1
+            return 1
+        return 0
+
+    # Collapse the log into a list of (cmd, data) transactions.
+    def transactions(self):
+        out = []
+        cur = None
+        data = None
+        for entry in self.log:
+            if entry is None:
+                if data is not None:
+                    cur[1].extend(data)
+                data = None
+                continue
+            dc, buf = entry
+            if dc == 0:
+                cur = [buf[0], bytearray()]
+                out.append(cur)
+            else:
+                data = (data or b"") + buf
+        self.log = []
+        return [(c, bytes(d)) for c, d in out]
+
+    def writes(self):
+        return [e for e in self.log if e is not None]
+
+
+def show(bus):
+    for cmd, data in bus.transactions():
+        if len(data) > 16:
+            print(hex(cmd), len(data), data[:8], data[-8:])
+        else:
+            print(hex(cmd), data)
+
+
+def new(bus, **kw):
+    return epaper.SSD1680(bus, bus.pin_dc, bus.pin_cs, bus.pin_rst, bus.pin_busy, **kw)
+
+
+def rgb565(c):
+    return bytes((c & 0xFF, c >> 8))
+
+
+WHITE = rgb565(0xFFFF)
+BLACK = rgb565(0x0000)
+RED = rgb565(0xF800)
+
+# Full and partial waveform initialisation.
+bus = Bus()
+epd = new(bus)
+print("init full")
+epd.init(epaper.FULL)
+show(bus)
+print("init partial")
+epd.init(epaper.PARTIAL)
+show(bus)
+print("init custom lut")
+epd.init(epaper.PARTIAL, bytes(range(4)))
+show(bus)
+
+# Clear, refresh and sleep.
+print("clear")
+epd.clear()
+for cmd, data in bus.transactions():
+    print(hex(cmd), len(data), data and data[0])
+print("refresh")
+bus.busy_count = 3
+epd.refresh()
+show(bus)
+print(bus.busy_count)
+epd.refresh(False)
+show(bus)
+epd.sleep()
+show(bus)
+
+# An unaligned area: pixels outside the area in edge bytes are written white.
+print("write_area")
+px = WHITE + BLACK + RED + BLACK + RED + WHITE + WHITE + BLACK
+epd.write_area(6, 2, 9, 3, px)
+show(bus)
+
+# An area clipped by the panel edges.
+print("clipped")
+epd.write_area(-2, 294, 1, 297, BLACK * 16)
+show(bus)
+epd.write_area(200, 0, 210, 0, BLACK * 11)
+show(bus)
+
+# A large area is split into several writes within one transaction.
+print("large")
+epd.write_area(0, 0, 151, 15, RED * (152 * 16))
+print([len(d) for dc, d in bus.writes() if dc and len(d) > 4])
+show(bus)
+
+# Thresholds and L8 format.
+print("thresholds")
+epd = new(bus, thresholds=(255, 0, 0))
+epd.write_area(0, 0, 7, 0, RED + BLACK + WHITE * 6)
+show(bus)
+print("L8")
+epd = new(bus, color_format=epaper.L8, width=16, height=8, ram_x_offset=0)
+epd.write_area(0, 0, 7, 0, bytes((0, 50, 99, 100, 101, 200, 255, 0)))
+show(bus)
+
+# Errors.
+try:
+    epd.write_area(0, 0, 7, 1, bytes(8))
+except ValueError:
+    print("ValueError")
+try:
+    # the area's size in bytes wraps to 0 with a 64-bit size_t
+    epd.write_area(0, 0, (1 << 32) - 1, (1 << 32) - 1, bytes(8))
+except (ValueError, OverflowError):
+    print("ValueError")
+try:
+    epd.init(2)
+except ValueError:
+    print("ValueError")
+try:
+    new(bus, color_format=5)
+except ValueError:
+    print("ValueError")
+bus.busy_count = 1000
+try:
+    epd.wait(30)
+except OSError as e:
+    print("OSError", e.errno == 110)
+bus.busy_count = 0
+print(epd.busy())
+
+
+# LVGL flush callback with fake display objects.
+class Area:
+    def __init__(self, x1, y1, x2, y2):
+        self.x1, self.y1, self.x2, self.y2 = x1, y1, x2, y2
+
+
+class Display:
+    def __init__(self, last):
+        self.last = last
+        self.ready = 0
+
+    def flush_is_last(self):
+        return self.last
+
+    def flush_ready(self):
+        self.ready += 1
+
+
+# LVGL's px_map is a C pointer which must be dereferenced.
+class Pointer:
+    def __init__(self, buf):
+        self.buf = buf
+
+    def __dereference__(self, n):
+        print("deref", n)
+        return memoryview(self.buf)[:n]
+
+
+print("flush_cb")
+bus = Bus()
+epd = new(bus)
+disp = Display(False)
+epd.flush_cb(disp, Area(8, 8, 15, 8), BLACK * 8)
+show(bus)
+print(disp.ready)
+disp = Display(True)
+epd.flush_cb(disp, Area(0, 0, 7, 0), Pointer(RED * 8 + bytes(100)))
+show(bus)
+print(disp.ready)
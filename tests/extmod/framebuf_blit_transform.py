@@ -0,0 +1,147 @@
+# Test FrameBuffer.blit with rotation and mirroring.
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    framebuf.ROTATE_90
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+BUF_SIZE = {
+    framebuf.MONO_VLSB: lambda w, h: w * ((h + 7) // 8),
+    framebuf.MONO_HLSB: lambda w, h: ((w + 7) // 8) * h,
+    framebuf.MONO_HMSB: lambda w, h: ((w + 7) // 8) * h,
+    framebuf.RGB565: lambda w, h: 2 * w * h,
+    framebuf.GS4_HMSB: lambda w, h: ((w + 1) // 2) * h,
+    framebuf.GS8: lambda w, h: w * h,
+}
+MAX_COL = {
+    framebuf.MONO_VLSB: 1,
+    framebuf.MONO_HLSB: 1,
+    framebuf.MONO_HMSB: 1,
+    framebuf.RGB565: 0xFFFF,
+    framebuf.GS4_HMSB: 15,
+    framebuf.GS8: 255,
+}
+
+
+def new_fb(w, h, fmt):
+    return framebuf.FrameBuffer(bytearray(BUF_SIZE[fmt](w, h)), w, h, fmt)
+
+
+def printbuf(fb, w, h):
+    for y in range(h):
+        print(" ".join("%d" % fb.pixel(x, y) for x in range(w)))
+    print("--")
+
+
+# Where a transformed pixel (u, v) of an image of size w x h comes from.
+def source_of(u, v, w, h, t):
+    if t & framebuf.TRANSPOSE:
+        w, h = h, w
+    if t & framebuf.FLIP_H:
+        u = w - 1 - u
+    if t & framebuf.FLIP_V:
+        v = h - 1 - v
+    if t & framebuf.TRANSPOSE:
+        u, v = v, u
+    return u, v
+
+
+def check(src_fmt, dest_fmt, t, x, y, key=-1):
+    sw, sh, dw, dh = 11, 6, 13, 14
+    src = new_fb(sw, sh, src_fmt)
+    n = 0
+    for j in range(sh):
+        for i in range(sw):
+            n = (n * 37 + 11) & 0xFFFF
+            src.pixel(i, j, n % (MAX_COL[src_fmt] + 1))
+    dest = new_fb(dw, dh, dest_fmt)
+    dest.fill(MAX_COL[dest_fmt] & 0x5A5A)
+    expect = [[dest.pixel(i, j) for i in range(dw)] for j in range(dh)]
+    tw, th = (sh, sw) if t & framebuf.TRANSPOSE else (sw, sh)
+    for v in range(th):
+        for u in range(tw):
+            if 0 <= x + u < dw and 0 <= y + v < dh:
+                c = src.pixel(*source_of(u, v, sw, sh, t))
+                if c != key:
+                    expect[y + v][x + u] = c & MAX_COL[dest_fmt]
+    dest.blit(src, x, y, key, None, t)
+    return all(expect[j][i] == dest.pixel(i, j) for j in range(dh) for i in range(dw))
+
+
+TRANSFORMS = (
+    0,
+    framebuf.ROTATE_90,
+    framebuf.ROTATE_180,
+    framebuf.ROTATE_270,
+    framebuf.FLIP_H,
+    framebuf.FLIP_V,
+    framebuf.TRANSPOSE,
+    framebuf.TRANSPOSE | framebuf.FLIP_H | framebuf.FLIP_V,
+)
+FORMATS = (
+    (framebuf.MONO_VLSB, framebuf.MONO_VLSB),
+    (framebuf.MONO_HLSB, framebuf.MONO_HLSB),
+    (framebuf.MONO_HMSB, framebuf.MONO_HMSB),
+    (framebuf.MONO_VLSB, framebuf.MONO_HLSB),
+    (framebuf.MONO_HLSB, framebuf.MONO_VLSB),
+    (framebuf.RGB565, framebuf.RGB565),
+    (framebuf.GS4_HMSB, framebuf.GS4_HMSB),
+    (framebuf.GS8, framebuf.RGB565),
+)
+for src_fmt, dest_fmt in FORMATS:
+    ok = True
+    for t in TRANSFORMS:
+        for x, y in ((0, 0), (3, 5), (-2, -3), (9, 10)):
+            ok = ok and check(src_fmt, dest_fmt, t, x, y)
+        ok = ok and check(src_fmt, dest_fmt, t, 1, 1, key=0)
+        ok = ok and check(src_fmt, dest_fmt, t, 1, 1, key=1)
+    print(src_fmt, dest_fmt, ok)
+
+# A small example of each rotation.
+src = new_fb(3, 2, framebuf.GS8)
+for i in range(6):
+    src.pixel(i % 3, i // 3, i + 1)
+dest = new_fb(3, 3, framebuf.GS8)
+for t in TRANSFORMS[:4]:
+    dest.fill(0)
+    dest.blit(src, 0, 0, -1, None, t)
+    printbuf(dest, 3, 3)
+
+# Transform with a palette.
+src = new_fb(4, 2, framebuf.MONO_HLSB)
+src.hline(0, 0, 4, 1)
+pal = new_fb(2, 1, framebuf.RGB565)
+pal.pixel(0, 0, 0x1234)
+pal.pixel(1, 0, 0xF800)
+dest = new_fb(2, 4, framebuf.RGB565)
+dest.blit(src, 0, 0, -1, pal, framebuf.ROTATE_90)
+printbuf(dest, 2, 4)
+
+# An RGB565 framebuffer blitted onto itself at an overlapping offset is
+# copied as if from a separate copy of the source.
+for key in (-1, 3):
+    ok = True
+    for dx, dy in ((2, 1), (-2, -1), (3, 0), (-3, 0), (0, 2), (1, -2)):
+        fb = new_fb(7, 6, framebuf.RGB565)
+        ref = new_fb(7, 6, framebuf.RGB565)
+        for i in range(42):
+            fb.pixel(i % 7, i // 7, i % 5)
+            ref.pixel(i % 7, i // 7, i % 5)
+        copy = new_fb(7, 6, framebuf.RGB565)
+        copy.blit(fb, 0, 0)
+        fb.blit(fb, dx, dy, key)
+        ref.blit(copy, dx, dy, key)
+        ok = ok and all(fb.pixel(x, y) == ref.pixel(x, y) for x in range(7) for y in range(6))
+    print("self blit", key, ok)
+
+# Invalid transform.
+try:
+    dest.blit(src, 0, 0, -1, None, 8)
+except ValueError:
+    print("ValueError")
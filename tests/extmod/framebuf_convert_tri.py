@@ -0,0 +1,131 @@
+# Test conversion of RGB565 data to tri-colour black/red planes.
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    framebuf.convert_rgb565_tri
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+WHITE = 0xFFFF
+BLACK = 0x0000
+RED = 0xF800
+GREY = 0x8410
+
+
+def rgb565_buf(pixels):
+    buf = bytearray(len(pixels) * 2)
+    for i, c in enumerate(pixels):
+        buf[i * 2] = c & 0xFF
+        buf[i * 2 + 1] = c >> 8
+    return buf
+
+
+def printbuf(fb, w, h):
+    for y in range(h):
+        print("".join(str(fb.pixel(x, y)) for x in range(w)))
+    print("--")
+
+
+# 4x3 source image.
+src = rgb565_buf(
+    [
+        BLACK, WHITE, RED, GREY,
+        WHITE, BLACK, WHITE, RED,
+        RED, RED, BLACK, WHITE,
+    ]
+)  # fmt: skip
+
+# All rotations, into MONO_VLSB planes.
+w, h = 8, 10
+kbuf = bytearray(w * ((h + 7) // 8))
+rbuf = bytearray(w * ((h + 7) // 8))
+black = framebuf.FrameBuffer(kbuf, w, h, framebuf.MONO_VLSB)
+red = framebuf.FrameBuffer(rbuf, w, h, framebuf.MONO_VLSB)
+for rotate in (0, 90, 180, 270):
+    black.fill(0)
+    red.fill(0)
+    framebuf.convert_rgb565_tri(src, (1, 2, 4, 3), black, red, rotate=rotate)
+    print("rotate", rotate)
+    printbuf(black, w, h)
+    printbuf(red, w, h)
+
+# Area partially outside the framebuffer is clipped.
+black.fill(0)
+red.fill(0)
+framebuf.convert_rgb565_tri(src, (6, 8, 4, 3), black, red)
+printbuf(black, w, h)
+printbuf(red, w, h)
+
+# Custom thresholds: treat grey as black and nothing as red.
+black.fill(0)
+framebuf.convert_rgb565_tri(src, (0, 0, 4, 3), black, None, thresholds=(256, 0, 200))
+printbuf(black, w, h)
+
+# Default thresholds: orange and dark green are red, blue and dark grey are
+# black, and pale red is white.
+src2 = rgb565_buf([0xF3C0, 0x03E0, 0x001F, 0x4208, 0xFE18, 0xF800, 0x8410, 0xFFFF])
+black.fill(0)
+red.fill(0)
+framebuf.convert_rgb565_tri(src2, (0, 0, 8, 1), black, red)
+printbuf(black, w, 1)
+printbuf(red, w, 1)
+
+# Per-component thresholds: red needs blue below 8, black only checks green.
+black.fill(0)
+red.fill(0)
+framebuf.convert_rgb565_tri(src2, (0, 0, 8, 1), black, red, thresholds=(160, 256, 8, 256, 8, 256))
+printbuf(black, w, 1)
+printbuf(red, w, 1)
+
+# Non-VLSB destination goes through the generic path.
+kbuf = bytearray(2 * h)
+rbuf = bytearray(2 * h)
+black = framebuf.FrameBuffer(kbuf, w, h, framebuf.MONO_HLSB)
+red = framebuf.FrameBuffer(rbuf, w, h, framebuf.MONO_HLSB)
+framebuf.convert_rgb565_tri(src, (1, 5, 4, 3), black, red, rotate=90)
+printbuf(black, w, h)
+printbuf(red, w, h)
+
+# Larger areas, spanning several words of each column, give the same result
+# through the MONO_VLSB fast path as through the generic path.
+w, h = 45, 77
+colours = (WHITE, BLACK, RED, GREY, 0x07E0, 0x001F)
+big = rgb565_buf([colours[(i * 7 + i // 13) % 6] for i in range(40 * 70)])
+for rotate in (0, 90, 180, 270):
+    planes = []
+    for fmt in (framebuf.MONO_VLSB, framebuf.MONO_HLSB):
+        k = framebuf.FrameBuffer(bytearray(w * h), w, h, fmt)
+        r = framebuf.FrameBuffer(bytearray(w * h), w, h, fmt)
+        k.fill(1)
+        area = (3, 5, 40, 70) if rotate in (0, 180) else (5, 3, 40, 70)
+        framebuf.convert_rgb565_tri(big, area, k, r, rotate=rotate)
+        planes.append([(k.pixel(x, y), r.pixel(x, y)) for y in range(h) for x in range(w)])
+    print("rotate", rotate, planes[0] == planes[1])
+
+# Errors.
+try:
+    framebuf.convert_rgb565_tri(src, (0, 0, 4, 4), black, red)
+except ValueError:
+    print("ValueError")
+try:
+    framebuf.convert_rgb565_tri(src, (0, 0, 4, 3), black, red, rotate=45)
+except ValueError:
+    print("ValueError")
+try:
+    framebuf.convert_rgb565_tri(src, (0, 0, 4, 3), black, red, thresholds=(1, 2))
+except ValueError:
+    print("ValueError")
+try:
+    # w * h * 2 wraps to 0 with a 64-bit size_t
+    framebuf.convert_rgb565_tri(src, (0, 0, 1 << 32, 1 << 31), black, red)
+except (ValueError, OverflowError):
+    print("ValueError")
+try:
+    framebuf.convert_rgb565_tri(src, (0, 0, 4, 3), black, framebuf.FrameBuffer(rbuf, 4, 4, framebuf.MONO_HLSB))
+except ValueError:
+    print("ValueError")
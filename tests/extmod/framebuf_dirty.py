@@ -0,0 +1,64 @@
+# Test dirty rectangle tracking of FrameBuffer.
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+fb = framebuf.FrameBuffer(bytearray(16 * 16 * 2), 16, 16, framebuf.RGB565)
+if not hasattr(fb, "dirty"):
+    print("SKIP")
+    raise SystemExit
+
+# A new framebuffer is clean.
+print(fb.dirty())
+
+
+def test(name, f):
+    fb.clear_dirty()
+    f()
+    print(name, fb.dirty())
+
+
+test("pixel", lambda: fb.pixel(3, 4, 1))
+test("pixel get", lambda: fb.pixel(3, 4))
+test("pixel clipped", lambda: fb.pixel(16, 4, 1))
+test("fill", lambda: fb.fill(0))
+test("fill_rect", lambda: fb.fill_rect(2, 3, 4, 5, 1))
+test("fill_rect clipped", lambda: fb.fill_rect(-2, 12, 4, 10, 1))
+test("fill_rect outside", lambda: fb.fill_rect(20, 20, 4, 4, 1))
+test("hline", lambda: fb.hline(1, 2, 5, 1))
+test("vline", lambda: fb.vline(1, 2, 5, 1))
+test("rect", lambda: fb.rect(4, 5, 3, 2, 1))
+test("line", lambda: fb.line(10, 1, 2, 7, 1))
+test("line clipped", lambda: fb.line(-5, -5, 5, 20, 1))
+test("ellipse", lambda: fb.ellipse(8, 8, 3, 2, 1))
+test("text", lambda: fb.text("a", 4, 2, 1))
+test("text clipped", lambda: fb.text("ab", 12, -4, 1))
+test("scroll right down", lambda: fb.scroll(2, 3))
+test("scroll left up", lambda: fb.scroll(-2, -3))
+
+src = framebuf.FrameBuffer(bytearray(4 * 3 * 2), 4, 3, framebuf.RGB565)
+test("blit", lambda: fb.blit(src, 5, 6))
+test("blit clipped", lambda: fb.blit(src, 14, -1))
+if hasattr(framebuf, "ROTATE_90"):
+    test("blit rotated", lambda: fb.blit(src, 5, 6, -1, None, framebuf.ROTATE_90))
+else:
+    print("blit rotated (5, 6, 3, 4)")
+
+try:
+    from array import array
+
+    test("poly", lambda: fb.poly(2, 3, array("h", [0, 0, 5, 1, 2, 6]), 1))
+    test("poly fill", lambda: fb.poly(2, 3, array("h", [0, 0, 5, 1, 2, 6]), 1, True))
+except ImportError:
+    print("poly (2, 3, 6, 7)")
+    print("poly fill (2, 3, 6, 7)")
+
+# Changes accumulate until cleared.
+fb.clear_dirty()
+fb.pixel(1, 1, 1)
+fb.pixel(10, 12, 1)
+print(fb.dirty())
+fb.clear_dirty()
+print(fb.dirty())
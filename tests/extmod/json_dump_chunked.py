@@ -0,0 +1,37 @@
+# test json.dump of documents larger than the encoder's write buffer
+
+try:
+    import io, json
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+if not hasattr(io, "IOBase"):
+    print("SKIP")
+    raise SystemExit
+
+
+class S(io.IOBase):
+    def __init__(self):
+        self.chunks = []
+
+    def write(self, buf):
+        if type(buf) == bytearray:
+            # uPy passes a bytearray, CPython passes a str
+            buf = str(buf, "utf-8")
+        self.chunks.append(buf)
+        return len(buf)
+
+
+doc = [{"id": i, "name": "item\t%d" % i, "ok": i % 2 == 0, "vals": (i, -i, None)} for i in range(300)]
+for seps in (None, (",", ":")):
+    s = S()
+    json.dump(doc, s, separators=seps)
+    out = "".join(s.chunks)
+    print(len(out), out == json.dumps(doc, separators=seps), json.loads(out) == json.loads(json.dumps(doc)))
+print(sorted(json.loads(out)[-1].items()))
+
+# long strings needing escapes
+s = S()
+json.dump(["x" * 1000 + '"\\\n' * 100], s)
+print(json.loads("".join(s.chunks))[0][995:1010])
@@ -0,0 +1,57 @@
+# test MicroPython-specific behaviour of json.dump writing in chunks
+
+try:
+    import io, json
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+if not hasattr(io, "IOBase"):
+    print("SKIP")
+    raise SystemExit
+
+
+class S(io.IOBase):
+    def __init__(self, on_write=None):
+        self.chunks = []
+        self.on_write = on_write
+
+    def write(self, buf):
+        self.chunks.append(bytes(buf))
+        if self.on_write:
+            self.on_write()
+        return len(buf)
+
+
+# output is written in full chunks of the encoder's buffer size, then the rest
+s = S()
+json.dump([{"a": i, "b": "x" * (i % 7)} for i in range(200)], s)
+print(len(s.chunks), set(len(c) for c in s.chunks[:-1]), 0 < len(s.chunks[-1]) <= 256)
+print(json.loads(b"".join(s.chunks))[-1])
+
+# objects without a JSON encoding are printed with their repr, which can
+# resize the list that is being encoded
+class A:
+    def __repr__(self):
+        lst.clear()
+        return "0"
+
+
+lst = [1, A(), 2, 3]
+print(json.dumps(lst))
+lst = [1, A(), 2, 3]
+s = S()
+json.dump(lst, s)
+print(b"".join(s.chunks))
+
+# so can writing a chunk to the stream
+lst = ["x" * 100 for _ in range(10)]
+s = S(lst.clear)
+json.dump(lst, s)
+print(len(s.chunks), json.loads(b"".join(s.chunks)) == ["x" * 100] * 3)
+
+# and the same for a dict
+d = {"k%d" % i: "v" * 10 for i in range(40)}
+s = S(d.clear)
+json.dump(d, s)
+print(len(s.chunks), len(json.loads(b"".join(s.chunks))) < 40)
@@ -0,0 +1,20 @@
+# test json.load and json.loads on documents longer than the stream read size
+
+try:
+    from io import StringIO
+    import json
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+doc = json.dumps([{"key%d" % i: [i * 1.5, "s" * (i % 37), -i, "a\\b\"c" * (i % 5)]} for i in range(300)])
+print(len(doc), json.load(StringIO(doc)) == json.loads(doc))
+print(json.loads(doc)[-1])
+
+# tokens straddling the boundary at every offset
+for n in range(240, 270):
+    for tok in ('"abcdefghijklmnopq"', '"ab\\ncd\\u0041"', "-1234567.5e-3", "12345678901234567890", "true"):
+        s = " " * n + "[" + tok + "]"
+        if json.load(StringIO(s)) != json.loads(s):
+            print("mismatch", n, tok)
+print(json.loads(" " * 255 + '["abc", 1.25, -7]'))
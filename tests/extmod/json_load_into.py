@@ -0,0 +1,45 @@
+# test json.load_into, which parses into an existing dict and arrays
+
+try:
+    from io import StringIO
+    from array import array
+    import json
+
+    json.load_into
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+target = {"samples": array("f"), "ids": array("i", [9, 9, 9]), "meta": {"n": 0}}
+json.load_into('{"samples": [1.5, 2, -3.25e1], "ids": [1, 2, 3, 4], "meta": {"m": 1}, "x": "y"}', target)
+print(sorted(target.items()))
+
+# arrays are refilled in place, from bytes and streams
+samples = target["samples"]
+json.load_into(b'{"samples": [0.5, 100]}', target)
+print(target["samples"] is samples, samples)
+json.load_into(StringIO('{"samples": [' + ", ".join(str(i / 4) for i in range(50)) + "]}"), target)
+print(len(samples), samples[-1])
+json.load_into('{"samples": []}', target)
+print(samples)
+
+# a double array
+target = {"d": array("d")}
+json.load_into('{"d": [1e300, -2.5, 3]}', target)
+print(target["d"])
+
+# fields that aren't arrays or dicts are replaced
+target = {"a": array("b"), "b": {"c": 1}}
+json.load_into('{"a": {"x": 1}, "b": [2]}', target)
+print(sorted(target.items()))
+
+# errors
+for doc in ("[1]", "1", '{"a": [[1]]}', '{"a": ["x"]}', '{"a": [{}]}', '{"a": [null]}', '{"a": [1.5]}', '{"a": [1000]}'):
+    try:
+        json.load_into(doc, {"a": array("b")})
+    except (ValueError, TypeError, OverflowError) as e:
+        print(type(e).__name__)
+try:
+    json.load_into("{}", [])
+except TypeError:
+    print("TypeError")
@@ -0,0 +1,55 @@
+# test the Pike VM engine, selected with the re.PIKEVM flag
+try:
+    import re
+
+    re.PIKEVM
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def print_groups(match):
+    print("----")
+    try:
+        if match is not None:
+            i = 0
+            while True:
+                print(match.group(i))
+                i += 1
+    except IndexError:
+        pass
+
+
+def test(pattern, string):
+    r = re.compile(pattern, re.PIKEVM)
+    print_groups(r.match(string))
+    print_groups(r.search(string))
+
+
+test("a", "a")
+test("a", "ba")
+test("a+", "baaab")
+test("a+?", "baaab")
+test("(a|ab)(c|bcd)(d*)", "abcd")
+test("(a*)(a*)", "aaa")
+test("(a*?)(a*)", "aaa")
+test("(a|b)*c", "xababc")
+test("([0-9]+)-([0-9]+)", "tel: 123-4567")
+test("^abc$", "abc")
+test("^abc$", "abcd")
+test("b$", "ab")
+test("[^a-c]+", "abcxyzabc")
+test(r"\d+\s\w+", "-- 12 abc")
+test("x*", "aaa")
+test("", "aaa")
+
+# sub and split use the same engine
+r = re.compile("[, ]+", re.PIKEVM)
+print(r.split("a, b,c  d"))
+print(r.sub("-", "a, b,c  d"))
+
+# patterns that make the backtracking engine overflow its stack
+print(re.compile("(a*)*", re.PIKEVM).match("aaa").group(0))
+print(re.compile("(a*)*b", re.PIKEVM).match("a" * 1000))
+print(re.compile("(a|aa)*c", re.PIKEVM).search("a" * 1000))
+print(re.compile("(x+x+)+y", re.PIKEVM).search("x" * 100 + "y").group(0) == "x" * 100 + "y")
@@ -0,0 +1,144 @@
+# Test sys.path_importer_cache, which caches directory listings for import.
+
+import sys
+
+try:
+    import io, vfs
+
+    io.IOBase
+    sys.path_importer_cache
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class File(io.IOBase):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def ioctl(self, req, arg):
+        return 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+    def write(self, buf):
+        return len(buf)
+
+
+# FS without ilistdir, so import falls back to stat
+class FSNoList:
+    def __init__(self, files):
+        self.files = files
+
+    def mount(self, readonly, mkfs):
+        pass
+
+    def umount(self):
+        pass
+
+    def stat(self, path):
+        print("stat", path)
+        if path in self.files:
+            return (0x8000, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        if any(p.startswith(path + "/") for p in self.files):
+            return (0x4000, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError(2)
+
+    def open(self, path, mode):
+        print("open", path, mode)
+        if "w" in mode:
+            self.files[path] = b""
+        return File(self.files[path])
+
+
+class FS(FSNoList):
+    def ilistdir(self, path):
+        print("ilistdir", path)
+        prefix = path.rstrip("/") + "/"
+        names = set()
+        for p in self.files:
+            if p.startswith(prefix):
+                names.add(p[len(prefix) :].split("/")[0])
+        if not names:
+            raise OSError(2)
+        for n in names:
+            yield (n, 0x8000 if prefix + n in self.files else 0x4000, 0)
+
+
+def show_cache():
+    for d in sorted(sys.path_importer_cache):
+        entries = sys.path_importer_cache[d]
+        if isinstance(entries, dict):
+            entries = sorted(entries.items())
+        print(" ", repr(d), entries)
+
+
+files = {
+    "/mod1.py": b"print('mod1')",
+    "/pkg/__init__.py": b"print('pkg')",
+    "/pkg/sub.py": b"print('pkg.sub')",
+}
+vfs.mount(FS(files), "/fs")
+sys.path.insert(0, "/fs/missing")
+sys.path.insert(1, "/fs")
+sys.path_importer_cache.clear()
+
+# the first import lists the directories on sys.path, with no stat calls
+import mod1
+import pkg.sub
+
+show_cache()
+
+# a module that doesn't exist is looked up in the cache
+try:
+    import mod2
+except ImportError:
+    print("ImportError")
+
+# creating a file clears the cache, so the new module can be imported
+open("/fs/mod2.py", "w")
+print(sys.path_importer_cache)
+import mod2
+
+# mounting and unmounting clear the cache
+vfs.mount(FSNoList({"/mod3.py": b"print('mod3')"}), "/fs2")
+print(sys.path_importer_cache)
+sys.path.insert(0, "/fs2")
+import mod3
+
+show_cache()
+vfs.umount("/fs2")
+print(sys.path_importer_cache)
+sys.path.pop(0)
+
+# errors other than ENOENT are not cached, and import falls back to stat
+class FSDenied(FS):
+    def ilistdir(self, path):
+        print("ilistdir", path)
+        raise OSError(13)
+
+
+vfs.mount(FSDenied({"/mod4.py": b"print('mod4')"}), "/fs3")
+sys.path.insert(0, "/fs3")
+import mod4
+
+show_cache()
+vfs.umount("/fs3")
+sys.path.pop(0)
+
+# the cache can be disabled
+saved_cache = sys.path_importer_cache
+sys.path_importer_cache = None
+del sys.modules["mod1"]
+import mod1
+
+sys.path_importer_cache = saved_cache
+
+vfs.umount("/fs")
+sys.path.pop(0)
+sys.path.pop(0)
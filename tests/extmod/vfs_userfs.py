@@ -15,11 +15,12 @@ except (ImportError, AttributeError):
 class UserFile(io.IOBase):
     buffer_size = 16
 
-    def __init__(self, mode, data):
+    def __init__(self, mode, data, error_pos=None):
         assert isinstance(data, bytes)
         self.is_text = mode.find("b") == -1
         self.data = data
         self.pos = 0
+        self.error_pos = error_pos
 
     def read(self):
         if self.is_text:
@@ -29,6 +30,8 @@ class UserFile(io.IOBase):
 
     def readinto(self, buf):
         assert not self.is_text
+        if self.error_pos is not None and self.pos >= self.error_pos:
+            return -5  # EIO
         n = 0
         while n < len(buf) and self.pos < len(self.data):
             buf[n] = self.data[self.pos]
@@ -46,8 +49,9 @@ class UserFile(io.IOBase):
 
 
 class UserFS:
-    def __init__(self, files):
+    def __init__(self, files, read_errors):
         self.files = files
+        self.read_errors = read_errors
 
     def mount(self, readonly, mksfs):
         pass
@@ -63,7 +67,7 @@ class UserFS:
 
     def open(self, path, mode):
         print("open", path, mode)
-        return UserFile(mode, self.files[path])
+        return UserFile(mode, self.files[path], self.read_errors.get(path))
 
 
 # create and mount a user filesystem
@@ -75,8 +79,17 @@ user_files = {
     "/usermod4.mpy": b"syntax error",
     "/usermod5.py": b"print('in usermod5')",
     "/usermod6.py": b"print('in usermod6')",
+    "/usermod7.py": b"s = '" + b"0123456789" * 200 + b"'\nprint('in usermod7', len(s))",
+    "/usermod8.py": b"s = '" + b"0123456789" * 200 + b"'",
+    # header, 1 qstr, 0 objects, then a qstr of 100 bytes
+    "/usermod9.mpy": b"M\x06\x00\x1f\x02\x00\x81\x48" + b"a" * 101,
 }
-vfs.mount(UserFS(user_files), "/userfs")
+# reading these files fails with EIO once the given position is reached
+read_errors = {
+    "/usermod8.py": 16,
+    "/usermod9.mpy": 16,
+}
+vfs.mount(UserFS(user_files, read_errors), "/userfs")
 
 # open and read a file
 f = open("/userfs/data.txt")
@@ -92,7 +105,8 @@ try:
 except SyntaxError:
     print("SyntaxError in usermod3")
 
-# import a .mpy file with a syntax error (file should be closed on error)
+# import a .mpy file with a syntax error (file should be closed on error); it
+# isn't asked for a memory mapping, as a Python stream can't provide one
 try:
     import usermod4
 except ValueError:
@@ -106,6 +120,22 @@ import usermod5
 UserFile.buffer_size = 1024
 import usermod6
 
+# Test an import of a file much larger than the buffer
+UserFile.buffer_size = 16
+import usermod7
+
+# A read error when refilling the buffer is raised (file should be closed).
+try:
+    import usermod8
+except OSError as e:
+    print("OSError in usermod8", e.errno)
+
+# A read error when reading directly into the caller's buffer is raised.
+try:
+    import usermod9
+except OSError as e:
+    print("OSError in usermod9", e.errno)
+
 # unmount and undo path addition
 vfs.umount("/userfs")
 sys.path.pop()
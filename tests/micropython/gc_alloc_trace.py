@@ -0,0 +1,81 @@
+# test gc.trace_start() and related functions
+
+import gc
+
+try:
+    gc.trace_start
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def alloc_big():
+    return bytearray(1000)
+
+
+def alloc_tuples(n):
+    return [(i, i) for i in range(n)]
+
+
+def site(d, name):
+    for k, v in d.items():
+        if k.startswith(name + " "):
+            return k, v
+    return None, (0, 0)
+
+
+gc.trace_start()
+s0 = gc.trace_snapshot()
+alloc_big()
+s1 = gc.trace_snapshot()
+alloc_big()
+alloc_big()
+alloc_tuples(10)
+s2 = gc.trace_snapshot()
+
+# sites are named "function (file:line)" and count every allocation
+big, v1 = site(s1, "alloc_big")
+print(big.endswith("gc_alloc_trace.py:13)"), v1[0] >= 1000, v1[1] >= 1)
+k, v2 = site(s2, "alloc_big")
+print(k == big, v2[0] == 3 * v1[0], v2[1] == 3 * v1[1])
+k, v = site(s2, "<listcomp>")
+print(k.endswith("gc_alloc_trace.py:17)"), v[1] >= 10)
+
+# diffs are sorted by bytes, largest first, and omit sites that didn't change
+d = gc.trace_diff(s2, s1)
+print(d[0] == (2 * v1[0], 2 * v1[1], big))
+print(all(x[0] >= y[0] for x, y in zip(d, d[1:])))
+print(any(x[2] == big for x in gc.trace_diff(s1, s0)), gc.trace_diff(s2, s2))
+
+# sites only in the old snapshot give negative counts
+d = gc.trace_diff(s0, s2)
+print(d[-1][0] < 0, d[-1][1] < 0)
+
+# restarting discards previous counts
+gc.trace_start(4)
+print(site(gc.trace_snapshot(), "alloc_big")[0])
+
+# more sites than fit in the table are still counted
+for i in range(20):
+    exec("x%d = bytearray(100)" % i)
+print(sum(v[1] for v in gc.trace_snapshot().values()) >= 20)
+
+gc.trace_stop()
+try:
+    gc.trace_snapshot()
+except RuntimeError:
+    print("RuntimeError")
+try:
+    gc.trace_start(0)
+except ValueError:
+    print("ValueError")
+for size in (1 << 62, (1 << 59) + 1, 1 << 31):
+    # sizes whose table wouldn't fit in memory, or whose size overflows
+    try:
+        gc.trace_start(size)
+    except (ValueError, MemoryError, OverflowError):
+        print("too big")
+try:
+    gc.trace_diff(1, {})
+except TypeError:
+    print("TypeError")
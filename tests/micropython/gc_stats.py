@@ -0,0 +1,58 @@
+# test gc.stats() and gc.stats_callback()
+
+import gc
+
+try:
+    gc.stats
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+s0 = gc.stats()
+print(sorted(s0.keys()))
+print(len(s0["free_runs"]), s0["max_free"] <= s0["free"])
+
+# each collection is counted and timed
+gc.collect()
+s1 = gc.stats()
+print(s1["collections"] == s0["collections"] + 1)
+for k in ("mark_us", "sweep_us"):
+    print(k, 0 <= s1[k] <= s1[k + "_max"] <= s1[k + "_total"])
+print(s1["mark_us_total"] >= s0["mark_us_total"], s1["sweep_us_total"] >= s0["sweep_us_total"])
+
+# gc.collect() sweeps the whole heap in one step
+print(s1["sweep_steps"])
+
+# freed memory is reported as reclaimed
+l = [bytearray(1000) for _ in range(10)]
+l = None
+gc.collect()
+s2 = gc.stats()
+print(s2["reclaimed"] >= 10000, s2["reclaimed_total"] >= s1["reclaimed_total"] + s2["reclaimed"])
+
+# freeing every other object leaves runs of free blocks that are counted
+l = [bytearray(100) for _ in range(100)]
+for i in range(0, len(l), 2):
+    l[i] = None
+gc.collect()
+s3 = gc.stats()
+print(sum(s3["free_runs"][:4]) - sum(s2["free_runs"][:4]) >= 40)
+l = None
+
+# the callback is scheduled after each collection
+stats = []
+gc.stats_callback(stats.append)
+gc.collect()
+for _ in range(10):
+    pass
+print(len(stats), stats[0]["collections"] == gc.stats()["collections"])
+gc.stats_callback(None)
+gc.collect()
+for _ in range(10):
+    pass
+print(len(stats))
+
+try:
+    gc.stats_callback(1)
+except TypeError:
+    print("TypeError")
@@ -49,6 +49,9 @@ user_files = {
     "/mod0.mpy": b"",  # empty file
     "/mod1.mpy": b"M",  # too short header
     "/mod2.mpy": b"M\x00\x00\x00",  # bad version
+    "/mod3.mpy": b"M\x06\x00\x1f\x81",  # truncated in the middle of a uint
+    # valid file followed by padding, which is ignored
+    "/mod4.mpy": b"M\x06\x00\x1f\x04\x00\x0emod4.py\x00\x0f\x08mod4\x00\x81w`\x08\x02\x01\x11\x03\x10\x024\x01YQc\x05\xff\xff\xff\xff\xff",
 }
 
 # create and mount a user filesystem
@@ -104,6 +104,7 @@ user_files = {
                 b'\x06\x04' # rodata=6 bytes, bss=4 bytes
                 b'rodata' # rodata content
                 b'\x03\x01\x00' # dummy relocation of rodata
+                b'\xff' # end of relocations
     ),
 }
 # fmt: on
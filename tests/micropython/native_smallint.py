@@ -0,0 +1,118 @@
+# tests for arithmetic and comparisons on small ints in native code
+
+
+@micropython.native
+def binop(a, b):
+    return a + b, a - b, a & b, a | b, a ^ b
+
+
+@micropython.native
+def compare(a, b):
+    return a < b, a > b, a == b, a <= b, a >= b, a != b
+
+
+@micropython.native
+def binop_const(a):
+    return a + 1, a - 1, a + 100000, a - -5, a & 3, a | 8, a ^ 1, a < 0
+
+
+# small ints
+print(binop(3, 5), binop(-7, 2), binop(0, 0))
+print(compare(3, 5), compare(5, 5), compare(-1, -2))
+print(binop_const(7), binop_const(-1))
+
+# results that overflow a small int, for 31, 47 and 63 bit small ints
+for n in (30, 46, 62):
+    hi = 2**n - 1
+    lo = -(2**n)
+    print(binop(hi, 1), binop(lo, -1), binop(lo, 1), binop(hi, lo))
+    print(compare(hi, hi + 1), compare(lo, lo - 1))
+    print(binop_const(hi), binop_const(lo))
+
+# other types
+print(binop(2**70, 3), binop(3, 2**70), compare(2**70, 3))
+print(binop(True, 2), compare(False, 0))
+print(compare(1.5, 2), compare(2, 1.5))
+
+
+# inplace ops on mutable objects
+@micropython.native
+def inplace(a, b):
+    a += b
+    a -= b
+    return a
+
+
+class Num:
+    def __init__(self, v):
+        self.v = v
+
+    def __iadd__(self, other):
+        print("iadd", other)
+        return self
+
+    def __isub__(self, other):
+        print("isub", other)
+        return self
+
+
+print(inplace(1, 2), inplace(2**62, 2**62), inplace(1.5, 2))
+try:
+    inplace([1], [2])
+except TypeError:
+    print("TypeError")
+print(inplace(Num(1), 3).v)
+
+
+# comparisons that return something other than a bool
+class Cmp:
+    def __lt__(self, other):
+        return 42
+
+    def __gt__(self, other):
+        return 0
+
+
+@micropython.native
+def branch(a, b):
+    if a < b:
+        x = "lt"
+    else:
+        x = "not lt"
+    if not a > b:
+        x += " not gt"
+    return x
+
+
+print(branch(1, 2), branch(2, 1), branch(Cmp(), 1), branch(2**70, 2**71))
+
+
+# many locals in nested loops, so some live in registers and some don't
+@micropython.native
+def loops(n):
+    a = b = c = d = e = f = g = 0
+    for i in range(n):
+        for j in range(n):
+            a += i
+            b += j
+            c += a
+            d ^= b
+            e |= c
+            f -= 1
+            g += i & j
+    return a, b, c, d, e, f, g
+
+
+print(loops(6))
+
+
+# viper args in and out of registers
+@micropython.viper
+def viper_args(a: int, b: int, c, d, e, f: int, g: int) -> int:
+    x = 0
+    for i in range(f):
+        x += a + b + g
+    return x + int(c) + int(d) + int(e)
+
+
+print(viper_args(1, 2, 3, 4, 5, 6, 7))
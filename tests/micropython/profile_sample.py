@@ -0,0 +1,55 @@
+# test the sampling profiler in the micropython module
+
+import micropython
+
+try:
+    micropython.profile_start
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+import time
+
+
+def work(n):
+    x = 0
+    for i in range(n):
+        x += i * i
+    return x
+
+
+def run(ms):
+    t = time.ticks_ms()
+    while time.ticks_diff(time.ticks_ms(), t) < ms:
+        work(100)
+
+
+# no samples without starting the profiler
+print(micropython.profile_stop())
+
+# samples are collapsed stacks, outermost frame first, mapped to counts
+micropython.profile_start(500)
+run(300)
+stacks = micropython.profile_stop()
+print(type(stacks), len(stacks) > 0)
+print(all(type(k) is str and type(v) is int and v > 0 for k, v in stacks.items()))
+print(any(k.startswith("<module> (") and ";run (" in k and k.count(";") >= 1 for k in stacks))
+print(any(";work (" in k for k in stacks))
+
+# the buffer keeps the most recent samples
+micropython.profile_start(500, 4)
+run(100)
+print(sum(micropython.profile_stop().values()) <= 4)
+
+# invalid arguments
+for args in ((0,), (-1,), (100, 0)):
+    try:
+        micropython.profile_start(*args)
+    except ValueError:
+        print("ValueError")
+
+# a buffer whose size in bytes would overflow
+try:
+    micropython.profile_start(100, 1 << 62)
+except (ValueError, OverflowError):
+    print("too big")
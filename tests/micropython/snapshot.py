@@ -0,0 +1,216 @@
+# Test micropython.snapshot, which saves a module with a snapshot of its state,
+# and importing the result, which restores that state without executing the module.
+
+import gc, os, sys
+
+try:
+    import micropython
+
+    micropython.snapshot
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+module_source = """
+print("executing snapmod")
+import sys
+
+N = 123
+BIG = 1 << 100
+NEG = -(1 << 40)
+FLOAT = 1.5
+STR = "a string that is not a qstr"
+BYTES = b"bytes"
+BA = bytearray(b"abc")
+LIST = [1, 2, [3, None]]
+LIST.append(LIST)
+DICT = {"a": 1, (1, 2): "tuple key", 3: LIST}
+SET = {1, 2, 3}
+FROZENSET = frozenset({4, 5})
+TUPLE = (LIST, DICT, True, ...)
+SYS = sys
+
+
+def add(a, b=10, *, c=100):
+    return a + b + c
+
+
+def make_counter():
+    n = 0
+
+    def inc():
+        nonlocal n
+        n += 1
+        return n
+
+    return inc
+
+
+counter = make_counter()
+counter()
+
+
+def fact(n):
+    return 1 if n <= 1 else n * fact(n - 1)
+
+
+def gen(n):
+    for i in range(n):
+        yield i * i
+
+
+class Base:
+    count = 0
+
+    def __init__(self, v):
+        self.v = v
+        Base.count += 1
+
+    def get(self):
+        return self.v
+
+    @staticmethod
+    def smeth():
+        return "static"
+
+    @classmethod
+    def cmeth(cls):
+        return cls.__name__
+
+    @property
+    def prop(self):
+        return self.v * 2
+
+
+class Derived(Base):
+    def get(self):
+        return super().get() + 1
+
+
+class Color:
+    pass
+
+
+Color.RED = Color()
+Color.RED.name = "red"
+Color.ALL = [Color.RED]
+
+
+class Error(Exception):
+    pass
+
+
+obj = Derived(5)
+meth = obj.get
+square = lambda x: x * x
+"""
+
+# We need a directory for testing that doesn't already exist.
+temp_dir = "micropy_test_snapshot_dir"
+try:
+    os.stat(temp_dir)
+    print("SKIP")
+    raise SystemExit
+except OSError:
+    pass
+
+os.mkdir(temp_dir)
+sys.path.insert(0, temp_dir)
+
+try:
+    # Execute the module and save its snapshot.
+    with open(temp_dir + "/snapmod_src.py", "w") as f:
+        f.write(module_source)
+    m = micropython.snapshot("snapmod", temp_dir + "/snapmod_src.py", temp_dir + "/snapmod.mpy")
+    print(m.N, m.counter())
+    del sys.modules["snapmod"]
+    gc.collect()
+
+    # Import the snapshot, which doesn't execute the module.
+    import snapmod
+
+    print(snapmod is not m, snapmod.__name__, snapmod.__file__.endswith("snapmod.mpy"))
+
+    # Constants and containers, including identity and cycles.
+    print(snapmod.N, snapmod.BIG, snapmod.NEG, snapmod.FLOAT, snapmod.STR, snapmod.BYTES)
+    print(snapmod.BA, snapmod.LIST[:3], snapmod.LIST[3] is snapmod.LIST)
+    print(snapmod.DICT["a"], snapmod.DICT[(1, 2)], snapmod.DICT[3] is snapmod.LIST)
+    print(sorted(snapmod.SET), sorted(snapmod.FROZENSET), type(snapmod.FROZENSET) is frozenset)
+    print(snapmod.TUPLE[0] is snapmod.LIST, snapmod.TUPLE[1] is snapmod.DICT, snapmod.TUPLE[2:])
+    snapmod.BA.append(100)
+    snapmod.LIST.append(4)
+    print(snapmod.BA, len(snapmod.LIST))
+
+    # Other modules are referred to, not copied.
+    print(snapmod.SYS is sys)
+
+    # Functions, with their default args, closures and recursion.
+    print(snapmod.add(1), snapmod.add(1, 2, c=3))
+    print(snapmod.counter(), snapmod.counter())
+    print(snapmod.fact(5), list(snapmod.gen(4)), snapmod.square(7))
+
+    # Classes, instances and bound methods.
+    print(snapmod.Base.count, snapmod.obj.get(), snapmod.obj.prop, snapmod.meth())
+    print(snapmod.Base.smeth(), snapmod.Derived.cmeth(), snapmod.Derived(7).get(), snapmod.Base.count)
+    print(type(snapmod.obj) is snapmod.Derived, isinstance(snapmod.obj, snapmod.Base))
+    print(snapmod.Color.RED.name, snapmod.Color.ALL[0] is snapmod.Color.RED)
+    print(isinstance(snapmod.Color.RED, snapmod.Color))
+    try:
+        raise snapmod.Error("error")
+    except Exception as e:
+        print(type(e) is snapmod.Error, e)
+
+    # Objects that can't be snapshotted.
+    with open(temp_dir + "/snapbad.py", "w") as f:
+        f.write("f = open(__file__)\n")
+    try:
+        micropython.snapshot("snapbad", temp_dir + "/snapbad.py", temp_dir + "/snapbad.mpy")
+    except TypeError:
+        print("TypeError")
+    sys.modules["snapbad"].f.close()
+
+    # A snapshot that refers to a qstr beyond the module's qstr table.
+    with open(temp_dir + "/snapq_src.py", "w") as f:
+        f.write("X = 1\n")
+    micropython.snapshot("snapq", temp_dir + "/snapq_src.py", temp_dir + "/snapq.mpy")
+    del sys.modules["snapq"]
+    with open(temp_dir + "/snapq.mpy", "rb") as f:
+        data = f.read()
+    # The snapshot is: no objects, no records, then one global, X = 1.
+    print(data[-6:-2], data[-1])
+    with open(temp_dir + "/snapq.mpy", "wb") as f:
+        f.write(data[:-2] + bytes([31 << 2 | 2]) + data[-1:])
+    try:
+        import snapq
+    except ValueError as e:
+        print("ValueError", e)
+
+    # Snapshots that are corrupted in other ways.
+    def import_corrupted(name, source, old, new):
+        with open(temp_dir + "/" + name + "_src.py", "w") as f:
+            f.write(source)
+        micropython.snapshot(name, temp_dir + "/" + name + "_src.py", temp_dir + "/" + name + ".mpy")
+        del sys.modules[name]
+        with open(temp_dir + "/" + name + ".mpy", "rb") as f:
+            data = f.read()
+        with open(temp_dir + "/" + name + ".mpy", "wb") as f:
+            f.write(data.replace(old, new, 1))
+        try:
+            __import__(name)
+        except ValueError as e:
+            print("ValueError", e)
+
+    # The function record is: depth 1, child 0, no defaults; use child 5.
+    import_corrupted("snapf", "def f():\n    return 1\n", b"\x04\x01\x00\x01\x00\x00", b"\x04\x01\x00\x01\x05\x00")
+    # The shells are: C, its dict, L, its dict, then c; make c an instance of L.
+    import_corrupted(
+        "snapi",
+        "class C:\n    pass\nclass L(list):\n    pass\nc = C()\n",
+        b"\x0b\x02\x10\x00",
+        b"\x0b\x02\x10\x08",
+    )
+finally:
+    sys.path.pop(0)
+    for name in os.listdir(temp_dir):
+        os.remove(temp_dir + "/" + name)
+    os.rmdir(temp_dir)
@@ -0,0 +1,99 @@
+# This tests GC allocation speed on a fragmented heap.  The heap is first
+# riddled with single-block holes, by keeping every other one of many floats,
+# and then a ring of live lists, dicts and strings of mixed sizes is replaced
+# in turn, so most allocations need runs of several blocks.
+#
+# To see allocation latency percentiles rather than the total time run:
+#   micropython -c "exec(open('perf_bench/core_heap_churn.py').read()); latency_report()"
+
+
+def make(i):
+    k = i % 7
+    if k == 0:
+        return [i] * (i % 13)
+    elif k == 1:
+        return {"a": i, "b": i + 1, "c": i % 5}
+    elif k == 2:
+        return "s%d" % i * (1 + i % 9)
+    elif k == 3:
+        return (i, i + 1)
+    elif k == 4:
+        return bytearray(i % 100)
+    elif k == 5:
+        return [[i], [i, i]]
+    else:
+        return {i: str(i) for i in range(i % 6)}
+
+
+def churn(ring, n, start):
+    total = 0
+    size = len(ring)
+    for i in range(start, start + n):
+        # Vary the stride so freed objects are spread throughout the heap.
+        obj = make(i)
+        ring[(i * 7919) % size] = obj
+        total += len(obj)
+    return total
+
+
+def fragment(nfrag):
+    import gc
+
+    keep = [None] * nfrag
+    for i in range(nfrag):
+        keep[i] = i + 0.5
+        # This float becomes garbage, leaving a hole after the one kept.
+        t = i + 0.25
+    gc.collect()
+    return keep
+
+
+def test(nfrag, nring, niter):
+    keep = fragment(nfrag)
+    ring = [None] * nring
+    churn(ring, nring, 0)
+    return churn(ring, niter, nring) + len(keep)
+
+
+def latency_report(nfrag=20000, nring=2000, niter=100000, batch=10):
+    import time
+
+    keep = fragment(nfrag)
+    ring = [None] * nring
+    churn(ring, nring, 0)
+    times = []
+    for i in range(nring, nring + niter, batch):
+        t0 = time.ticks_us()
+        for j in range(i, i + batch):
+            ring[(j * 7919) % nring] = make(j)
+        times.append(time.ticks_diff(time.ticks_us(), t0))
+    times.sort()
+    n = len(times)
+    print("us per %d allocations:" % batch)
+    for p in (500, 900, 990, 999):
+        print("  p%g: %d" % (p / 10, times[n * p // 1000]))
+    print("  max: %d" % times[-1])
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (200, 100, 1000),
+    (1000, 10): (5000, 1000, 20000),
+    (5000, 10): (20000, 2000, 100000),
+}
+
+
+def bm_setup(params):
+    nfrag, nring, niter = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(nfrag, nring, niter)
+
+    def result():
+        return niter // 10, state
+
+    return run, result
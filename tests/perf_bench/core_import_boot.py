@@ -0,0 +1,133 @@
+# Test performance of importing the modules of an application at boot, from a
+# filesystem where each stat is expensive.  The result is the number of stat
+# calls made by one boot without sys.path_importer_cache, and the number of
+# stat and ilistdir calls made with it.
+
+import sys, io, vfs
+
+if not hasattr(sys, "path_importer_cache") or not hasattr(io, "IOBase"):
+    print("SKIP")
+    raise SystemExit
+
+files = {
+    "/lib/config.py": "import logging\nvalue = 1",
+    "/lib/logging.py": "level = 0",
+    "/lib/net/__init__.py": "from . import wifi, mqtt",
+    "/lib/net/wifi.py": "import config",
+    "/lib/net/mqtt.py": "import logging",
+    "/lib/sensors/__init__.py": "",
+    "/lib/sensors/temp.py": "import sensors.base",
+    "/lib/sensors/base.py": "",
+    "/app/main.py": "import config, net, sensors.temp, ui, storage",
+    "/app/ui.py": "import logging",
+    "/app/storage.py": "import config",
+    "/boot.py": "import main",
+}
+dirs = set(p[: p.rfind("/")] for p in files) | {"/"}
+n_stat = 0
+n_listdir = 0
+
+
+class File(io.IOBase):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def ioctl(self, req, arg):
+        return 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+
+# Like a filesystem on flash, a stat scans the entries of the parent directory.
+def scan(path):
+    prefix = path.rstrip("/") + "/"
+    for p in files:
+        if p.startswith(prefix) and "/" not in p[len(prefix) :]:
+            yield (p[len(prefix) :], 0x8000, 0)
+    for p in dirs:
+        if p.startswith(prefix) and p != path and "/" not in p[len(prefix) :]:
+            yield (p[len(prefix) :], 0x4000, 0)
+
+
+class FS:
+    def mount(self, readonly, mkfs):
+        pass
+
+    def stat(self, path):
+        global n_stat
+        n_stat += 1
+        i = path.rfind("/")
+        parent, name = path[:i] or "/", path[i + 1 :]
+        if parent in dirs:
+            for entry in scan(parent):
+                if entry[0] == name:
+                    return (entry[1], 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError(2)  # ENOENT
+
+    def ilistdir(self, path):
+        global n_listdir
+        n_listdir += 1
+        if path not in dirs:
+            raise OSError(2)  # ENOENT
+        return scan(path)
+
+    def open(self, path, mode):
+        return File(bytes(files[path], "utf8"))
+
+
+def mount():
+    global saved_modules
+    vfs.mount(FS(), "/__boot")
+    sys.path[:] = ["/__boot/app", "/__boot/lib", "/__boot"]
+    saved_modules = set(sys.modules)
+
+
+def import_app():
+    for m in list(sys.modules):
+        if m not in saved_modules:
+            del sys.modules[m]
+    if sys.path_importer_cache is not None:
+        sys.path_importer_cache.clear()
+    for name in ("boot", "main", "config", "logging", "net", "sensors", "ui", "storage"):
+        __import__(name)
+
+
+def fs_calls():
+    global n_stat, n_listdir
+    saved_cache = sys.path_importer_cache
+    sys.path_importer_cache = None
+    n_stat = 0
+    try:
+        import_app()
+    finally:
+        sys.path_importer_cache = saved_cache
+    calls = [n_stat]
+    n_stat = n_listdir = 0
+    import_app()
+    return calls + [n_stat, n_listdir]
+
+
+def test(r):
+    for _ in r:
+        import_app()
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (5,),
+    (1000, 10): (50,),
+    (5000, 10): (500,),
+}
+
+
+def bm_setup(params):
+    (nloop,) = params
+    mount()
+    return lambda: test(range(nloop)), lambda: (nloop, fs_calls())
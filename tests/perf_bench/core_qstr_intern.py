@@ -0,0 +1,42 @@
+# This tests qstr_find_strn() speed when many strings have been interned at
+# runtime, by interning lots of attribute names and then looking them up.
+
+
+class C:
+    pass
+
+
+def test(nnames, nlookup):
+    obj = C()
+    names = ["attr_%d" % i for i in range(nnames)]
+    for i, name in enumerate(names):
+        setattr(obj, name, i)
+    total = 0
+    for _ in range(nlookup):
+        for name in names:
+            total += getattr(obj, name)
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (200, 2),
+    (1000, 10): (2000, 4),
+    (5000, 10): (10000, 4),
+}
+
+
+def bm_setup(params):
+    nnames, nlookup = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(nnames, nlookup)
+
+    def result():
+        return nnames * nlookup // 10, state
+
+    return run, result
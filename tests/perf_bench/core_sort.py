@@ -0,0 +1,57 @@
+# This tests list.sort() and sorted() on sorted, reversed and random data,
+# with and without a key function.
+
+
+def make_data(n):
+    rand = []
+    x = 1
+    for _ in range(n):
+        x = (x * 1103515245 + 12345) & 0x7FFFFFFF
+        rand.append(x >> 8)
+    inc = sorted(rand)
+    dec = inc[::-1]
+    return inc, dec, rand, [str(x) for x in rand]
+
+
+def key(x):
+    return -x
+
+
+def test(niter, data):
+    inc, dec, rand, rand_str = data
+    for _ in range(niter):
+        for l in (inc, dec, rand):
+            a = sorted(l)
+            b = sorted(l, key=key)
+            c = sorted(l, reverse=True)
+        d = sorted(rand_str)
+        e = sorted(rand_str, key=len)
+    return a[0], b[0], c[0], d[0], e[0]
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (1, 50),
+    (50, 10): (2, 50),
+    (100, 10): (1, 500),
+    (500, 10): (4, 500),
+    (1000, 10): (2, 2000),
+    (5000, 10): (10, 2000),
+}
+
+
+def bm_setup(params):
+    niter, n = params
+    data = make_data(n)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter, data)
+
+    def result():
+        return niter * n // 10, state
+
+    return run, result
@@ -0,0 +1,49 @@
+# Rotate full-screen frame buffers by 90 degrees with FrameBuffer.blit, for a
+# 296x152 monochrome e-paper frame and a 320x240 RGB565 frame.
+
+try:
+    import framebuf
+
+    framebuf.ROTATE_90
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def test(frames, nloop):
+    for _ in range(nloop):
+        for src, dest, _, _ in frames:
+            dest.blit(src, 0, 0, -1, None, framebuf.ROTATE_90)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (64, 32, 64, 32, 4),
+    (100, 100): (296, 152, 160, 120, 10),
+    (1000, 1000): (296, 152, 320, 240, 50),
+}
+
+
+def bm_setup(params):
+    mw, mh, cw, ch, nloop = params
+    mono_src = framebuf.FrameBuffer(bytearray(mw * mh // 8), mw, mh, framebuf.MONO_VLSB)
+    mono_dest = framebuf.FrameBuffer(bytearray(mw * mh // 8), mh, mw, framebuf.MONO_VLSB)
+    colour_src = framebuf.FrameBuffer(bytearray(cw * ch * 2), cw, ch, framebuf.RGB565)
+    colour_dest = framebuf.FrameBuffer(bytearray(cw * ch * 2), ch, cw, framebuf.RGB565)
+    for i in range(0, mw, 3):
+        mono_src.line(i, 0, mw - 1 - i, mh - 1, 1)
+    for i in range(0, cw, 5):
+        colour_src.line(i, 0, cw - 1 - i, ch - 1, i * 0x123)
+    frames = ((mono_src, mono_dest, mw, mh), (colour_src, colour_dest, cw, ch))
+
+    def result():
+        # Check a few pixels, (x, y) in the source goes to (h - 1 - y, x).
+        ok = True
+        for src, dest, w, h in frames:
+            for x, y in ((0, 0), (w - 1, 0), (0, h - 1), (w // 3, h // 2), (w - 1, h - 1)):
+                ok = ok and dest.pixel(h - 1 - y, x) == src.pixel(x, y)
+        return nloop * (mw * mh + cw * ch) // 10000, ok
+
+    return lambda: test(frames, nloop), result
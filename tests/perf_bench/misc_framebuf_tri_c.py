@@ -0,0 +1,66 @@
+# Convert an RGB565 frame to tri-colour e-paper planes using the native
+# framebuf.convert_rgb565_tri.  Compare with misc_framebuf_tri_py.py which does
+# the same work in Python.
+
+try:
+    import framebuf
+
+    framebuf.convert_rgb565_tri
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def reference(src, w, h, black, red):
+    # Same conversion in Python, used only to check the result.  As in the
+    # original flush callback, green and blue are compared without scaling.
+    i = 0
+    for y in range(h):
+        for x in range(w):
+            c = src[i] | src[i + 1] << 8
+            i += 2
+            r, g, b = (c >> 8) & 0xF8, (c >> 5) & 0x3F, c & 0x1F
+            is_red = r >= 160 and g < 40 and b < 40
+            is_black = not is_red and r < 100 and g < 100 and b < 100
+            black.pixel(y, w - 1 - x, not is_black)
+            red.pixel(y, w - 1 - x, is_red)
+
+
+def test(src, w, h, black, red, nframes):
+    for _ in range(nframes):
+        framebuf.convert_rgb565_tri(src, (0, 0, w, h), black, red, rotate=90)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (32, 48, 1),
+    (100, 100): (152, 296, 1),
+    (1000, 1000): (152, 296, 4),
+}
+
+
+def bm_setup(params):
+    w, h, nframes = params
+    src = bytearray(w * h * 2)
+    colours = (0xFFFF, 0x0000, 0xF800, 0x8410, 0xF8A0, 0x3186)
+    seed = 1
+    for i in range(w * h):
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+        c = colours[(seed >> 16) % len(colours)]
+        src[2 * i] = c & 0xFF
+        src[2 * i + 1] = c >> 8
+    kbuf = bytearray(h * w // 8)
+    rbuf = bytearray(h * w // 8)
+    black = framebuf.FrameBuffer(kbuf, h, w, framebuf.MONO_VLSB)
+    red = framebuf.FrameBuffer(rbuf, h, w, framebuf.MONO_VLSB)
+
+    def result():
+        planes = kbuf + rbuf
+        black.fill(0)
+        red.fill(0)
+        reference(src, w, h, black, red)
+        return nframes * w * h // 1000, planes == kbuf + rbuf
+
+    return lambda: test(src, w, h, black, red, nframes), result
@@ -0,0 +1,72 @@
+# Convert an RGB565 frame to tri-colour e-paper planes in Python, one pixel at a
+# time, as a flush callback would without native support.  Compare with
+# misc_framebuf_tri_c.py which does the same work using framebuf.convert_rgb565_tri.
+
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+def rgb565_to_tri(lo, hi):
+    r = hi & 0xF8
+    g = ((hi & 0x07) << 3) | ((lo & 0xE0) >> 5)
+    b = lo & 0x1F
+    if r >= 160 and g < 40 and b < 40:
+        return 2  # red
+    elif r < 100 and g < 100 and b < 100:
+        return 1  # black
+    else:
+        return 0  # white
+
+
+def convert(src, w, h, black, red):
+    # Rotate by 90 degrees: logical (x, y) goes to plane pixel (y, w - 1 - x).
+    i = 0
+    for y in range(h):
+        for x in range(w):
+            c = rgb565_to_tri(src[i], src[i + 1])
+            i += 2
+            if c == 0:
+                black.pixel(y, w - 1 - x, 1)
+                red.pixel(y, w - 1 - x, 0)
+            elif c == 1:
+                black.pixel(y, w - 1 - x, 0)
+                red.pixel(y, w - 1 - x, 0)
+            else:
+                black.pixel(y, w - 1 - x, 1)
+                red.pixel(y, w - 1 - x, 1)
+
+
+def test(src, w, h, black, red, nframes):
+    for _ in range(nframes):
+        convert(src, w, h, black, red)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (32, 48, 1),
+    (100, 100): (152, 296, 1),
+    (1000, 1000): (152, 296, 4),
+}
+
+
+def bm_setup(params):
+    w, h, nframes = params
+    src = bytearray(w * h * 2)
+    colours = (0xFFFF, 0x0000, 0xF800, 0x8410, 0xF8A0, 0x3186)
+    seed = 1
+    for i in range(w * h):
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+        c = colours[(seed >> 16) % len(colours)]
+        src[2 * i] = c & 0xFF
+        src[2 * i + 1] = c >> 8
+    kbuf = bytearray(h * w // 8)
+    rbuf = bytearray(h * w // 8)
+    black = framebuf.FrameBuffer(kbuf, h, w, framebuf.MONO_VLSB)
+    red = framebuf.FrameBuffer(rbuf, h, w, framebuf.MONO_VLSB)
+
+    return lambda: test(src, w, h, black, red, nframes), lambda: (nframes * w * h // 1000, None)
@@ -0,0 +1,55 @@
+# This tests serialising telemetry-like data with json.dumps and json.dump
+
+import io
+import json
+
+
+def make_data(nrec):
+    recs = []
+    for i in range(nrec):
+        recs.append(
+            {
+                "ts": 1700000000 + i,
+                "id": "sensor-%d" % (i % 16),
+                "ok": i % 3 != 0,
+                "note": "reading %d within range" % i,
+                "v": [i, -i, i * 7],
+            }
+        )
+    return recs
+
+
+def test(data, niter):
+    for _ in range(niter):
+        s = json.dumps(data)
+        f = io.StringIO()
+        json.dump(data, f)
+    return len(s), s == f.getvalue()
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (8, 1),
+    (50, 10): (16, 1),
+    (100, 10): (32, 1),
+    (500, 10): (64, 4),
+    (1000, 10): (128, 8),
+    (5000, 10): (256, 20),
+}
+
+
+def bm_setup(params):
+    nrec, niter = params
+    data = make_data(nrec)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(data, niter)
+
+    def result():
+        return nrec * niter, state
+
+    return run, result
@@ -0,0 +1,54 @@
+# This tests parsing telemetry-like JSON documents with json.loads and json.load
+
+import io
+import json
+
+
+def make_doc(nrec):
+    recs = []
+    for i in range(nrec):
+        recs.append(
+            {
+                "ts": 1700000000 + i,
+                "temp": 21.5 + i * 0.125,
+                "id": "sensor-%d" % (i % 16),
+                "ok": i % 3 != 0,
+                "v": [i, -i, i * 7],
+            }
+        )
+    return json.dumps(recs)
+
+
+def test(doc, niter):
+    for _ in range(niter):
+        a = json.loads(doc)
+        b = json.load(io.StringIO(doc))
+    return len(a), a[-1] == b[-1]
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (8, 1),
+    (50, 10): (16, 1),
+    (100, 10): (32, 1),
+    (500, 10): (64, 4),
+    (1000, 10): (128, 8),
+    (5000, 10): (256, 20),
+}
+
+
+def bm_setup(params):
+    nrec, niter = params
+    doc = make_doc(nrec)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(doc, niter)
+
+    def result():
+        return nrec * niter, state
+
+    return run, result
@@ -0,0 +1,82 @@
+# This tests the Pike VM re engine with typical regular expressions, and with
+# pathological ones that the backtracking engine takes exponential time (or
+# stack) to run.
+
+try:
+    import re
+
+    re.PIKEVM
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+TYPICAL = (
+    "ERROR: ([a-z]+)",
+    r"id=(\d+)",
+    "(warn|error)",
+    "[0-9]+ms",
+)
+
+PATHOLOGICAL = (
+    ("(a*)*b", "a"),
+    ("(a|aa)+c", "a"),
+    ("(x+x+)+y", "x"),
+    (".*a.*a.*a.*a.*a.*ab", "a"),
+)
+
+
+def make_text(nline):
+    lines = []
+    for i in range(nline):
+        if i % 7 == 0:
+            lines.append("12:%02d ERROR: disk id=%d took %dms" % (i % 60, i, i * 3))
+        else:
+            lines.append("12:%02d info: all fine in sector %d, nothing to report" % (i % 60, i))
+    return "\n".join(lines)
+
+
+def test(typical, pathological, text, nloop):
+    n = 0
+    ok = True
+    for _ in range(nloop):
+        for r in typical:
+            pos = text
+            while True:
+                m = r.search(pos)
+                if m is None:
+                    break
+                n += 1
+                pos = pos[pos.index(m.group(0)) + len(m.group(0)) :]
+        for r, s in pathological:
+            ok = ok and r.search(s) is None
+    return n > 0 and ok
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (4, 16, 1),
+    (50, 10): (8, 16, 1),
+    (100, 10): (16, 32, 1),
+    (500, 10): (32, 64, 2),
+    (1000, 10): (64, 64, 4),
+    (5000, 10): (128, 128, 8),
+}
+
+
+def bm_setup(params):
+    nline, npath, nloop = params
+    typical = [re.compile(p, re.PIKEVM) for p in TYPICAL]
+    pathological = [(re.compile(p, re.PIKEVM), c * npath) for p, c in PATHOLOGICAL]
+    text = make_text(nline)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(typical, pathological, text, nloop)
+
+    def result():
+        return nline * nloop, state
+
+    return run, result
@@ -0,0 +1,66 @@
+# This tests searching, splitting and substituting in log-like text with
+# typical regular expressions, using the default re engine.
+
+import re
+
+PATTERNS = (
+    "ERROR: ([a-z]+)",
+    r"id=(\d+)",
+    "(warn|error)",
+    "[0-9]+ms",
+)
+
+
+def make_text(nline):
+    lines = []
+    for i in range(nline):
+        if i % 7 == 0:
+            lines.append("12:%02d ERROR: disk id=%d took %dms" % (i % 60, i, i * 3))
+        else:
+            lines.append("12:%02d info: all fine in sector %d, nothing to report" % (i % 60, i))
+    return "\n".join(lines)
+
+
+def test(patterns, text, nloop):
+    n = 0
+    for _ in range(nloop):
+        for r in patterns:
+            pos = text
+            while True:
+                m = r.search(pos)
+                if m is None:
+                    break
+                n += 1
+                pos = pos[pos.index(m.group(0)) + len(m.group(0)) :]
+        n += len(patterns[1].sub("id=?", text))
+        n += len(re.compile("\n").split(text))
+    return n
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (4, 1),
+    (50, 10): (8, 1),
+    (100, 10): (16, 1),
+    (500, 10): (32, 2),
+    (1000, 10): (64, 4),
+    (5000, 10): (128, 8),
+}
+
+
+def bm_setup(params):
+    nline, nloop = params
+    patterns = [re.compile(p) for p in PATTERNS]
+    text = make_text(nline)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(patterns, text, nloop)
+
+    def result():
+        return nline * nloop, state
+
+    return run, result
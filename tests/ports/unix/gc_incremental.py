@@ -0,0 +1,55 @@
+# Test automatic collections whose sweep is done in steps by later
+# allocations: objects allocated while a sweep is in progress must survive it,
+# nothing must be left allocated once a full collection has run, and only the
+# sweeps of automatic collections are spread over more than one step.
+
+import gc
+
+if not hasattr(gc, "stats"):
+    print("SKIP")
+    raise SystemExit
+
+
+# keep a ring of live objects while churning through short-lived ones, so that
+# automatic collections happen and their sweeps overlap with new allocations
+def churn(n):
+    ring = [None] * 64
+    # the number of steps of each sweep of an automatic collection
+    steps = []
+    collections = gc.stats()["collections"]
+    first = True
+    for i in range(n):
+        obj = [i] * (i % 13)
+        bytearray(i % 50)
+        str(i) * (i % 5)
+        ring[i % len(ring)] = (i, obj)
+        if i % 16 == 0:
+            s = gc.stats()
+            if s["collections"] != collections:
+                # a new collection finishes the previous sweep first, which
+                # is from a gc.collect() for the first one seen
+                if not first:
+                    steps.append(s["sweep_steps"])
+                first = False
+                collections = s["collections"]
+    print(all(obj == [i] * (i % 13) for i, obj in ring))
+    print(len(steps) > 0 and min(steps) > 1)
+
+
+# a full collection finishes any sweep in progress and reclaims everything, so
+# the heap ends up the same after each run
+free = []
+for _ in range(3):
+    churn(50000)
+    gc.collect()
+    print(gc.stats()["sweep_steps"])
+    free.append(gc.mem_free())
+print(free[0] == free[1] == free[2])
+
+# the same with a small threshold, so the sweeps are interleaved with the loop
+gc.threshold(4096)
+ring = [None] * 16
+for i in range(5000):
+    ring[i % len(ring)] = {i: str(i)}
+print(all(d == {k: str(k)} for d in ring for k in d))
+gc.threshold(-1)
@@ -0,0 +1,61 @@
+# Test importing an .mpy file from the filesystem.  With
+# MICROPY_PERSISTENT_CODE_LOAD_XIP enabled (the unix coverage variant) the file
+# is mapped into memory and its bytecode and constants are referenced in place.
+
+import gc, os, sys
+
+# This is xipmod.py, compiled to xipmod.mpy below.
+"""
+class A:
+    def __init__(self, arg):
+        self.arg = arg
+
+    def get(self):
+        return self.arg
+
+
+def f(x):
+    s = "a long string constant that is not a qstr"
+    b = b"some bytes constant"
+    return s, b, len(s) + x
+
+
+value = f(1)
+"""
+file_data = b'M\x06\x00\x1f\x0e\x02\x12xipmod.py\x00\x0f\x02A\x00\x02f\x00#\x06arg\x00\x81-\x82E/-5\x02x\x00\x81W\x82\x13\x05)a long string constant that is not a qstr\x00\x06\x13some bytes constant\x00\x81l\x10\n\x01\x89\x08d`T2\x00\x10\x024\x02\x16\x022\x01\x16\x03\x11\x03\x814\x01\x16\x07Qc\x02\x81<\x00\x06\x02(d\x11\x08\x16\t\x10\x02\x16\n2\x00\x16\x042\x01\x16\x06Qc\x02`\x1a\x08\x04\r\x05@\xb1\xb0\x18\x05QcP\t\x08\x06\r`@\xb0\x13\x05c\x81P1\x0c\x03\x0b\x80\t###\x00\xc1#\x01\xc2\xb1\xb2\x12\x0c\xb14\x01\xb0\xf2*\x03c'
+
+# We need a directory for testing that doesn't already exist.
+temp_dir = "micropy_test_xip_dir"
+try:
+    os.stat(temp_dir)
+    print("SKIP")
+    raise SystemExit
+except OSError:
+    pass
+
+os.mkdir(temp_dir)
+with open(temp_dir + "/xipmod.mpy", "wb") as f:
+    f.write(file_data)
+sys.path.insert(0, temp_dir)
+
+try:
+    for _ in range(2):
+        import xipmod
+
+        print(xipmod.value)
+        print(xipmod.A(123).get(), xipmod.f(2)[2])
+
+        # constants loaded from the file work as str/bytes and dict keys
+        s, b, _ = xipmod.f(0)
+        d = {s: 1}
+        print(d["a long string constant that is not a qstr"], {b: 2}[b"some bytes constant"])
+        print(s.upper()[:6], b[5:], hash(s) == hash("a long string constant that is not a qstr"))
+
+        # the module works after a collection, and can be imported again
+        del sys.modules["xipmod"]
+        gc.collect()
+        print(xipmod.f(3)[2])
+finally:
+    sys.path.pop(0)
+    os.remove(temp_dir + "/xipmod.mpy")
+    os.rmdir(temp_dir)
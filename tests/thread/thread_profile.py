@@ -0,0 +1,60 @@
+# test starting and stopping the sampling profiler while threads take samples
+
+import micropython
+
+try:
+    micropython.profile_start
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+import time
+import _thread
+
+
+def work(n):
+    x = 0
+    for i in range(n):
+        x += i * i
+    return x
+
+
+def th():
+    while not done:
+        work(100)
+    with lock:
+        global n_finished
+        n_finished += 1
+
+
+lock = _thread.allocate_lock()
+done = False
+n_thread = 0
+n_finished = 0
+
+# spawn threads that run Python code, so any of them may take a sample
+for _ in range(4):
+    try:
+        _thread.start_new_thread(th, ())
+        n_thread += 1
+    except OSError:
+        # System cannot create a new thead, so stop trying to create them.
+        break
+
+# restart the profiler with a small buffer, which is replaced each time
+n_samples = 0
+for _ in range(20):
+    micropython.profile_start(10000, 8)
+    t = time.ticks_ms()
+    while time.ticks_diff(time.ticks_ms(), t) < 10:
+        work(100)
+    stacks = micropython.profile_stop()
+    assert all(v > 0 for v in stacks.values())
+    n_samples += sum(stacks.values())
+
+# wait for threads to finish
+done = True
+while n_finished < n_thread:
+    time.sleep(0)
+
+print(n_samples > 0)
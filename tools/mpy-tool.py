@@ -115,6 +115,8 @@ MP_NATIVE_ARCH_XTENSA = 9
 MP_NATIVE_ARCH_XTENSAWIN = 10
 MP_NATIVE_ARCH_RV32IMC = 11
 
+MPY_FEATURE_SNAPSHOT = 0x80
+
 MP_PERSISTENT_OBJ_FUN_TABLE = 0
 MP_PERSISTENT_OBJ_NONE = 1
 MP_PERSISTENT_OBJ_FALSE = 2
@@ -568,6 +570,7 @@ class CompiledModule:
         obj_table_file_offset,
         raw_code_file_offset,
         escaped_name,
+        snapshot,
     ):
         self.mpy_source_file = mpy_source_file
         self.mpy_segments = mpy_segments
@@ -580,6 +583,7 @@ class CompiledModule:
         self.obj_table_file_offset = obj_table_file_offset
         self.raw_code_file_offset = raw_code_file_offset
         self.escaped_name = escaped_name
+        self.snapshot = snapshot
 
     def hexdump(self):
         with open(self.mpy_source_file, "rb") as f:
@@ -670,6 +674,22 @@ class CompiledModule:
 
         self.freeze_constants()
 
+        if self.snapshot is not None:
+            # The snapshot of the module's state, prefixed by the size of the
+            # qstr table it refers to and by its length.
+            data = (
+                mp_encode_uint(len(self.qstr_table))
+                + mp_encode_uint(len(self.snapshot))
+                + self.snapshot
+            )
+            print()
+            print("#if MICROPY_PERSISTENT_CODE_SNAPSHOT")
+            print("static const uint8_t snapshot_%s[%u] = {" % (self.escaped_name, len(data)))
+            for i in range(0, len(data), 16):
+                print("   ", "".join(" 0x%02x," % b for b in data[i : i + 16]))
+            print("};")
+            print("#endif")
+
         print()
         print("static const mp_frozen_module_t frozen_module_%s = {" % self.escaped_name)
         print("    .constants = {")
@@ -686,6 +706,10 @@ class CompiledModule:
             print("        .obj_table = NULL,")
         print("    },")
         print("    .proto_fun = &proto_fun_%s," % self.raw_code.escaped_name)
+        if self.snapshot is not None:
+            print("    #if MICROPY_PERSISTENT_CODE_SNAPSHOT")
+            print("    .snapshot = snapshot_%s," % self.escaped_name)
+            print("    #endif")
         print("};")
 
     def freeze_constant_obj(self, obj_name, obj):
@@ -931,9 +955,11 @@ class RawCode(object):
             print("    .children = (void *)%s," % prelude_ptr)
         else:
             print("    .children = NULL,")
+        print("    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_PERSISTENT_CODE_SNAPSHOT")
+        print("    .n_children = %u," % len(self.children))
+        print("    #endif")
         print("    #if MICROPY_PERSISTENT_CODE_SAVE")
         print("    .fun_data_len = %u," % len(self.fun_data))
-        print("    .n_children = %u," % len(self.children))
         print("    #if MICROPY_EMIT_MACHINE_CODE")
         print("    .prelude_offset = %u," % self.prelude_offset)
         print("    #endif")
@@ -1357,7 +1383,7 @@ def read_mpy(filename):
         if header[1] != config.MPY_VERSION:
             raise MPYReadError(filename, "incompatible .mpy version")
         feature_byte = header[2]
-        mpy_native_arch = feature_byte >> 2
+        mpy_native_arch = feature_byte >> 2 & 0x1F
         if mpy_native_arch != MP_NATIVE_ARCH_NONE:
             mpy_sub_version = feature_byte & 3
             if mpy_sub_version != config.MPY_SUB_VERSION:
@@ -1391,6 +1417,11 @@ def read_mpy(filename):
         raw_code_file_offset = reader.tell()
         raw_code = read_raw_code(reader, cm_escaped_name, qstr_table, obj_table, segments)
 
+        # Read the snapshot of the module's state, if there is one after the raw code.
+        snapshot = None
+        if feature_byte & MPY_FEATURE_SNAPSHOT:
+            snapshot = reader.read_bytes(reader.read_uint())
+
     # Create the outer-level compiled module representing the whole .mpy file.
     return CompiledModule(
         filename,
@@ -1403,6 +1434,7 @@ def read_mpy(filename):
         obj_table_file_offset,
         raw_code_file_offset,
         cm_escaped_name,
+        snapshot,
     )
 
 
@@ -1692,8 +1724,10 @@ def merge_mpy(compiled_modules, output_file):
     else:
         main_cm_idx = None
         for idx, cm in enumerate(compiled_modules):
+            if cm.snapshot is not None:
+                raise Exception("can't merge files that contain a snapshot")
             feature_byte = cm.header[2]
-            mpy_native_arch = feature_byte >> 2
+            mpy_native_arch = feature_byte >> 2 & 0x1F
             if mpy_native_arch:
                 # Must use qstr_table and obj_table from this raw_code
                 if main_cm_idx is not None: